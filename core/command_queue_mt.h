@@ -37,6 +37,8 @@
 #include "core/simple_type.h"
 #include "core/typedefs.h"
 
+#include <atomic>
+
 #define COMMA(N) _COMMA_##N
 #define _COMMA_0
 #define _COMMA_1 ,
@@ -339,6 +341,9 @@ class CommandQueueMT {
 	uint32_t read_ptr = 0;
 	uint32_t write_ptr = 0;
 	uint32_t dealloc_ptr = 0;
+	// Whether read_ptr may lag behind write_ptr. Only changed with the lock held, but
+	// read without it by flush_if_pending().
+	std::atomic<bool> pending = { false };
 	SyncSemaphore sync_sems[SYNC_SEMAPHORES];
 	Mutex mutex;
 	Semaphore *sync = nullptr;
@@ -394,6 +399,7 @@ class CommandQueueMT {
 		// allocate the command
 		T *cmd = memnew_placement(&command_mem[write_ptr], T);
 		write_ptr += size;
+		pending.store(true, std::memory_order_release);
 		return cmd;
 	}
 
@@ -420,6 +426,7 @@ class CommandQueueMT {
 
 		// tried to read an empty queue
 		if (read_ptr == write_ptr) {
+			pending.store(false, std::memory_order_release);
 			if (p_lock) {
 				unlock();
 			}
@@ -484,6 +491,12 @@ public:
 		flush_one();
 	}
 
+	void flush_if_pending() {
+		if (unlikely(pending.load(std::memory_order_acquire))) {
+			flush_all();
+		}
+	}
+
 	void flush_all() {
 		//ERR_FAIL_COND(sync);
 		lock();
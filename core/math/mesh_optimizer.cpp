@@ -0,0 +1,768 @@
+/*************************************************************************/
+/*  mesh_optimizer.cpp                                                   */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "mesh_optimizer.h"
+
+#include "core/local_vector.h"
+#include "core/math/aabb.h"
+#include "core/math/face3.h"
+#include "core/math/geometry_3d.h"
+#include "core/sort_array.h"
+
+/* VERTEX CACHE */
+
+static _FORCE_INLINE_ float _vertex_cache_score(int p_cache_position, uint32_t p_live_triangles) {
+	if (p_live_triangles == 0) {
+		return -1.0; // No triangle left to draw with this vertex.
+	}
+
+	float score = 0.0;
+	if (p_cache_position >= 0) {
+		if (p_cache_position < 3) {
+			// Used by the last triangle, the score must not depend on the order inside it.
+			score = 0.75;
+		} else {
+			score = Math::pow(1.0f - float(p_cache_position - 3) / float(MeshOptimizer::VERTEX_CACHE_SIZE - 3), 1.5f);
+		}
+	}
+
+	// Favor vertices with few triangles left, so they don't end up as isolated stragglers.
+	return score + 2.0f * Math::pow(float(p_live_triangles), -0.5f);
+}
+
+void MeshOptimizer::optimize_vertex_cache(int *r_indices, int p_index_count, int p_vertex_count) {
+	ERR_FAIL_COND(p_index_count % 3 != 0);
+
+	const uint32_t triangle_count = p_index_count / 3;
+	if (triangle_count < 2) {
+		return;
+	}
+
+	// Triangles using each vertex, the first live_triangles[v] of them still waiting to be drawn.
+	LocalVector<uint32_t> offsets;
+	offsets.resize(p_vertex_count + 1);
+	LocalVector<uint32_t> live_triangles;
+	live_triangles.resize(p_vertex_count);
+	for (int i = 0; i < p_vertex_count; i++) {
+		live_triangles[i] = 0;
+	}
+	for (int i = 0; i < p_index_count; i++) {
+		ERR_FAIL_INDEX(r_indices[i], p_vertex_count);
+		live_triangles[r_indices[i]]++;
+	}
+
+	uint32_t offset = 0;
+	for (int i = 0; i < p_vertex_count; i++) {
+		offsets[i] = offset;
+		offset += live_triangles[i];
+		live_triangles[i] = 0;
+	}
+	offsets[p_vertex_count] = offset;
+
+	LocalVector<uint32_t> adjacency;
+	adjacency.resize(p_index_count);
+	for (uint32_t i = 0; i < triangle_count; i++) {
+		for (int j = 0; j < 3; j++) {
+			int v = r_indices[i * 3 + j];
+			adjacency[offsets[v] + live_triangles[v]++] = i;
+		}
+	}
+
+	LocalVector<int> cache_position;
+	cache_position.resize(p_vertex_count);
+	LocalVector<float> vertex_score;
+	vertex_score.resize(p_vertex_count);
+	for (int i = 0; i < p_vertex_count; i++) {
+		cache_position[i] = -1;
+		vertex_score[i] = _vertex_cache_score(-1, live_triangles[i]);
+	}
+
+	LocalVector<uint8_t> emitted;
+	emitted.resize(triangle_count);
+
+	uint32_t best_triangle = 0;
+	float best_score = -1.0;
+	for (uint32_t i = 0; i < triangle_count; i++) {
+		const int *tri = &r_indices[i * 3];
+		float score = vertex_score[tri[0]] + vertex_score[tri[1]] + vertex_score[tri[2]];
+		emitted[i] = 0;
+		if (score > best_score) {
+			best_triangle = i;
+			best_score = score;
+		}
+	}
+
+	LocalVector<int> output;
+	output.resize(p_index_count);
+	uint32_t output_count = 0;
+
+	int cache[VERTEX_CACHE_SIZE + 3];
+	int new_cache[VERTEX_CACHE_SIZE + 3];
+	int cache_count = 0;
+	uint32_t scan_from = 0;
+
+	while (true) {
+		const int *tri = &r_indices[best_triangle * 3];
+		emitted[best_triangle] = 1;
+
+		int new_cache_count = 0;
+		for (int j = 0; j < 3; j++) {
+			int v = tri[j];
+			output[output_count++] = v;
+			new_cache[new_cache_count++] = v;
+
+			// Take the triangle off the vertex' live range.
+			uint32_t *list = &adjacency[offsets[v]];
+			for (uint32_t k = 0; k < live_triangles[v]; k++) {
+				if (list[k] == best_triangle) {
+					SWAP(list[k], list[live_triangles[v] - 1]);
+					live_triangles[v]--;
+					break;
+				}
+			}
+		}
+
+		for (int i = 0; i < cache_count; i++) {
+			int v = cache[i];
+			if (v != tri[0] && v != tri[1] && v != tri[2]) {
+				new_cache[new_cache_count++] = v;
+			}
+		}
+
+		// Rescore what is (or just fell out of) the cache, then the triangles around it.
+		for (int i = 0; i < new_cache_count; i++) {
+			int v = new_cache[i];
+			cache_position[v] = i < VERTEX_CACHE_SIZE ? i : -1;
+			vertex_score[v] = _vertex_cache_score(cache_position[v], live_triangles[v]);
+		}
+
+		bool found = false;
+		for (int i = 0; i < new_cache_count; i++) {
+			int v = new_cache[i];
+			const uint32_t *list = &adjacency[offsets[v]];
+			for (uint32_t k = 0; k < live_triangles[v]; k++) {
+				uint32_t t = list[k];
+				const int *other = &r_indices[t * 3];
+				float score = vertex_score[other[0]] + vertex_score[other[1]] + vertex_score[other[2]];
+				if (!found || score > best_score) {
+					best_triangle = t;
+					best_score = score;
+					found = true;
+				}
+			}
+		}
+
+		cache_count = MIN(new_cache_count, (int)VERTEX_CACHE_SIZE);
+		for (int i = 0; i < cache_count; i++) {
+			cache[i] = new_cache[i];
+		}
+
+		if (!found) {
+			// Nothing left around the cache, continue with the next triangle in the original order.
+			while (scan_from < triangle_count && emitted[scan_from]) {
+				scan_from++;
+			}
+			if (scan_from == triangle_count) {
+				break;
+			}
+			best_triangle = scan_from;
+		}
+	}
+
+	for (int i = 0; i < p_index_count; i++) {
+		r_indices[i] = output[i];
+	}
+}
+
+/* OVERDRAW */
+
+struct _MeshOptimizerCluster {
+	uint32_t start;
+	uint32_t count;
+	float sort_key;
+
+	bool operator<(const _MeshOptimizerCluster &p_other) const {
+		// Outward facing clusters first, keeping the original order on ties.
+		if (sort_key != p_other.sort_key) {
+			return sort_key > p_other.sort_key;
+		}
+		return start < p_other.start;
+	}
+};
+
+void MeshOptimizer::optimize_overdraw(int *r_indices, int p_index_count, const Vector3 *p_vertices, int p_vertex_count) {
+	ERR_FAIL_COND(p_index_count % 3 != 0);
+
+	const uint32_t triangle_count = p_index_count / 3;
+	if (triangle_count < 2) {
+		return;
+	}
+
+	// A cluster starts wherever a small FIFO cache misses all three vertices, so reordering
+	// whole clusters costs almost nothing in cache efficiency.
+	const uint32_t fifo_size = 16;
+	LocalVector<uint32_t> timestamps;
+	timestamps.resize(p_vertex_count);
+	for (int i = 0; i < p_vertex_count; i++) {
+		timestamps[i] = 0;
+	}
+	uint32_t time = fifo_size + 1;
+
+	LocalVector<_MeshOptimizerCluster> clusters;
+	Vector3 mesh_centroid;
+	real_t mesh_area = 0.0;
+
+	for (uint32_t i = 0; i < triangle_count; i++) {
+		const int *tri = &r_indices[i * 3];
+		int misses = 0;
+		for (int j = 0; j < 3; j++) {
+			ERR_FAIL_INDEX(tri[j], p_vertex_count);
+			if (time - timestamps[tri[j]] > fifo_size) {
+				timestamps[tri[j]] = time++;
+				misses++;
+			}
+		}
+
+		if (i == 0 || misses == 3) {
+			_MeshOptimizerCluster cluster;
+			cluster.start = i;
+			cluster.count = 0;
+			cluster.sort_key = 0.0;
+			clusters.push_back(cluster);
+		}
+		clusters[clusters.size() - 1].count++;
+
+		const Vector3 &a = p_vertices[tri[0]];
+		const Vector3 &b = p_vertices[tri[1]];
+		const Vector3 &c = p_vertices[tri[2]];
+		real_t area = (b - a).cross(c - a).length();
+		mesh_centroid += (a + b + c) * area;
+		mesh_area += area;
+	}
+
+	if (clusters.size() < 2 || mesh_area <= 0.0) {
+		return;
+	}
+	mesh_centroid /= mesh_area * 3.0;
+
+	for (uint32_t i = 0; i < clusters.size(); i++) {
+		_MeshOptimizerCluster &cluster = clusters[i];
+		Vector3 centroid;
+		Vector3 normal;
+		real_t area = 0.0;
+
+		for (uint32_t t = cluster.start; t < cluster.start + cluster.count; t++) {
+			const int *tri = &r_indices[t * 3];
+			const Vector3 &a = p_vertices[tri[0]];
+			const Vector3 &b = p_vertices[tri[1]];
+			const Vector3 &c = p_vertices[tri[2]];
+			Vector3 n = (b - a).cross(c - a);
+			real_t tri_area = n.length();
+			centroid += (a + b + c) * tri_area;
+			normal += n;
+			area += tri_area;
+		}
+
+		if (area > 0.0) {
+			centroid /= area * 3.0;
+			cluster.sort_key = (centroid - mesh_centroid).dot(normal.normalized());
+		}
+	}
+
+	clusters.sort();
+
+	LocalVector<int> output;
+	output.resize(p_index_count);
+	uint32_t output_count = 0;
+	for (uint32_t i = 0; i < clusters.size(); i++) {
+		const int *src = &r_indices[clusters[i].start * 3];
+		for (uint32_t j = 0; j < clusters[i].count * 3; j++) {
+			output[output_count++] = src[j];
+		}
+	}
+
+	for (int i = 0; i < p_index_count; i++) {
+		r_indices[i] = output[i];
+	}
+}
+
+/* SIMPLIFICATION */
+
+// Sum of squared distances to a set of planes, weighted by triangle area. Only used to order the
+// collapses, the reported error is measured on the surface instead.
+struct _MeshOptimizerQuadric {
+	float a00 = 0, a01 = 0, a02 = 0, a11 = 0, a12 = 0, a22 = 0;
+	float b0 = 0, b1 = 0, b2 = 0;
+	float c = 0;
+	float w = 0;
+
+	void add_plane(const Vector3 &p_normal, float p_d, float p_weight) {
+		a00 += p_normal.x * p_normal.x * p_weight;
+		a01 += p_normal.x * p_normal.y * p_weight;
+		a02 += p_normal.x * p_normal.z * p_weight;
+		a11 += p_normal.y * p_normal.y * p_weight;
+		a12 += p_normal.y * p_normal.z * p_weight;
+		a22 += p_normal.z * p_normal.z * p_weight;
+		b0 += p_normal.x * p_d * p_weight;
+		b1 += p_normal.y * p_d * p_weight;
+		b2 += p_normal.z * p_d * p_weight;
+		c += p_d * p_d * p_weight;
+		w += p_weight;
+	}
+
+	void operator+=(const _MeshOptimizerQuadric &p_other) {
+		a00 += p_other.a00;
+		a01 += p_other.a01;
+		a02 += p_other.a02;
+		a11 += p_other.a11;
+		a12 += p_other.a12;
+		a22 += p_other.a22;
+		b0 += p_other.b0;
+		b1 += p_other.b1;
+		b2 += p_other.b2;
+		c += p_other.c;
+		w += p_other.w;
+	}
+
+	// Mean squared distance of p_point to the planes.
+	float error(const Vector3 &p_point) const {
+		float rx = a00 * p_point.x + a01 * p_point.y + a02 * p_point.z;
+		float ry = a01 * p_point.x + a11 * p_point.y + a12 * p_point.z;
+		float rz = a02 * p_point.x + a12 * p_point.y + a22 * p_point.z;
+		float r = rx * p_point.x + ry * p_point.y + rz * p_point.z;
+		r += 2.0f * (b0 * p_point.x + b1 * p_point.y + b2 * p_point.z) + c;
+		return w > 0.0f ? Math::abs(r) / w : 0.0f;
+	}
+};
+
+struct _MeshOptimizerCollapse {
+	int from;
+	int to;
+	float error;
+
+	bool operator<(const _MeshOptimizerCollapse &p_other) const {
+		return error < p_other.error;
+	}
+};
+
+struct _MeshOptimizerPositionSort {
+	const Vector3 *positions = nullptr;
+
+	bool operator()(int p_a, int p_b) const {
+		return positions[p_a] < positions[p_b];
+	}
+};
+
+static _FORCE_INLINE_ bool _triangle_has_edge(const int *p_tri, int p_from, int p_to) {
+	return (p_tri[0] == p_from && p_tri[1] == p_to) || (p_tri[1] == p_from && p_tri[2] == p_to) || (p_tri[2] == p_from && p_tri[0] == p_to);
+}
+
+// Distance from p_point to the fan around p_from once it is collapsed into p_to.
+static float _collapsed_fan_distance(const Vector3 &p_point, const int *p_indices, const uint32_t *p_fan, uint32_t p_fan_count, int p_from, int p_to, const Vector3 *p_positions) {
+	float distance = 1e20;
+	for (uint32_t k = 0; k < p_fan_count; k++) {
+		const int *tri = &p_indices[p_fan[k] * 3];
+		Vector3 closest;
+		if (tri[0] == p_to || tri[1] == p_to || tri[2] == p_to) {
+			// Removed, it shrinks to its edge opposite of p_from.
+			int corner = tri[0] == p_from ? 0 : (tri[1] == p_from ? 1 : 2);
+			Vector3 edge[2] = { p_positions[tri[(corner + 1) % 3]], p_positions[tri[(corner + 2) % 3]] };
+			closest = Geometry3D::get_closest_point_to_segment(p_point, edge);
+		} else {
+			Face3 face(p_positions[tri[0] == p_from ? p_to : tri[0]], p_positions[tri[1] == p_from ? p_to : tri[1]], p_positions[tri[2] == p_from ? p_to : tri[2]]);
+			closest = face.get_closest_point_to(p_point);
+		}
+		distance = MIN(distance, closest.distance_to(p_point));
+	}
+	return distance;
+}
+
+Vector<int> MeshOptimizer::simplify(const int *p_indices, int p_index_count, const Vector3 *p_vertices, int p_vertex_count, int p_target_index_count, float p_target_error, float *r_error) {
+	ERR_FAIL_COND_V(p_index_count % 3 != 0, Vector<int>());
+
+	Vector<int> result;
+	result.resize(p_index_count);
+	int *indices = result.ptrw();
+	for (int i = 0; i < p_index_count; i++) {
+		ERR_FAIL_INDEX_V(p_indices[i], p_vertex_count, Vector<int>());
+		indices[i] = p_indices[i];
+	}
+
+	if (r_error) {
+		*r_error = 0.0;
+	}
+
+	if (p_index_count <= p_target_index_count || p_vertex_count == 0) {
+		return result;
+	}
+
+	// Work in a unit box, so the error thresholds don't depend on the mesh scale.
+	AABB aabb(p_vertices[0], Vector3());
+	for (int i = 1; i < p_vertex_count; i++) {
+		aabb.expand_to(p_vertices[i]);
+	}
+	float scale = aabb.get_longest_axis_size();
+	if (scale <= 0.0) {
+		return result;
+	}
+	float inv_scale = 1.0 / scale;
+
+	LocalVector<Vector3> positions;
+	positions.resize(p_vertex_count);
+	for (int i = 0; i < p_vertex_count; i++) {
+		positions[i] = (p_vertices[i] - aabb.position) * inv_scale;
+	}
+
+	// Vertices sharing a position with another one split attributes (UV seams, hard edges),
+	// moving them would tear the surface open.
+	LocalVector<uint8_t> shared;
+	shared.resize(p_vertex_count);
+	{
+		LocalVector<int> order;
+		order.resize(p_vertex_count);
+		for (int i = 0; i < p_vertex_count; i++) {
+			order[i] = i;
+			shared[i] = 0;
+		}
+		SortArray<int, _MeshOptimizerPositionSort> sorter;
+		sorter.compare.positions = positions.ptr();
+		sorter.sort(order.ptr(), p_vertex_count);
+		for (int i = 1; i < p_vertex_count; i++) {
+			if (positions[order[i]] == positions[order[i - 1]]) {
+				shared[order[i]] = 1;
+				shared[order[i - 1]] = 1;
+			}
+		}
+	}
+
+	LocalVector<_MeshOptimizerQuadric> quadrics;
+	quadrics.resize(p_vertex_count);
+	for (int i = 0; i < p_index_count; i += 3) {
+		const Vector3 &a = positions[indices[i + 0]];
+		const Vector3 &b = positions[indices[i + 1]];
+		const Vector3 &c = positions[indices[i + 2]];
+		Vector3 normal = (b - a).cross(c - a);
+		float area = normal.length();
+		if (area <= 0.0) {
+			continue;
+		}
+		normal /= area;
+		float d = -normal.dot(a);
+		for (int j = 0; j < 3; j++) {
+			quadrics[indices[i + j]].add_plane(normal, d, area);
+		}
+	}
+
+	const float target_error = p_target_error * inv_scale;
+	const float target_error_sq = target_error * target_error;
+	float max_error = 0.0;
+
+	// How far the surface around each vertex may already be from the original one.
+	LocalVector<float> vertex_error;
+	vertex_error.resize(p_vertex_count);
+	for (int i = 0; i < p_vertex_count; i++) {
+		vertex_error[i] = 0.0;
+	}
+	int index_count = p_index_count;
+
+	LocalVector<uint32_t> offsets;
+	offsets.resize(p_vertex_count + 1);
+	LocalVector<uint32_t> counts;
+	counts.resize(p_vertex_count);
+	LocalVector<uint32_t> adjacency;
+	LocalVector<uint8_t> movable;
+	movable.resize(p_vertex_count);
+	LocalVector<uint8_t> touched;
+	touched.resize(p_vertex_count);
+	LocalVector<int> remap;
+	remap.resize(p_vertex_count);
+	LocalVector<_MeshOptimizerCollapse> collapses;
+
+	while (index_count > p_target_index_count) {
+		// Triangles around each vertex for the current index list.
+		for (int i = 0; i < p_vertex_count; i++) {
+			counts[i] = 0;
+		}
+		for (int i = 0; i < index_count; i++) {
+			counts[indices[i]]++;
+		}
+		uint32_t offset = 0;
+		for (int i = 0; i < p_vertex_count; i++) {
+			offsets[i] = offset;
+			offset += counts[i];
+			counts[i] = 0;
+		}
+		offsets[p_vertex_count] = offset;
+		adjacency.resize(index_count);
+		for (int i = 0; i < index_count; i++) {
+			int v = indices[i];
+			adjacency[offsets[v] + counts[v]++] = i / 3;
+		}
+
+		// Only vertices whose every edge is shared by exactly two opposite triangles can move,
+		// which keeps open borders and non-manifold parts in place.
+		for (int v = 0; v < p_vertex_count; v++) {
+			remap[v] = v;
+			touched[v] = 0;
+			movable[v] = 0;
+
+			if (shared[v] || counts[v] == 0) {
+				continue;
+			}
+
+			bool interior = true;
+			for (uint32_t k = offsets[v]; k < offsets[v] + counts[v] && interior; k++) {
+				const int *tri = &indices[adjacency[k] * 3];
+				int corner = tri[0] == v ? 0 : (tri[1] == v ? 1 : 2);
+				int next = tri[(corner + 1) % 3];
+
+				int opposite = 0;
+				for (uint32_t l = offsets[v]; l < offsets[v] + counts[v]; l++) {
+					if (_triangle_has_edge(&indices[adjacency[l] * 3], next, v)) {
+						opposite++;
+					}
+				}
+				interior = opposite == 1;
+			}
+			movable[v] = interior;
+		}
+
+		collapses.clear();
+		for (int i = 0; i < index_count; i += 3) {
+			for (int j = 0; j < 3; j++) {
+				int a = indices[i + j];
+				int b = indices[i + (j + 1) % 3];
+				for (int k = 0; k < 2; k++) {
+					int from = k == 0 ? a : b;
+					int to = k == 0 ? b : a;
+					if (!movable[from]) {
+						continue;
+					}
+					_MeshOptimizerQuadric q = quadrics[from];
+					q += quadrics[to];
+					_MeshOptimizerCollapse collapse;
+					collapse.from = from;
+					collapse.to = to;
+					collapse.error = q.error(positions[to]);
+					collapses.push_back(collapse);
+				}
+			}
+		}
+
+		if (collapses.empty()) {
+			break;
+		}
+		collapses.sort();
+
+		// An interior collapse removes two triangles.
+		int triangles_to_remove = (index_count - p_target_index_count) / 3;
+		int collapsed = 0;
+
+		for (uint32_t c = 0; c < collapses.size() && collapsed * 2 < triangles_to_remove; c++) {
+			const _MeshOptimizerCollapse &collapse = collapses[c];
+			if (collapse.error > target_error_sq) {
+				break;
+			}
+
+			int from = collapse.from;
+			int to = collapse.to;
+			if (touched[from] || touched[to]) {
+				continue;
+			}
+
+			const uint32_t *from_tris = &adjacency[offsets[from]];
+			const uint32_t from_count = counts[from];
+			bool valid = true;
+
+			// The two vertices may only share the two neighbors across the collapsed edge,
+			// otherwise the result folds onto itself.
+			int shared_neighbors = 0;
+			for (uint32_t k = 0; k < from_count; k++) {
+				const int *tri = &indices[from_tris[k] * 3];
+				int corner = tri[0] == from ? 0 : (tri[1] == from ? 1 : 2);
+				int n = tri[(corner + 1) % 3];
+				if (n == to) {
+					continue;
+				}
+				for (uint32_t l = offsets[to]; l < offsets[to] + counts[to]; l++) {
+					const int *other = &indices[adjacency[l] * 3];
+					if (other[0] == n || other[1] == n || other[2] == n) {
+						shared_neighbors++;
+						break;
+					}
+				}
+			}
+			valid = shared_neighbors <= 2;
+
+			// No triangle may flip or collapse to a sliver.
+			for (uint32_t k = 0; k < from_count && valid; k++) {
+				const int *tri = &indices[from_tris[k] * 3];
+				if (tri[0] == to || tri[1] == to || tri[2] == to) {
+					continue; // Removed by the collapse.
+				}
+				const Vector3 &a = positions[tri[0]];
+				const Vector3 &b = positions[tri[1]];
+				const Vector3 &c = positions[tri[2]];
+				Vector3 normal = (b - a).cross(c - a);
+
+				const Vector3 &na = tri[0] == from ? positions[to] : a;
+				const Vector3 &nb = tri[1] == from ? positions[to] : b;
+				const Vector3 &nc = tri[2] == from ? positions[to] : c;
+				Vector3 new_normal = (nb - na).cross(nc - na);
+
+				valid = normal.dot(new_normal) > 0.1f * normal.length() * new_normal.length();
+			}
+
+			if (!valid) {
+				continue;
+			}
+
+			// Largest distance from the old fan to the new one, sampled at the moved vertex, the
+			// middle of its edges and the triangle centers. It adds up with the error the fan
+			// already had.
+			float distance = _collapsed_fan_distance(positions[from], indices, from_tris, from_count, from, to, positions.ptr());
+			for (uint32_t k = 0; k < from_count && distance <= target_error; k++) {
+				const int *tri = &indices[from_tris[k] * 3];
+				const Vector3 &a = positions[tri[0]];
+				const Vector3 &b = positions[tri[1]];
+				const Vector3 &c = positions[tri[2]];
+				int corner = tri[0] == from ? 0 : (tri[1] == from ? 1 : 2);
+				Vector3 middle = (positions[from] + positions[tri[(corner + 1) % 3]]) * 0.5;
+				distance = MAX(distance, _collapsed_fan_distance(middle, indices, from_tris, from_count, from, to, positions.ptr()));
+				distance = MAX(distance, _collapsed_fan_distance((a + b + c) / 3.0, indices, from_tris, from_count, from, to, positions.ptr()));
+			}
+			if (distance < 1e-4f) {
+				distance = 0.0; // Rounding noise on a flat fan, it would add up over the passes.
+			}
+			distance += vertex_error[from];
+			if (distance > target_error) {
+				continue;
+			}
+
+			remap[from] = to;
+			quadrics[to] += quadrics[from];
+			max_error = MAX(max_error, distance);
+			collapsed++;
+
+			// Keep the whole fan untouched for the rest of the pass, the checks above rely on it.
+			for (uint32_t k = 0; k < from_count; k++) {
+				const int *tri = &indices[from_tris[k] * 3];
+				for (int j = 0; j < 3; j++) {
+					touched[tri[j]] = 1;
+					vertex_error[tri[j]] = MAX(vertex_error[tri[j]], distance);
+				}
+			}
+		}
+
+		if (collapsed == 0) {
+			break;
+		}
+
+		int write = 0;
+		for (int i = 0; i < index_count; i += 3) {
+			int a = remap[indices[i + 0]];
+			int b = remap[indices[i + 1]];
+			int c = remap[indices[i + 2]];
+			if (a == b || b == c || c == a) {
+				continue;
+			}
+			indices[write++] = a;
+			indices[write++] = b;
+			indices[write++] = c;
+		}
+		index_count = write;
+	}
+
+	result.resize(index_count);
+
+	if (r_error) {
+		*r_error = max_error * scale;
+	}
+
+	return result;
+}
+
+Vector<MeshOptimizer::LOD> MeshOptimizer::generate_lods(const int *p_indices, int p_index_count, const Vector3 *p_vertices, int p_vertex_count) {
+	Vector<LOD> lods;
+	ERR_FAIL_COND_V(p_index_count % 3 != 0, lods);
+
+	if (p_vertex_count == 0) {
+		return lods;
+	}
+
+	AABB aabb(p_vertices[0], Vector3());
+	for (int i = 1; i < p_vertex_count; i++) {
+		aabb.expand_to(p_vertices[i]);
+	}
+
+	// Past this, the mesh is only a few pixels tall whenever the LOD would be picked.
+	const float max_error = aabb.get_longest_axis_size() * 0.1;
+	const int min_index_count = 3 * 8;
+
+	Vector<int> current;
+	current.resize(p_index_count);
+	for (int i = 0; i < p_index_count; i++) {
+		current.write[i] = p_indices[i];
+	}
+
+	float error = 0.0;
+
+	while (lods.size() < MAX_LODS) {
+		int target_index_count = (current.size() / 6) * 3;
+		if (target_index_count < min_index_count) {
+			break;
+		}
+
+		float step_error = 0.0;
+		Vector<int> simplified = simplify(current.ptr(), current.size(), p_vertices, p_vertex_count, target_index_count, max_error - error, &step_error);
+
+		if (simplified.size() > current.size() * 0.85) {
+			break; // Stalled on seams, borders or the error budget.
+		}
+
+		// Each level is simplified from the previous one, so the errors add up.
+		error += step_error;
+		optimize_vertex_cache(simplified.ptrw(), simplified.size(), p_vertex_count);
+
+		LOD lod;
+		lod.error = MAX(error, (float)CMP_EPSILON);
+		lod.indices = simplified;
+
+		if (lods.size() && lods[lods.size() - 1].error >= lod.error) {
+			lods.write[lods.size() - 1] = lod; // Same error with fewer triangles, only keep this one.
+		} else {
+			lods.push_back(lod);
+		}
+
+		current = simplified;
+	}
+
+	return lods;
+}
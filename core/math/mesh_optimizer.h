@@ -0,0 +1,66 @@
+/*************************************************************************/
+/*  mesh_optimizer.h                                                     */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef MESH_OPTIMIZER_H
+#define MESH_OPTIMIZER_H
+
+#include "core/math/vector3.h"
+#include "core/vector.h"
+
+// Index buffer tools for indexed triangle lists: post-transform cache and overdraw
+// ordering, and quadric error simplification for generating LODs. Vertices are never
+// added or moved, so every LOD can share the original vertex buffer.
+class MeshOptimizer {
+public:
+	enum {
+		VERTEX_CACHE_SIZE = 32,
+		MAX_LODS = 8,
+	};
+
+	struct LOD {
+		float error; // Upper bound of the distance from the original surface, in mesh units.
+		Vector<int> indices;
+	};
+
+	// Reorders the triangles so vertices are reused while still in the post-transform cache (Forsyth).
+	static void optimize_vertex_cache(int *r_indices, int p_index_count, int p_vertex_count);
+	// Splits a cache optimized list where the cache runs cold and draws outward facing clusters first.
+	static void optimize_overdraw(int *r_indices, int p_index_count, const Vector3 *p_vertices, int p_vertex_count);
+
+	// Collapses edges until p_target_index_count is reached or the error would exceed p_target_error
+	// (in mesh units). Vertices sharing a position with another (seams, hard edges) and vertices on
+	// open borders are kept.
+	static Vector<int> simplify(const int *p_indices, int p_index_count, const Vector3 *p_vertices, int p_vertex_count, int p_target_index_count, float p_target_error, float *r_error = nullptr);
+
+	// Halves the triangle count per level, as long as the error stays small compared to the mesh size.
+	static Vector<LOD> generate_lods(const int *p_indices, int p_index_count, const Vector3 *p_vertices, int p_vertex_count);
+};
+
+#endif // MESH_OPTIMIZER_H
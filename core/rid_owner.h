@@ -338,6 +338,12 @@ public:
 		return *ptr;
 	}
 
+	_FORCE_INLINE_ void replace(const RID &p_rid, T *p_new_ptr) {
+		T **ptr = alloc.getornull(p_rid);
+		ERR_FAIL_COND(!ptr);
+		*ptr = p_new_ptr;
+	}
+
 	_FORCE_INLINE_ bool owns(const RID &p_rid) {
 		return alloc.owns(p_rid);
 	}
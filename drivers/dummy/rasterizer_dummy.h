@@ -249,6 +249,8 @@ public:
 
 	virtual void texture_debug_usage(List<RS::TextureInfo> *r_info) {}
 	virtual void texture_set_force_redraw_if_visible(RID p_texture, bool p_enable) {}
+	virtual void texture_set_streaming_feedback(RID p_texture, bool p_enable) {}
+	virtual Vector<int> texture_get_streaming_demand(const Vector<RID> &p_textures) { return Vector<int>(); }
 	virtual Size2 texture_size_with_proxy(RID p_proxy) { return Size2(); }
 
 	virtual void texture_add_to_decal_atlas(RID p_texture, bool p_panorama_to_dp = false) {}
@@ -931,6 +933,8 @@ public:
 	virtual void canvas_render_items(RID p_to_render_target, Item *p_item_list, const Color &p_modulate, Light *p_light_list, const Transform2D &p_canvas_transform) {}
 	virtual void canvas_debug_viewport_shadows(Light *p_lights_with_shadow) {}
 
+	virtual int get_render_info(RS::RenderInfo p_info) { return 0; }
+
 	virtual RID light_create() { return RID(); }
 	virtual void light_set_texture(RID p_rid, RID p_texture) {}
 	virtual void light_set_use_shadow(RID p_rid, bool p_enable, int p_resolution) {}
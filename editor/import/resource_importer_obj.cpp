@@ -486,6 +486,7 @@ void ResourceImporterOBJ::get_import_options(List<ImportOption> *r_options, int
 	r_options->push_back(ImportOption(PropertyInfo(Variant::VECTOR3, "scale_mesh"), Vector3(1, 1, 1)));
 	r_options->push_back(ImportOption(PropertyInfo(Variant::VECTOR3, "offset_mesh"), Vector3(0, 0, 0)));
 	r_options->push_back(ImportOption(PropertyInfo(Variant::BOOL, "optimize_mesh"), true));
+	r_options->push_back(ImportOption(PropertyInfo(Variant::BOOL, "generate_lods"), true));
 }
 
 bool ResourceImporterOBJ::get_option_visibility(const String &p_option, const Map<StringName, Variant> &p_options) const {
@@ -500,6 +501,13 @@ Error ResourceImporterOBJ::import(const String &p_source_file, const String &p_s
 	ERR_FAIL_COND_V(err != OK, err);
 	ERR_FAIL_COND_V(meshes.size() != 1, ERR_BUG);
 
+	if (bool(p_options["generate_lods"])) {
+		Ref<ArrayMesh> mesh = meshes.front()->get();
+		if (mesh.is_valid()) {
+			mesh->generate_lods();
+		}
+	}
+
 	String save_path = p_save_path + ".mesh";
 
 	err = ResourceSaver::save(save_path, meshes.front()->get());
@@ -33,6 +33,7 @@
 #include "core/message_queue.h"
 #include "core/os/os.h"
 #include "scene/main/node.h"
+#include "scene/main/scene_pool.h"
 #include "scene/main/scene_tree.h"
 #include "servers/audio_server.h"
 #include "servers/physics_server_2d.h"
@@ -77,6 +78,8 @@ void Performance::_bind_methods() {
 	BIND_ENUM_CONSTANT(PHYSICS_3D_COLLISION_PAIRS);
 	BIND_ENUM_CONSTANT(PHYSICS_3D_ISLAND_COUNT);
 	BIND_ENUM_CONSTANT(AUDIO_OUTPUT_LATENCY);
+	BIND_ENUM_CONSTANT(OBJECT_SCENE_POOL_HITS);
+	BIND_ENUM_CONSTANT(OBJECT_SCENE_POOL_MISSES);
 
 	BIND_ENUM_CONSTANT(MONITOR_MAX);
 }
@@ -121,6 +124,8 @@ String Performance::get_monitor_name(Monitor p_monitor) const {
 		"physics_3d/collision_pairs",
 		"physics_3d/islands",
 		"audio/output_latency",
+		"object/scene_pool_hits",
+		"object/scene_pool_misses",
 
 	};
 
@@ -183,6 +188,10 @@ float Performance::get_monitor(Monitor p_monitor) const {
 			return PhysicsServer3D::get_singleton()->get_process_info(PhysicsServer3D::INFO_ISLAND_COUNT);
 		case AUDIO_OUTPUT_LATENCY:
 			return AudioServer::get_singleton()->get_output_latency();
+		case OBJECT_SCENE_POOL_HITS:
+			return ScenePool::get_hit_count();
+		case OBJECT_SCENE_POOL_MISSES:
+			return ScenePool::get_miss_count();
 
 		default: {
 		}
@@ -223,6 +232,8 @@ Performance::MonitorType Performance::get_monitor_type(Monitor p_monitor) const
 		MONITOR_TYPE_QUANTITY,
 		MONITOR_TYPE_QUANTITY,
 		MONITOR_TYPE_TIME,
+		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_QUANTITY,
 
 	};
 
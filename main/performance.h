@@ -92,6 +92,8 @@ public:
 		PHYSICS_3D_ISLAND_COUNT,
 		//physics
 		AUDIO_OUTPUT_LATENCY,
+		OBJECT_SCENE_POOL_HITS,
+		OBJECT_SCENE_POOL_MISSES,
 		MONITOR_MAX
 	};
 
@@ -67,7 +67,7 @@
 #define JointAssertSameSpace(bodyA, bodyB, ret)                                                   \
 	if (bodyA->get_space() != bodyB->get_space()) {                                               \
 		ERR_PRINT("In order to create a joint the Body_A and Body_B must be in the same space!"); \
-		return RID();                                                                             \
+		return ret;                                                                               \
 	}
 
 #define AddJointToSpace(body, joint) \
@@ -145,6 +145,10 @@ Variant BulletPhysicsServer3D::shape_get_data(RID p_shape) const {
 	return shape->get_data();
 }
 
+Vector<uint8_t> BulletPhysicsServer3D::shape_get_bvh_cache(RID p_shape) const {
+	return Vector<uint8_t>();
+}
+
 void BulletPhysicsServer3D::shape_set_margin(RID p_shape, real_t p_margin) {
 	ShapeBullet *shape = shape_owner.getornull(p_shape);
 	ERR_FAIL_COND(!shape);
@@ -231,6 +235,14 @@ int BulletPhysicsServer3D::space_get_contact_count(RID p_space) const {
 	return space->get_debug_contact_count();
 }
 
+Vector<uint8_t> BulletPhysicsServer3D::space_get_state_snapshot(RID p_space) {
+	ERR_FAIL_V_MSG(Vector<uint8_t>(), "State snapshots are not supported by the Bullet backend.");
+}
+
+Error BulletPhysicsServer3D::space_set_state_snapshot(RID p_space, const Vector<uint8_t> &p_snapshot) {
+	ERR_FAIL_V_MSG(ERR_UNAVAILABLE, "State snapshots are not supported by the Bullet backend.");
+}
+
 RID BulletPhysicsServer3D::area_create() {
 	AreaBullet *area = bulletnew(AreaBullet);
 	area->set_collision_layer(1);
@@ -862,6 +874,16 @@ bool BulletPhysicsServer3D::body_test_motion(RID p_body, const Transform &p_from
 	return body->get_space()->test_body_motion(body, p_from, p_motion, p_infinite_inertia, r_result, p_exclude_raycast_shapes);
 }
 
+int BulletPhysicsServer3D::body_test_motion_batch(const RID *p_bodies, const Transform *p_from, const Vector3 *p_motions, int p_count, bool p_infinite_inertia, MotionResult *r_results, bool p_exclude_raycast_shapes) {
+	int collided = 0;
+	for (int i = 0; i < p_count; i++) {
+		if (body_test_motion(p_bodies[i], p_from[i], p_motions[i], p_infinite_inertia, &r_results[i], p_exclude_raycast_shapes)) {
+			collided++;
+		}
+	}
+	return collided;
+}
+
 int BulletPhysicsServer3D::body_test_ray_separation(RID p_body, const Transform &p_transform, bool p_infinite_inertia, Vector3 &r_recover_motion, SeparationResult *r_results, int p_result_max, float p_margin) {
 	RigidBodyBullet *body = rigid_body_owner.getornull(p_body);
 	ERR_FAIL_COND_V(!body, 0);
@@ -1200,25 +1222,44 @@ bool BulletPhysicsServer3D::joint_is_disabled_collisions_between_bodies(RID p_jo
 	return joint->is_disabled_collisions_between_bodies();
 }
 
-RID BulletPhysicsServer3D::joint_create_pin(RID p_body_A, const Vector3 &p_local_A, RID p_body_B, const Vector3 &p_local_B) {
+RID BulletPhysicsServer3D::joint_create() {
+	JointBullet *joint = bulletnew(JointBullet);
+	CreateThenReturnRID(joint_owner, joint);
+}
+
+void BulletPhysicsServer3D::_joint_replace(JointBullet *p_prev_joint, JointBullet *p_joint) {
+	// Keep the RID and whatever was set on the joint before it was made.
+	p_joint->set_self(p_prev_joint->get_self());
+	p_joint->_set_physics_server(this);
+	p_joint->disable_collisions_between_bodies(p_prev_joint->is_disabled_collisions_between_bodies());
+	joint_owner.replace(p_joint->get_self(), p_joint);
+
+	p_prev_joint->destroy_internal_constraint();
+	bulletdelete(p_prev_joint);
+}
+
+bool BulletPhysicsServer3D::joint_make_pin(RID p_joint, RID p_body_A, const Vector3 &p_local_A, RID p_body_B, const Vector3 &p_local_B) {
+	JointBullet *prev_joint = joint_owner.getornull(p_joint);
+	ERR_FAIL_COND_V(!prev_joint, false);
+
 	RigidBodyBullet *body_A = rigid_body_owner.getornull(p_body_A);
-	ERR_FAIL_COND_V(!body_A, RID());
+	ERR_FAIL_COND_V(!body_A, false);
 
-	JointAssertSpace(body_A, "A", RID());
+	JointAssertSpace(body_A, "A", false);
 
 	RigidBodyBullet *body_B = nullptr;
 	if (p_body_B.is_valid()) {
 		body_B = rigid_body_owner.getornull(p_body_B);
-		JointAssertSpace(body_B, "B", RID());
-		JointAssertSameSpace(body_A, body_B, RID());
+		JointAssertSpace(body_B, "B", false);
+		JointAssertSameSpace(body_A, body_B, false);
 	}
 
-	ERR_FAIL_COND_V(body_A == body_B, RID());
+	ERR_FAIL_COND_V(body_A == body_B, false);
 
 	JointBullet *joint = bulletnew(PinJointBullet(body_A, p_local_A, body_B, p_local_B));
+	_joint_replace(prev_joint, joint);
 	AddJointToSpace(body_A, joint);
-
-	CreateThenReturnRID(joint_owner, joint);
+	return true;
 }
 
 void BulletPhysicsServer3D::pin_joint_set_param(RID p_joint, PinJointParam p_param, float p_value) {
@@ -1269,44 +1310,50 @@ Vector3 BulletPhysicsServer3D::pin_joint_get_local_b(RID p_joint) const {
 	return pin_joint->getPivotInB();
 }
 
-RID BulletPhysicsServer3D::joint_create_hinge(RID p_body_A, const Transform &p_hinge_A, RID p_body_B, const Transform &p_hinge_B) {
+bool BulletPhysicsServer3D::joint_make_hinge(RID p_joint, RID p_body_A, const Transform &p_hinge_A, RID p_body_B, const Transform &p_hinge_B) {
+	JointBullet *prev_joint = joint_owner.getornull(p_joint);
+	ERR_FAIL_COND_V(!prev_joint, false);
+
 	RigidBodyBullet *body_A = rigid_body_owner.getornull(p_body_A);
-	ERR_FAIL_COND_V(!body_A, RID());
-	JointAssertSpace(body_A, "A", RID());
+	ERR_FAIL_COND_V(!body_A, false);
+	JointAssertSpace(body_A, "A", false);
 
 	RigidBodyBullet *body_B = nullptr;
 	if (p_body_B.is_valid()) {
 		body_B = rigid_body_owner.getornull(p_body_B);
-		JointAssertSpace(body_B, "B", RID());
-		JointAssertSameSpace(body_A, body_B, RID());
+		JointAssertSpace(body_B, "B", false);
+		JointAssertSameSpace(body_A, body_B, false);
 	}
 
-	ERR_FAIL_COND_V(body_A == body_B, RID());
+	ERR_FAIL_COND_V(body_A == body_B, false);
 
 	JointBullet *joint = bulletnew(HingeJointBullet(body_A, body_B, p_hinge_A, p_hinge_B));
+	_joint_replace(prev_joint, joint);
 	AddJointToSpace(body_A, joint);
-
-	CreateThenReturnRID(joint_owner, joint);
+	return true;
 }
 
-RID BulletPhysicsServer3D::joint_create_hinge_simple(RID p_body_A, const Vector3 &p_pivot_A, const Vector3 &p_axis_A, RID p_body_B, const Vector3 &p_pivot_B, const Vector3 &p_axis_B) {
+bool BulletPhysicsServer3D::joint_make_hinge_simple(RID p_joint, RID p_body_A, const Vector3 &p_pivot_A, const Vector3 &p_axis_A, RID p_body_B, const Vector3 &p_pivot_B, const Vector3 &p_axis_B) {
+	JointBullet *prev_joint = joint_owner.getornull(p_joint);
+	ERR_FAIL_COND_V(!prev_joint, false);
+
 	RigidBodyBullet *body_A = rigid_body_owner.getornull(p_body_A);
-	ERR_FAIL_COND_V(!body_A, RID());
-	JointAssertSpace(body_A, "A", RID());
+	ERR_FAIL_COND_V(!body_A, false);
+	JointAssertSpace(body_A, "A", false);
 
 	RigidBodyBullet *body_B = nullptr;
 	if (p_body_B.is_valid()) {
 		body_B = rigid_body_owner.getornull(p_body_B);
-		JointAssertSpace(body_B, "B", RID());
-		JointAssertSameSpace(body_A, body_B, RID());
+		JointAssertSpace(body_B, "B", false);
+		JointAssertSameSpace(body_A, body_B, false);
 	}
 
-	ERR_FAIL_COND_V(body_A == body_B, RID());
+	ERR_FAIL_COND_V(body_A == body_B, false);
 
 	JointBullet *joint = bulletnew(HingeJointBullet(body_A, body_B, p_pivot_A, p_pivot_B, p_axis_A, p_axis_B));
+	_joint_replace(prev_joint, joint);
 	AddJointToSpace(body_A, joint);
-
-	CreateThenReturnRID(joint_owner, joint);
+	return true;
 }
 
 void BulletPhysicsServer3D::hinge_joint_set_param(RID p_joint, HingeJointParam p_param, float p_value) {
@@ -1341,24 +1388,27 @@ bool BulletPhysicsServer3D::hinge_joint_get_flag(RID p_joint, HingeJointFlag p_f
 	return hinge_joint->get_flag(p_flag);
 }
 
-RID BulletPhysicsServer3D::joint_create_slider(RID p_body_A, const Transform &p_local_frame_A, RID p_body_B, const Transform &p_local_frame_B) {
+bool BulletPhysicsServer3D::joint_make_slider(RID p_joint, RID p_body_A, const Transform &p_local_frame_A, RID p_body_B, const Transform &p_local_frame_B) {
+	JointBullet *prev_joint = joint_owner.getornull(p_joint);
+	ERR_FAIL_COND_V(!prev_joint, false);
+
 	RigidBodyBullet *body_A = rigid_body_owner.getornull(p_body_A);
-	ERR_FAIL_COND_V(!body_A, RID());
-	JointAssertSpace(body_A, "A", RID());
+	ERR_FAIL_COND_V(!body_A, false);
+	JointAssertSpace(body_A, "A", false);
 
 	RigidBodyBullet *body_B = nullptr;
 	if (p_body_B.is_valid()) {
 		body_B = rigid_body_owner.getornull(p_body_B);
-		JointAssertSpace(body_B, "B", RID());
-		JointAssertSameSpace(body_A, body_B, RID());
+		JointAssertSpace(body_B, "B", false);
+		JointAssertSameSpace(body_A, body_B, false);
 	}
 
-	ERR_FAIL_COND_V(body_A == body_B, RID());
+	ERR_FAIL_COND_V(body_A == body_B, false);
 
 	JointBullet *joint = bulletnew(SliderJointBullet(body_A, body_B, p_local_frame_A, p_local_frame_B));
+	_joint_replace(prev_joint, joint);
 	AddJointToSpace(body_A, joint);
-
-	CreateThenReturnRID(joint_owner, joint);
+	return true;
 }
 
 void BulletPhysicsServer3D::slider_joint_set_param(RID p_joint, SliderJointParam p_param, float p_value) {
@@ -1377,22 +1427,25 @@ float BulletPhysicsServer3D::slider_joint_get_param(RID p_joint, SliderJointPara
 	return slider_joint->get_param(p_param);
 }
 
-RID BulletPhysicsServer3D::joint_create_cone_twist(RID p_body_A, const Transform &p_local_frame_A, RID p_body_B, const Transform &p_local_frame_B) {
+bool BulletPhysicsServer3D::joint_make_cone_twist(RID p_joint, RID p_body_A, const Transform &p_local_frame_A, RID p_body_B, const Transform &p_local_frame_B) {
+	JointBullet *prev_joint = joint_owner.getornull(p_joint);
+	ERR_FAIL_COND_V(!prev_joint, false);
+
 	RigidBodyBullet *body_A = rigid_body_owner.getornull(p_body_A);
-	ERR_FAIL_COND_V(!body_A, RID());
-	JointAssertSpace(body_A, "A", RID());
+	ERR_FAIL_COND_V(!body_A, false);
+	JointAssertSpace(body_A, "A", false);
 
 	RigidBodyBullet *body_B = nullptr;
 	if (p_body_B.is_valid()) {
 		body_B = rigid_body_owner.getornull(p_body_B);
-		JointAssertSpace(body_B, "B", RID());
-		JointAssertSameSpace(body_A, body_B, RID());
+		JointAssertSpace(body_B, "B", false);
+		JointAssertSameSpace(body_A, body_B, false);
 	}
 
 	JointBullet *joint = bulletnew(ConeTwistJointBullet(body_A, body_B, p_local_frame_A, p_local_frame_B));
+	_joint_replace(prev_joint, joint);
 	AddJointToSpace(body_A, joint);
-
-	CreateThenReturnRID(joint_owner, joint);
+	return true;
 }
 
 void BulletPhysicsServer3D::cone_twist_joint_set_param(RID p_joint, ConeTwistJointParam p_param, float p_value) {
@@ -1411,24 +1464,27 @@ float BulletPhysicsServer3D::cone_twist_joint_get_param(RID p_joint, ConeTwistJo
 	return coneTwist_joint->get_param(p_param);
 }
 
-RID BulletPhysicsServer3D::joint_create_generic_6dof(RID p_body_A, const Transform &p_local_frame_A, RID p_body_B, const Transform &p_local_frame_B) {
+bool BulletPhysicsServer3D::joint_make_generic_6dof(RID p_joint, RID p_body_A, const Transform &p_local_frame_A, RID p_body_B, const Transform &p_local_frame_B) {
+	JointBullet *prev_joint = joint_owner.getornull(p_joint);
+	ERR_FAIL_COND_V(!prev_joint, false);
+
 	RigidBodyBullet *body_A = rigid_body_owner.getornull(p_body_A);
-	ERR_FAIL_COND_V(!body_A, RID());
-	JointAssertSpace(body_A, "A", RID());
+	ERR_FAIL_COND_V(!body_A, false);
+	JointAssertSpace(body_A, "A", false);
 
 	RigidBodyBullet *body_B = nullptr;
 	if (p_body_B.is_valid()) {
 		body_B = rigid_body_owner.getornull(p_body_B);
-		JointAssertSpace(body_B, "B", RID());
-		JointAssertSameSpace(body_A, body_B, RID());
+		JointAssertSpace(body_B, "B", false);
+		JointAssertSameSpace(body_A, body_B, false);
 	}
 
-	ERR_FAIL_COND_V(body_A == body_B, RID());
+	ERR_FAIL_COND_V(body_A == body_B, false);
 
 	JointBullet *joint = bulletnew(Generic6DOFJointBullet(body_A, body_B, p_local_frame_A, p_local_frame_B));
+	_joint_replace(prev_joint, joint);
 	AddJointToSpace(body_A, joint);
-
-	CreateThenReturnRID(joint_owner, joint);
+	return true;
 }
 
 void BulletPhysicsServer3D::generic_6dof_joint_set_param(RID p_joint, Vector3::Axis p_axis, G6DOFJointAxisParam p_param, float p_value) {
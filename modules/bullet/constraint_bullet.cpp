@@ -49,7 +49,9 @@ void ConstraintBullet::set_space(SpaceBullet *p_space) {
 }
 
 void ConstraintBullet::destroy_internal_constraint() {
-	space->remove_constraint(this);
+	if (space) {
+		space->remove_constraint(this);
+	}
 }
 
 void ConstraintBullet::disable_collisions_between_bodies(const bool p_disabled) {
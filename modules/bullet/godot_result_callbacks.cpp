@@ -75,7 +75,7 @@ bool GodotClosestRayResultCallback::needsCollision(btBroadphaseProxy *proxy0) co
 			return false;
 		}
 
-		if (m_exclude->has(gObj->get_self())) {
+		if (m_exclude->is_excluded(gObj->get_self(), gObj->get_instance_id())) {
 			return false;
 		}
 
@@ -94,7 +94,7 @@ bool GodotAllConvexResultCallback::needsCollision(btBroadphaseProxy *proxy0) con
 	if (needs) {
 		btCollisionObject *btObj = static_cast<btCollisionObject *>(proxy0->m_clientObject);
 		CollisionObjectBullet *gObj = static_cast<CollisionObjectBullet *>(btObj->getUserPointer());
-		if (m_exclude->has(gObj->get_self())) {
+		if (m_exclude->is_excluded(gObj->get_self(), gObj->get_instance_id())) {
 			return false;
 		}
 
@@ -165,7 +165,7 @@ bool GodotClosestConvexResultCallback::needsCollision(btBroadphaseProxy *proxy0)
 			}
 		}
 
-		if (m_exclude->has(gObj->get_self())) {
+		if (m_exclude->is_excluded(gObj->get_self(), gObj->get_instance_id())) {
 			return false;
 		}
 		return true;
@@ -203,7 +203,7 @@ bool GodotAllContactResultCallback::needsCollision(btBroadphaseProxy *proxy0) co
 			}
 		}
 
-		if (m_exclude->has(gObj->get_self())) {
+		if (m_exclude->is_excluded(gObj->get_self(), gObj->get_instance_id())) {
 			return false;
 		}
 		return true;
@@ -259,7 +259,7 @@ bool GodotContactPairContactResultCallback::needsCollision(btBroadphaseProxy *pr
 			}
 		}
 
-		if (m_exclude->has(gObj->get_self())) {
+		if (m_exclude->is_excluded(gObj->get_self(), gObj->get_instance_id())) {
 			return false;
 		}
 		return true;
@@ -302,7 +302,7 @@ bool GodotRestInfoContactResultCallback::needsCollision(btBroadphaseProxy *proxy
 			}
 		}
 
-		if (m_exclude->has(gObj->get_self())) {
+		if (m_exclude->is_excluded(gObj->get_self(), gObj->get_instance_id())) {
 			return false;
 		}
 		return true;
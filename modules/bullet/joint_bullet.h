@@ -41,11 +41,12 @@
 class RigidBodyBullet;
 class btTypedConstraint;
 
+// Also used as is for joints created empty, which have no constraint.
 class JointBullet : public ConstraintBullet {
 public:
 	JointBullet();
 	virtual ~JointBullet();
 
-	virtual PhysicsServer3D::JointType get_type() const = 0;
+	virtual PhysicsServer3D::JointType get_type() const { return PhysicsServer3D::JOINT_TYPE_MAX; }
 };
 #endif
@@ -33,6 +33,7 @@
 #include "bullet_physics_server.h"
 #include "core/class_db.h"
 #include "core/project_settings.h"
+#include "servers/physics_3d/physics_server_3d_wrap_mt.h"
 
 /**
 	@author AndreaCatania
@@ -40,7 +41,7 @@
 
 #ifndef _3D_DISABLED
 PhysicsServer3D *_createBulletPhysicsCallback() {
-	return memnew(BulletPhysicsServer3D);
+	return PhysicsServer3DWrapMT::init_server<BulletPhysicsServer3D>();
 }
 #endif
 
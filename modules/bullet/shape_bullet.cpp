@@ -408,7 +408,14 @@ ConcavePolygonShapeBullet::~ConcavePolygonShapeBullet() {
 }
 
 void ConcavePolygonShapeBullet::set_data(const Variant &p_data) {
-	setup(p_data);
+	if (p_data.get_type() == Variant::DICTIONARY) {
+		// the "bvh" cache of the built-in physics is not usable here
+		Dictionary d = p_data;
+		ERR_FAIL_COND(!d.has("faces"));
+		setup(d["faces"]);
+	} else {
+		setup(p_data);
+	}
 }
 
 Variant ConcavePolygonShapeBullet::get_data() const {
@@ -185,7 +185,7 @@ void AudioStreamPlayer2D::_notification(int p_what) {
 
 			PhysicsDirectSpaceState2D::ShapeResult sr[MAX_INTERSECT_AREAS];
 
-			int areas = space_state->intersect_point(global_pos, sr, MAX_INTERSECT_AREAS, Set<RID>(), area_mask, false, true);
+			int areas = space_state->intersect_point(global_pos, sr, MAX_INTERSECT_AREAS, PhysicsQueryFilter(), area_mask, false, true);
 
 			for (int i = 0; i < areas; i++) {
 				Area2D *area2d = Object::cast_to<Area2D>(sr[i].collider);
@@ -32,6 +32,7 @@
 #define RAY_CAST_2D_H
 
 #include "scene/2d/node_2d.h"
+#include "servers/physics_query_filter.h"
 
 class RayCast2D : public Node2D {
 	GDCLASS(RayCast2D, Node2D);
@@ -42,7 +43,7 @@ class RayCast2D : public Node2D {
 	int against_shape;
 	Vector2 collision_point;
 	Vector2 collision_normal;
-	Set<RID> exclude;
+	PhysicsQueryFilter exclude;
 	uint32_t collision_mask;
 	bool exclude_parent_body;
 
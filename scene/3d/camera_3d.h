@@ -36,6 +36,7 @@
 #include "scene/main/window.h"
 #include "scene/resources/camera_effects.h"
 #include "scene/resources/environment.h"
+#include "servers/physics_query_filter.h"
 
 class Camera3D : public Node3D {
 	GDCLASS(Camera3D, Node3D);
@@ -201,7 +202,7 @@ private:
 	bool clip_to_areas;
 	bool clip_to_bodies;
 
-	Set<RID> exclude;
+	PhysicsQueryFilter exclude;
 
 	Vector<Vector3> points;
 
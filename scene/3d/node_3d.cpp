@@ -80,7 +80,7 @@ void Node3D::_notify_dirty() {
 	if (data.notify_transform && !data.ignore_notification && !xform_change.in_list()) {
 
 #endif
-		get_tree()->xform_change_list.add(&xform_change);
+		get_tree()->_xform_change_add(&xform_change);
 	}
 }
 
@@ -95,10 +95,17 @@ void Node3D::_propagate_transform_changed(Node3D *p_origin) {
 		return;
 	}
 
-	/*
-	if (data.dirty&DIRTY_GLOBAL)
-		return; //already dirty
-	*/
+	/* A node whose global transform is already dirty has its whole subtree dirty
+	 * too (resolving a transform resolves all its parents first), and every node
+	 * below it that wants a notification is already queued: delivering the
+	 * notification resolves the transform (see NOTIFICATION_TRANSFORM_CHANGED),
+	 * as does enabling notifications. So nothing is left to do below it, and
+	 * setting several properties on animated hierarchies no longer walks the
+	 * same subtrees over and over.
+	 */
+	if (data.dirty & DIRTY_GLOBAL) {
+		return;
+	}
 
 	data.children_lock++;
 
@@ -113,7 +120,7 @@ void Node3D::_propagate_transform_changed(Node3D *p_origin) {
 #else
 	if (data.notify_transform && !data.ignore_notification && !xform_change.in_list()) {
 #endif
-		get_tree()->xform_change_list.add(&xform_change);
+		get_tree()->_xform_change_add(&xform_change);
 	}
 	data.dirty |= DIRTY_GLOBAL;
 
@@ -153,7 +160,7 @@ void Node3D::_notification(int p_what) {
 		case NOTIFICATION_EXIT_TREE: {
 			notification(NOTIFICATION_EXIT_WORLD, true);
 			if (xform_change.in_list()) {
-				get_tree()->xform_change_list.remove(&xform_change);
+				get_tree()->_xform_change_remove(&xform_change);
 			}
 			if (data.C) {
 				data.parent->data.children.erase(data.C);
@@ -211,6 +218,8 @@ void Node3D::_notification(int p_what) {
 		} break;
 
 		case NOTIFICATION_TRANSFORM_CHANGED: {
+			// Keep the propagation shortcut valid, a dirty node must never be waiting for a notification.
+			get_global_transform();
 #ifdef TOOLS_ENABLED
 			if (data.gizmo.is_valid()) {
 				data.gizmo->transform();
@@ -253,25 +262,49 @@ Transform Node3D::get_transform() const {
 	return data.local_transform;
 }
 
-Transform Node3D::get_global_transform() const {
-	ERR_FAIL_COND_V(!is_inside_tree(), Transform());
+void Node3D::_update_global_transform() const {
+	// Resolve the dirty ancestors top-down in a loop rather than recursing
+	// through get_global_transform(), deep hierarchies only cost one walk up.
+	const int max_chain = 32;
+	const Node3D *chain[max_chain];
+	int count = 0;
 
-	if (data.dirty & DIRTY_GLOBAL) {
-		if (data.dirty & DIRTY_LOCAL) {
-			_update_local_transform();
+	const Node3D *n = this;
+	while (true) {
+		chain[count++] = n;
+		if (count == max_chain || !n->data.parent || n->data.toplevel_active || !(n->data.parent->data.dirty & DIRTY_GLOBAL)) {
+			break;
+		}
+		n = n->data.parent;
+	}
+
+	for (int i = count - 1; i >= 0; i--) {
+		const Node3D *node = chain[i];
+
+		if (node->data.dirty & DIRTY_LOCAL) {
+			node->_update_local_transform();
 		}
 
-		if (data.parent && !data.toplevel_active) {
-			data.global_transform = data.parent->get_global_transform() * data.local_transform;
+		if (node->data.parent && !node->data.toplevel_active) {
+			// Only the top of a chain longer than max_chain can still have a dirty parent.
+			node->data.global_transform = node->data.parent->get_global_transform() * node->data.local_transform;
 		} else {
-			data.global_transform = data.local_transform;
+			node->data.global_transform = node->data.local_transform;
 		}
 
-		if (data.disable_scale) {
-			data.global_transform.basis.orthonormalize();
+		if (node->data.disable_scale) {
+			node->data.global_transform.basis.orthonormalize();
 		}
 
-		data.dirty &= ~DIRTY_GLOBAL;
+		node->data.dirty &= ~DIRTY_GLOBAL;
+	}
+}
+
+Transform Node3D::get_global_transform() const {
+	ERR_FAIL_COND_V(!is_inside_tree(), Transform());
+
+	if (data.dirty & DIRTY_GLOBAL) {
+		_update_global_transform();
 	}
 
 	return data.global_transform;
@@ -408,6 +441,7 @@ void Node3D::set_gizmo(const Ref<Node3DGizmo> &p_gizmo) {
 	}
 	data.gizmo = p_gizmo;
 	if (data.gizmo.is_valid() && is_inside_world()) {
+		get_global_transform(); // Gizmos get transform notifications, see set_notify_transform().
 		data.gizmo->create();
 		if (is_visible_in_tree()) {
 			data.gizmo->redraw();
@@ -676,6 +710,11 @@ Vector3 Node3D::to_global(Vector3 p_local) const {
 
 void Node3D::set_notify_transform(bool p_enable) {
 	data.notify_transform = p_enable;
+
+	if (p_enable && is_inside_tree()) {
+		//this ensures that invalid globals get resolved, so notifications can be received
+		get_global_transform();
+	}
 }
 
 bool Node3D::is_transform_notification_enabled() const {
@@ -695,7 +734,7 @@ void Node3D::force_update_transform() {
 	if (!xform_change.in_list()) {
 		return; //nothing to update
 	}
-	get_tree()->xform_change_list.remove(&xform_change);
+	get_tree()->_xform_change_remove(&xform_change);
 
 	notification(NOTIFICATION_TRANSFORM_CHANGED);
 }
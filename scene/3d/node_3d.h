@@ -102,9 +102,15 @@ class Node3D : public Node {
 	void _propagate_visibility_changed();
 
 protected:
-	_FORCE_INLINE_ void set_ignore_transform_notification(bool p_ignore) { data.ignore_notification = p_ignore; }
+	_FORCE_INLINE_ void set_ignore_transform_notification(bool p_ignore) {
+		data.ignore_notification = p_ignore;
+		if (!p_ignore && (data.dirty & DIRTY_GLOBAL) && is_inside_tree()) {
+			get_global_transform(); // Changes made while ignoring were not queued, see set_notify_transform().
+		}
+	}
 
 	_FORCE_INLINE_ void _update_local_transform() const;
+	void _update_global_transform() const;
 
 	void _notification(int p_what);
 	static void _bind_methods();
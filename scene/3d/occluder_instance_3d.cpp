@@ -0,0 +1,191 @@
+/*************************************************************************/
+/*  occluder_instance_3d.cpp                                             */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "occluder_instance_3d.h"
+
+#include "core/core_string_names.h"
+
+void Occluder3D::_update() {
+	aabb = AABB();
+	for (int i = 0; i < vertices.size(); i++) {
+		if (i == 0) {
+			aabb.position = vertices[i];
+		} else {
+			aabb.expand_to(vertices[i]);
+		}
+	}
+
+	// Vertices and indices are set separately, only hand consistent meshes to the server.
+	bool valid = indices.size() % 3 == 0;
+	for (int i = 0; valid && i < indices.size(); i++) {
+		valid = indices[i] >= 0 && indices[i] < vertices.size();
+	}
+
+	if (valid) {
+		RS::get_singleton()->occluder_set_mesh(occluder, vertices, indices);
+	} else {
+		RS::get_singleton()->occluder_set_mesh(occluder, Vector<Vector3>(), Vector<int>());
+	}
+
+	emit_changed();
+}
+
+void Occluder3D::set_vertices(const Vector<Vector3> &p_vertices) {
+	vertices = p_vertices;
+	_update();
+}
+
+Vector<Vector3> Occluder3D::get_vertices() const {
+	return vertices;
+}
+
+void Occluder3D::set_indices(const Vector<int> &p_indices) {
+	indices = p_indices;
+	_update();
+}
+
+Vector<int> Occluder3D::get_indices() const {
+	return indices;
+}
+
+void Occluder3D::make_box(const Vector3 &p_extents) {
+	vertices.resize(8);
+	for (int i = 0; i < 8; i++) {
+		vertices.write[i] = Vector3(i & 1 ? p_extents.x : -p_extents.x, i & 2 ? p_extents.y : -p_extents.y, i & 4 ? p_extents.z : -p_extents.z);
+	}
+
+	static const int box_indices[36] = {
+		0, 1, 3, 0, 3, 2, // -Z
+		4, 6, 7, 4, 7, 5, // +Z
+		0, 2, 6, 0, 6, 4, // -X
+		1, 5, 7, 1, 7, 3, // +X
+		0, 4, 5, 0, 5, 1, // -Y
+		2, 3, 7, 2, 7, 6, // +Y
+	};
+	indices.resize(36);
+	for (int i = 0; i < 36; i++) {
+		indices.write[i] = box_indices[i];
+	}
+
+	_update();
+}
+
+AABB Occluder3D::get_aabb() const {
+	return aabb;
+}
+
+RID Occluder3D::get_rid() const {
+	return occluder;
+}
+
+void Occluder3D::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("set_vertices", "vertices"), &Occluder3D::set_vertices);
+	ClassDB::bind_method(D_METHOD("get_vertices"), &Occluder3D::get_vertices);
+
+	ClassDB::bind_method(D_METHOD("set_indices", "indices"), &Occluder3D::set_indices);
+	ClassDB::bind_method(D_METHOD("get_indices"), &Occluder3D::get_indices);
+
+	ClassDB::bind_method(D_METHOD("make_box", "extents"), &Occluder3D::make_box);
+
+	ADD_PROPERTY(PropertyInfo(Variant::PACKED_VECTOR3_ARRAY, "vertices"), "set_vertices", "get_vertices");
+	ADD_PROPERTY(PropertyInfo(Variant::PACKED_INT32_ARRAY, "indices"), "set_indices", "get_indices");
+}
+
+Occluder3D::Occluder3D() {
+	occluder = RS::get_singleton()->occluder_create();
+}
+
+Occluder3D::~Occluder3D() {
+	RS::get_singleton()->free(occluder);
+}
+
+/////////////////////////////
+
+void OccluderInstance3D::_occluder_changed() {
+	update_gizmo();
+}
+
+void OccluderInstance3D::set_occluder(const Ref<Occluder3D> &p_occluder) {
+	if (occluder == p_occluder) {
+		return;
+	}
+
+	if (occluder.is_valid()) {
+		occluder->disconnect(CoreStringNames::get_singleton()->changed, callable_mp(this, &OccluderInstance3D::_occluder_changed));
+	}
+
+	occluder = p_occluder;
+
+	if (occluder.is_valid()) {
+		occluder->connect(CoreStringNames::get_singleton()->changed, callable_mp(this, &OccluderInstance3D::_occluder_changed));
+		set_base(occluder->get_rid());
+	} else {
+		set_base(RID());
+	}
+
+	update_gizmo();
+	update_configuration_warning();
+}
+
+Ref<Occluder3D> OccluderInstance3D::get_occluder() const {
+	return occluder;
+}
+
+AABB OccluderInstance3D::get_aabb() const {
+	if (occluder.is_valid()) {
+		return occluder->get_aabb();
+	}
+	return AABB();
+}
+
+Vector<Face3> OccluderInstance3D::get_faces(uint32_t p_usage_flags) const {
+	return Vector<Face3>();
+}
+
+String OccluderInstance3D::get_configuration_warning() const {
+	String warning = VisualInstance3D::get_configuration_warning();
+	if (occluder.is_null()) {
+		if (warning != String()) {
+			warning += "\n\n";
+		}
+		warning += TTR("An Occluder3D resource must be set for this node to hide anything behind it.");
+	}
+	return warning;
+}
+
+void OccluderInstance3D::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("set_occluder", "occluder"), &OccluderInstance3D::set_occluder);
+	ClassDB::bind_method(D_METHOD("get_occluder"), &OccluderInstance3D::get_occluder);
+
+	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "occluder", PROPERTY_HINT_RESOURCE_TYPE, "Occluder3D"), "set_occluder", "get_occluder");
+}
+
+OccluderInstance3D::OccluderInstance3D() {
+}
@@ -32,6 +32,7 @@
 #define RAY_CAST_3D_H
 
 #include "scene/3d/node_3d.h"
+#include "servers/physics_query_filter.h"
 
 class RayCast3D : public Node3D {
 	GDCLASS(RayCast3D, Node3D);
@@ -44,7 +45,7 @@ class RayCast3D : public Node3D {
 	Vector3 collision_normal;
 
 	Vector3 cast_to;
-	Set<RID> exclude;
+	PhysicsQueryFilter exclude;
 
 	uint32_t collision_mask;
 	bool exclude_parent_body;
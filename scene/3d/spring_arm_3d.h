@@ -32,12 +32,13 @@
 #define SPRING_ARM_H
 
 #include "scene/3d/node_3d.h"
+#include "servers/physics_query_filter.h"
 
 class SpringArm3D : public Node3D {
 	GDCLASS(SpringArm3D, Node3D);
 
 	Ref<Shape3D> shape;
-	Set<RID> excluded_objects;
+	PhysicsQueryFilter excluded_objects;
 	float spring_length = 1;
 	float current_spring_length = 0;
 	bool keep_child_basis = false;
@@ -160,7 +160,7 @@ class VehicleBody3D : public RigidBody3D {
 	real_t m_steeringValue;
 	real_t m_currentVehicleSpeedKmHour;
 
-	Set<RID> exclude;
+	PhysicsQueryFilter exclude;
 
 	Vector<Vector3> m_forwardWS;
 	Vector<Vector3> m_axle;
@@ -48,7 +48,20 @@
 
 VARIANT_ENUM_CAST(Node::PauseMode);
 
-int Node::orphan_node_count = 0;
+#ifdef DEBUG_ENABLED
+// The tree is not locked while process thread groups run, catch structural changes coming from them.
+#define ERR_FAIL_PROCESSING_THREAD_GROUPS(m_method) \
+	ERR_FAIL_COND_MSG(data.tree && data.tree->is_processing_thread_groups(), "Can't call " m_method "() on a node inside the tree from a process thread group. Consider using call_deferred(\"" m_method "\") instead.")
+// Detached subtrees (e.g. scenes instanced on a worker thread) can be built anywhere, but
+// only the main thread may change the structure of the tree itself.
+#define ERR_FAIL_OUTSIDE_MAIN_THREAD(m_method) \
+	ERR_FAIL_COND_MSG(data.inside_tree && Thread::get_caller_id() != Thread::get_main_id(), "Can't call " m_method "() on a node inside the tree from a thread other than the main one. Consider using call_deferred(\"" m_method "\") instead.")
+#else
+#define ERR_FAIL_PROCESSING_THREAD_GROUPS(m_method)
+#define ERR_FAIL_OUTSIDE_MAIN_THREAD(m_method)
+#endif
+
+uint32_t Node::orphan_node_count = 0;
 
 void Node::_notification(int p_notification) {
 	switch (p_notification) {
@@ -90,7 +103,7 @@ void Node::_notification(int p_notification) {
 			}
 
 			get_tree()->node_count++;
-			orphan_node_count--;
+			atomic_decrement(&orphan_node_count);
 
 		} break;
 		case NOTIFICATION_EXIT_TREE: {
@@ -98,7 +111,7 @@ void Node::_notification(int p_notification) {
 			ERR_FAIL_COND(!get_tree());
 
 			get_tree()->node_count--;
-			orphan_node_count++;
+			atomic_increment(&orphan_node_count);
 
 			if (data.input) {
 				remove_from_group("_vp_input" + itos(get_viewport()->get_instance_id()));
@@ -295,6 +308,8 @@ void Node::move_child(Node *p_child, int p_pos) {
 	ERR_FAIL_INDEX_MSG(p_pos, data.children.size() + 1, "Invalid new child position: " + itos(p_pos) + ".");
 	ERR_FAIL_COND_MSG(p_child->data.parent != this, "Child is not a child of this node.");
 	ERR_FAIL_COND_MSG(data.blocked > 0, "Parent node is busy setting up children, move_child() failed. Consider using call_deferred(\"move_child\") instead (or \"popup\" if this is from a popup).");
+	ERR_FAIL_PROCESSING_THREAD_GROUPS("move_child");
+	ERR_FAIL_OUTSIDE_MAIN_THREAD("move_child");
 
 	// Specifying one place beyond the end
 	// means the same as moving to the last position
@@ -356,6 +371,7 @@ void Node::move_child_notify(Node *p_child) {
 }
 
 void Node::set_physics_process(bool p_process) {
+	ERR_FAIL_PROCESSING_THREAD_GROUPS("set_physics_process");
 	if (data.physics_process == p_process) {
 		return;
 	}
@@ -376,6 +392,7 @@ bool Node::is_physics_processing() const {
 }
 
 void Node::set_physics_process_internal(bool p_process_internal) {
+	ERR_FAIL_PROCESSING_THREAD_GROUPS("set_physics_process_internal");
 	if (data.physics_process_internal == p_process_internal) {
 		return;
 	}
@@ -405,6 +422,7 @@ void Node::set_pause_mode(PauseMode p_mode) {
 	if (!is_inside_tree()) {
 		return; //pointless
 	}
+	data.tree->_invalidate_process_lists();
 	if ((data.pause_mode == PAUSE_MODE_INHERIT) == prev_inherits) {
 		return; ///nothing changed
 	}
@@ -852,6 +870,7 @@ float Node::get_process_delta_time() const {
 }
 
 void Node::set_process(bool p_idle_process) {
+	ERR_FAIL_PROCESSING_THREAD_GROUPS("set_process");
 	if (data.idle_process == p_idle_process) {
 		return;
 	}
@@ -872,6 +891,7 @@ bool Node::is_processing() const {
 }
 
 void Node::set_process_internal(bool p_idle_process_internal) {
+	ERR_FAIL_PROCESSING_THREAD_GROUPS("set_process_internal");
 	if (data.idle_process_internal == p_idle_process_internal) {
 		return;
 	}
@@ -892,6 +912,7 @@ bool Node::is_processing_internal() const {
 }
 
 void Node::set_process_priority(int p_priority) {
+	ERR_FAIL_PROCESSING_THREAD_GROUPS("set_process_priority");
 	data.process_priority = p_priority;
 
 	// Make sure we are in SceneTree.
@@ -920,6 +941,22 @@ int Node::get_process_priority() const {
 	return data.process_priority;
 }
 
+void Node::set_process_thread_group(int p_group) {
+	ERR_FAIL_COND_MSG(p_group < 0, "Process thread group must be 0 (main thread) or positive.");
+	ERR_FAIL_PROCESSING_THREAD_GROUPS("set_process_thread_group");
+	if (data.process_thread_group == p_group) {
+		return;
+	}
+	data.process_thread_group = p_group;
+	if (data.tree) {
+		data.tree->_invalidate_process_lists();
+	}
+}
+
+int Node::get_process_thread_group() const {
+	return data.process_thread_group;
+}
+
 void Node::set_process_input(bool p_enable) {
 	if (p_enable == data.input) {
 		return;
@@ -1003,6 +1040,7 @@ bool Node::_validate_node_name(String &p_name) {
 }
 
 void Node::set_name(const String &p_name) {
+	ERR_FAIL_PROCESSING_THREAD_GROUPS("set_name");
 	String name = p_name;
 	_validate_node_name(name);
 
@@ -1225,6 +1263,8 @@ void Node::add_child(Node *p_child, bool p_legible_unique_name) {
 	ERR_FAIL_COND_MSG(p_child == this, "Can't add child '" + p_child->get_name() + "' to itself."); // adding to itself!
 	ERR_FAIL_COND_MSG(p_child->data.parent, "Can't add child '" + p_child->get_name() + "' to '" + get_name() + "', already has a parent '" + p_child->data.parent->get_name() + "'."); //Fail if node has a parent
 	ERR_FAIL_COND_MSG(data.blocked > 0, "Parent node is busy setting up children, add_node() failed. Consider using call_deferred(\"add_child\", child) instead.");
+	ERR_FAIL_PROCESSING_THREAD_GROUPS("add_child");
+	ERR_FAIL_OUTSIDE_MAIN_THREAD("add_child");
 
 	/* Validate name */
 	_validate_child_name(p_child, p_legible_unique_name);
@@ -1269,6 +1309,8 @@ void Node::_propagate_validate_owner() {
 void Node::remove_child(Node *p_child) {
 	ERR_FAIL_NULL(p_child);
 	ERR_FAIL_COND_MSG(data.blocked > 0, "Parent node is busy setting up children, remove_node() failed. Consider using call_deferred(\"remove_child\", child) instead.");
+	ERR_FAIL_PROCESSING_THREAD_GROUPS("remove_child");
+	ERR_FAIL_OUTSIDE_MAIN_THREAD("remove_child");
 
 	int child_count = data.children.size();
 	Node **children = data.children.ptrw();
@@ -1695,6 +1737,7 @@ bool Node::is_in_group(const StringName &p_identifier) const {
 
 void Node::add_to_group(const StringName &p_identifier, bool p_persistent) {
 	ERR_FAIL_COND(!p_identifier.operator String().length());
+	ERR_FAIL_PROCESSING_THREAD_GROUPS("add_to_group");
 
 	if (data.grouped.has(p_identifier)) {
 		return;
@@ -1715,6 +1758,7 @@ void Node::add_to_group(const StringName &p_identifier, bool p_persistent) {
 
 void Node::remove_from_group(const StringName &p_identifier) {
 	ERR_FAIL_COND(!data.grouped.has(p_identifier));
+	ERR_FAIL_PROCESSING_THREAD_GROUPS("remove_from_group");
 
 	Map<StringName, GroupData>::Element *E = data.grouped.find(p_identifier);
 
@@ -2757,6 +2801,8 @@ void Node::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_process", "enable"), &Node::set_process);
 	ClassDB::bind_method(D_METHOD("set_process_priority", "priority"), &Node::set_process_priority);
 	ClassDB::bind_method(D_METHOD("get_process_priority"), &Node::get_process_priority);
+	ClassDB::bind_method(D_METHOD("set_process_thread_group", "group"), &Node::set_process_thread_group);
+	ClassDB::bind_method(D_METHOD("get_process_thread_group"), &Node::get_process_thread_group);
 	ClassDB::bind_method(D_METHOD("is_processing"), &Node::is_processing);
 	ClassDB::bind_method(D_METHOD("set_process_input", "enable"), &Node::set_process_input);
 	ClassDB::bind_method(D_METHOD("is_processing_input"), &Node::is_processing_input);
@@ -2895,6 +2941,7 @@ void Node::_bind_methods() {
 	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "multiplayer", PROPERTY_HINT_RESOURCE_TYPE, "MultiplayerAPI", 0), "", "get_multiplayer");
 	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "custom_multiplayer", PROPERTY_HINT_RESOURCE_TYPE, "MultiplayerAPI", 0), "set_custom_multiplayer", "get_custom_multiplayer");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "process_priority"), "set_process_priority", "get_process_priority");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "process_thread_group", PROPERTY_HINT_RANGE, "0,64,1,or_greater"), "set_process_thread_group", "get_process_thread_group");
 
 	BIND_VMETHOD(MethodInfo("_process", PropertyInfo(Variant::FLOAT, "delta")));
 	BIND_VMETHOD(MethodInfo("_physics_process", PropertyInfo(Variant::FLOAT, "delta")));
@@ -2930,6 +2977,7 @@ Node::Node() {
 	data.physics_process = false;
 	data.idle_process = false;
 	data.process_priority = 0;
+	data.process_thread_group = 0;
 	data.physics_process_internal = false;
 	data.idle_process_internal = false;
 	data.inside_tree = false;
@@ -2951,7 +2999,7 @@ Node::Node() {
 	data.display_folded = false;
 	data.ready_first = true;
 
-	orphan_node_count++;
+	atomic_increment(&orphan_node_count);
 }
 
 Node::~Node() {
@@ -2962,7 +3010,7 @@ Node::~Node() {
 	ERR_FAIL_COND(data.parent);
 	ERR_FAIL_COND(data.children.size());
 
-	orphan_node_count--;
+	atomic_decrement(&orphan_node_count);
 }
 
 ////////////////////////////////
@@ -73,7 +73,7 @@ public:
 		bool operator()(const Node *p_a, const Node *p_b) const { return p_b->data.process_priority == p_a->data.process_priority ? p_b->is_greater_than(p_a) : p_b->data.process_priority > p_a->data.process_priority; }
 	};
 
-	static int orphan_node_count;
+	static uint32_t orphan_node_count;
 
 private:
 	struct GroupData {
@@ -127,6 +127,7 @@ private:
 		bool physics_process;
 		bool idle_process;
 		int process_priority;
+		int process_thread_group; // 0 processes on the main thread
 
 		bool physics_process_internal;
 		bool idle_process_internal;
@@ -357,6 +358,9 @@ public:
 	void set_process_priority(int p_priority);
 	int get_process_priority() const;
 
+	void set_process_thread_group(int p_group);
+	int get_process_thread_group() const;
+
 	void set_process_input(bool p_enable);
 	bool is_processing_input() const;
 
@@ -0,0 +1,370 @@
+/*************************************************************************/
+/*  scene_pool.cpp                                                       */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "scene_pool.h"
+
+#include "core/core_string_names.h"
+#include "core/message_queue.h"
+
+uint32_t ScenePool::hit_count = 0;
+uint32_t ScenePool::miss_count = 0;
+
+void ScenePool::_capture_state(Node *p_node, Vector<NodeState> &r_states) {
+	NodeState state;
+	state.node = p_node->get_instance_id();
+
+	List<PropertyInfo> plist;
+	p_node->get_property_list(&plist);
+	for (List<PropertyInfo>::Element *E = plist.front(); E; E = E->next()) {
+		if (!(E->get().usage & PROPERTY_USAGE_STORAGE) || E->get().name == CoreStringNames::get_singleton()->_script) {
+			continue;
+		}
+		state.properties.push_back(Pair<StringName, Variant>(E->get().name, p_node->get(E->get().name)));
+	}
+
+	if (p_node->get_script_instance()) {
+		p_node->get_script_instance()->get_property_state(state.script_state);
+	}
+	p_node->get_all_signal_connections(&state.connections);
+	p_node->get_groups(&state.groups);
+
+	r_states.push_back(state);
+
+	for (int i = 0; i < p_node->get_child_count(); i++) {
+		_capture_state(p_node->get_child(i), r_states);
+	}
+}
+
+int ScenePool::_count_nodes(Node *p_node) {
+	int count = 1;
+	for (int i = 0; i < p_node->get_child_count(); i++) {
+		count += _count_nodes(p_node->get_child(i));
+	}
+	return count;
+}
+
+void ScenePool::_restore_connections(Node *p_node, const NodeState &p_state) {
+	List<Connection> connections;
+	p_node->get_all_signal_connections(&connections);
+	for (List<Connection>::Element *E = connections.front(); E; E = E->next()) {
+		const Connection &c = E->get();
+		bool found = false;
+		for (const List<Connection>::Element *F = p_state.connections.front(); F; F = F->next()) {
+			if (F->get().signal == c.signal && F->get().callable == c.callable) {
+				found = true;
+				break;
+			}
+		}
+		if (!found) {
+			p_node->disconnect(c.signal.get_name(), c.callable);
+		}
+	}
+
+	// One shot connections and ones removed at runtime are made again.
+	for (const List<Connection>::Element *E = p_state.connections.front(); E; E = E->next()) {
+		const Connection &c = E->get();
+		if (c.callable.get_object() && !p_node->is_connected(c.signal.get_name(), c.callable)) {
+			p_node->connect(c.signal.get_name(), c.callable, c.binds, c.flags);
+		}
+	}
+}
+
+void ScenePool::_restore_groups(Node *p_node, const NodeState &p_state) {
+	List<Node::GroupInfo> groups;
+	p_node->get_groups(&groups);
+	for (List<Node::GroupInfo>::Element *E = groups.front(); E; E = E->next()) {
+		bool found = false;
+		for (const List<Node::GroupInfo>::Element *F = p_state.groups.front(); F; F = F->next()) {
+			if (F->get().name == E->get().name) {
+				found = true;
+				break;
+			}
+		}
+		if (!found) {
+			p_node->remove_from_group(E->get().name);
+		}
+	}
+
+	for (const List<Node::GroupInfo>::Element *E = p_state.groups.front(); E; E = E->next()) {
+		if (!p_node->is_in_group(E->get().name)) {
+			p_node->add_to_group(E->get().name, E->get().persistent);
+		}
+	}
+}
+
+bool ScenePool::_restore_state(const Vector<NodeState> &p_nodes) {
+	Node *root = Object::cast_to<Node>(ObjectDB::get_instance(p_nodes[0].node));
+	ERR_FAIL_COND_V(!root, false);
+
+	// Nodes added or removed since can't be put back, such instances are dropped.
+	if (_count_nodes(root) != p_nodes.size()) {
+		return false;
+	}
+	for (int i = 1; i < p_nodes.size(); i++) {
+		Node *node = Object::cast_to<Node>(ObjectDB::get_instance(p_nodes[i].node));
+		if (!node || !root->is_a_parent_of(node)) {
+			return false;
+		}
+	}
+
+	for (int i = 0; i < p_nodes.size(); i++) {
+		const NodeState &state = p_nodes[i];
+		Node *node = Object::cast_to<Node>(ObjectDB::get_instance(state.node));
+
+		// Only touch what changed, setters may be far from free.
+		for (int j = 0; j < state.properties.size(); j++) {
+			const Pair<StringName, Variant> &property = state.properties[j];
+			if (node->get(property.first) != property.second) {
+				node->set(property.first, property.second);
+			}
+		}
+
+		if (node->get_script_instance()) {
+			for (const List<Pair<StringName, Variant>>::Element *E = state.script_state.front(); E; E = E->next()) {
+				node->get_script_instance()->set(E->get().first, E->get().second);
+			}
+		}
+
+		_restore_connections(node, state);
+		_restore_groups(node, state);
+
+		node->request_ready();
+	}
+
+	return true;
+}
+
+Node *ScenePool::_create_instance() {
+	ERR_FAIL_COND_V_MSG(scene.is_null(), nullptr, "No scene set for this pool.");
+
+	Node *node = scene->instance();
+	ERR_FAIL_COND_V(!node, nullptr);
+
+	Instance instance;
+	_capture_state(node, instance.nodes);
+
+	MutexLock lock(mutex);
+	instances[node->get_instance_id()] = instance;
+	return node;
+}
+
+void ScenePool::_prune_freed() {
+	// Instances that were freed instead of released.
+	Vector<ObjectID> freed;
+	const ObjectID *key = nullptr;
+	while ((key = instances.next(key))) {
+		if (!ObjectDB::get_instance(*key)) {
+			freed.push_back(*key);
+		}
+	}
+	for (int i = 0; i < freed.size(); i++) {
+		instances.erase(freed[i]);
+	}
+	prune_threshold = MAX(64u, instances.size() * 2);
+}
+
+void ScenePool::set_scene(const Ref<PackedScene> &p_scene) {
+	if (scene == p_scene) {
+		return;
+	}
+	clear();
+	scene = p_scene;
+}
+
+Ref<PackedScene> ScenePool::get_scene() const {
+	return scene;
+}
+
+void ScenePool::set_max_size(int p_size) {
+	ERR_FAIL_COND(p_size < 0);
+
+	MutexLock lock(mutex);
+	max_size = p_size;
+	while (available.size() > max_size) {
+		ObjectID id = available[available.size() - 1];
+		available.resize(available.size() - 1);
+		instances.erase(id);
+		Object *node = ObjectDB::get_instance(id);
+		if (node) {
+			memdelete(node);
+		}
+	}
+}
+
+int ScenePool::get_max_size() const {
+	return max_size;
+}
+
+Node *ScenePool::acquire() {
+	{
+		MutexLock lock(mutex);
+		while (available.size()) {
+			ObjectID id = available[available.size() - 1];
+			available.resize(available.size() - 1);
+
+			Node *node = Object::cast_to<Node>(ObjectDB::get_instance(id));
+			if (!node) {
+				instances.erase(id);
+				continue;
+			}
+			instances[id].available = false;
+			atomic_increment(&hit_count);
+			return node;
+		}
+
+		if (instances.size() >= prune_threshold) {
+			_prune_freed();
+		}
+	}
+
+	atomic_increment(&miss_count);
+	return _create_instance();
+}
+
+void ScenePool::release(Node *p_node) {
+	ERR_FAIL_NULL(p_node);
+
+	ObjectID id = p_node->get_instance_id();
+	{
+		MutexLock lock(mutex);
+		Instance *instance = instances.getptr(id);
+		ERR_FAIL_COND_MSG(!instance, "Node '" + p_node->get_name() + "' was not acquired from this pool.");
+		ERR_FAIL_COND_MSG(instance->available || instance->releasing, "Node '" + p_node->get_name() + "' was already released to this pool.");
+		instance->releasing = true;
+	}
+
+	// Leaving the tree detaches the server resources (scenario, space, canvas)
+	// without freeing them. Nodes can't leave it while physics callbacks run, so
+	// wait until the end of the frame. The queued call keeps the pool alive, or
+	// the node would be left in the tree if the pool went away first.
+	if (p_node->get_parent()) {
+		MessageQueue::get_singleton()->push_callable(callable_mp(this, &ScenePool::_finish_deferred_release), id, Ref<ScenePool>(this));
+	} else {
+		_finish_release(id);
+	}
+}
+
+void ScenePool::_finish_deferred_release(ObjectID p_id, const Ref<ScenePool> &p_pool) {
+	_finish_release(p_id);
+}
+
+void ScenePool::_finish_release(ObjectID p_id) {
+	Node *node = Object::cast_to<Node>(ObjectDB::get_instance(p_id));
+	if (!node) {
+		MutexLock lock(mutex);
+		instances.erase(p_id);
+		return;
+	}
+
+	if (node->get_parent()) {
+		node->get_parent()->remove_child(node);
+		ERR_FAIL_COND(node->get_parent());
+	}
+
+	// Setters and scripts run while restoring, the pool must not be locked then.
+	Vector<NodeState> nodes;
+	bool keep = false;
+	{
+		MutexLock lock(mutex);
+		const Instance *instance = instances.getptr(p_id);
+		if (instance && instance->releasing && available.size() < max_size) {
+			nodes = instance->nodes;
+			keep = true;
+		}
+	}
+
+	keep = keep && _restore_state(nodes);
+
+	MutexLock lock(mutex);
+	Instance *instance = instances.getptr(p_id);
+	if (!keep || !instance || available.size() >= max_size) {
+		instances.erase(p_id);
+		// May well be called from the node itself. Unlike queue_delete(), this
+		// doesn't need a SceneTree, the node may never have been in one.
+		MessageQueue::get_singleton()->push_call(node, CoreStringNames::get_singleton()->_free);
+		return;
+	}
+
+	instance->releasing = false;
+	instance->available = true;
+	available.push_back(p_id);
+}
+
+void ScenePool::prefill(int p_count) {
+	ERR_FAIL_COND(scene.is_null());
+
+	int count = MIN(p_count, max_size) - get_available_count();
+	for (int i = 0; i < count; i++) {
+		Node *node = _create_instance();
+		ERR_FAIL_COND(!node);
+
+		MutexLock lock(mutex);
+		instances[node->get_instance_id()].available = true;
+		available.push_back(node->get_instance_id());
+	}
+}
+
+void ScenePool::clear() {
+	MutexLock lock(mutex);
+	for (int i = 0; i < available.size(); i++) {
+		Object *node = ObjectDB::get_instance(available[i]);
+		if (node) {
+			memdelete(node);
+		}
+	}
+	available.clear();
+	instances.clear();
+	prune_threshold = 64;
+}
+
+int ScenePool::get_available_count() const {
+	MutexLock lock(mutex);
+	return available.size();
+}
+
+void ScenePool::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("set_scene", "scene"), &ScenePool::set_scene);
+	ClassDB::bind_method(D_METHOD("get_scene"), &ScenePool::get_scene);
+	ClassDB::bind_method(D_METHOD("set_max_size", "size"), &ScenePool::set_max_size);
+	ClassDB::bind_method(D_METHOD("get_max_size"), &ScenePool::get_max_size);
+
+	ClassDB::bind_method(D_METHOD("acquire"), &ScenePool::acquire);
+	ClassDB::bind_method(D_METHOD("release", "node"), &ScenePool::release);
+	ClassDB::bind_method(D_METHOD("prefill", "count"), &ScenePool::prefill);
+	ClassDB::bind_method(D_METHOD("clear"), &ScenePool::clear);
+	ClassDB::bind_method(D_METHOD("get_available_count"), &ScenePool::get_available_count);
+
+	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "scene", PROPERTY_HINT_RESOURCE_TYPE, "PackedScene"), "set_scene", "get_scene");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "max_size", PROPERTY_HINT_RANGE, "0,1024,1,or_greater"), "set_max_size", "get_max_size");
+}
+
+ScenePool::~ScenePool() {
+	clear();
+}
@@ -0,0 +1,108 @@
+/*************************************************************************/
+/*  scene_pool.h                                                         */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef SCENE_POOL_H
+#define SCENE_POOL_H
+
+#include "core/os/mutex.h"
+#include "core/pair.h"
+#include "core/reference.h"
+#include "scene/resources/packed_scene.h"
+
+// Keeps instances of a scene around once they are released, out of the
+// tree but with their objects, connections and server resources intact,
+// and hands them out again reset to the state they were instanced in.
+class ScenePool : public Reference {
+	GDCLASS(ScenePool, Reference);
+
+	struct NodeState {
+		ObjectID node;
+		Vector<Pair<StringName, Variant>> properties;
+		List<Pair<StringName, Variant>> script_state;
+		// Made at runtime, e.g. in _ready(), they'd pile up each time the instance is reused.
+		List<Connection> connections;
+		List<Node::GroupInfo> groups;
+	};
+
+	struct Instance {
+		Vector<NodeState> nodes; // In tree order, the root comes first.
+		bool available = false;
+		bool releasing = false; // Waiting to leave the tree.
+	};
+
+	Ref<PackedScene> scene;
+	int max_size = 32;
+
+	mutable Mutex mutex;
+	// Every instance created by this pool that was not freed, by root.
+	HashMap<ObjectID, Instance> instances;
+	Vector<ObjectID> available;
+	uint32_t prune_threshold = 64;
+
+	static uint32_t hit_count;
+	static uint32_t miss_count;
+
+	static void _capture_state(Node *p_node, Vector<NodeState> &r_states);
+	static int _count_nodes(Node *p_node);
+	static bool _restore_state(const Vector<NodeState> &p_nodes);
+	static void _restore_connections(Node *p_node, const NodeState &p_state);
+	static void _restore_groups(Node *p_node, const NodeState &p_state);
+
+	Node *_create_instance();
+	void _prune_freed();
+	void _finish_release(ObjectID p_id);
+	void _finish_deferred_release(ObjectID p_id, const Ref<ScenePool> &p_pool);
+
+protected:
+	static void _bind_methods();
+
+public:
+	void set_scene(const Ref<PackedScene> &p_scene);
+	Ref<PackedScene> get_scene() const;
+
+	void set_max_size(int p_size);
+	int get_max_size() const;
+
+	Node *acquire();
+	void release(Node *p_node);
+	void prefill(int p_count);
+	void clear();
+
+	int get_available_count() const;
+
+	// Totals across all pools, for Performance.
+	static uint32_t get_hit_count() { return hit_count; }
+	static uint32_t get_miss_count() { return miss_count; }
+
+	ScenePool() {}
+	~ScenePool();
+};
+
+#endif // SCENE_POOL_H
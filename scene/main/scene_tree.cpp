@@ -128,6 +128,7 @@ SceneTree::Group *SceneTree::add_to_group(const StringName &p_group, Node *p_nod
 	E->get().nodes.push_back(p_node);
 	//E->get().last_tree_version=0;
 	E->get().changed = true;
+	_process_list_group_changed(p_group);
 	return &E->get();
 }
 
@@ -139,6 +140,7 @@ void SceneTree::remove_from_group(const StringName &p_group, Node *p_node) {
 	if (E->get().nodes.empty()) {
 		group_map.erase(E);
 	}
+	_process_list_group_changed(p_group);
 }
 
 void SceneTree::make_group_changed(const StringName &p_group) {
@@ -146,6 +148,50 @@ void SceneTree::make_group_changed(const StringName &p_group) {
 	if (E) {
 		E->get().changed = true;
 	}
+	_process_list_group_changed(p_group);
+}
+
+void SceneTree::_process_list_group_changed(const StringName &p_group) {
+	for (int i = 0; i < PROCESS_LIST_MAX; i++) {
+		if (process_lists[i].group == p_group) {
+			process_lists[i].dirty = true;
+			return;
+		}
+	}
+}
+
+void SceneTree::_invalidate_process_lists() {
+	// Pause state or pause modes changed, resolved on the next processing pass.
+	process_state_version++;
+}
+
+void SceneTree::_xform_change_add(SelfList<Node> *p_elem) {
+	if (!processing_thread_groups) {
+		xform_change_list.add(p_elem);
+		return;
+	}
+
+	// Removals can reach into any group's list, so adds take the same lock while groups run.
+	MutexLock lock(xform_change_mutex);
+	Thread::ID caller = Thread::get_caller_id();
+	for (uint32_t i = 0; i < process_thread_group_count; i++) {
+		if (process_thread_groups[i].thread_id == caller) {
+			process_thread_groups[i].xform_change_list.add(p_elem);
+			return;
+		}
+	}
+	xform_change_list.add(p_elem);
+}
+
+void SceneTree::_xform_change_remove(SelfList<Node> *p_elem) {
+	if (!processing_thread_groups) {
+		p_elem->remove_from_list();
+		return;
+	}
+
+	// The element may sit in the shared list or in another group's, next to nodes that thread is adding.
+	MutexLock lock(xform_change_mutex);
+	p_elem->remove_from_list();
 }
 
 void SceneTree::flush_transform_notifications() {
@@ -769,6 +815,7 @@ void SceneTree::set_pause(bool p_enabled) {
 		return;
 	}
 	pause = p_enabled;
+	_invalidate_process_lists();
 	NavigationServer3D::get_singleton()->set_active(!p_enabled);
 	PhysicsServer3D::get_singleton()->set_active(!p_enabled);
 	PhysicsServer2D::get_singleton()->set_active(!p_enabled);
@@ -781,48 +828,203 @@ bool SceneTree::is_paused() const {
 	return pause;
 }
 
-void SceneTree::_notify_group_pause(const StringName &p_group, int p_notification) {
-	Map<StringName, Group>::Element *E = group_map.find(p_group);
+static _FORCE_INLINE_ ObjectID _get_script_id(ScriptInstance *p_instance) {
+	Ref<Script> script = p_instance->get_script();
+	return script.is_valid() ? script->get_instance_id() : ObjectID();
+}
+
+void SceneTree::_update_process_list(ProcessList &p_list, int p_notification) {
+	p_list.entries.clear();
+	p_list.threaded_entries.clear();
+	p_list.dirty = false;
+
+	Map<StringName, Group>::Element *E = group_map.find(p_list.group);
 	if (!E) {
 		return;
 	}
 	Group &g = E->get();
-	if (g.nodes.empty()) {
-		return;
+
+	_update_group_order(g, true);
+
+	// Only the user callbacks can run threaded, internal processing stays on the main thread.
+	bool threaded = p_notification == Node::NOTIFICATION_PROCESS || p_notification == Node::NOTIFICATION_PHYSICS_PROCESS;
+
+	Node *const *nodes = g.nodes.ptr();
+	int node_count = g.nodes.size();
+	for (int i = 0; i < node_count; i++) {
+		Node *n = nodes[i];
+		if (!n->can_process()) {
+			continue;
+		}
+
+		ProcessListEntry entry;
+		entry.node = n;
+		entry.script_instance = n->get_script_instance();
+		entry.script_notification = false;
+		if (entry.script_instance) {
+			entry.script = _get_script_id(entry.script_instance);
+			entry.script_notification = entry.script_instance->has_method(SceneStringNames::get_singleton()->_notification);
+		}
+
+		if (threaded && n->data.process_thread_group != 0) {
+			p_list.threaded_entries.push_back(entry);
+		} else {
+			p_list.entries.push_back(entry);
+		}
 	}
+}
 
-	_update_group_order(g, p_notification == Node::NOTIFICATION_PROCESS || p_notification == Node::NOTIFICATION_INTERNAL_PROCESS || p_notification == Node::NOTIFICATION_PHYSICS_PROCESS || p_notification == Node::NOTIFICATION_INTERNAL_PHYSICS_PROCESS);
+void SceneTree::_dispatch_process(const ProcessListEntry &p_entry, int p_notification) {
+	Node *n = p_entry.node;
+	ScriptInstance *si = n->get_script_instance();
+	if (!p_entry.script_notification && si == p_entry.script_instance && (!si || _get_script_id(si) == p_entry.script)) {
+		// The script has no _notification() to look up, only the class chain (which calls _process) needs it.
+		n->_notificationv(p_notification, false);
+	} else {
+		n->notification(p_notification);
+	}
+}
 
-	//copy, so copy on write happens in case something is removed from process while being called
-	//performance is not lost because only if something is added/removed the vector is copied.
-	Vector<Node *> nodes_copy = g.nodes;
+void SceneTree::_notify_group_pause(const StringName &p_group, int p_notification) {
+	ProcessList *list = nullptr;
+	for (int i = 0; i < PROCESS_LIST_MAX; i++) {
+		if (process_lists[i].group == p_group) {
+			list = &process_lists[i];
+			break;
+		}
+	}
+	ERR_FAIL_COND_MSG(!list, "Not a processing group: " + String(p_group) + ".");
 
-	int node_count = nodes_copy.size();
-	Node **nodes = nodes_copy.ptrw();
+	if (list->iterating) {
+		return; // Not reentrant, the list is being processed already.
+	}
+
+	if (process_lists_version != process_state_version) {
+		for (int i = 0; i < PROCESS_LIST_MAX; i++) {
+			process_lists[i].dirty = true;
+		}
+		process_lists_version = process_state_version;
+	}
+
+	if (list->dirty) {
+		_update_process_list(*list, p_notification);
+	}
+
+	if (list->entries.empty() && list->threaded_entries.empty()) {
+		return;
+	}
+
+	// Changes during processing only mark the list dirty, so the arrays stay valid
+	// here. Removed nodes end up in call_skip, and processing toggled off or pause
+	// changes made by the callbacks are still honored for the rest of the list.
+	list->iterating = true;
+	uint64_t version = process_state_version;
 
 	call_lock++;
 
-	for (int i = 0; i < node_count; i++) {
-		Node *n = nodes[i];
-		if (call_lock && call_skip.has(n)) {
+	if (!list->threaded_entries.empty()) {
+		_notify_thread_groups(list->threaded_entries, p_notification);
+	}
+
+	const ProcessListEntry *entries = list->entries.ptr();
+	uint32_t entry_count = list->entries.size();
+
+	for (uint32_t i = 0; i < entry_count; i++) {
+		Node *n = entries[i].node;
+		if (!call_skip.empty() && call_skip.has(n)) {
 			continue;
 		}
 
-		if (!n->can_process()) {
+		if (!n->can_process_notification(p_notification)) {
 			continue;
 		}
-		if (!n->can_process_notification(p_notification)) {
+		if (version != process_state_version && !n->can_process()) {
 			continue;
 		}
 
-		n->notification(p_notification);
-		//ERR_FAIL_COND(node_count != g.nodes.size());
+		_dispatch_process(entries[i], p_notification);
 	}
 
 	call_lock--;
 	if (call_lock == 0) {
 		call_skip.clear();
 	}
+
+	list->iterating = false;
+}
+
+void SceneTree::_notify_thread_groups(const LocalVector<ProcessListEntry> &p_entries, int p_notification) {
+	for (uint32_t i = 0; i < process_thread_group_count; i++) {
+		process_thread_groups[i].entries.clear();
+	}
+	process_thread_group_count = 0;
+
+	// Bucket on the main thread, keeping the process priority order within each group.
+	uint32_t last = 0;
+	for (uint32_t i = 0; i < p_entries.size(); i++) {
+		Node *n = p_entries[i].node;
+		if (!call_skip.empty() && call_skip.has(n)) {
+			continue;
+		}
+		if (!n->can_process_notification(p_notification)) {
+			continue;
+		}
+
+		int id = n->data.process_thread_group;
+		if (last >= process_thread_group_count || process_thread_groups[last].id != id) {
+			last = 0;
+			while (last < process_thread_group_count && process_thread_groups[last].id != id) {
+				last++;
+			}
+			if (last == process_thread_group_count) {
+				if (process_thread_groups.size() == last) {
+					process_thread_groups.push_back(ProcessThreadGroup());
+				}
+				process_thread_groups[last].id = id;
+				process_thread_group_count++;
+			}
+		}
+
+		process_thread_groups[last].entries.push_back(p_entries[i]);
+	}
+
+	if (process_thread_group_count == 0) {
+		return;
+	}
+
+	processing_thread_groups = true;
+
+	if (process_thread_group_count == 1) {
+		// Nothing to run in parallel with, skip the handoff.
+		_process_thread_group(0, p_notification);
+	} else {
+		if (!process_thread_pool_started) {
+			process_thread_pool.init();
+			process_thread_pool_started = true;
+		}
+		process_thread_pool.do_work(process_thread_group_count, this, &SceneTree::_process_thread_group, p_notification);
+	}
+
+	processing_thread_groups = false;
+
+	// Queue the transform changes of each group, in group order.
+	for (uint32_t i = 0; i < process_thread_group_count; i++) {
+		SelfList<Node>::List &list = process_thread_groups[i].xform_change_list;
+		while (list.first()) {
+			SelfList<Node> *n = list.first();
+			list.remove(n);
+			xform_change_list.add_last(n);
+		}
+	}
+}
+
+void SceneTree::_process_thread_group(uint32_t p_index, int p_notification) {
+	ProcessThreadGroup &group = process_thread_groups[p_index];
+	group.thread_id = Thread::get_caller_id();
+	for (uint32_t i = 0; i < group.entries.size(); i++) {
+		_dispatch_process(group.entries[i], p_notification);
+	}
+	group.thread_id = 0;
 }
 
 /*
@@ -1335,6 +1537,11 @@ SceneTree::SceneTree() {
 	if (singleton == nullptr) {
 		singleton = this;
 	}
+
+	process_lists[PROCESS_LIST_IDLE].group = "idle_process";
+	process_lists[PROCESS_LIST_IDLE_INTERNAL].group = "idle_process_internal";
+	process_lists[PROCESS_LIST_PHYSICS].group = "physics_process";
+	process_lists[PROCESS_LIST_PHYSICS_INTERNAL].group = "physics_process_internal";
 	_quit = false;
 	accept_quit = true;
 	quit_on_go_back = true;
@@ -1435,6 +1642,10 @@ SceneTree::SceneTree() {
 }
 
 SceneTree::~SceneTree() {
+	if (process_thread_pool_started) {
+		process_thread_pool.finish();
+	}
+
 	if (root) {
 		root->_set_tree(nullptr);
 		root->_propagate_after_exit_tree();
@@ -32,9 +32,12 @@
 #define SCENE_MAIN_LOOP_H
 
 #include "core/io/multiplayer_api.h"
+#include "core/local_vector.h"
 #include "core/os/main_loop.h"
+#include "core/os/thread.h"
 #include "core/os/thread_safe.h"
 #include "core/self_list.h"
+#include "core/thread_work_pool.h"
 #include "scene/resources/mesh.h"
 #include "scene/resources/world_2d.h"
 #include "scene/resources/world_3d.h"
@@ -128,6 +131,63 @@ private:
 
 	List<ObjectID> delete_queue;
 
+	// The processing groups are flattened into lists of the nodes that can
+	// process under the current pause state. They are only rebuilt when the
+	// group, the pause state or a pause mode changes, not every frame.
+	struct ProcessListEntry {
+		Node *node;
+		ScriptInstance *script_instance;
+		ObjectID script; // the instance may be recreated at the same address for another script
+		bool script_notification; // the script has a _notification() that must see the callback
+	};
+
+	enum ProcessListType {
+		PROCESS_LIST_IDLE,
+		PROCESS_LIST_IDLE_INTERNAL,
+		PROCESS_LIST_PHYSICS,
+		PROCESS_LIST_PHYSICS_INTERNAL,
+		PROCESS_LIST_MAX
+	};
+
+	struct ProcessList {
+		StringName group;
+		LocalVector<ProcessListEntry> entries;
+		LocalVector<ProcessListEntry> threaded_entries;
+		bool dirty = true;
+		bool iterating = false;
+	};
+
+	ProcessList process_lists[PROCESS_LIST_MAX];
+	uint64_t process_state_version = 1;
+	uint64_t process_lists_version = 0;
+
+	void _process_list_group_changed(const StringName &p_group);
+	void _invalidate_process_lists();
+	void _update_process_list(ProcessList &p_list, int p_notification);
+	_FORCE_INLINE_ void _dispatch_process(const ProcessListEntry &p_entry, int p_notification);
+
+	// Nodes with a process thread group run their process callbacks on the
+	// worker pool, one task per group. The tree must not change meanwhile.
+	// Transform changes made by a group are queued in its own list and moved
+	// to xform_change_list on the main thread once all groups are done. Adds
+	// and removals lock xform_change_mutex meanwhile, as a node can leave the
+	// queue from another thread than the one that queued it.
+	struct ProcessThreadGroup {
+		int id = 0;
+		LocalVector<ProcessListEntry> entries;
+		Thread::ID thread_id = 0; // set while a thread processes the group
+		SelfList<Node>::List xform_change_list;
+	};
+
+	LocalVector<ProcessThreadGroup> process_thread_groups;
+	uint32_t process_thread_group_count = 0;
+	ThreadWorkPool process_thread_pool;
+	bool process_thread_pool_started = false;
+	bool processing_thread_groups = false;
+
+	void _notify_thread_groups(const LocalVector<ProcessListEntry> &p_entries, int p_notification);
+	void _process_thread_group(uint32_t p_index, int p_notification);
+
 	Map<UGCall, Vector<Variant>> unique_group_calls;
 	bool ugc_locked;
 	void _flush_ugc();
@@ -189,6 +249,10 @@ private:
 	friend class Viewport;
 
 	SelfList<Node>::List xform_change_list;
+	Mutex xform_change_mutex;
+
+	void _xform_change_add(SelfList<Node> *p_elem);
+	void _xform_change_remove(SelfList<Node> *p_elem);
 
 #ifdef DEBUG_ENABLED // No live editor in release build.
 	friend class LiveEditor;
@@ -346,6 +410,8 @@ public:
 
 	static void add_idle_callback(IdleCallback p_callback);
 
+	_FORCE_INLINE_ bool is_processing_thread_groups() const { return processing_thread_groups; }
+
 	//default texture settings
 
 	SceneTree();
@@ -684,7 +684,7 @@ void Viewport::_notification(int p_what) {
 
 							Vector2 point = canvas_transform.affine_inverse().xform(pos);
 
-							int rc = ss2d->intersect_point_on_canvas(point, canvas_layer_id, res, 64, Set<RID>(), 0xFFFFFFFF, true, true, true);
+							int rc = ss2d->intersect_point_on_canvas(point, canvas_layer_id, res, 64, PhysicsQueryFilter(), 0xFFFFFFFF, true, true, true);
 							for (int i = 0; i < rc; i++) {
 								if (res[i].collider_id.is_valid() && res[i].collider) {
 									CollisionObject2D *co = Object::cast_to<CollisionObject2D>(res[i].collider);
@@ -772,7 +772,7 @@ void Viewport::_notification(int p_what) {
 
 							PhysicsDirectSpaceState3D *space = PhysicsServer3D::get_singleton()->space_get_direct_state(find_world_3d()->get_space());
 							if (space) {
-								bool col = space->intersect_ray(from, from + dir * 10000, result, Set<RID>(), 0xFFFFFFFF, true, true, true);
+								bool col = space->intersect_ray(from, from + dir * 10000, result, PhysicsQueryFilter(), 0xFFFFFFFF, true, true, true);
 								ObjectID new_collider;
 								if (col) {
 									CollisionObject3D *co = Object::cast_to<CollisionObject3D>(result.collider);
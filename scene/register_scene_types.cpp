@@ -124,6 +124,7 @@
 #include "scene/main/http_request.h"
 #include "scene/main/instance_placeholder.h"
 #include "scene/main/resource_preloader.h"
+#include "scene/main/scene_pool.h"
 #include "scene/main/scene_tree.h"
 #include "scene/main/timer.h"
 #include "scene/main/viewport.h"
@@ -203,6 +204,7 @@
 #include "scene/3d/navigation_agent_3d.h"
 #include "scene/3d/navigation_obstacle_3d.h"
 #include "scene/3d/navigation_region_3d.h"
+#include "scene/3d/occluder_instance_3d.h"
 #include "scene/3d/path_3d.h"
 #include "scene/3d/physics_body_3d.h"
 #include "scene/3d/physics_joint_3d.h"
@@ -282,6 +284,7 @@ void register_scene_types() {
 	ClassDB::register_class<CanvasLayer>();
 	ClassDB::register_class<CanvasModulate>();
 	ClassDB::register_class<ResourcePreloader>();
+	ClassDB::register_class<ScenePool>();
 	ClassDB::register_class<Window>();
 
 	/* REGISTER GUI */
@@ -437,6 +440,8 @@ void register_scene_types() {
 	ClassDB::register_class<SpotLight3D>();
 	ClassDB::register_class<ReflectionProbe>();
 	ClassDB::register_class<Decal>();
+	ClassDB::register_class<Occluder3D>();
+	ClassDB::register_class<OccluderInstance3D>();
 	ClassDB::register_class<GIProbe>();
 	ClassDB::register_class<GIProbeData>();
 	ClassDB::register_class<BakedLightmap>();
@@ -690,6 +695,8 @@ void register_scene_types() {
 	ClassDB::register_virtual_class<Texture2D>();
 	ClassDB::register_class<Sky>();
 	ClassDB::register_class<StreamTexture2D>();
+	SceneTree::add_idle_callback(StreamTexture2D::update_streaming);
+	StreamTexture2D::init_streaming();
 	ClassDB::register_class<ImageTexture>();
 	ClassDB::register_class<AtlasTexture>();
 	ClassDB::register_class<MeshTexture>();
@@ -973,5 +980,6 @@ void unregister_scene_types() {
 
 	ParticlesMaterial::finish_shaders();
 	CanvasItemMaterial::finish_shaders();
+	StreamTexture2D::finish_streaming();
 	SceneStringNames::free();
 }
@@ -83,10 +83,31 @@ Vector<Vector3> ConcavePolygonShape3D::get_faces() const {
 	return PhysicsServer3D::get_singleton()->shape_get_data(get_shape());
 }
 
+void ConcavePolygonShape3D::_set_data(const Variant &p_data) {
+	if (p_data.get_type() != Variant::DICTIONARY) {
+		set_faces(p_data); // Saved before the tree was stored along with the faces.
+		return;
+	}
+
+	// Handing the faces and the tree over together lets the server skip building it.
+	PhysicsServer3D::get_singleton()->shape_set_data(get_shape(), p_data);
+	notify_change_to_owners();
+}
+
+Variant ConcavePolygonShape3D::_get_data() const {
+	Dictionary d;
+	d["faces"] = get_faces();
+	d["bvh"] = PhysicsServer3D::get_singleton()->shape_get_bvh_cache(get_shape());
+	return d;
+}
+
 void ConcavePolygonShape3D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_faces", "faces"), &ConcavePolygonShape3D::set_faces);
 	ClassDB::bind_method(D_METHOD("get_faces"), &ConcavePolygonShape3D::get_faces);
-	ADD_PROPERTY(PropertyInfo(Variant::PACKED_VECTOR3_ARRAY, "data", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NOEDITOR | PROPERTY_USAGE_INTERNAL), "set_faces", "get_faces");
+	ClassDB::bind_method(D_METHOD("_set_data", "data"), &ConcavePolygonShape3D::_set_data);
+	ClassDB::bind_method(D_METHOD("_get_data"), &ConcavePolygonShape3D::_get_data);
+
+	ADD_PROPERTY(PropertyInfo(Variant::DICTIONARY, "data", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NOEDITOR | PROPERTY_USAGE_INTERNAL), "_set_data", "_get_data");
 }
 
 ConcavePolygonShape3D::ConcavePolygonShape3D() :
@@ -56,6 +56,10 @@ class ConcavePolygonShape3D : public Shape3D {
 		}
 	};
 
+	// Stores the faces together with the tree built by the physics server.
+	void _set_data(const Variant &p_data);
+	Variant _get_data() const;
+
 protected:
 	static void _bind_methods();
 
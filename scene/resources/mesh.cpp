@@ -30,6 +30,7 @@
 
 #include "mesh.h"
 
+#include "core/math/mesh_optimizer.h"
 #include "core/pair.h"
 #include "scene/resources/concave_polygon_shape_3d.h"
 #include "scene/resources/convex_polygon_shape_3d.h"
@@ -1309,6 +1310,67 @@ void ArrayMesh::regen_normalmaps() {
 	}
 }
 
+void ArrayMesh::generate_lods() {
+	if (surfaces.size() == 0) {
+		return;
+	}
+
+	struct SurfaceLODs {
+		PrimitiveType primitive;
+		uint32_t format;
+		Array arrays;
+		Array blend_shapes;
+		Dictionary lods;
+		Ref<Material> material;
+		String name;
+	};
+
+	Vector<SurfaceLODs> surfs;
+	for (int i = 0; i < get_surface_count(); i++) {
+		SurfaceLODs s;
+		s.primitive = surface_get_primitive_type(i);
+		s.format = surface_get_format(i);
+		s.arrays = surface_get_arrays(i);
+		s.blend_shapes = surface_get_blend_shape_arrays(i);
+		s.material = surface_get_material(i);
+		s.name = surface_get_name(i);
+
+		if (s.primitive == PRIMITIVE_TRIANGLES && s.arrays[ARRAY_VERTEX].get_type() == Variant::PACKED_VECTOR3_ARRAY) {
+			Vector<Vector3> vertices = s.arrays[ARRAY_VERTEX];
+			Vector<int> indices = s.arrays[ARRAY_INDEX];
+			if (indices.size() == 0) {
+				indices.resize(vertices.size());
+				int *w = indices.ptrw();
+				for (int j = 0; j < vertices.size(); j++) {
+					w[j] = j;
+				}
+				s.format |= ARRAY_FORMAT_INDEX;
+			}
+
+			if (indices.size() >= 3 && indices.size() % 3 == 0) {
+				MeshOptimizer::optimize_vertex_cache(indices.ptrw(), indices.size(), vertices.size());
+				MeshOptimizer::optimize_overdraw(indices.ptrw(), indices.size(), vertices.ptr(), vertices.size());
+				s.arrays[ARRAY_INDEX] = indices;
+
+				Vector<MeshOptimizer::LOD> lods = MeshOptimizer::generate_lods(indices.ptr(), indices.size(), vertices.ptr(), vertices.size());
+				for (int j = 0; j < lods.size(); j++) {
+					s.lods[lods[j].error] = lods[j].indices;
+				}
+			}
+		}
+
+		surfs.push_back(s);
+	}
+
+	clear_surfaces();
+
+	for (int i = 0; i < surfs.size(); i++) {
+		add_surface_from_arrays(surfs[i].primitive, surfs[i].arrays, surfs[i].blend_shapes, surfs[i].lods, surfs[i].format);
+		surface_set_material(i, surfs[i].material);
+		surface_set_name(i, surfs[i].name);
+	}
+}
+
 //dirty hack
 bool (*array_mesh_lightmap_unwrap_callback)(float p_texel_size, const float *p_vertices, const float *p_normals, int p_vertex_count, const int *p_indices, int p_index_count, float **r_uv, int **r_vertex, int *r_vertex_count, int **r_index, int *r_index_count, int *r_size_hint_x, int *r_size_hint_y, int *&r_cache_data, unsigned int &r_cache_size, bool &r_used_cache);
 
@@ -1528,6 +1590,8 @@ void ArrayMesh::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("create_outline", "margin"), &ArrayMesh::create_outline);
 	ClassDB::bind_method(D_METHOD("regen_normalmaps"), &ArrayMesh::regen_normalmaps);
 	ClassDB::set_method_flags(get_class_static(), _scs_create("regen_normalmaps"), METHOD_FLAGS_DEFAULT | METHOD_FLAG_EDITOR);
+	ClassDB::bind_method(D_METHOD("generate_lods"), &ArrayMesh::generate_lods);
+	ClassDB::set_method_flags(get_class_static(), _scs_create("generate_lods"), METHOD_FLAGS_DEFAULT | METHOD_FLAG_EDITOR);
 	ClassDB::bind_method(D_METHOD("lightmap_unwrap", "transform", "texel_size"), &ArrayMesh::lightmap_unwrap);
 	ClassDB::set_method_flags(get_class_static(), _scs_create("lightmap_unwrap"), METHOD_FLAGS_DEFAULT | METHOD_FLAG_EDITOR);
 	ClassDB::bind_method(D_METHOD("get_faces"), &ArrayMesh::get_faces);
@@ -45,6 +45,88 @@ bool SceneState::can_instance() const {
 	return nodes.size() > 0;
 }
 
+const SceneState::InstancePlan *SceneState::_get_instance_plan() const {
+	MutexLock lock(instance_plan_mutex);
+
+	if (instance_plan) {
+		return instance_plan;
+	}
+
+	InstancePlan *plan = memnew(InstancePlan);
+
+	plan->node_properties.resize(nodes.size());
+	for (int i = 0; i < nodes.size(); i++) {
+		const NodeData &n = nodes[i];
+		Vector<InstancePlan::Property> &properties = plan->node_properties.write[i];
+		properties.resize(n.properties.size());
+
+		if ((i == 0 && base_scene_idx >= 0) || n.instance >= 0 || n.type == TYPE_INSTANCED) {
+			// Created elsewhere, its class is only known once instanced.
+			continue;
+		}
+		ERR_CONTINUE(n.type < 0 || n.type >= names.size());
+		const StringName &type = names[n.type];
+
+		for (int j = 0; j < n.properties.size(); j++) {
+			ERR_CONTINUE(n.properties[j].name < 0 || n.properties[j].name >= names.size());
+			const StringName &name = names[n.properties[j].name];
+			if (name == CoreStringNames::get_singleton()->_script) {
+				continue;
+			}
+
+			StringName setter = ClassDB::get_property_setter(type, name);
+			if (setter == StringName()) {
+				continue; // Not a class property (or read-only), let Object::set() deal with it.
+			}
+
+			InstancePlan::Property &property = properties.write[j];
+			property.setter = ClassDB::get_method(type, setter);
+			property.index = ClassDB::get_property_index(type, name);
+		}
+	}
+
+	plan->connection_binds.resize(connections.size());
+	for (int i = 0; i < connections.size(); i++) {
+		const ConnectionData &c = connections[i];
+		Vector<Variant> &binds = plan->connection_binds.write[i];
+		binds.resize(c.binds.size());
+		for (int j = 0; j < c.binds.size(); j++) {
+			ERR_CONTINUE(c.binds[j] < 0 || c.binds[j] >= variants.size());
+			binds.write[j] = variants[c.binds[j]];
+		}
+	}
+
+	instance_plan = plan;
+	return instance_plan;
+}
+
+void SceneState::_clear_instance_plan() {
+	MutexLock lock(instance_plan_mutex);
+
+	if (instance_plan) {
+		memdelete(instance_plan);
+		instance_plan = nullptr;
+	}
+}
+
+// Same as Object::set() for a property known to be backed by p_setter.
+static _FORCE_INLINE_ void _set_planned_property(Node *p_node, const StringName &p_name, MethodBind *p_setter, int p_index, const Variant &p_value) {
+	ScriptInstance *script_instance = p_node->get_script_instance();
+	if (script_instance && script_instance->set(p_name, p_value)) {
+		return;
+	}
+
+	Callable::CallError ce;
+	if (p_index >= 0) {
+		Variant index = p_index;
+		const Variant *args[2] = { &index, &p_value };
+		p_setter->call(p_node, args, 2, ce);
+	} else {
+		const Variant *args[1] = { &p_value };
+		p_setter->call(p_node, args, 1, ce);
+	}
+}
+
 Node *SceneState::instance(GenEditState p_edit_state) const {
 	// nodes where instancing failed (because something is missing)
 	List<Node *> stray_instances;
@@ -84,8 +166,16 @@ Node *SceneState::instance(GenEditState p_edit_state) const {
 
 	Map<Ref<Resource>, Ref<Resource>> resources_local_to_scene;
 
+	// The editor may change anything about the classes in between, so it
+	// always goes through the generic path.
+	const InstancePlan *plan = nullptr;
+	if (p_edit_state == GEN_EDIT_STATE_DISABLED && !Engine::get_singleton()->is_editor_hint()) {
+		plan = _get_instance_plan();
+	}
+
 	for (int i = 0; i < nc; i++) {
 		const NodeData &n = nd[i];
+		const InstancePlan::Property *planned_props = nullptr;
 
 		Node *parent = nullptr;
 
@@ -173,6 +263,10 @@ Node *SceneState::instance(GenEditState p_edit_state) const {
 
 			node = Object::cast_to<Node>(obj);
 
+			if (plan && node->get_class_name() == snames[n.type] && n.properties.size()) {
+				planned_props = plan->node_properties[i].ptr();
+			}
+
 		} else {
 			//print_line("Class is disabled for: " + itos(n.type));
 			//print_line("name: " + String(snames[n.type]));
@@ -243,7 +337,11 @@ Node *SceneState::instance(GenEditState p_edit_state) const {
 						} else if (p_edit_state == GEN_EDIT_STATE_INSTANCE) {
 							value = value.duplicate(true); // Duplicate arrays and dictionaries for the editor
 						}
-						node->set(snames[nprops[j].name], value, &valid);
+						if (planned_props && planned_props[j].setter) {
+							_set_planned_property(node, snames[nprops[j].name], planned_props[j].setter, planned_props[j].index, value);
+						} else {
+							node->set(snames[nprops[j].name], value, &valid);
+						}
 					}
 				}
 			}
@@ -316,6 +414,11 @@ Node *SceneState::instance(GenEditState p_edit_state) const {
 			continue;
 		}
 
+		if (plan) {
+			cfrom->connect(snames[c.signal], Callable(cto, snames[c.method]), plan->connection_binds[i], CONNECT_PERSIST | c.flags);
+			continue;
+		}
+
 		Vector<Variant> binds;
 		if (c.binds.size()) {
 			binds.resize(c.binds.size());
@@ -900,6 +1003,7 @@ String SceneState::get_path() const {
 }
 
 void SceneState::clear() {
+	_clear_instance_plan();
 	names.clear();
 	variants.clear();
 	nodes.clear();
@@ -1063,6 +1167,8 @@ void SceneState::set_bundled_scene(const Dictionary &p_dictionary) {
 
 	ERR_FAIL_COND_MSG(version > PACKED_SCENE_VERSION, "Save format version too new.");
 
+	_clear_instance_plan();
+
 	const int node_count = p_dictionary["node_count"];
 	const Vector<int> snodes = p_dictionary["nodes"];
 	ERR_FAIL_COND(snodes.size() < node_count);
@@ -1510,6 +1616,7 @@ int SceneState::add_node(int p_parent, int p_owner, int p_type, int p_name, int
 	nd.instance = p_instance;
 	nd.index = p_index;
 
+	_clear_instance_plan();
 	nodes.push_back(nd);
 
 	return nodes.size() - 1;
@@ -1523,6 +1630,7 @@ void SceneState::add_node_property(int p_node, int p_name, int p_value) {
 	NodeData::Property prop;
 	prop.name = p_name;
 	prop.value = p_value;
+	_clear_instance_plan();
 	nodes.write[p_node].properties.push_back(prop);
 }
 
@@ -1534,6 +1642,7 @@ void SceneState::add_node_group(int p_node, int p_group) {
 
 void SceneState::set_base_scene(int p_idx) {
 	ERR_FAIL_INDEX(p_idx, variants.size());
+	_clear_instance_plan();
 	base_scene_idx = p_idx;
 }
 
@@ -1551,6 +1660,7 @@ void SceneState::add_connection(int p_from, int p_to, int p_signal, int p_method
 	c.method = p_method;
 	c.flags = p_flags;
 	c.binds = p_binds;
+	_clear_instance_plan();
 	connections.push_back(c);
 }
 
@@ -1603,6 +1713,10 @@ SceneState::SceneState() {
 	last_modified_time = 0;
 }
 
+SceneState::~SceneState() {
+	_clear_instance_plan();
+}
+
 ////////////////
 
 void PackedScene::_set_bundled_scene(const Dictionary &p_scene) {
@@ -31,6 +31,7 @@
 #ifndef PACKED_SCENE_H
 #define PACKED_SCENE_H
 
+#include "core/os/mutex.h"
 #include "core/resource.h"
 #include "scene/main/node.h"
 
@@ -88,6 +89,26 @@ class SceneState : public Reference {
 
 	Vector<ConnectionData> connections;
 
+	// Everything instance() can resolve once instead of on every call:
+	// the setter behind each stored property (as long as the node is created
+	// from its stored class) and the bound arguments of each connection.
+	// Built on first use, dropped whenever the state is modified.
+	struct InstancePlan {
+		struct Property {
+			MethodBind *setter = nullptr; // nullptr falls back to Object::set().
+			int index = -1;
+		};
+
+		Vector<Vector<Property>> node_properties;
+		Vector<Vector<Variant>> connection_binds;
+	};
+
+	mutable Mutex instance_plan_mutex;
+	mutable InstancePlan *instance_plan = nullptr;
+
+	const InstancePlan *_get_instance_plan() const;
+	void _clear_instance_plan();
+
 	Error _parse_node(Node *p_owner, Node *p_node, int p_parent_idx, Map<StringName, int> &name_map, HashMap<Variant, int, VariantHasher, VariantComparator> &variant_map, Map<Node *, int> &node_map, Map<Node *, int> &nodepath_map);
 	Error _parse_connections(Node *p_owner, Node *p_node, Map<StringName, int> &name_map, HashMap<Variant, int, VariantHasher, VariantComparator> &variant_map, Map<Node *, int> &node_map, Map<Node *, int> &nodepath_map);
 
@@ -186,6 +207,7 @@ public:
 	uint64_t get_last_modified_time() const { return last_modified_time; }
 
 	SceneState();
+	~SceneState();
 };
 
 VARIANT_ENUM_CAST(SceneState::GenEditState)
@@ -31,9 +31,11 @@
 #include "texture.h"
 
 #include "core/core_string_names.h"
+#include "core/engine.h"
 #include "core/io/image_loader.h"
 #include "core/method_bind_ext.gen.inc"
 #include "core/os/os.h"
+#include "core/project_settings.h"
 #include "mesh.h"
 #include "scene/resources/bit_map.h"
 #include "servers/camera/camera_feed.h"
@@ -354,11 +356,13 @@ Ref<Image> StreamTexture2D::load_image_from_file(FileAccess *f, int p_size_limit
 		int total_size = 0;
 
 		bool first = true;
+		int first_w = sw;
+		int first_h = sh;
 
 		for (uint32_t i = 0; i < mipmaps + 1; i++) {
 			uint32_t size = f->get_32();
 
-			if (p_size_limit > 0 && i < (mipmaps - 1) && (sw > p_size_limit || sh > p_size_limit)) {
+			if (p_size_limit > 0 && i < mipmaps && (sw > p_size_limit || sh > p_size_limit)) {
 				//can't load this due to size limit
 				sw = MAX(sw >> 1, 1);
 				sh = MAX(sh >> 1, 1);
@@ -390,6 +394,8 @@ Ref<Image> StreamTexture2D::load_image_from_file(FileAccess *f, int p_size_limit
 				//format will actually be the format of the first image,
 				//as it may have changed on compression
 				format = img->get_format();
+				first_w = sw;
+				first_h = sh;
 				first = false;
 			} else if (img->get_format() != format) {
 				img->convert(format); //all needs to be the same format
@@ -431,24 +437,26 @@ Ref<Image> StreamTexture2D::load_image_from_file(FileAccess *f, int p_size_limit
 				}
 			}
 
-			image->create(w, h, true, mipmap_images[0]->get_format(), img_data);
+			image->create(first_w, first_h, true, mipmap_images[0]->get_format(), img_data);
 			return image;
 		}
 
 	} else if (data_format == DATA_FORMAT_IMAGE) {
 		int size = Image::get_image_data_size(w, h, format, mipmaps ? true : false);
+		uint64_t data_pos = f->get_position();
 
 		for (uint32_t i = 0; i < mipmaps + 1; i++) {
 			int tw, th;
 			int ofs = Image::get_image_mipmap_offset_and_dimensions(w, h, format, i, tw, th);
 
-			if (p_size_limit > 0 && i < mipmaps && (p_size_limit > tw || p_size_limit > th)) {
-				if (ofs) {
-					f->seek(f->get_position() + ofs);
-				}
+			if (p_size_limit > 0 && i < mipmaps && (tw > p_size_limit || th > p_size_limit)) {
 				continue; //oops, size limit enforced, go to next
 			}
 
+			if (ofs) {
+				f->seek(data_pos + ofs);
+			}
+
 			Vector<uint8_t> data;
 			data.resize(size - ofs);
 
@@ -538,6 +546,13 @@ Error StreamTexture2D::_load_data(const String &p_path, int &tw, int &th, int &t
 	f->get_32();
 	f->get_32();
 
+	//size of the full image, the largest mips may be skipped below
+	uint64_t data_pos = f->get_position();
+	f->get_32(); //data format
+	tw = f->get_16();
+	th = f->get_16();
+	f->seek(data_pos);
+
 #ifdef TOOLS_ENABLED
 
 	r_request_3d = request_3d_callback && df & FORMAT_BIT_DETECT_3D;
@@ -576,11 +591,15 @@ Error StreamTexture2D::load(const String &p_path) {
 	bool request_roughness;
 	int mipmap_limit;
 
-	Error err = _load_data(p_path, lw, lh, lwc, lhc, image, request_3d, request_normal, request_roughness, mipmap_limit);
+	int size_limit = streaming ? streaming->base_size : 0;
+
+	Error err = _load_data(p_path, lw, lh, lwc, lhc, image, request_3d, request_normal, request_roughness, mipmap_limit, size_limit);
 	if (err) {
 		return err;
 	}
 
+	bool streamed = image->get_width() < lw || image->get_height() < lh;
+
 	if (texture.is_valid()) {
 		RID new_texture = RS::get_singleton()->texture_2d_create(image);
 		RS::get_singleton()->texture_replace(texture, new_texture);
@@ -589,6 +608,8 @@ Error StreamTexture2D::load(const String &p_path) {
 	}
 	if (lwc || lhc) {
 		RS::get_singleton()->texture_set_size_override(texture, lwc, lhc);
+	} else if (streamed) {
+		RS::get_singleton()->texture_set_size_override(texture, lw, lh);
 	}
 
 	w = lwc ? lwc : lw;
@@ -596,6 +617,12 @@ Error StreamTexture2D::load(const String &p_path) {
 	path_to_file = p_path;
 	format = image->get_format();
 
+	if (streamed) {
+		_streaming_register(image, lw, lh);
+	} else {
+		_streaming_unregister();
+	}
+
 	if (get_path() == String()) {
 		//temporarily set path if no path set for resource, helps find errors
 		RenderingServer::get_singleton()->texture_set_path(texture, p_path);
@@ -740,6 +767,227 @@ void StreamTexture2D::reload_from_file() {
 	load(path);
 }
 
+Mutex StreamTexture2D::streaming_mutex;
+StreamTexture2D::Streaming *StreamTexture2D::streaming = nullptr;
+
+void StreamTexture2D::_streaming_register(const Ref<Image> &p_image, int p_full_width, int p_full_height) {
+	ERR_FAIL_COND(!streaming);
+	MutexLock lock(streaming_mutex);
+
+	uint64_t id = uint64_t(get_instance_id());
+	if (streaming->residency.has_texture(id)) {
+		streaming->residency.texture_remove(id);
+	}
+
+	streaming_base_image = p_image;
+	streaming_width = p_full_width;
+	streaming_height = p_full_height;
+
+	int base_mip = 0;
+	while (MAX(p_full_width >> base_mip, 1) > p_image->get_width() || MAX(p_full_height >> base_mip, 1) > p_image->get_height()) {
+		base_mip++;
+	}
+
+	Vector<uint64_t> mip_sizes;
+	for (int i = 0; i <= base_mip + p_image->get_mipmap_count(); i++) {
+		mip_sizes.push_back(Image::get_image_data_size(MAX(p_full_width >> i, 1), MAX(p_full_height >> i, 1), p_image->get_format()));
+	}
+	streaming->residency.texture_add(id, mip_sizes, base_mip);
+
+	if (!streaming_element.in_list()) {
+		streaming->textures.add(&streaming_element);
+	}
+
+	RS::get_singleton()->texture_set_streaming_feedback(texture, true);
+}
+
+void StreamTexture2D::_streaming_unregister() {
+	if (!streaming) {
+		return;
+	}
+	MutexLock lock(streaming_mutex);
+
+	uint64_t id = uint64_t(get_instance_id());
+	if (streaming->residency.has_texture(id)) {
+		streaming->residency.texture_remove(id);
+	}
+	if (streaming_element.in_list()) {
+		streaming->textures.remove(&streaming_element);
+	}
+	streaming_base_image.unref();
+}
+
+void StreamTexture2D::_streaming_apply(const Ref<Image> &p_image) {
+	RID new_texture = RS::get_singleton()->texture_2d_create(p_image);
+	RS::get_singleton()->texture_replace(texture, new_texture);
+	RS::get_singleton()->texture_set_size_override(texture, w, h);
+	RS::get_singleton()->texture_set_path(texture, get_path() != String() ? get_path() : path_to_file);
+}
+
+int StreamTexture2D::_streaming_get_mip(int p_pixels) const {
+	int size = MAX(streaming_width, streaming_height);
+	int mip = 0;
+	while ((size >> (mip + 1)) >= p_pixels && (size >> (mip + 1)) > 0) {
+		mip++;
+	}
+	return mip;
+}
+
+Ref<Image> StreamTexture2D::_streaming_load(const String &p_path, int p_size_limit) {
+	FileAccess *f = FileAccess::open(p_path, FileAccess::READ);
+	ERR_FAIL_COND_V(!f, Ref<Image>());
+
+	uint8_t header[4];
+	f->get_buffer(header, 4);
+	if (header[0] != 'G' || header[1] != 'S' || header[2] != 'T' || header[3] != '2') {
+		memdelete(f);
+		ERR_FAIL_V_MSG(Ref<Image>(), "Stream texture file is corrupt (Bad header).");
+	}
+
+	//version, custom size, data format, mipmap limit and reserved
+	for (int i = 0; i < 8; i++) {
+		f->get_32();
+	}
+
+	Ref<Image> image = load_image_from_file(f, p_size_limit);
+	memdelete(f);
+
+	return image;
+}
+
+void StreamTexture2D::_streaming_thread_func(void *p_ud) {
+	while (true) {
+		streaming->semaphore.wait();
+		if (streaming->exit) {
+			break;
+		}
+
+		StreamingLoad load;
+		{
+			MutexLock lock(streaming_mutex);
+			if (streaming->queue.empty()) {
+				continue;
+			}
+			load = streaming->queue.front()->get();
+			streaming->queue.pop_front();
+		}
+
+		load.image = _streaming_load(load.path, load.size_limit);
+
+		MutexLock lock(streaming_mutex);
+		streaming->results.push_back(load);
+	}
+}
+
+void StreamTexture2D::init_streaming() {
+	bool enabled = GLOBAL_DEF("rendering/quality/texture_streaming/enabled", false);
+	int budget_mb = GLOBAL_DEF("rendering/quality/texture_streaming/budget_mb", 512);
+	ProjectSettings::get_singleton()->set_custom_property_info("rendering/quality/texture_streaming/budget_mb", PropertyInfo(Variant::INT, "rendering/quality/texture_streaming/budget_mb", PROPERTY_HINT_RANGE, "0,16384,1,or_greater"));
+	int base_size = GLOBAL_DEF("rendering/quality/texture_streaming/base_mip_size", 64);
+	ProjectSettings::get_singleton()->set_custom_property_info("rendering/quality/texture_streaming/base_mip_size", PropertyInfo(Variant::INT, "rendering/quality/texture_streaming/base_mip_size", PROPERTY_HINT_RANGE, "8,1024,1"));
+
+	if (!enabled || Engine::get_singleton()->is_editor_hint()) {
+		//the editor always works with full size textures
+		return;
+	}
+
+	streaming = memnew(Streaming);
+	streaming->residency.set_budget(uint64_t(budget_mb) * 1024 * 1024);
+	streaming->base_size = MAX(base_size, 1);
+	streaming->thread = Thread::create(_streaming_thread_func, nullptr);
+}
+
+void StreamTexture2D::finish_streaming() {
+	if (!streaming) {
+		return;
+	}
+
+	streaming->exit = true;
+	streaming->semaphore.post();
+	Thread::wait_to_finish(streaming->thread);
+	memdelete(streaming->thread);
+
+	{
+		MutexLock lock(streaming_mutex);
+		while (streaming->textures.first()) {
+			streaming->textures.remove(streaming->textures.first());
+		}
+	}
+
+	memdelete(streaming);
+	streaming = nullptr;
+}
+
+void StreamTexture2D::update_streaming() {
+	if (!streaming) {
+		return;
+	}
+	MutexLock lock(streaming_mutex);
+
+	uint64_t frame = ++streaming->frame;
+
+	// Feedback from the renderer.
+	Vector<RID> rids;
+	for (SelfList<StreamTexture2D> *E = streaming->textures.first(); E; E = E->next()) {
+		rids.push_back(E->self()->texture);
+	}
+	if (rids.size()) {
+		Vector<int> demand = RS::get_singleton()->texture_get_streaming_demand(rids);
+		int i = 0;
+		for (SelfList<StreamTexture2D> *E = streaming->textures.first(); E && i < demand.size(); E = E->next(), i++) {
+			if (demand[i] > 0) {
+				StreamTexture2D *st = E->self();
+				streaming->residency.texture_request(uint64_t(st->get_instance_id()), st->_streaming_get_mip(demand[i]), frame);
+			}
+		}
+	}
+
+	// Finished loads.
+	for (List<StreamingLoad>::Element *E = streaming->results.front(); E; E = E->next()) {
+		const StreamingLoad &load = E->get();
+		uint64_t id = uint64_t(load.texture);
+		if (!streaming->residency.has_texture(id) || streaming->residency.texture_get_pending_mip(id) != load.mip) {
+			continue; //texture was freed or reloaded meanwhile
+		}
+
+		StreamTexture2D *st = Object::cast_to<StreamTexture2D>(ObjectDB::get_instance(load.texture));
+		if (!st || load.image.is_null() || load.image->empty()) {
+			streaming->residency.texture_load_failed(id);
+			continue;
+		}
+
+		st->_streaming_apply(load.image);
+		streaming->residency.texture_loaded(id, load.mip);
+	}
+	streaming->results.clear();
+
+	Vector<TextureStreamingResidency::Operation> loads;
+	Vector<TextureStreamingResidency::Operation> evictions;
+	streaming->residency.update(frame, loads, evictions);
+
+	for (int i = 0; i < evictions.size(); i++) {
+		StreamTexture2D *st = Object::cast_to<StreamTexture2D>(ObjectDB::get_instance(ObjectID(evictions[i].texture)));
+		if (st) {
+			st->_streaming_apply(st->streaming_base_image);
+		}
+	}
+
+	for (int i = 0; i < loads.size(); i++) {
+		StreamTexture2D *st = Object::cast_to<StreamTexture2D>(ObjectDB::get_instance(ObjectID(loads[i].texture)));
+		if (!st) {
+			continue;
+		}
+
+		StreamingLoad load;
+		load.texture = st->get_instance_id();
+		load.path = st->path_to_file;
+		load.mip = loads[i].mip;
+		load.size_limit = MAX(MAX(st->streaming_width >> load.mip, st->streaming_height >> load.mip), 1);
+		streaming->queue.push_back(load);
+		streaming->semaphore.post();
+	}
+}
+
 void StreamTexture2D::_validate_property(PropertyInfo &property) const {
 }
 
@@ -750,13 +998,16 @@ void StreamTexture2D::_bind_methods() {
 	ADD_PROPERTY(PropertyInfo(Variant::STRING, "load_path", PROPERTY_HINT_FILE, "*.stex"), "load", "get_load_path");
 }
 
-StreamTexture2D::StreamTexture2D() {
+StreamTexture2D::StreamTexture2D() :
+		streaming_element(this) {
 	format = Image::FORMAT_MAX;
 	w = 0;
 	h = 0;
 }
 
 StreamTexture2D::~StreamTexture2D() {
+	_streaming_unregister();
+
 	if (texture.is_valid()) {
 		RS::get_singleton()->free(texture);
 	}
@@ -36,10 +36,14 @@
 #include "core/os/file_access.h"
 #include "core/os/mutex.h"
 #include "core/os/rw_lock.h"
+#include "core/os/semaphore.h"
+#include "core/os/thread.h"
 #include "core/os/thread_safe.h"
 #include "core/resource.h"
+#include "core/self_list.h"
 #include "scene/resources/curve.h"
 #include "scene/resources/gradient.h"
+#include "scene/resources/texture_streaming.h"
 #include "servers/camera_server.h"
 #include "servers/rendering_server.h"
 
@@ -170,6 +174,43 @@ private:
 	static void _requested_roughness(void *p_ud, const String &p_normal_path, RS::TextureDetectRoughnessChannel p_roughness_channel);
 	static void _requested_normal(void *p_ud);
 
+	// Mip streaming: streamable textures start with their small mips only and
+	// the rest is loaded on a thread when the renderer draws them bigger.
+	struct StreamingLoad {
+		ObjectID texture;
+		String path;
+		int mip = 0;
+		int size_limit = 0;
+		Ref<Image> image;
+	};
+
+	struct Streaming {
+		TextureStreamingResidency residency;
+		SelfList<StreamTexture2D>::List textures;
+		List<StreamingLoad> queue;
+		List<StreamingLoad> results;
+		int base_size = 0;
+		uint64_t frame = 0;
+		Thread *thread = nullptr;
+		Semaphore semaphore;
+		bool exit = false;
+	};
+
+	static Mutex streaming_mutex;
+	static Streaming *streaming;
+
+	SelfList<StreamTexture2D> streaming_element;
+	Ref<Image> streaming_base_image;
+	int streaming_width = 0;
+	int streaming_height = 0;
+
+	void _streaming_register(const Ref<Image> &p_image, int p_full_width, int p_full_height);
+	void _streaming_unregister();
+	void _streaming_apply(const Ref<Image> &p_image);
+	int _streaming_get_mip(int p_pixels) const;
+	static Ref<Image> _streaming_load(const String &p_path, int p_size_limit);
+	static void _streaming_thread_func(void *p_ud);
+
 protected:
 	static void _bind_methods();
 	void _validate_property(PropertyInfo &property) const override;
@@ -177,6 +218,10 @@ protected:
 public:
 	static Ref<Image> load_image_from_file(FileAccess *p_file, int p_size_limit);
 
+	static void init_streaming();
+	static void finish_streaming();
+	static void update_streaming();
+
 	typedef void (*TextureFormatRequestCallback)(const Ref<StreamTexture2D> &);
 	typedef void (*TextureFormatRoughnessRequestCallback)(const Ref<StreamTexture2D> &, const String &p_normal_path, RS::TextureDetectRoughnessChannel p_roughness_channel);
 
@@ -0,0 +1,244 @@
+/*************************************************************************/
+/*  texture_streaming.cpp                                                */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "texture_streaming.h"
+
+#include "core/error_macros.h"
+
+uint64_t TextureStreamingResidency::_get_level_bytes(const Texture &p_texture, int p_mip) {
+	uint64_t bytes = 0;
+	for (uint32_t i = p_mip; i < p_texture.mip_sizes.size(); i++) {
+		bytes += p_texture.mip_sizes[i];
+	}
+	return bytes;
+}
+
+bool TextureStreamingResidency::_evict_until_fits(uint64_t p_frame, uint64_t p_needed, LocalVector<EvictSort> &p_candidates, uint32_t &r_next, Vector<Operation> &r_evictions) {
+	if (budget == 0) {
+		return true;
+	}
+
+	while (resident_bytes + pending_bytes + p_needed > budget) {
+		if (r_next >= p_candidates.size()) {
+			return false;
+		}
+
+		const EvictSort &candidate = p_candidates[r_next++];
+		Texture *t = textures.getptr(candidate.id);
+		if (t->last_used >= p_frame || t->pending_mip >= 0 || t->resident_mip >= t->base_mip) {
+			continue;
+		}
+
+		resident_bytes -= _get_level_bytes(*t, t->resident_mip) - _get_level_bytes(*t, t->base_mip);
+		t->resident_mip = t->base_mip;
+		t->requested_mip = t->base_mip;
+
+		Operation op;
+		op.texture = candidate.id;
+		op.mip = t->base_mip;
+		r_evictions.push_back(op);
+	}
+
+	return true;
+}
+
+void TextureStreamingResidency::texture_add(uint64_t p_texture, const Vector<uint64_t> &p_mip_sizes, int p_base_mip) {
+	ERR_FAIL_COND(textures.has(p_texture));
+	ERR_FAIL_INDEX(p_base_mip, p_mip_sizes.size());
+
+	Texture t;
+	t.mip_sizes.resize(p_mip_sizes.size());
+	for (int i = 0; i < p_mip_sizes.size(); i++) {
+		t.mip_sizes[i] = p_mip_sizes[i];
+	}
+	t.base_mip = p_base_mip;
+	t.resident_mip = p_base_mip;
+	t.requested_mip = p_base_mip;
+
+	resident_bytes += _get_level_bytes(t, p_base_mip);
+	textures.set(p_texture, t);
+}
+
+void TextureStreamingResidency::texture_remove(uint64_t p_texture) {
+	Texture *t = textures.getptr(p_texture);
+	ERR_FAIL_COND(!t);
+
+	resident_bytes -= _get_level_bytes(*t, t->resident_mip);
+	pending_bytes -= t->pending_bytes;
+	textures.erase(p_texture);
+}
+
+bool TextureStreamingResidency::has_texture(uint64_t p_texture) const {
+	return textures.has(p_texture);
+}
+
+void TextureStreamingResidency::texture_request(uint64_t p_texture, int p_mip, uint64_t p_frame) {
+	Texture *t = textures.getptr(p_texture);
+	ERR_FAIL_COND(!t);
+
+	int mip = CLAMP(p_mip, t->min_mip, t->base_mip);
+	if (t->last_used == p_frame) {
+		// Several users in the same frame, the finest one wins.
+		t->requested_mip = MIN(t->requested_mip, mip);
+	} else {
+		t->requested_mip = mip;
+	}
+	t->last_used = p_frame;
+}
+
+void TextureStreamingResidency::texture_loaded(uint64_t p_texture, int p_mip) {
+	Texture *t = textures.getptr(p_texture);
+	ERR_FAIL_COND(!t);
+	ERR_FAIL_INDEX(p_mip, (int)t->mip_sizes.size());
+
+	pending_bytes -= t->pending_bytes;
+	t->pending_bytes = 0;
+	t->pending_mip = -1;
+
+	if (p_mip < t->resident_mip) {
+		resident_bytes += _get_level_bytes(*t, p_mip) - _get_level_bytes(*t, t->resident_mip);
+		t->resident_mip = p_mip;
+	}
+}
+
+void TextureStreamingResidency::texture_load_failed(uint64_t p_texture) {
+	Texture *t = textures.getptr(p_texture);
+	ERR_FAIL_COND(!t);
+
+	pending_bytes -= t->pending_bytes;
+	t->pending_bytes = 0;
+	t->pending_mip = -1;
+	t->min_mip = t->resident_mip;
+	t->requested_mip = t->resident_mip;
+}
+
+int TextureStreamingResidency::texture_get_resident_mip(uint64_t p_texture) const {
+	const Texture *t = textures.getptr(p_texture);
+	ERR_FAIL_COND_V(!t, -1);
+	return t->resident_mip;
+}
+
+int TextureStreamingResidency::texture_get_pending_mip(uint64_t p_texture) const {
+	const Texture *t = textures.getptr(p_texture);
+	ERR_FAIL_COND_V(!t, -1);
+	return t->pending_mip;
+}
+
+void TextureStreamingResidency::update(uint64_t p_frame, Vector<Operation> &r_loads, Vector<Operation> &r_evictions) {
+	LocalVector<LoadSort> wanted;
+	LocalVector<EvictSort> evictable;
+
+	const uint64_t *k = nullptr;
+	while ((k = textures.next(k))) {
+		const Texture *t = textures.getptr(*k);
+		if (t->pending_mip >= 0) {
+			continue;
+		}
+		if (t->last_used == p_frame) {
+			if (t->requested_mip < t->resident_mip) {
+				LoadSort ls;
+				ls.texture = t;
+				ls.id = *k;
+				wanted.push_back(ls);
+			}
+		} else if (t->resident_mip < t->base_mip) {
+			EvictSort es;
+			es.texture = t;
+			es.id = *k;
+			evictable.push_back(es);
+		}
+	}
+
+	evictable.sort();
+	uint32_t next_evict = 0;
+
+	// The budget may have shrunk since the last update.
+	_evict_until_fits(p_frame, 0, evictable, next_evict, r_evictions);
+
+	wanted.sort();
+
+	for (uint32_t i = 0; i < wanted.size() && r_loads.size() < max_loads_per_update; i++) {
+		Texture *t = textures.getptr(wanted[i].id);
+		uint64_t current = _get_level_bytes(*t, t->resident_mip);
+
+		// Fall back to coarser levels when the finest one does not fit.
+		int target = t->requested_mip;
+		uint64_t cost = 0;
+		while (target < t->resident_mip) {
+			cost = _get_level_bytes(*t, target) - current;
+			if (_evict_until_fits(p_frame, cost, evictable, next_evict, r_evictions)) {
+				break;
+			}
+			target++;
+		}
+
+		if (target >= t->resident_mip) {
+			continue;
+		}
+
+		t->pending_mip = target;
+		t->pending_bytes = cost;
+		pending_bytes += cost;
+
+		Operation op;
+		op.texture = wanted[i].id;
+		op.mip = target;
+		r_loads.push_back(op);
+	}
+}
+
+void TextureStreamingResidency::set_budget(uint64_t p_bytes) {
+	budget = p_bytes;
+}
+
+uint64_t TextureStreamingResidency::get_budget() const {
+	return budget;
+}
+
+void TextureStreamingResidency::set_max_loads_per_update(int p_loads) {
+	ERR_FAIL_COND(p_loads < 1);
+	max_loads_per_update = p_loads;
+}
+
+int TextureStreamingResidency::get_max_loads_per_update() const {
+	return max_loads_per_update;
+}
+
+uint64_t TextureStreamingResidency::get_resident_bytes() const {
+	return resident_bytes;
+}
+
+uint64_t TextureStreamingResidency::get_pending_bytes() const {
+	return pending_bytes;
+}
+
+int TextureStreamingResidency::get_texture_count() const {
+	return textures.size();
+}
@@ -0,0 +1,130 @@
+/*************************************************************************/
+/*  texture_streaming.h                                                  */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEXTURE_STREAMING_H
+#define TEXTURE_STREAMING_H
+
+#include "core/hash_map.h"
+#include "core/local_vector.h"
+#include "core/vector.h"
+
+// Decides which mip levels of streamed textures should be resident.
+// It only does the bookkeeping: the caller reports what the renderer needs,
+// performs the loads and evictions it is told about, and reports back when
+// a load finished. Mip levels are counted from the full size image (0) down,
+// so a texture with resident mip 2 has levels 2 and coarser in memory.
+class TextureStreamingResidency {
+public:
+	struct Operation {
+		uint64_t texture;
+		int mip;
+	};
+
+private:
+	struct Texture {
+		LocalVector<uint64_t> mip_sizes;
+		int base_mip = 0; // Coarsest level set, always resident.
+		int min_mip = 0; // Finest level that may be loaded.
+		int resident_mip = 0;
+		int requested_mip = 0;
+		int pending_mip = -1;
+		uint64_t pending_bytes = 0;
+		uint64_t last_used = 0;
+	};
+
+	struct LoadSort {
+		const Texture *texture;
+		uint64_t id;
+
+		bool operator<(const LoadSort &p_other) const {
+			int gap = texture->resident_mip - texture->requested_mip;
+			int other_gap = p_other.texture->resident_mip - p_other.texture->requested_mip;
+			if (gap != other_gap) {
+				return gap > other_gap;
+			}
+			return id < p_other.id;
+		}
+	};
+
+	struct EvictSort {
+		const Texture *texture;
+		uint64_t id;
+
+		bool operator<(const EvictSort &p_other) const {
+			if (texture->last_used != p_other.texture->last_used) {
+				return texture->last_used < p_other.texture->last_used;
+			}
+			return id < p_other.id;
+		}
+	};
+
+	HashMap<uint64_t, Texture> textures;
+	uint64_t budget = 0;
+	uint64_t resident_bytes = 0;
+	uint64_t pending_bytes = 0;
+	int max_loads_per_update = 4;
+
+	static uint64_t _get_level_bytes(const Texture &p_texture, int p_mip);
+	bool _evict_until_fits(uint64_t p_frame, uint64_t p_needed, LocalVector<EvictSort> &p_candidates, uint32_t &r_next, Vector<Operation> &r_evictions);
+
+public:
+	// p_mip_sizes holds the size in bytes of every level, p_base_mip is the
+	// level that was loaded up front and is never evicted.
+	void texture_add(uint64_t p_texture, const Vector<uint64_t> &p_mip_sizes, int p_base_mip);
+	void texture_remove(uint64_t p_texture);
+	bool has_texture(uint64_t p_texture) const;
+
+	// Renderer feedback: p_texture was drawn in p_frame and needs p_mip.
+	void texture_request(uint64_t p_texture, int p_mip, uint64_t p_frame);
+	void texture_loaded(uint64_t p_texture, int p_mip);
+	// The load could not be done, stop asking for finer levels.
+	void texture_load_failed(uint64_t p_texture);
+
+	int texture_get_resident_mip(uint64_t p_texture) const;
+	int texture_get_pending_mip(uint64_t p_texture) const;
+
+	// Emits the loads to start, most needed first, and the textures to drop
+	// back to their base mip, least recently used first, so that resident and
+	// in-flight data stays within the budget. Textures used in p_frame are
+	// never evicted.
+	void update(uint64_t p_frame, Vector<Operation> &r_loads, Vector<Operation> &r_evictions);
+
+	// Zero means no limit.
+	void set_budget(uint64_t p_bytes);
+	uint64_t get_budget() const;
+	void set_max_loads_per_update(int p_loads);
+	int get_max_loads_per_update() const;
+
+	uint64_t get_resident_bytes() const;
+	uint64_t get_pending_bytes() const;
+	int get_texture_count() const;
+};
+
+#endif // TEXTURE_STREAMING_H
@@ -93,6 +93,7 @@ SceneStringNames::SceneStringNames() {
 
 	_physics_process = StaticCString::create("_physics_process");
 	_process = StaticCString::create("_process");
+	_notification = StaticCString::create("_notification");
 
 	_enter_tree = StaticCString::create("_enter_tree");
 	_exit_tree = StaticCString::create("_exit_tree");
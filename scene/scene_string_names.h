@@ -113,6 +113,7 @@ public:
 
 	StringName _physics_process;
 	StringName _process;
+	StringName _notification;
 	StringName _enter_world;
 	StringName _exit_world;
 	StringName _enter_tree;
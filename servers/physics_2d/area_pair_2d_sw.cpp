@@ -67,6 +67,10 @@ bool AreaPair2DSW::setup(real_t p_step) {
 void AreaPair2DSW::solve(real_t p_step) {
 }
 
+Constraint2DSW::OrderKey AreaPair2DSW::get_order_key() const {
+	return OrderKey::from_pair(body->get_self(), body_shape, area->get_self(), area_shape);
+}
+
 AreaPair2DSW::AreaPair2DSW(Body2DSW *p_body, int p_body_shape, Area2DSW *p_area, int p_area_shape) {
 	body = p_body;
 	area = p_area;
@@ -132,6 +136,10 @@ bool Area2Pair2DSW::setup(real_t p_step) {
 void Area2Pair2DSW::solve(real_t p_step) {
 }
 
+Constraint2DSW::OrderKey Area2Pair2DSW::get_order_key() const {
+	return OrderKey::from_pair(area_a->get_self(), shape_a, area_b->get_self(), shape_b);
+}
+
 Area2Pair2DSW::Area2Pair2DSW(Area2DSW *p_area_a, int p_shape_a, Area2DSW *p_area_b, int p_shape_b) {
 	area_a = p_area_a;
 	area_b = p_area_b;
@@ -46,6 +46,8 @@ public:
 	bool setup(real_t p_step);
 	void solve(real_t p_step);
 
+	OrderKey get_order_key() const;
+
 	AreaPair2DSW(Body2DSW *p_body, int p_body_shape, Area2DSW *p_area, int p_area_shape);
 	~AreaPair2DSW();
 };
@@ -61,6 +63,8 @@ public:
 	bool setup(real_t p_step);
 	void solve(real_t p_step);
 
+	OrderKey get_order_key() const;
+
 	Area2Pair2DSW(Area2DSW *p_area_a, int p_shape_a, Area2DSW *p_area_b, int p_shape_b);
 	~Area2Pair2DSW();
 };
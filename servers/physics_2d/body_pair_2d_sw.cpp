@@ -499,8 +499,13 @@ void BodyPair2DSW::solve(real_t p_step) {
 	}
 }
 
+Constraint2DSW::OrderKey BodyPair2DSW::get_order_key() const {
+	return OrderKey::from_pair(A->get_self(), shape_A, B->get_self(), shape_B);
+}
+
 BodyPair2DSW::BodyPair2DSW(Body2DSW *p_A, int p_shape_A, Body2DSW *p_B, int p_shape_B) :
-		Constraint2DSW(_arr, 2) {
+		Constraint2DSW(_arr, 2),
+		pair_list(this) {
 	A = p_A;
 	B = p_B;
 	shape_A = p_shape_A;
@@ -508,6 +513,7 @@ BodyPair2DSW::BodyPair2DSW(Body2DSW *p_A, int p_shape_A, Body2DSW *p_B, int p_sh
 	space = A->get_space();
 	A->add_constraint(this, 0);
 	B->add_constraint(this, 1);
+	space->body_pair_add_to_list(&pair_list);
 	contact_count = 0;
 	collided = false;
 	oneway_disabled = false;
@@ -516,4 +522,5 @@ BodyPair2DSW::BodyPair2DSW(Body2DSW *p_A, int p_shape_A, Body2DSW *p_B, int p_sh
 BodyPair2DSW::~BodyPair2DSW() {
 	A->remove_constraint(this);
 	B->remove_constraint(this);
+	space->body_pair_remove_from_list(&pair_list);
 }
@@ -78,6 +78,10 @@ class BodyPair2DSW : public Constraint2DSW {
 	bool oneway_disabled;
 	int cc;
 
+	SelfList<BodyPair2DSW> pair_list;
+
+	friend class Space2DSW; // state snapshots and statistics
+
 	bool _test_ccd(real_t p_step, Body2DSW *p_A, int p_shape_A, const Transform2D &p_xform_A, Body2DSW *p_B, int p_shape_B, const Transform2D &p_xform_B, bool p_swap_result = false);
 	void _validate_contacts();
 	static void _add_contact(const Vector2 &p_point_A, const Vector2 &p_point_B, void *p_self);
@@ -87,6 +91,8 @@ public:
 	bool setup(real_t p_step);
 	void solve(real_t p_step);
 
+	OrderKey get_order_key() const;
+
 	BodyPair2DSW(Body2DSW *p_A, int p_shape_A, Body2DSW *p_B, int p_shape_B);
 	~BodyPair2DSW();
 };
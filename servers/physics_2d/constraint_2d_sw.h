@@ -52,6 +52,37 @@ protected:
 	}
 
 public:
+	// Identifies a constraint independently of where it lives in memory. Islands are solved
+	// in this order, so a step gives the same result after pairs are recreated.
+	struct OrderKey {
+		uint64_t ids[2] = { 0, 0 };
+		int shapes[2] = { 0, 0 };
+
+		// Pairs may be created with their objects in either order.
+		static _FORCE_INLINE_ OrderKey from_pair(const RID &p_a, int p_shape_a, const RID &p_b, int p_shape_b) {
+			OrderKey key;
+			bool swap = p_b.get_id() < p_a.get_id() || (p_b == p_a && p_shape_b < p_shape_a);
+			key.ids[0] = swap ? p_b.get_id() : p_a.get_id();
+			key.ids[1] = swap ? p_a.get_id() : p_b.get_id();
+			key.shapes[0] = swap ? p_shape_b : p_shape_a;
+			key.shapes[1] = swap ? p_shape_a : p_shape_b;
+			return key;
+		}
+
+		_FORCE_INLINE_ bool operator<(const OrderKey &p_key) const {
+			if (ids[0] != p_key.ids[0]) {
+				return ids[0] < p_key.ids[0];
+			}
+			if (ids[1] != p_key.ids[1]) {
+				return ids[1] < p_key.ids[1];
+			}
+			if (shapes[0] != p_key.shapes[0]) {
+				return shapes[0] < p_key.shapes[0];
+			}
+			return shapes[1] < p_key.shapes[1];
+		}
+	};
+
 	_FORCE_INLINE_ void set_self(const RID &p_self) { self = p_self; }
 	_FORCE_INLINE_ RID get_self() const { return self; }
 
@@ -70,6 +101,13 @@ public:
 	_FORCE_INLINE_ void disable_collisions_between_bodies(const bool p_disabled) { disabled_collisions_between_bodies = p_disabled; }
 	_FORCE_INLINE_ bool is_disabled_collisions_between_bodies() const { return disabled_collisions_between_bodies; }
 
+	// Joints are keyed by their RID, pairs override this with their bodies and shapes.
+	virtual OrderKey get_order_key() const {
+		OrderKey key;
+		key.ids[0] = self.get_id();
+		return key;
+	}
+
 	virtual bool setup(real_t p_step) = 0;
 	virtual void solve(real_t p_step) = 0;
 
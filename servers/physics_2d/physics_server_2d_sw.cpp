@@ -281,6 +281,19 @@ int PhysicsServer2DSW::space_get_contact_count(RID p_space) const {
 	return space->get_debug_contact_count();
 }
 
+Vector<uint8_t> PhysicsServer2DSW::space_get_state_snapshot(RID p_space) {
+	Space2DSW *space = space_owner.getornull(p_space);
+	ERR_FAIL_COND_V(!space, Vector<uint8_t>());
+	return space->get_state_snapshot();
+}
+
+Error PhysicsServer2DSW::space_set_state_snapshot(RID p_space, const Vector<uint8_t> &p_snapshot) {
+	Space2DSW *space = space_owner.getornull(p_space);
+	ERR_FAIL_COND_V(!space, ERR_INVALID_PARAMETER);
+	_update_shapes(); // pending shape changes must reach the broadphase before pairs are rebuilt
+	return space->set_state_snapshot(p_snapshot);
+}
+
 PhysicsDirectSpaceState2D *PhysicsServer2DSW::space_get_direct_state(RID p_space) {
 	Space2DSW *space = space_owner.getornull(p_space);
 	ERR_FAIL_COND_V(!space, nullptr);
@@ -77,6 +77,9 @@ class PhysicsServer2DSW : public PhysicsServer2D {
 	RID _shape_create(ShapeType p_shape);
 
 public:
+	// statistics for benchmarks, which link the built-in server directly
+	const Space2DSW *get_space(RID p_space) const { return space_owner.getornull(p_space); }
+
 	struct CollCbkData {
 		Vector2 valid_dir;
 		real_t valid_depth;
@@ -120,6 +123,9 @@ public:
 	virtual Vector<Vector2> space_get_contacts(RID p_space) const override;
 	virtual int space_get_contact_count(RID p_space) const override;
 
+	virtual Vector<uint8_t> space_get_state_snapshot(RID p_space) override;
+	virtual Error space_set_state_snapshot(RID p_space, const Vector<uint8_t> &p_snapshot) override;
+
 	// this function only works on physics process, errors and returns null otherwise
 	virtual PhysicsDirectSpaceState2D *space_get_direct_state(RID p_space) override;
 
@@ -41,6 +41,12 @@
 #else
 #define SYNC_DEBUG
 #endif
+#define SERVER_WAIT_CHECK(m_ret)
+#define SERVER_DIRECT_CALL
+#define SERVER_POOL_REFILL(m_allocn)                                     \
+	int ret;                                                             \
+	command_queue.push_and_ret(this, &ServerNameWrapMT::m_allocn, &ret); \
+	SYNC_DEBUG
 
 class PhysicsServer2DWrapMT : public PhysicsServer2D {
 	mutable PhysicsServer2D *physics_2d_server;
@@ -124,6 +130,16 @@ public:
 		return physics_2d_server->space_get_contact_count(p_space);
 	}
 
+	virtual Vector<uint8_t> space_get_state_snapshot(RID p_space) {
+		ERR_FAIL_COND_V(main_thread != Thread::get_caller_id(), Vector<uint8_t>());
+		return physics_2d_server->space_get_state_snapshot(p_space);
+	}
+
+	virtual Error space_set_state_snapshot(RID p_space, const Vector<uint8_t> &p_snapshot) {
+		ERR_FAIL_COND_V(main_thread != Thread::get_caller_id(), ERR_UNAVAILABLE);
+		return physics_2d_server->space_set_state_snapshot(p_space, p_snapshot);
+	}
+
 	/* AREA API */
 
 	//FUNC0RID(area);
@@ -336,5 +352,8 @@ public:
 #undef DEBUG_SYNC
 #endif
 #undef SYNC_DEBUG
+#undef SERVER_WAIT_CHECK
+#undef SERVER_DIRECT_CALL
+#undef SERVER_POOL_REFILL
 
 #endif // PHYSICS2DSERVERWRAPMT_H
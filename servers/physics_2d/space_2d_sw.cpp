@@ -50,7 +50,7 @@ _FORCE_INLINE_ static bool _can_collide_with(CollisionObject2DSW *p_object, uint
 	return true;
 }
 
-int PhysicsDirectSpaceState2DSW::_intersect_point_impl(const Vector2 &p_point, ShapeResult *r_results, int p_result_max, const Set<RID> &p_exclude, uint32_t p_collision_mask, bool p_collide_with_bodies, bool p_collide_with_areas, bool p_pick_point, bool p_filter_by_canvas, ObjectID p_canvas_instance_id) {
+int PhysicsDirectSpaceState2DSW::_intersect_point_impl(const Vector2 &p_point, ShapeResult *r_results, int p_result_max, const PhysicsQueryFilter &p_exclude, uint32_t p_collision_mask, bool p_collide_with_bodies, bool p_collide_with_areas, bool p_pick_point, bool p_filter_by_canvas, ObjectID p_canvas_instance_id) {
 	if (p_result_max <= 0) {
 		return 0;
 	}
@@ -68,7 +68,7 @@ int PhysicsDirectSpaceState2DSW::_intersect_point_impl(const Vector2 &p_point, S
 			continue;
 		}
 
-		if (p_exclude.has(space->intersection_query_results[i]->get_self())) {
+		if (p_exclude.is_excluded(space->intersection_query_results[i]->get_self(), space->intersection_query_results[i]->get_instance_id())) {
 			continue;
 		}
 
@@ -110,15 +110,15 @@ int PhysicsDirectSpaceState2DSW::_intersect_point_impl(const Vector2 &p_point, S
 	return cc;
 }
 
-int PhysicsDirectSpaceState2DSW::intersect_point(const Vector2 &p_point, ShapeResult *r_results, int p_result_max, const Set<RID> &p_exclude, uint32_t p_collision_mask, bool p_collide_with_bodies, bool p_collide_with_areas, bool p_pick_point) {
+int PhysicsDirectSpaceState2DSW::intersect_point(const Vector2 &p_point, ShapeResult *r_results, int p_result_max, const PhysicsQueryFilter &p_exclude, uint32_t p_collision_mask, bool p_collide_with_bodies, bool p_collide_with_areas, bool p_pick_point) {
 	return _intersect_point_impl(p_point, r_results, p_result_max, p_exclude, p_collision_mask, p_collide_with_bodies, p_collide_with_areas, p_pick_point);
 }
 
-int PhysicsDirectSpaceState2DSW::intersect_point_on_canvas(const Vector2 &p_point, ObjectID p_canvas_instance_id, ShapeResult *r_results, int p_result_max, const Set<RID> &p_exclude, uint32_t p_collision_mask, bool p_collide_with_bodies, bool p_collide_with_areas, bool p_pick_point) {
+int PhysicsDirectSpaceState2DSW::intersect_point_on_canvas(const Vector2 &p_point, ObjectID p_canvas_instance_id, ShapeResult *r_results, int p_result_max, const PhysicsQueryFilter &p_exclude, uint32_t p_collision_mask, bool p_collide_with_bodies, bool p_collide_with_areas, bool p_pick_point) {
 	return _intersect_point_impl(p_point, r_results, p_result_max, p_exclude, p_collision_mask, p_collide_with_bodies, p_collide_with_areas, p_pick_point, true, p_canvas_instance_id);
 }
 
-bool PhysicsDirectSpaceState2DSW::intersect_ray(const Vector2 &p_from, const Vector2 &p_to, RayResult &r_result, const Set<RID> &p_exclude, uint32_t p_collision_mask, bool p_collide_with_bodies, bool p_collide_with_areas) {
+bool PhysicsDirectSpaceState2DSW::intersect_ray(const Vector2 &p_from, const Vector2 &p_to, RayResult &r_result, const PhysicsQueryFilter &p_exclude, uint32_t p_collision_mask, bool p_collide_with_bodies, bool p_collide_with_areas) {
 	ERR_FAIL_COND_V(space->locked, false);
 
 	Vector2 begin, end;
@@ -142,7 +142,7 @@ bool PhysicsDirectSpaceState2DSW::intersect_ray(const Vector2 &p_from, const Vec
 			continue;
 		}
 
-		if (p_exclude.has(space->intersection_query_results[i]->get_self())) {
+		if (p_exclude.is_excluded(space->intersection_query_results[i]->get_self(), space->intersection_query_results[i]->get_instance_id())) {
 			continue;
 		}
 
@@ -198,7 +198,7 @@ bool PhysicsDirectSpaceState2DSW::intersect_ray(const Vector2 &p_from, const Vec
 	return true;
 }
 
-int PhysicsDirectSpaceState2DSW::intersect_shape(const RID &p_shape, const Transform2D &p_xform, const Vector2 &p_motion, real_t p_margin, ShapeResult *r_results, int p_result_max, const Set<RID> &p_exclude, uint32_t p_collision_mask, bool p_collide_with_bodies, bool p_collide_with_areas) {
+int PhysicsDirectSpaceState2DSW::intersect_shape(const RID &p_shape, const Transform2D &p_xform, const Vector2 &p_motion, real_t p_margin, ShapeResult *r_results, int p_result_max, const PhysicsQueryFilter &p_exclude, uint32_t p_collision_mask, bool p_collide_with_bodies, bool p_collide_with_areas) {
 	if (p_result_max <= 0) {
 		return 0;
 	}
@@ -222,7 +222,7 @@ int PhysicsDirectSpaceState2DSW::intersect_shape(const RID &p_shape, const Trans
 			continue;
 		}
 
-		if (p_exclude.has(space->intersection_query_results[i]->get_self())) {
+		if (p_exclude.is_excluded(space->intersection_query_results[i]->get_self(), space->intersection_query_results[i]->get_instance_id())) {
 			continue;
 		}
 
@@ -247,7 +247,7 @@ int PhysicsDirectSpaceState2DSW::intersect_shape(const RID &p_shape, const Trans
 	return cc;
 }
 
-bool PhysicsDirectSpaceState2DSW::cast_motion(const RID &p_shape, const Transform2D &p_xform, const Vector2 &p_motion, real_t p_margin, real_t &p_closest_safe, real_t &p_closest_unsafe, const Set<RID> &p_exclude, uint32_t p_collision_mask, bool p_collide_with_bodies, bool p_collide_with_areas) {
+bool PhysicsDirectSpaceState2DSW::cast_motion(const RID &p_shape, const Transform2D &p_xform, const Vector2 &p_motion, real_t p_margin, real_t &p_closest_safe, real_t &p_closest_unsafe, const PhysicsQueryFilter &p_exclude, uint32_t p_collision_mask, bool p_collide_with_bodies, bool p_collide_with_areas) {
 	Shape2DSW *shape = PhysicsServer2DSW::singletonsw->shape_owner.getornull(p_shape);
 	ERR_FAIL_COND_V(!shape, false);
 
@@ -265,7 +265,7 @@ bool PhysicsDirectSpaceState2DSW::cast_motion(const RID &p_shape, const Transfor
 			continue;
 		}
 
-		if (p_exclude.has(space->intersection_query_results[i]->get_self())) {
+		if (p_exclude.is_excluded(space->intersection_query_results[i]->get_self(), space->intersection_query_results[i]->get_instance_id())) {
 			continue; //ignore excluded
 		}
 
@@ -314,7 +314,7 @@ bool PhysicsDirectSpaceState2DSW::cast_motion(const RID &p_shape, const Transfor
 	return true;
 }
 
-bool PhysicsDirectSpaceState2DSW::collide_shape(RID p_shape, const Transform2D &p_shape_xform, const Vector2 &p_motion, real_t p_margin, Vector2 *r_results, int p_result_max, int &r_result_count, const Set<RID> &p_exclude, uint32_t p_collision_mask, bool p_collide_with_bodies, bool p_collide_with_areas) {
+bool PhysicsDirectSpaceState2DSW::collide_shape(RID p_shape, const Transform2D &p_shape_xform, const Vector2 &p_motion, real_t p_margin, Vector2 *r_results, int p_result_max, int &r_result_count, const PhysicsQueryFilter &p_exclude, uint32_t p_collision_mask, bool p_collide_with_bodies, bool p_collide_with_areas) {
 	if (p_result_max <= 0) {
 		return false;
 	}
@@ -348,7 +348,7 @@ bool PhysicsDirectSpaceState2DSW::collide_shape(RID p_shape, const Transform2D &
 		const CollisionObject2DSW *col_obj = space->intersection_query_results[i];
 		int shape_idx = space->intersection_query_subindex_results[i];
 
-		if (p_exclude.has(col_obj->get_self())) {
+		if (p_exclude.is_excluded(col_obj->get_self(), col_obj->get_instance_id())) {
 			continue;
 		}
 
@@ -411,7 +411,7 @@ static void _rest_cbk_result(const Vector2 &p_point_A, const Vector2 &p_point_B,
 	rd->best_local_shape = rd->local_shape;
 }
 
-bool PhysicsDirectSpaceState2DSW::rest_info(RID p_shape, const Transform2D &p_shape_xform, const Vector2 &p_motion, real_t p_margin, ShapeRestInfo *r_info, const Set<RID> &p_exclude, uint32_t p_collision_mask, bool p_collide_with_bodies, bool p_collide_with_areas) {
+bool PhysicsDirectSpaceState2DSW::rest_info(RID p_shape, const Transform2D &p_shape_xform, const Vector2 &p_motion, real_t p_margin, ShapeRestInfo *r_info, const PhysicsQueryFilter &p_exclude, uint32_t p_collision_mask, bool p_collide_with_bodies, bool p_collide_with_areas) {
 	Shape2DSW *shape = PhysicsServer2DSW::singletonsw->shape_owner.getornull(p_shape);
 	ERR_FAIL_COND_V(!shape, 0);
 
@@ -435,7 +435,7 @@ bool PhysicsDirectSpaceState2DSW::rest_info(RID p_shape, const Transform2D &p_sh
 		const CollisionObject2DSW *col_obj = space->intersection_query_results[i];
 		int shape_idx = space->intersection_query_subindex_results[i];
 
-		if (p_exclude.has(col_obj->get_self())) {
+		if (p_exclude.is_excluded(col_obj->get_self(), col_obj->get_instance_id())) {
 			continue;
 		}
 
@@ -1157,6 +1157,14 @@ void Space2DSW::_broadphase_unpair(CollisionObject2DSW *A, int p_subindex_A, Col
 	memdelete(c);
 }
 
+void Space2DSW::body_pair_add_to_list(SelfList<BodyPair2DSW> *p_pair) {
+	body_pair_list.add(p_pair);
+}
+
+void Space2DSW::body_pair_remove_from_list(SelfList<BodyPair2DSW> *p_pair) {
+	body_pair_list.remove(p_pair);
+}
+
 const SelfList<Body2DSW>::List &Space2DSW::get_active_body_list() const {
 	return active_list;
 }
@@ -1317,6 +1325,388 @@ PhysicsDirectSpaceState2DSW *Space2DSW::get_direct_state() {
 	return direct_access;
 }
 
+/* STATE SNAPSHOTS */
+
+// Snapshots are meant for rollback inside the same process, so values are stored in
+// native layout. Bodies are keyed by RID and pairs by their bodies and shapes, which keeps
+// the blob independent of allocation order.
+
+#define SNAPSHOT_MAGIC 0x32535350 // "PSS2"
+#define SNAPSHOT_VERSION 1
+
+template <class T>
+static _FORCE_INLINE_ void _snapshot_write(uint8_t *&r_ptr, const T &p_value) {
+	memcpy(r_ptr, &p_value, sizeof(T));
+	r_ptr += sizeof(T);
+}
+
+template <class T>
+static _FORCE_INLINE_ void _snapshot_read(const uint8_t *&r_ptr, T &r_value) {
+	memcpy(&r_value, r_ptr, sizeof(T));
+	r_ptr += sizeof(T);
+}
+
+struct _SnapshotBodySort {
+	_FORCE_INLINE_ bool operator()(const Body2DSW *p_a, const Body2DSW *p_b) const {
+		return p_a->get_self() < p_b->get_self();
+	}
+};
+
+enum {
+	SNAPSHOT_HEADER_SIZE = sizeof(uint32_t) * 6,
+	SNAPSHOT_BODY_SIZE = sizeof(uint64_t) + sizeof(Transform2D) * 2 + sizeof(Vector2) * 2 + sizeof(real_t) * 3 + sizeof(uint8_t),
+	SNAPSHOT_PAIR_SIZE = (sizeof(uint64_t) + sizeof(uint32_t)) * 2 + sizeof(Vector2) + sizeof(uint8_t) + sizeof(uint32_t),
+	SNAPSHOT_CONTACT_SIZE = sizeof(Vector2) * 3 + sizeof(real_t) * 3 + sizeof(uint8_t),
+};
+
+enum {
+	SNAPSHOT_BODY_ACTIVE = 1,
+	SNAPSHOT_BODY_FIRST_INTEGRATION = 2,
+	SNAPSHOT_BODY_FIRST_TIME_KINEMATIC = 4,
+};
+
+int Space2DSW::get_contact_count() const {
+	int count = 0;
+	for (const SelfList<BodyPair2DSW> *E = body_pair_list.first(); E; E = E->next()) {
+		count += E->self()->contact_count;
+	}
+	return count;
+}
+
+void Space2DSW::_snapshot_gather() {
+	snapshot_bodies.clear();
+	for (Set<CollisionObject2DSW *>::Element *E = objects.front(); E; E = E->next()) {
+		if (E->get()->get_type() == CollisionObject2DSW::TYPE_BODY) {
+			snapshot_bodies.push_back(static_cast<Body2DSW *>(E->get()));
+		}
+	}
+	snapshot_bodies.sort_custom<_SnapshotBodySort>();
+
+	snapshot_pairs.clear();
+	for (SelfList<BodyPair2DSW> *E = body_pair_list.first(); E; E = E->next()) {
+		BodyPair2DSW *pair = E->self();
+		SnapshotPair sp;
+		sp.A = pair->A->get_self();
+		sp.shape_A = pair->shape_A;
+		sp.B = pair->B->get_self();
+		sp.shape_B = pair->shape_B;
+		sp.pair = pair;
+		snapshot_pairs.push_back(sp);
+	}
+	snapshot_pairs.sort();
+}
+
+Vector<uint8_t> Space2DSW::get_state_snapshot() {
+	ERR_FAIL_COND_V_MSG(locked, Vector<uint8_t>(), "Can't take a snapshot of a space while it is being stepped.");
+
+	solve_in_order = true;
+
+	_snapshot_gather();
+
+	uint32_t active_count = 0;
+	for (const SelfList<Body2DSW> *E = active_list.first(); E; E = E->next()) {
+		active_count++;
+	}
+
+	uint32_t size = SNAPSHOT_HEADER_SIZE;
+	size += snapshot_bodies.size() * SNAPSHOT_BODY_SIZE;
+	size += active_count * sizeof(uint32_t);
+	for (uint32_t i = 0; i < snapshot_pairs.size(); i++) {
+		size += SNAPSHOT_PAIR_SIZE + snapshot_pairs[i].pair->contact_count * SNAPSHOT_CONTACT_SIZE;
+	}
+
+	Vector<uint8_t> snapshot;
+	snapshot.resize(size);
+	uint8_t *w = snapshot.ptrw();
+
+	_snapshot_write<uint32_t>(w, SNAPSHOT_MAGIC);
+	_snapshot_write<uint32_t>(w, SNAPSHOT_VERSION);
+	_snapshot_write<uint32_t>(w, sizeof(real_t));
+	_snapshot_write<uint32_t>(w, snapshot_bodies.size());
+	_snapshot_write<uint32_t>(w, active_count);
+	_snapshot_write<uint32_t>(w, snapshot_pairs.size());
+
+	for (uint32_t i = 0; i < snapshot_bodies.size(); i++) {
+		const Body2DSW *body = snapshot_bodies[i];
+		uint8_t flags = 0;
+		if (body->active) {
+			flags |= SNAPSHOT_BODY_ACTIVE;
+		}
+		if (body->first_integration) {
+			flags |= SNAPSHOT_BODY_FIRST_INTEGRATION;
+		}
+		if (body->first_time_kinematic) {
+			flags |= SNAPSHOT_BODY_FIRST_TIME_KINEMATIC;
+		}
+
+		_snapshot_write<uint64_t>(w, body->get_self().get_id());
+		_snapshot_write(w, body->get_transform());
+		_snapshot_write(w, body->new_transform);
+		_snapshot_write(w, body->linear_velocity);
+		_snapshot_write(w, body->angular_velocity);
+		_snapshot_write(w, body->applied_force);
+		_snapshot_write(w, body->applied_torque);
+		_snapshot_write(w, body->still_time);
+		_snapshot_write(w, flags);
+	}
+
+	// The active list order decides integration and island order, so it is part of the state.
+	for (const SelfList<Body2DSW> *E = active_list.first(); E; E = E->next()) {
+		uint32_t index = 0;
+		uint32_t count = snapshot_bodies.size();
+		while (count > 0) { // Binary search, bodies are sorted by RID.
+			uint32_t half = count / 2;
+			if (snapshot_bodies[index + half]->get_self() < E->self()->get_self()) {
+				index += half + 1;
+				count -= half + 1;
+			} else {
+				count = half;
+			}
+		}
+		_snapshot_write<uint32_t>(w, index);
+	}
+
+	for (uint32_t i = 0; i < snapshot_pairs.size(); i++) {
+		const SnapshotPair &sp = snapshot_pairs[i];
+		const BodyPair2DSW *pair = sp.pair;
+
+		_snapshot_write<uint64_t>(w, sp.A.get_id());
+		_snapshot_write<uint32_t>(w, sp.shape_A);
+		_snapshot_write<uint64_t>(w, sp.B.get_id());
+		_snapshot_write<uint32_t>(w, sp.shape_B);
+		_snapshot_write(w, pair->sep_axis);
+		_snapshot_write<uint8_t>(w, pair->oneway_disabled);
+		_snapshot_write<uint32_t>(w, pair->contact_count);
+
+		for (int j = 0; j < pair->contact_count; j++) {
+			const BodyPair2DSW::Contact &c = pair->contacts[j];
+			_snapshot_write(w, c.local_A);
+			_snapshot_write(w, c.local_B);
+			_snapshot_write(w, c.normal);
+			_snapshot_write(w, c.acc_normal_impulse);
+			_snapshot_write(w, c.acc_tangent_impulse);
+			_snapshot_write(w, c.acc_bias_impulse);
+			_snapshot_write<uint8_t>(w, c.reused);
+		}
+	}
+
+	CRASH_COND(w != snapshot.ptr() + size);
+
+	return snapshot;
+}
+
+// Walks the whole blob before anything is changed, so a corrupt snapshot can't leave
+// the space partially restored.
+bool Space2DSW::_snapshot_validate(const uint8_t *p_ptr, const uint8_t *p_end, uint32_t p_body_count, uint32_t p_active_count, uint32_t p_pair_count) {
+	if (p_end - p_ptr < (int64_t)p_body_count * SNAPSHOT_BODY_SIZE + (int64_t)p_active_count * (int64_t)sizeof(uint32_t)) {
+		return false;
+	}
+	p_ptr += p_body_count * SNAPSHOT_BODY_SIZE;
+
+	for (uint32_t i = 0; i < p_active_count; i++) {
+		uint32_t index;
+		_snapshot_read(p_ptr, index);
+		if (index >= p_body_count) {
+			return false;
+		}
+	}
+
+	for (uint32_t i = 0; i < p_pair_count; i++) {
+		if (p_end - p_ptr < SNAPSHOT_PAIR_SIZE) {
+			return false;
+		}
+		p_ptr += SNAPSHOT_PAIR_SIZE - sizeof(uint32_t);
+
+		uint32_t contact_count;
+		_snapshot_read(p_ptr, contact_count);
+		if (contact_count > BodyPair2DSW::MAX_CONTACTS || p_end - p_ptr < (int64_t)contact_count * SNAPSHOT_CONTACT_SIZE) {
+			return false;
+		}
+		p_ptr += contact_count * SNAPSHOT_CONTACT_SIZE;
+	}
+
+	return p_ptr == p_end;
+}
+
+Error Space2DSW::set_state_snapshot(const Vector<uint8_t> &p_snapshot) {
+	ERR_FAIL_COND_V_MSG(locked, ERR_LOCKED, "Can't restore a snapshot while the space is being stepped.");
+	ERR_FAIL_COND_V(p_snapshot.size() < SNAPSHOT_HEADER_SIZE, ERR_INVALID_DATA);
+
+	solve_in_order = true;
+
+	const uint8_t *r = p_snapshot.ptr();
+	const uint8_t *end = r + p_snapshot.size();
+
+	uint32_t magic, version, real_size, body_count, active_count, pair_count;
+	_snapshot_read(r, magic);
+	_snapshot_read(r, version);
+	_snapshot_read(r, real_size);
+	_snapshot_read(r, body_count);
+	_snapshot_read(r, active_count);
+	_snapshot_read(r, pair_count);
+
+	ERR_FAIL_COND_V_MSG(magic != SNAPSHOT_MAGIC || version != SNAPSHOT_VERSION, ERR_INVALID_DATA, "Invalid or incompatible physics space snapshot.");
+	ERR_FAIL_COND_V_MSG(real_size != sizeof(real_t), ERR_INVALID_DATA, "Physics space snapshot was taken with a different real_t precision.");
+	ERR_FAIL_COND_V_MSG(!_snapshot_validate(r, end, body_count, active_count, pair_count), ERR_INVALID_DATA, "Corrupt physics space snapshot.");
+
+	_snapshot_gather();
+
+	// Bodies, matched against the current ones by RID. Bodies created after the snapshot
+	// was taken are left as they are.
+
+	LocalVector<Body2DSW *> body_map;
+	body_map.resize(body_count);
+
+	uint32_t current = 0;
+	for (uint32_t i = 0; i < body_count; i++) {
+		uint64_t id;
+		Transform2D transform;
+		uint8_t flags;
+
+		_snapshot_read(r, id);
+		while (current < snapshot_bodies.size() && snapshot_bodies[current]->get_self().get_id() < id) {
+			current++;
+		}
+
+		if (current == snapshot_bodies.size() || snapshot_bodies[current]->get_self().get_id() != id) {
+			body_map[i] = nullptr; // Freed since the snapshot was taken.
+			r += SNAPSHOT_BODY_SIZE - sizeof(uint64_t);
+			continue;
+		}
+
+		Body2DSW *body = snapshot_bodies[current];
+		body_map[i] = body;
+
+		_snapshot_read(r, transform);
+		_snapshot_read(r, body->new_transform);
+		_snapshot_read(r, body->linear_velocity);
+		_snapshot_read(r, body->angular_velocity);
+		_snapshot_read(r, body->applied_force);
+		_snapshot_read(r, body->applied_torque);
+		_snapshot_read(r, body->still_time);
+		_snapshot_read(r, flags);
+
+		if (transform != body->get_transform()) {
+			body->_set_transform(transform);
+			body->_set_inv_transform(transform.affine_inverse());
+		}
+
+		body->first_integration = flags & SNAPSHOT_BODY_FIRST_INTEGRATION;
+		body->first_time_kinematic = flags & SNAPSHOT_BODY_FIRST_TIME_KINEMATIC;
+		body->active = false; // Re-added below, in the original order.
+		body->biased_linear_velocity = Vector2();
+		body->biased_angular_velocity = 0;
+	}
+
+	// Rebuild the active list: restored bodies first, in snapshot order, then any body
+	// that is unknown to the snapshot but currently active.
+
+	LocalVector<Body2DSW *> unknown_active;
+	while (active_list.first()) {
+		Body2DSW *body = active_list.first()->self();
+		if (body->active) {
+			unknown_active.push_back(body);
+		}
+		active_list.remove(active_list.first());
+	}
+
+	for (uint32_t i = 0; i < active_count; i++) {
+		uint32_t index;
+		_snapshot_read(r, index);
+		Body2DSW *body = body_map[index];
+		if (body && !body->active) {
+			body->active = true;
+			active_list.add_last(&body->active_list);
+		}
+	}
+
+	for (uint32_t i = 0; i < unknown_active.size(); i++) {
+		active_list.add_last(&unknown_active[i]->active_list);
+	}
+
+	// Let the broadphase create and remove pairs for the restored transforms, then bring
+	// back the contact caches used for warm starting.
+
+	broadphase->update();
+	_snapshot_gather();
+
+	for (uint32_t i = 0; i < snapshot_pairs.size(); i++) {
+		BodyPair2DSW *pair = snapshot_pairs[i].pair;
+		pair->contact_count = 0;
+		pair->sep_axis = Vector2();
+		pair->collided = false;
+		pair->oneway_disabled = false;
+	}
+
+	current = 0;
+	for (uint32_t i = 0; i < pair_count; i++) {
+		uint64_t id_A, id_B;
+		uint32_t shape_A, shape_B, contact_count;
+		Vector2 sep_axis;
+		uint8_t oneway_disabled;
+
+		_snapshot_read(r, id_A);
+		_snapshot_read(r, shape_A);
+		_snapshot_read(r, id_B);
+		_snapshot_read(r, shape_B);
+		_snapshot_read(r, sep_axis);
+		_snapshot_read(r, oneway_disabled);
+		_snapshot_read(r, contact_count);
+
+		while (current < snapshot_pairs.size()) {
+			const SnapshotPair &sp = snapshot_pairs[current];
+			if (sp.A.get_id() != id_A) {
+				if (sp.A.get_id() > id_A) {
+					break;
+				}
+			} else if (sp.shape_A != (int)shape_A) {
+				if (sp.shape_A > (int)shape_A) {
+					break;
+				}
+			} else if (sp.B.get_id() != id_B) {
+				if (sp.B.get_id() > id_B) {
+					break;
+				}
+			} else if (sp.shape_B >= (int)shape_B) {
+				break;
+			}
+			current++;
+		}
+
+		BodyPair2DSW *pair = nullptr;
+		if (current < snapshot_pairs.size()) {
+			const SnapshotPair &sp = snapshot_pairs[current];
+			if (sp.A.get_id() == id_A && sp.shape_A == (int)shape_A && sp.B.get_id() == id_B && sp.shape_B == (int)shape_B) {
+				pair = sp.pair;
+			}
+		}
+
+		if (!pair) {
+			r += contact_count * SNAPSHOT_CONTACT_SIZE;
+			continue;
+		}
+
+		pair->sep_axis = sep_axis;
+		pair->oneway_disabled = oneway_disabled;
+		pair->contact_count = contact_count;
+
+		for (uint32_t j = 0; j < contact_count; j++) {
+			BodyPair2DSW::Contact &c = pair->contacts[j];
+			_snapshot_read(r, c.local_A);
+			_snapshot_read(r, c.local_B);
+			uint8_t reused;
+			_snapshot_read(r, c.normal);
+			_snapshot_read(r, c.acc_normal_impulse);
+			_snapshot_read(r, c.acc_tangent_impulse);
+			_snapshot_read(r, c.acc_bias_impulse);
+			_snapshot_read(r, reused);
+			c.reused = reused;
+		}
+	}
+
+	return OK;
+}
+
 Space2DSW::Space2DSW() {
 	collision_pairs = 0;
 	active_objects = 0;
@@ -38,24 +38,25 @@
 #include "broad_phase_2d_sw.h"
 #include "collision_object_2d_sw.h"
 #include "core/hash_map.h"
+#include "core/local_vector.h"
 #include "core/project_settings.h"
 #include "core/typedefs.h"
 
 class PhysicsDirectSpaceState2DSW : public PhysicsDirectSpaceState2D {
 	GDCLASS(PhysicsDirectSpaceState2DSW, PhysicsDirectSpaceState2D);
 
-	int _intersect_point_impl(const Vector2 &p_point, ShapeResult *r_results, int p_result_max, const Set<RID> &p_exclude, uint32_t p_collision_mask, bool p_collide_with_bodies, bool p_collide_with_areas, bool p_pick_point, bool p_filter_by_canvas = false, ObjectID p_canvas_instance_id = ObjectID());
+	int _intersect_point_impl(const Vector2 &p_point, ShapeResult *r_results, int p_result_max, const PhysicsQueryFilter &p_exclude, uint32_t p_collision_mask, bool p_collide_with_bodies, bool p_collide_with_areas, bool p_pick_point, bool p_filter_by_canvas = false, ObjectID p_canvas_instance_id = ObjectID());
 
 public:
 	Space2DSW *space;
 
-	virtual int intersect_point(const Vector2 &p_point, ShapeResult *r_results, int p_result_max, const Set<RID> &p_exclude = Set<RID>(), uint32_t p_collision_mask = 0xFFFFFFFF, bool p_collide_with_bodies = true, bool p_collide_with_areas = false, bool p_pick_point = false) override;
-	virtual int intersect_point_on_canvas(const Vector2 &p_point, ObjectID p_canvas_instance_id, ShapeResult *r_results, int p_result_max, const Set<RID> &p_exclude = Set<RID>(), uint32_t p_collision_mask = 0xFFFFFFFF, bool p_collide_with_bodies = true, bool p_collide_with_areas = false, bool p_pick_point = false) override;
-	virtual bool intersect_ray(const Vector2 &p_from, const Vector2 &p_to, RayResult &r_result, const Set<RID> &p_exclude = Set<RID>(), uint32_t p_collision_mask = 0xFFFFFFFF, bool p_collide_with_bodies = true, bool p_collide_with_areas = false) override;
-	virtual int intersect_shape(const RID &p_shape, const Transform2D &p_xform, const Vector2 &p_motion, real_t p_margin, ShapeResult *r_results, int p_result_max, const Set<RID> &p_exclude = Set<RID>(), uint32_t p_collision_mask = 0xFFFFFFFF, bool p_collide_with_bodies = true, bool p_collide_with_areas = false) override;
-	virtual bool cast_motion(const RID &p_shape, const Transform2D &p_xform, const Vector2 &p_motion, real_t p_margin, real_t &p_closest_safe, real_t &p_closest_unsafe, const Set<RID> &p_exclude = Set<RID>(), uint32_t p_collision_mask = 0xFFFFFFFF, bool p_collide_with_bodies = true, bool p_collide_with_areas = false) override;
-	virtual bool collide_shape(RID p_shape, const Transform2D &p_shape_xform, const Vector2 &p_motion, real_t p_margin, Vector2 *r_results, int p_result_max, int &r_result_count, const Set<RID> &p_exclude = Set<RID>(), uint32_t p_collision_mask = 0xFFFFFFFF, bool p_collide_with_bodies = true, bool p_collide_with_areas = false) override;
-	virtual bool rest_info(RID p_shape, const Transform2D &p_shape_xform, const Vector2 &p_motion, real_t p_margin, ShapeRestInfo *r_info, const Set<RID> &p_exclude = Set<RID>(), uint32_t p_collision_mask = 0xFFFFFFFF, bool p_collide_with_bodies = true, bool p_collide_with_areas = false) override;
+	virtual int intersect_point(const Vector2 &p_point, ShapeResult *r_results, int p_result_max, const PhysicsQueryFilter &p_exclude = PhysicsQueryFilter(), uint32_t p_collision_mask = 0xFFFFFFFF, bool p_collide_with_bodies = true, bool p_collide_with_areas = false, bool p_pick_point = false) override;
+	virtual int intersect_point_on_canvas(const Vector2 &p_point, ObjectID p_canvas_instance_id, ShapeResult *r_results, int p_result_max, const PhysicsQueryFilter &p_exclude = PhysicsQueryFilter(), uint32_t p_collision_mask = 0xFFFFFFFF, bool p_collide_with_bodies = true, bool p_collide_with_areas = false, bool p_pick_point = false) override;
+	virtual bool intersect_ray(const Vector2 &p_from, const Vector2 &p_to, RayResult &r_result, const PhysicsQueryFilter &p_exclude = PhysicsQueryFilter(), uint32_t p_collision_mask = 0xFFFFFFFF, bool p_collide_with_bodies = true, bool p_collide_with_areas = false) override;
+	virtual int intersect_shape(const RID &p_shape, const Transform2D &p_xform, const Vector2 &p_motion, real_t p_margin, ShapeResult *r_results, int p_result_max, const PhysicsQueryFilter &p_exclude = PhysicsQueryFilter(), uint32_t p_collision_mask = 0xFFFFFFFF, bool p_collide_with_bodies = true, bool p_collide_with_areas = false) override;
+	virtual bool cast_motion(const RID &p_shape, const Transform2D &p_xform, const Vector2 &p_motion, real_t p_margin, real_t &p_closest_safe, real_t &p_closest_unsafe, const PhysicsQueryFilter &p_exclude = PhysicsQueryFilter(), uint32_t p_collision_mask = 0xFFFFFFFF, bool p_collide_with_bodies = true, bool p_collide_with_areas = false) override;
+	virtual bool collide_shape(RID p_shape, const Transform2D &p_shape_xform, const Vector2 &p_motion, real_t p_margin, Vector2 *r_results, int p_result_max, int &r_result_count, const PhysicsQueryFilter &p_exclude = PhysicsQueryFilter(), uint32_t p_collision_mask = 0xFFFFFFFF, bool p_collide_with_bodies = true, bool p_collide_with_areas = false) override;
+	virtual bool rest_info(RID p_shape, const Transform2D &p_shape_xform, const Vector2 &p_motion, real_t p_margin, ShapeRestInfo *r_info, const PhysicsQueryFilter &p_exclude = PhysicsQueryFilter(), uint32_t p_collision_mask = 0xFFFFFFFF, bool p_collide_with_bodies = true, bool p_collide_with_areas = false) override;
 
 	PhysicsDirectSpaceState2DSW();
 };
@@ -90,6 +91,7 @@ private:
 	SelfList<Body2DSW>::List state_query_list;
 	SelfList<Area2DSW>::List monitor_query_list;
 	SelfList<Area2DSW>::List area_moved_list;
+	SelfList<BodyPair2DSW>::List body_pair_list;
 
 	static void *_broadphase_pair(CollisionObject2DSW *A, int p_subindex_A, CollisionObject2DSW *B, int p_subindex_B, void *p_self);
 	static void _broadphase_unpair(CollisionObject2DSW *A, int p_subindex_A, CollisionObject2DSW *B, int p_subindex_B, void *p_data, void *p_self);
@@ -124,6 +126,37 @@ private:
 
 	int _cull_aabb_for_body(Body2DSW *p_body, const Rect2 &p_aabb);
 
+	struct SnapshotPair {
+		RID A;
+		int shape_A;
+		RID B;
+		int shape_B;
+		BodyPair2DSW *pair;
+
+		_FORCE_INLINE_ bool operator<(const SnapshotPair &p_pair) const {
+			if (A != p_pair.A) {
+				return A < p_pair.A;
+			}
+			if (shape_A != p_pair.shape_A) {
+				return shape_A < p_pair.shape_A;
+			}
+			if (B != p_pair.B) {
+				return B < p_pair.B;
+			}
+			return shape_B < p_pair.shape_B;
+		}
+	};
+
+	// Set once snapshots are used. Constraints are then solved in a stable order,
+	// which re-simulating from a snapshot relies on but other spaces don't need.
+	bool solve_in_order = false;
+
+	LocalVector<Body2DSW *> snapshot_bodies;
+	LocalVector<SnapshotPair> snapshot_pairs;
+
+	void _snapshot_gather();
+	static bool _snapshot_validate(const uint8_t *p_ptr, const uint8_t *p_end, uint32_t p_body_count, uint32_t p_active_count, uint32_t p_pair_count);
+
 	Vector<Vector2> contact_debug;
 	int contact_debug_count;
 
@@ -145,6 +178,9 @@ public:
 	void area_remove_from_moved_list(SelfList<Area2DSW> *p_area);
 	const SelfList<Area2DSW>::List &get_moved_area_list() const;
 
+	void body_pair_add_to_list(SelfList<BodyPair2DSW> *p_pair);
+	void body_pair_remove_from_list(SelfList<BodyPair2DSW> *p_pair);
+
 	void body_add_to_state_query_list(SelfList<Body2DSW> *p_body);
 	void body_remove_from_state_query_list(SelfList<Body2DSW> *p_body);
 
@@ -183,8 +219,14 @@ public:
 	int get_active_objects() const { return active_objects; }
 
 	int get_collision_pairs() const { return collision_pairs; }
+	int get_contact_count() const;
 
 	bool test_body_motion(Body2DSW *p_body, const Transform2D &p_from, const Vector2 &p_motion, bool p_infinite_inertia, real_t p_margin, PhysicsServer2D::MotionResult *r_result, bool p_exclude_raycast_shapes = true);
+
+	_FORCE_INLINE_ bool is_solving_in_order() const { return solve_in_order; }
+
+	Vector<uint8_t> get_state_snapshot();
+	Error set_state_snapshot(const Vector<uint8_t> &p_snapshot);
 	int test_body_ray_separation(Body2DSW *p_body, const Transform2D &p_transform, bool p_infinite_inertia, Vector2 &r_recover_motion, PhysicsServer2D::SeparationResult *r_results, int p_result_max, real_t p_margin);
 
 	void set_debug_contacts(int p_amount) { contact_debug.resize(p_amount); }
@@ -58,6 +58,30 @@ void Step2DSW::_populate_island(Body2DSW *p_body, Body2DSW **p_island, Constrain
 	}
 }
 
+Constraint2DSW *Step2DSW::_sort_island(Constraint2DSW *p_island) {
+	// Islands are discovered through maps keyed by pointer, so their order depends on
+	// allocation. Sort them by a stable key to keep stepping deterministic.
+	sorted_constraints.clear();
+	for (Constraint2DSW *c = p_island; c; c = c->get_island_next()) {
+		SortedConstraint sc;
+		sc.key = c->get_order_key();
+		sc.constraint = c;
+		sorted_constraints.push_back(sc);
+	}
+
+	if (sorted_constraints.size() < 2) {
+		return p_island;
+	}
+
+	sorted_constraints.sort();
+
+	for (uint32_t i = 0; i < sorted_constraints.size(); i++) {
+		sorted_constraints[i].constraint->set_island_next(i + 1 < sorted_constraints.size() ? sorted_constraints[i + 1].constraint : nullptr);
+	}
+
+	return sorted_constraints[0].constraint;
+}
+
 bool Step2DSW::_setup_island(Constraint2DSW *p_island, real_t p_delta) {
 	Constraint2DSW *ci = p_island;
 	Constraint2DSW *prev_ci = nullptr;
@@ -172,6 +196,9 @@ void Step2DSW::step(Space2DSW *p_space, real_t p_delta, int p_iterations) {
 			Body2DSW *island = nullptr;
 			Constraint2DSW *constraint_island = nullptr;
 			_populate_island(body, &island, &constraint_island);
+			if (p_space->is_solving_in_order()) {
+				constraint_island = _sort_island(constraint_island);
+			}
 
 			island->set_island_list_next(island_list);
 			island_list = island;
@@ -189,6 +216,8 @@ void Step2DSW::step(Space2DSW *p_space, real_t p_delta, int p_iterations) {
 
 	const SelfList<Area2DSW>::List &aml = p_space->get_moved_area_list();
 
+	const bool in_order = p_space->is_solving_in_order();
+	sorted_constraints.clear();
 	while (aml.first()) {
 		for (const Set<Constraint2DSW *>::Element *E = aml.first()->self()->get_constraints().front(); E; E = E->next()) {
 			Constraint2DSW *c = E->get();
@@ -197,12 +226,27 @@ void Step2DSW::step(Space2DSW *p_space, real_t p_delta, int p_iterations) {
 			}
 			c->set_island_step(_step);
 			c->set_island_next(nullptr);
-			c->set_island_list_next(constraint_island_list);
-			constraint_island_list = c;
+			if (in_order) {
+				SortedConstraint sc;
+				sc.key = c->get_order_key();
+				sc.constraint = c;
+				sorted_constraints.push_back(sc);
+			} else {
+				c->set_island_list_next(constraint_island_list);
+				constraint_island_list = c;
+			}
 		}
 		p_space->area_remove_from_moved_list((SelfList<Area2DSW> *)aml.first()); //faster to remove here
 	}
 
+	// Area pairs are set up in order too, as that decides how overlapping areas combine.
+	sorted_constraints.sort();
+	for (int i = sorted_constraints.size() - 1; i >= 0; i--) {
+		Constraint2DSW *c = sorted_constraints[i].constraint;
+		c->set_island_list_next(constraint_island_list);
+		constraint_island_list = c;
+	}
+
 	{ //profile
 		profile_endtime = OS::get_singleton()->get_ticks_usec();
 		p_space->set_elapsed_time(Space2DSW::ELAPSED_TIME_GENERATE_ISLANDS, profile_endtime - profile_begtime);
@@ -36,7 +36,17 @@
 class Step2DSW {
 	uint64_t _step;
 
+	struct SortedConstraint {
+		Constraint2DSW::OrderKey key;
+		Constraint2DSW *constraint;
+
+		_FORCE_INLINE_ bool operator<(const SortedConstraint &p_other) const { return key < p_other.key; }
+	};
+
+	LocalVector<SortedConstraint> sorted_constraints;
+
 	void _populate_island(Body2DSW *p_body, Body2DSW **p_island, Constraint2DSW **p_constraint_island);
+	Constraint2DSW *_sort_island(Constraint2DSW *p_island);
 	bool _setup_island(Constraint2DSW *p_island, real_t p_delta);
 	void _solve_island(Constraint2DSW *p_island, int p_iterations, real_t p_delta);
 	void _check_suspend(Body2DSW *p_island, real_t p_delta);
@@ -46,6 +46,8 @@ public:
 	bool setup(real_t p_step);
 	void solve(real_t p_step);
 
+	OrderKey get_order_key() const;
+
 	AreaPair3DSW(Body3DSW *p_body, int p_body_shape, Area3DSW *p_area, int p_area_shape);
 	~AreaPair3DSW();
 };
@@ -61,6 +63,8 @@ public:
 	bool setup(real_t p_step);
 	void solve(real_t p_step);
 
+	OrderKey get_order_key() const;
+
 	Area2Pair3DSW(Area3DSW *p_area_a, int p_shape_a, Area3DSW *p_area_b, int p_shape_b);
 	~Area2Pair3DSW();
 };
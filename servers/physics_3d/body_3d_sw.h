@@ -135,14 +135,17 @@ class Body3DSW : public CollisionObject3DSW {
 	ForceIntegrationCallback *fi_callback;
 
 	uint64_t island_step;
+	uint64_t contact_solver_pass = 0;
+	uint32_t contact_solver_index = 0;
 	Body3DSW *island_next;
 	Body3DSW *island_list_next;
 
 	_FORCE_INLINE_ void _compute_area_gravity_and_dampenings(const Area3DSW *p_area);
 
-	_FORCE_INLINE_ void _update_transform_dependant();
+	void _update_transform_dependant();
 
 	friend class PhysicsDirectBodyState3DSW; // i give up, too many functions to expose
+	friend class Space3DSW; // state snapshots
 
 public:
 	void set_force_integration_callback(ObjectID p_id, const StringName &p_method, const Variant &p_udata = Variant());
@@ -189,6 +192,12 @@ public:
 	_FORCE_INLINE_ uint64_t get_island_step() const { return island_step; }
 	_FORCE_INLINE_ void set_island_step(uint64_t p_step) { island_step = p_step; }
 
+	_FORCE_INLINE_ uint64_t get_contact_solver_pass() const { return contact_solver_pass; }
+	_FORCE_INLINE_ void set_contact_solver_pass(uint64_t p_pass) { contact_solver_pass = p_pass; }
+
+	_FORCE_INLINE_ uint32_t get_contact_solver_index() const { return contact_solver_index; }
+	_FORCE_INLINE_ void set_contact_solver_index(uint32_t p_index) { contact_solver_index = p_index; }
+
 	_FORCE_INLINE_ Body3DSW *get_island_next() const { return island_next; }
 	_FORCE_INLINE_ void set_island_next(Body3DSW *p_next) { island_next = p_next; }
 
@@ -213,7 +222,10 @@ public:
 	_FORCE_INLINE_ void set_angular_velocity(const Vector3 &p_velocity) { angular_velocity = p_velocity; }
 	_FORCE_INLINE_ Vector3 get_angular_velocity() const { return angular_velocity; }
 
+	_FORCE_INLINE_ void set_biased_linear_velocity(const Vector3 &p_velocity) { biased_linear_velocity = p_velocity; }
 	_FORCE_INLINE_ const Vector3 &get_biased_linear_velocity() const { return biased_linear_velocity; }
+
+	_FORCE_INLINE_ void set_biased_angular_velocity(const Vector3 &p_velocity) { biased_angular_velocity = p_velocity; }
 	_FORCE_INLINE_ const Vector3 &get_biased_angular_velocity() const { return biased_angular_velocity; }
 
 	_FORCE_INLINE_ void apply_central_impulse(const Vector3 &p_impulse) {
@@ -31,6 +31,7 @@
 #include "body_pair_3d_sw.h"
 
 #include "collision_solver_3d_sw.h"
+#include "contact_solver_3d_sw.h"
 #include "core/os/os.h"
 #include "space_3d_sw.h"
 
@@ -367,8 +368,8 @@ void BodyPair3DSW::solve(real_t p_step) {
 
 			Vector3 jb = c.normal * (c.acc_bias_impulse - jbnOld);
 
-			A->apply_bias_impulse(c.rA + A->get_center_of_mass(), -jb, MAX_BIAS_ROTATION / p_step);
-			B->apply_bias_impulse(c.rB + B->get_center_of_mass(), jb, MAX_BIAS_ROTATION / p_step);
+			A->apply_bias_impulse(-jb, c.rA + A->get_center_of_mass(), MAX_BIAS_ROTATION / p_step);
+			B->apply_bias_impulse(jb, c.rB + B->get_center_of_mass(), MAX_BIAS_ROTATION / p_step);
 
 			crbA = A->get_biased_angular_velocity().cross(c.rA);
 			crbB = B->get_biased_angular_velocity().cross(c.rB);
@@ -383,8 +384,8 @@ void BodyPair3DSW::solve(real_t p_step) {
 
 				Vector3 jb_com = c.normal * (c.acc_bias_impulse_center_of_mass - jbnOld_com);
 
-				A->apply_bias_impulse(A->get_center_of_mass(), -jb_com, 0.0f);
-				B->apply_bias_impulse(B->get_center_of_mass(), jb_com, 0.0f);
+				A->apply_bias_impulse(-jb_com, A->get_center_of_mass(), 0.0f);
+				B->apply_bias_impulse(jb_com, B->get_center_of_mass(), 0.0f);
 			}
 
 			c.active = true;
@@ -455,8 +456,18 @@ void BodyPair3DSW::solve(real_t p_step) {
 	}
 }
 
+bool BodyPair3DSW::add_to_contact_solver(ContactSolver3DSW *p_solver) {
+	p_solver->add_body_pair(this);
+	return true;
+}
+
+Constraint3DSW::OrderKey BodyPair3DSW::get_order_key() const {
+	return OrderKey::from_pair(A->get_self(), shape_A, B->get_self(), shape_B);
+}
+
 BodyPair3DSW::BodyPair3DSW(Body3DSW *p_A, int p_shape_A, Body3DSW *p_B, int p_shape_B) :
-		Constraint3DSW(_arr, 2) {
+		Constraint3DSW(_arr, 2),
+		pair_list(this) {
 	A = p_A;
 	B = p_B;
 	shape_A = p_shape_A;
@@ -464,6 +475,7 @@ BodyPair3DSW::BodyPair3DSW(Body3DSW *p_A, int p_shape_A, Body3DSW *p_B, int p_sh
 	space = A->get_space();
 	A->add_constraint(this, 0);
 	B->add_constraint(this, 1);
+	space->body_pair_add_to_list(&pair_list);
 	contact_count = 0;
 	collided = false;
 }
@@ -471,4 +483,5 @@ BodyPair3DSW::BodyPair3DSW(Body3DSW *p_A, int p_shape_A, Body3DSW *p_B, int p_sh
 BodyPair3DSW::~BodyPair3DSW() {
 	A->remove_constraint(this);
 	B->remove_constraint(this);
+	space->body_pair_remove_from_list(&pair_list);
 }
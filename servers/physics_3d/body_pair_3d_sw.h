@@ -84,11 +84,19 @@ class BodyPair3DSW : public Constraint3DSW {
 	bool _test_ccd(real_t p_step, Body3DSW *p_A, int p_shape_A, const Transform &p_xform_A, Body3DSW *p_B, int p_shape_B, const Transform &p_xform_B);
 
 	Space3DSW *space;
+	SelfList<BodyPair3DSW> pair_list;
+
+	friend class Space3DSW; // state snapshots and statistics
+	friend class ContactSolver3DSW;
 
 public:
 	bool setup(real_t p_step);
 	void solve(real_t p_step);
 
+	bool add_to_contact_solver(ContactSolver3DSW *p_solver);
+
+	OrderKey get_order_key() const;
+
 	BodyPair3DSW(Body3DSW *p_A, int p_shape_A, Body3DSW *p_B, int p_shape_B);
 	~BodyPair3DSW();
 };
@@ -322,6 +322,10 @@ public:
 
 		if (min_B > 0.0 || max_B < 0.0) {
 			separator_axis = axis;
+			if (callback && callback->prev_axis) {
+				// a persistent pair that is still apart will exit on this axis next time
+				*callback->prev_axis = axis;
+			}
 			return false; // doesn't contain 0
 		}
 
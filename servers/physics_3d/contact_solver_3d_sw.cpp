@@ -0,0 +1,394 @@
+/*************************************************************************/
+/*  contact_solver_3d_sw.cpp                                             */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "contact_solver_3d_sw.h"
+
+#include "body_pair_3d_sw.h"
+
+#define MIN_VELOCITY 0.0001
+#define MAX_BIAS_ROTATION (Math_PI / 8)
+
+uint32_t ContactSolver3DSW::_get_body_index(Body3DSW *p_body) {
+	if (p_body->get_contact_solver_pass() == pass) {
+		return p_body->get_contact_solver_index();
+	}
+
+	SolverBody sb;
+	sb.body = p_body;
+	if (p_body->get_mode() > PhysicsServer3D::BODY_MODE_KINEMATIC) {
+		sb.inv_mass = p_body->get_inv_mass();
+		sb.inv_inertia_tensor = p_body->get_inv_inertia_tensor();
+	} else {
+		// Immovable bodies may appear in several lanes of a batch. They must come out of
+		// a solve unchanged, so they are scattered back without conflicts.
+		sb.inv_mass = 0;
+		sb.inv_inertia_tensor.set_zero();
+	}
+	sb.linear_velocity = p_body->get_linear_velocity();
+	sb.angular_velocity = p_body->get_angular_velocity();
+	sb.biased_linear_velocity = p_body->get_biased_linear_velocity();
+	sb.biased_angular_velocity = p_body->get_biased_angular_velocity();
+
+	uint32_t index = bodies.size();
+	bodies.push_back(sb);
+	p_body->set_contact_solver_pass(pass);
+	p_body->set_contact_solver_index(index);
+	return index;
+}
+
+void ContactSolver3DSW::begin(real_t p_step) {
+	pass++;
+	max_bias_rotation = MAX_BIAS_ROTATION / p_step;
+
+	bodies.clear();
+	contact_refs.clear();
+	batches.clear();
+
+	// Index 0 is an immovable body that padding lanes point to.
+	SolverBody padding;
+	padding.inv_mass = 0;
+	padding.inv_inertia_tensor.set_zero();
+	padding.body = nullptr;
+	bodies.push_back(padding);
+}
+
+void ContactSolver3DSW::add_body_pair(BodyPair3DSW *p_pair) {
+	if (!p_pair->collided) {
+		return;
+	}
+
+	uint32_t body_A = _get_body_index(p_pair->A);
+	uint32_t body_B = _get_body_index(p_pair->B);
+
+	for (int i = 0; i < p_pair->contact_count; i++) {
+		if (!p_pair->contacts[i].active) {
+			continue;
+		}
+
+		ContactRef ref;
+		ref.body_A = body_A;
+		ref.body_B = body_B;
+		ref.pair = p_pair;
+		ref.contact = i;
+		contact_refs.push_back(ref);
+	}
+}
+
+void ContactSolver3DSW::_build_batches() {
+	for (uint32_t i = 0; i < contact_refs.size(); i++) {
+		const ContactRef &ref = contact_refs[i];
+		const SolverBody &A = bodies[ref.body_A];
+		const SolverBody &B = bodies[ref.body_B];
+
+		// Only bodies that receive impulses must be unique within a batch.
+		bool dynamic_A = A.body->get_mode() > PhysicsServer3D::BODY_MODE_KINEMATIC;
+		bool dynamic_B = B.body->get_mode() > PhysicsServer3D::BODY_MODE_KINEMATIC;
+
+		uint32_t batch_index = batches.size();
+		int lane = 0;
+
+		uint32_t from = batches.size() > BATCH_SEARCH_WINDOW ? batches.size() - BATCH_SEARCH_WINDOW : 0;
+		for (uint32_t j = from; j < batches.size(); j++) {
+			const Batch &batch = batches[j];
+			int free_lane = -1;
+			bool conflict = false;
+
+			for (int l = 0; l < LANES; l++) {
+				if (batch.contact_ref[l] == UINT32_MAX) {
+					if (free_lane == -1) {
+						free_lane = l;
+					}
+					continue;
+				}
+				if (dynamic_A && (batch.body_A[l] == ref.body_A || batch.body_B[l] == ref.body_A)) {
+					conflict = true;
+					break;
+				}
+				if (dynamic_B && (batch.body_A[l] == ref.body_B || batch.body_B[l] == ref.body_B)) {
+					conflict = true;
+					break;
+				}
+			}
+
+			if (!conflict && free_lane != -1) {
+				batch_index = j;
+				lane = free_lane;
+				break;
+			}
+		}
+
+		if (batch_index == batches.size()) {
+			Batch batch;
+			memset(&batch, 0, sizeof(Batch));
+			for (int l = 0; l < LANES; l++) {
+				batch.contact_ref[l] = UINT32_MAX;
+			}
+			batches.push_back(batch);
+		}
+
+		const BodyPair3DSW::Contact &c = ref.pair->contacts[ref.contact];
+		Batch &batch = batches[batch_index];
+
+		batch.body_A[lane] = ref.body_A;
+		batch.body_B[lane] = ref.body_B;
+		batch.contact_ref[lane] = i;
+
+		batch.normal.set(lane, c.normal);
+		batch.rA.set(lane, c.rA);
+		batch.rB.set(lane, c.rB);
+
+		batch.mass_normal[lane] = c.mass_normal;
+		batch.inv_mass_sum[lane] = A.inv_mass + B.inv_mass;
+		batch.bias[lane] = c.bias;
+		batch.bounce[lane] = c.bounce;
+		batch.friction[lane] = ABS(MIN(A.body->get_friction(), B.body->get_friction()));
+
+		batch.acc_normal_impulse[lane] = c.acc_normal_impulse;
+		batch.acc_tangent_impulse.set(lane, c.acc_tangent_impulse);
+		batch.acc_bias_impulse[lane] = c.acc_bias_impulse;
+		batch.acc_bias_impulse_center_of_mass[lane] = c.acc_bias_impulse_center_of_mass;
+
+		// Two immovable bodies can't exchange impulses, keep the lane idle.
+		batch.active[lane] = batch.inv_mass_sum[lane] > 0 ? 1 : 0;
+	}
+}
+
+void ContactSolver3DSW::_gather(LaneBodies &r_lanes, const uint32_t *p_indices) const {
+	for (int l = 0; l < LANES; l++) {
+		const SolverBody &sb = bodies[p_indices[l]];
+		r_lanes.linear_velocity.set(l, sb.linear_velocity);
+		r_lanes.angular_velocity.set(l, sb.angular_velocity);
+		r_lanes.biased_linear_velocity.set(l, sb.biased_linear_velocity);
+		r_lanes.biased_angular_velocity.set(l, sb.biased_angular_velocity);
+		for (int i = 0; i < 3; i++) {
+			for (int j = 0; j < 3; j++) {
+				r_lanes.inv_inertia_tensor.elements[i][j][l] = sb.inv_inertia_tensor.elements[i][j];
+			}
+		}
+		r_lanes.inv_mass[l] = sb.inv_mass;
+	}
+}
+
+void ContactSolver3DSW::_scatter(const LaneBodies &p_lanes, const uint32_t *p_indices) {
+	for (int l = 0; l < LANES; l++) {
+		SolverBody &sb = bodies[p_indices[l]];
+		sb.linear_velocity = p_lanes.linear_velocity.get(l);
+		sb.angular_velocity = p_lanes.angular_velocity.get(l);
+		sb.biased_linear_velocity = p_lanes.biased_linear_velocity.get(l);
+		sb.biased_angular_velocity = p_lanes.biased_angular_velocity.get(l);
+	}
+}
+
+void ContactSolver3DSW::_solve_batch(Batch &p_batch) {
+	// Lanes never share a dynamic body, so they are independent of each other.
+	LaneBodies lanes_A;
+	LaneBodies lanes_B;
+	_gather(lanes_A, p_batch.body_A);
+	_gather(lanes_B, p_batch.body_B);
+
+	// Same math as BodyPair3DSW::solve(), with its early outs turned into selects. A step
+	// that is skipped leaves its accumulated impulse as it was, so it applies a zero impulse.
+	for (int l = 0; l < LANES; l++) {
+		const bool lane_active = p_batch.active[l] != 0;
+
+		const Vector3 normal = p_batch.normal.get(l);
+		const Vector3 rA = p_batch.rA.get(l);
+		const Vector3 rB = p_batch.rB.get(l);
+		const real_t bias = p_batch.bias[l];
+		const real_t inv_mass_A = lanes_A.inv_mass[l];
+		const real_t inv_mass_B = lanes_B.inv_mass[l];
+		// Padding lanes have no mass at all, keep their divisions finite.
+		const real_t inv_mass_sum = p_batch.inv_mass_sum[l] > 0 ? p_batch.inv_mass_sum[l] : 1;
+
+		Vector3 lvA = lanes_A.linear_velocity.get(l);
+		Vector3 avA = lanes_A.angular_velocity.get(l);
+		Vector3 blvA = lanes_A.biased_linear_velocity.get(l);
+		Vector3 bavA = lanes_A.biased_angular_velocity.get(l);
+		Vector3 lvB = lanes_B.linear_velocity.get(l);
+		Vector3 avB = lanes_B.angular_velocity.get(l);
+		Vector3 blvB = lanes_B.biased_linear_velocity.get(l);
+		Vector3 bavB = lanes_B.biased_angular_velocity.get(l);
+
+		// bias impulse
+
+		Vector3 dbv = blvB + bavB.cross(rB) - blvA - bavA.cross(rA);
+		real_t vbn = dbv.dot(normal);
+		const bool solve_bias = lane_active && Math::abs(-vbn + bias) > MIN_VELOCITY;
+
+		real_t jbn_old = p_batch.acc_bias_impulse[l];
+		real_t jbn_acc = MAX(jbn_old + (-vbn + bias) * p_batch.mass_normal[l], 0.0f);
+		p_batch.acc_bias_impulse[l] = solve_bias ? jbn_acc : jbn_old;
+
+		Vector3 jb = normal * (p_batch.acc_bias_impulse[l] - jbn_old);
+
+		blvA -= jb * inv_mass_A;
+		blvB += jb * inv_mass_B;
+
+		Vector3 dav_A = lanes_A.inv_inertia_tensor.xform(l, rA.cross(-jb));
+		Vector3 dav_B = lanes_B.inv_inertia_tensor.xform(l, rB.cross(jb));
+		real_t dav_A_len = dav_A.length();
+		real_t dav_B_len = dav_B.length();
+		dav_A *= dav_A_len > max_bias_rotation ? max_bias_rotation / dav_A_len : 1;
+		dav_B *= dav_B_len > max_bias_rotation ? max_bias_rotation / dav_B_len : 1;
+		bavA += dav_A;
+		bavB += dav_B;
+
+		dbv = blvB + bavB.cross(rB) - blvA - bavA.cross(rA);
+		vbn = dbv.dot(normal);
+		const bool solve_bias_com = solve_bias && Math::abs(-vbn + bias) > MIN_VELOCITY;
+
+		real_t jbn_old_com = p_batch.acc_bias_impulse_center_of_mass[l];
+		real_t jbn_acc_com = MAX(jbn_old_com + (-vbn + bias) / inv_mass_sum, 0.0f);
+		p_batch.acc_bias_impulse_center_of_mass[l] = solve_bias_com ? jbn_acc_com : jbn_old_com;
+
+		Vector3 jb_com = normal * (p_batch.acc_bias_impulse_center_of_mass[l] - jbn_old_com);
+
+		blvA -= jb_com * inv_mass_A;
+		blvB += jb_com * inv_mass_B;
+
+		// normal impulse
+
+		Vector3 dv = lvB + avB.cross(rB) - lvA - avA.cross(rA);
+		real_t vn = dv.dot(normal);
+		const bool solve_normal = lane_active && Math::abs(vn) > MIN_VELOCITY;
+
+		real_t jn_old = p_batch.acc_normal_impulse[l];
+		real_t jn_acc = MAX(jn_old - (p_batch.bounce[l] + vn) * p_batch.mass_normal[l], 0.0f);
+		p_batch.acc_normal_impulse[l] = solve_normal ? jn_acc : jn_old;
+
+		Vector3 j = normal * (p_batch.acc_normal_impulse[l] - jn_old);
+
+		lvA -= j * inv_mass_A;
+		avA += lanes_A.inv_inertia_tensor.xform(l, rA.cross(-j));
+		lvB += j * inv_mass_B;
+		avB += lanes_B.inv_inertia_tensor.xform(l, rB.cross(j));
+
+		// friction impulse
+
+		Vector3 dtv = (lvB + avB.cross(rB)) - (lvA + avA.cross(rA));
+		Vector3 tv = dtv - normal * normal.dot(dtv);
+		real_t tvl = tv.length();
+		const bool solve_friction = lane_active && tvl > MIN_VELOCITY;
+
+		tv /= solve_friction ? tvl : 1;
+
+		Vector3 temp1 = lanes_A.inv_inertia_tensor.xform(l, rA.cross(tv));
+		Vector3 temp2 = lanes_B.inv_inertia_tensor.xform(l, rB.cross(tv));
+		real_t t = -tvl / (inv_mass_sum + tv.dot(temp1.cross(rA) + temp2.cross(rB)));
+
+		Vector3 jt_old = p_batch.acc_tangent_impulse.get(l);
+		Vector3 jt_acc = jt_old + t * tv;
+
+		real_t fi_len = jt_acc.length();
+		real_t jt_max = p_batch.acc_normal_impulse[l] * p_batch.friction[l];
+		jt_acc *= (fi_len > CMP_EPSILON && fi_len > jt_max) ? jt_max / fi_len : 1;
+
+		jt_acc.x = solve_friction ? jt_acc.x : jt_old.x;
+		jt_acc.y = solve_friction ? jt_acc.y : jt_old.y;
+		jt_acc.z = solve_friction ? jt_acc.z : jt_old.z;
+		p_batch.acc_tangent_impulse.set(l, jt_acc);
+
+		Vector3 jt = jt_acc - jt_old;
+
+		lvA -= jt * inv_mass_A;
+		avA += lanes_A.inv_inertia_tensor.xform(l, rA.cross(-jt));
+		lvB += jt * inv_mass_B;
+		avB += lanes_B.inv_inertia_tensor.xform(l, rB.cross(jt));
+
+		lanes_A.linear_velocity.set(l, lvA);
+		lanes_A.angular_velocity.set(l, avA);
+		lanes_A.biased_linear_velocity.set(l, blvA);
+		lanes_A.biased_angular_velocity.set(l, bavA);
+		lanes_B.linear_velocity.set(l, lvB);
+		lanes_B.angular_velocity.set(l, avB);
+		lanes_B.biased_linear_velocity.set(l, blvB);
+		lanes_B.biased_angular_velocity.set(l, bavB);
+
+		// Same early out as BodyPair3DSW::solve(), a contact that did nothing stays idle.
+		p_batch.active[l] = (solve_bias || solve_normal || solve_friction) ? 1 : 0;
+	}
+
+	_scatter(lanes_A, p_batch.body_A);
+	_scatter(lanes_B, p_batch.body_B);
+}
+
+void ContactSolver3DSW::prepare() {
+	_build_batches();
+}
+
+void ContactSolver3DSW::solve() {
+	for (uint32_t i = 0; i < batches.size(); i++) {
+		_solve_batch(batches[i]);
+	}
+}
+
+void ContactSolver3DSW::write_back_velocities() {
+	for (uint32_t i = 1; i < bodies.size(); i++) {
+		const SolverBody &sb = bodies[i];
+		if (sb.body->get_mode() <= PhysicsServer3D::BODY_MODE_KINEMATIC) {
+			continue;
+		}
+		sb.body->set_linear_velocity(sb.linear_velocity);
+		sb.body->set_angular_velocity(sb.angular_velocity);
+		sb.body->set_biased_linear_velocity(sb.biased_linear_velocity);
+		sb.body->set_biased_angular_velocity(sb.biased_angular_velocity);
+	}
+}
+
+void ContactSolver3DSW::read_velocities() {
+	for (uint32_t i = 1; i < bodies.size(); i++) {
+		SolverBody &sb = bodies[i];
+		sb.linear_velocity = sb.body->get_linear_velocity();
+		sb.angular_velocity = sb.body->get_angular_velocity();
+		sb.biased_linear_velocity = sb.body->get_biased_linear_velocity();
+		sb.biased_angular_velocity = sb.body->get_biased_angular_velocity();
+	}
+}
+
+void ContactSolver3DSW::finish() {
+	write_back_velocities();
+
+	// Accumulated impulses warm start the next step.
+	for (uint32_t i = 0; i < batches.size(); i++) {
+		const Batch &batch = batches[i];
+		for (int l = 0; l < LANES; l++) {
+			if (batch.contact_ref[l] == UINT32_MAX) {
+				continue;
+			}
+			const ContactRef &ref = contact_refs[batch.contact_ref[l]];
+			BodyPair3DSW::Contact &c = ref.pair->contacts[ref.contact];
+			c.acc_normal_impulse = batch.acc_normal_impulse[l];
+			c.acc_tangent_impulse = batch.acc_tangent_impulse.get(l);
+			c.acc_bias_impulse = batch.acc_bias_impulse[l];
+			c.acc_bias_impulse_center_of_mass = batch.acc_bias_impulse_center_of_mass[l];
+			c.active = batch.active[l] != 0;
+		}
+	}
+}
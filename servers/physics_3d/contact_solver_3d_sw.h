@@ -0,0 +1,156 @@
+/*************************************************************************/
+/*  contact_solver_3d_sw.h                                               */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef CONTACT_SOLVER_3D_SW_H
+#define CONTACT_SOLVER_3D_SW_H
+
+#include "body_3d_sw.h"
+#include "core/local_vector.h"
+
+class BodyPair3DSW;
+
+// Solves the contacts of an island in batches of LANES contacts that never share a
+// dynamic body. Contact data is packed structure-of-arrays per batch and body velocities
+// are gathered into lanes before solving, so the lane loop is branch-free arithmetic the
+// compiler can vectorize. Body velocities live in a flat array for the duration of the solve.
+
+class ContactSolver3DSW {
+public:
+	enum {
+		LANES = 4,
+		BATCH_SEARCH_WINDOW = 8, // how many trailing batches are probed for a free lane
+	};
+
+private:
+	struct SolverBody {
+		Vector3 linear_velocity;
+		Vector3 angular_velocity;
+		Vector3 biased_linear_velocity;
+		Vector3 biased_angular_velocity;
+		Basis inv_inertia_tensor;
+		real_t inv_mass;
+		Body3DSW *body; // null for the padding body
+	};
+
+	struct ContactRef {
+		uint32_t body_A;
+		uint32_t body_B;
+		BodyPair3DSW *pair;
+		int contact;
+	};
+
+	struct LaneVector3 {
+		real_t x[LANES];
+		real_t y[LANES];
+		real_t z[LANES];
+
+		_FORCE_INLINE_ Vector3 get(int p_lane) const { return Vector3(x[p_lane], y[p_lane], z[p_lane]); }
+		_FORCE_INLINE_ void set(int p_lane, const Vector3 &p_value) {
+			x[p_lane] = p_value.x;
+			y[p_lane] = p_value.y;
+			z[p_lane] = p_value.z;
+		}
+	};
+
+	struct LaneBasis {
+		real_t elements[3][3][LANES];
+
+		_FORCE_INLINE_ Vector3 xform(int p_lane, const Vector3 &p_vector) const {
+			return Vector3(
+					elements[0][0][p_lane] * p_vector.x + elements[0][1][p_lane] * p_vector.y + elements[0][2][p_lane] * p_vector.z,
+					elements[1][0][p_lane] * p_vector.x + elements[1][1][p_lane] * p_vector.y + elements[1][2][p_lane] * p_vector.z,
+					elements[2][0][p_lane] * p_vector.x + elements[2][1][p_lane] * p_vector.y + elements[2][2][p_lane] * p_vector.z);
+		}
+	};
+
+	// One side of the contacts of a batch.
+	struct LaneBodies {
+		LaneVector3 linear_velocity;
+		LaneVector3 angular_velocity;
+		LaneVector3 biased_linear_velocity;
+		LaneVector3 biased_angular_velocity;
+		LaneBasis inv_inertia_tensor;
+		real_t inv_mass[LANES];
+	};
+
+	struct Batch {
+		uint32_t body_A[LANES];
+		uint32_t body_B[LANES];
+
+		LaneVector3 normal;
+		LaneVector3 rA;
+		LaneVector3 rB;
+
+		real_t mass_normal[LANES];
+		real_t inv_mass_sum[LANES];
+		real_t bias[LANES];
+		real_t bounce[LANES];
+		real_t friction[LANES];
+
+		real_t acc_normal_impulse[LANES];
+		LaneVector3 acc_tangent_impulse;
+		real_t acc_bias_impulse[LANES];
+		real_t acc_bias_impulse_center_of_mass[LANES];
+
+		real_t active[LANES]; // 1 or 0, padding lanes stay at 0
+		uint32_t contact_ref[LANES];
+	};
+
+	uint64_t pass = 0;
+	real_t max_bias_rotation = 0;
+
+	LocalVector<SolverBody> bodies;
+	LocalVector<ContactRef> contact_refs;
+	LocalVector<Batch> batches;
+
+	uint32_t _get_body_index(Body3DSW *p_body);
+	void _build_batches();
+	void _gather(LaneBodies &r_lanes, const uint32_t *p_indices) const;
+	void _scatter(const LaneBodies &p_lanes, const uint32_t *p_indices);
+	void _solve_batch(Batch &p_batch);
+
+public:
+	void begin(real_t p_step);
+	void add_body_pair(BodyPair3DSW *p_pair);
+	bool has_contacts() const { return contact_refs.size() > 0; }
+
+	void prepare();
+	void solve();
+
+	// Only needed when scalar constraints share bodies with the batched contacts.
+	void write_back_velocities();
+	void read_velocities();
+
+	void finish();
+
+	uint32_t get_batch_count() const { return batches.size(); }
+};
+
+#endif // CONTACT_SOLVER_3D_SW_H
@@ -954,12 +954,22 @@ bool Penetration(	const Shape3DSW*	shape0,
 
 /* clang-format on */
 
-bool gjk_epa_calculate_distance(const Shape3DSW *p_shape_A, const Transform &p_transform_A, const Shape3DSW *p_shape_B, const Transform &p_transform_B, Vector3 &r_result_A, Vector3 &r_result_B) {
+bool gjk_epa_calculate_distance(const Shape3DSW *p_shape_A, const Transform &p_transform_A, const Shape3DSW *p_shape_B, const Transform &p_transform_B, Vector3 &r_result_A, Vector3 &r_result_B, Vector3 *r_sep_axis) {
 	GjkEpa2::sResults res;
 
-	if (GjkEpa2::Distance(p_shape_A, p_transform_A, p_shape_B, p_transform_B, p_transform_B.origin - p_transform_A.origin, res)) {
+	// A previous separating direction (pointing from A to B) is a much better first guess
+	// than the origins, GJK usually converges in one or two iterations with it.
+	Vector3 guess = p_transform_B.origin - p_transform_A.origin;
+	if (r_sep_axis && *r_sep_axis != Vector3()) {
+		guess = *r_sep_axis;
+	}
+
+	if (GjkEpa2::Distance(p_shape_A, p_transform_A, p_shape_B, p_transform_B, guess, res)) {
 		r_result_A = res.witnesses[0];
 		r_result_B = res.witnesses[1];
+		if (r_sep_axis && res.distance > 0) {
+			*r_sep_axis = -res.normal;
+		}
 		return true;
 	}
 
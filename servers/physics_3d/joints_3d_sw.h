@@ -34,9 +34,20 @@
 #include "body_3d_sw.h"
 #include "constraint_3d_sw.h"
 
+// Also used as is for joints created empty, which have no bodies and do nothing.
 class Joint3DSW : public Constraint3DSW {
 public:
-	virtual PhysicsServer3D::JointType get_type() const = 0;
+	virtual bool setup(real_t p_step) { return false; }
+	virtual void solve(real_t p_step) {}
+
+	virtual PhysicsServer3D::JointType get_type() const { return PhysicsServer3D::JOINT_TYPE_MAX; }
+
+	_FORCE_INLINE_ void copy_settings_from(Joint3DSW *p_joint) {
+		set_self(p_joint->get_self());
+		set_priority(p_joint->get_priority());
+		disable_collisions_between_bodies(p_joint->is_disabled_collisions_between_bodies());
+	}
+
 	_FORCE_INLINE_ Joint3DSW(Body3DSW **p_body_ptr = nullptr, int p_body_count = 0) :
 			Constraint3DSW(p_body_ptr, p_body_count) {
 	}
@@ -110,6 +110,15 @@ Variant PhysicsServer3DSW::shape_get_data(RID p_shape) const {
 	return shape->get_data();
 };
 
+Vector<uint8_t> PhysicsServer3DSW::shape_get_bvh_cache(RID p_shape) const {
+	const Shape3DSW *shape = shape_owner.getornull(p_shape);
+	ERR_FAIL_COND_V(!shape, Vector<uint8_t>());
+	if (shape->get_type() != SHAPE_CONCAVE_POLYGON) {
+		return Vector<uint8_t>();
+	}
+	return static_cast<const ConcavePolygonShape3DSW *>(shape)->get_bvh_data();
+}
+
 void PhysicsServer3DSW::shape_set_margin(RID p_shape, real_t p_margin) {
 }
 
@@ -197,6 +206,19 @@ int PhysicsServer3DSW::space_get_contact_count(RID p_space) const {
 	return space->get_debug_contact_count();
 }
 
+Vector<uint8_t> PhysicsServer3DSW::space_get_state_snapshot(RID p_space) {
+	Space3DSW *space = space_owner.getornull(p_space);
+	ERR_FAIL_COND_V(!space, Vector<uint8_t>());
+	return space->get_state_snapshot();
+}
+
+Error PhysicsServer3DSW::space_set_state_snapshot(RID p_space, const Vector<uint8_t> &p_snapshot) {
+	Space3DSW *space = space_owner.getornull(p_space);
+	ERR_FAIL_COND_V(!space, ERR_INVALID_PARAMETER);
+	_update_shapes(); // pending shape changes must reach the broadphase before pairs are rebuilt
+	return space->set_state_snapshot(p_snapshot);
+}
+
 RID PhysicsServer3DSW::area_create() {
 	Area3DSW *area = memnew(Area3DSW);
 	RID rid = area_owner.make_rid(area);
@@ -874,6 +896,43 @@ bool PhysicsServer3DSW::body_test_motion(RID p_body, const Transform &p_from, co
 	return body->get_space()->test_body_motion(body, p_from, p_motion, p_infinite_inertia, body->get_kinematic_margin(), r_result, p_exclude_raycast_shapes);
 }
 
+int PhysicsServer3DSW::body_test_motion_batch(const RID *p_bodies, const Transform *p_from, const Vector3 *p_motions, int p_count, bool p_infinite_inertia, MotionResult *r_results, bool p_exclude_raycast_shapes) {
+	if (p_count <= 0) {
+		return 0;
+	}
+
+	Space3DSW *space = nullptr;
+	motion_batch_bodies.resize(p_count);
+
+	for (int i = 0; i < p_count; i++) {
+		Body3DSW *body = body_owner.getornull(p_bodies[i]);
+		ERR_FAIL_COND_V(!body, 0);
+		ERR_FAIL_COND_V(!body->get_space(), 0);
+		if (i == 0) {
+			space = body->get_space();
+		} else {
+			ERR_FAIL_COND_V_MSG(body->get_space() != space, 0, "All bodies in a motion batch must be in the same space.");
+		}
+		motion_batch_bodies[i] = body;
+	}
+
+	ERR_FAIL_COND_V(space->is_locked(), 0);
+
+	_update_shapes();
+
+	// waking the workers isn't worth it for a handful of bodies
+	ThreadWorkPool *work_pool = nullptr;
+	if (p_count >= MOTION_BATCH_THREADED_MIN) {
+		if (!motion_work_pool_started) {
+			motion_work_pool.init();
+			motion_work_pool_started = true;
+		}
+		work_pool = &motion_work_pool;
+	}
+
+	return space->test_body_motion_batch(motion_batch_bodies.ptr(), p_from, p_motions, p_count, p_infinite_inertia, r_results, p_exclude_raycast_shapes, work_pool);
+}
+
 int PhysicsServer3DSW::body_test_ray_separation(RID p_body, const Transform &p_transform, bool p_infinite_inertia, Vector3 &r_recover_motion, SeparationResult *r_results, int p_result_max, float p_margin) {
 	Body3DSW *body = body_owner.getornull(p_body);
 	ERR_FAIL_COND_V(!body, false);
@@ -896,24 +955,44 @@ PhysicsDirectBodyState3D *PhysicsServer3DSW::body_get_direct_state(RID p_body) {
 
 /* JOINT API */
 
-RID PhysicsServer3DSW::joint_create_pin(RID p_body_A, const Vector3 &p_local_A, RID p_body_B, const Vector3 &p_local_B) {
+RID PhysicsServer3DSW::joint_create() {
+	Joint3DSW *joint = memnew(Joint3DSW);
+	RID rid = joint_owner.make_rid(joint);
+	joint->set_self(rid);
+	return rid;
+}
+
+void PhysicsServer3DSW::_joint_replace(Joint3DSW *p_prev_joint, Joint3DSW *p_joint) {
+	// Keep the RID and whatever was set on the joint before it was made.
+	p_joint->copy_settings_from(p_prev_joint);
+	joint_owner.replace(p_joint->get_self(), p_joint);
+
+	for (int i = 0; i < p_prev_joint->get_body_count(); i++) {
+		p_prev_joint->get_body_ptr()[i]->remove_constraint(p_prev_joint);
+	}
+	memdelete(p_prev_joint);
+}
+
+bool PhysicsServer3DSW::joint_make_pin(RID p_joint, RID p_body_A, const Vector3 &p_local_A, RID p_body_B, const Vector3 &p_local_B) {
+	Joint3DSW *prev_joint = joint_owner.getornull(p_joint);
+	ERR_FAIL_COND_V(!prev_joint, false);
+
 	Body3DSW *body_A = body_owner.getornull(p_body_A);
-	ERR_FAIL_COND_V(!body_A, RID());
+	ERR_FAIL_COND_V(!body_A, false);
 
 	if (!p_body_B.is_valid()) {
-		ERR_FAIL_COND_V(!body_A->get_space(), RID());
+		ERR_FAIL_COND_V(!body_A->get_space(), false);
 		p_body_B = body_A->get_space()->get_static_global_body();
 	}
 
 	Body3DSW *body_B = body_owner.getornull(p_body_B);
-	ERR_FAIL_COND_V(!body_B, RID());
+	ERR_FAIL_COND_V(!body_B, false);
 
-	ERR_FAIL_COND_V(body_A == body_B, RID());
+	ERR_FAIL_COND_V(body_A == body_B, false);
 
 	Joint3DSW *joint = memnew(PinJoint3DSW(body_A, p_local_A, body_B, p_local_B));
-	RID rid = joint_owner.make_rid(joint);
-	joint->set_self(rid);
-	return rid;
+	_joint_replace(prev_joint, joint);
+	return true;
 }
 
 void PhysicsServer3DSW::pin_joint_set_param(RID p_joint, PinJointParam p_param, real_t p_value) {
@@ -964,44 +1043,48 @@ Vector3 PhysicsServer3DSW::pin_joint_get_local_b(RID p_joint) const {
 	return pin_joint->get_position_b();
 }
 
-RID PhysicsServer3DSW::joint_create_hinge(RID p_body_A, const Transform &p_frame_A, RID p_body_B, const Transform &p_frame_B) {
+bool PhysicsServer3DSW::joint_make_hinge(RID p_joint, RID p_body_A, const Transform &p_frame_A, RID p_body_B, const Transform &p_frame_B) {
+	Joint3DSW *prev_joint = joint_owner.getornull(p_joint);
+	ERR_FAIL_COND_V(!prev_joint, false);
+
 	Body3DSW *body_A = body_owner.getornull(p_body_A);
-	ERR_FAIL_COND_V(!body_A, RID());
+	ERR_FAIL_COND_V(!body_A, false);
 
 	if (!p_body_B.is_valid()) {
-		ERR_FAIL_COND_V(!body_A->get_space(), RID());
+		ERR_FAIL_COND_V(!body_A->get_space(), false);
 		p_body_B = body_A->get_space()->get_static_global_body();
 	}
 
 	Body3DSW *body_B = body_owner.getornull(p_body_B);
-	ERR_FAIL_COND_V(!body_B, RID());
+	ERR_FAIL_COND_V(!body_B, false);
 
-	ERR_FAIL_COND_V(body_A == body_B, RID());
+	ERR_FAIL_COND_V(body_A == body_B, false);
 
 	Joint3DSW *joint = memnew(HingeJoint3DSW(body_A, body_B, p_frame_A, p_frame_B));
-	RID rid = joint_owner.make_rid(joint);
-	joint->set_self(rid);
-	return rid;
+	_joint_replace(prev_joint, joint);
+	return true;
 }
 
-RID PhysicsServer3DSW::joint_create_hinge_simple(RID p_body_A, const Vector3 &p_pivot_A, const Vector3 &p_axis_A, RID p_body_B, const Vector3 &p_pivot_B, const Vector3 &p_axis_B) {
+bool PhysicsServer3DSW::joint_make_hinge_simple(RID p_joint, RID p_body_A, const Vector3 &p_pivot_A, const Vector3 &p_axis_A, RID p_body_B, const Vector3 &p_pivot_B, const Vector3 &p_axis_B) {
+	Joint3DSW *prev_joint = joint_owner.getornull(p_joint);
+	ERR_FAIL_COND_V(!prev_joint, false);
+
 	Body3DSW *body_A = body_owner.getornull(p_body_A);
-	ERR_FAIL_COND_V(!body_A, RID());
+	ERR_FAIL_COND_V(!body_A, false);
 
 	if (!p_body_B.is_valid()) {
-		ERR_FAIL_COND_V(!body_A->get_space(), RID());
+		ERR_FAIL_COND_V(!body_A->get_space(), false);
 		p_body_B = body_A->get_space()->get_static_global_body();
 	}
 
 	Body3DSW *body_B = body_owner.getornull(p_body_B);
-	ERR_FAIL_COND_V(!body_B, RID());
+	ERR_FAIL_COND_V(!body_B, false);
 
-	ERR_FAIL_COND_V(body_A == body_B, RID());
+	ERR_FAIL_COND_V(body_A == body_B, false);
 
 	Joint3DSW *joint = memnew(HingeJoint3DSW(body_A, body_B, p_pivot_A, p_pivot_B, p_axis_A, p_axis_B));
-	RID rid = joint_owner.make_rid(joint);
-	joint->set_self(rid);
-	return rid;
+	_joint_replace(prev_joint, joint);
+	return true;
 }
 
 void PhysicsServer3DSW::hinge_joint_set_param(RID p_joint, HingeJointParam p_param, real_t p_value) {
@@ -1081,24 +1164,26 @@ PhysicsServer3DSW::JointType PhysicsServer3DSW::joint_get_type(RID p_joint) cons
 	return joint->get_type();
 }
 
-RID PhysicsServer3DSW::joint_create_slider(RID p_body_A, const Transform &p_local_frame_A, RID p_body_B, const Transform &p_local_frame_B) {
+bool PhysicsServer3DSW::joint_make_slider(RID p_joint, RID p_body_A, const Transform &p_local_frame_A, RID p_body_B, const Transform &p_local_frame_B) {
+	Joint3DSW *prev_joint = joint_owner.getornull(p_joint);
+	ERR_FAIL_COND_V(!prev_joint, false);
+
 	Body3DSW *body_A = body_owner.getornull(p_body_A);
-	ERR_FAIL_COND_V(!body_A, RID());
+	ERR_FAIL_COND_V(!body_A, false);
 
 	if (!p_body_B.is_valid()) {
-		ERR_FAIL_COND_V(!body_A->get_space(), RID());
+		ERR_FAIL_COND_V(!body_A->get_space(), false);
 		p_body_B = body_A->get_space()->get_static_global_body();
 	}
 
 	Body3DSW *body_B = body_owner.getornull(p_body_B);
-	ERR_FAIL_COND_V(!body_B, RID());
+	ERR_FAIL_COND_V(!body_B, false);
 
-	ERR_FAIL_COND_V(body_A == body_B, RID());
+	ERR_FAIL_COND_V(body_A == body_B, false);
 
 	Joint3DSW *joint = memnew(SliderJoint3DSW(body_A, body_B, p_local_frame_A, p_local_frame_B));
-	RID rid = joint_owner.make_rid(joint);
-	joint->set_self(rid);
-	return rid;
+	_joint_replace(prev_joint, joint);
+	return true;
 }
 
 void PhysicsServer3DSW::slider_joint_set_param(RID p_joint, SliderJointParam p_param, real_t p_value) {
@@ -1117,24 +1202,26 @@ real_t PhysicsServer3DSW::slider_joint_get_param(RID p_joint, SliderJointParam p
 	return slider_joint->get_param(p_param);
 }
 
-RID PhysicsServer3DSW::joint_create_cone_twist(RID p_body_A, const Transform &p_local_frame_A, RID p_body_B, const Transform &p_local_frame_B) {
+bool PhysicsServer3DSW::joint_make_cone_twist(RID p_joint, RID p_body_A, const Transform &p_local_frame_A, RID p_body_B, const Transform &p_local_frame_B) {
+	Joint3DSW *prev_joint = joint_owner.getornull(p_joint);
+	ERR_FAIL_COND_V(!prev_joint, false);
+
 	Body3DSW *body_A = body_owner.getornull(p_body_A);
-	ERR_FAIL_COND_V(!body_A, RID());
+	ERR_FAIL_COND_V(!body_A, false);
 
 	if (!p_body_B.is_valid()) {
-		ERR_FAIL_COND_V(!body_A->get_space(), RID());
+		ERR_FAIL_COND_V(!body_A->get_space(), false);
 		p_body_B = body_A->get_space()->get_static_global_body();
 	}
 
 	Body3DSW *body_B = body_owner.getornull(p_body_B);
-	ERR_FAIL_COND_V(!body_B, RID());
+	ERR_FAIL_COND_V(!body_B, false);
 
-	ERR_FAIL_COND_V(body_A == body_B, RID());
+	ERR_FAIL_COND_V(body_A == body_B, false);
 
 	Joint3DSW *joint = memnew(ConeTwistJoint3DSW(body_A, body_B, p_local_frame_A, p_local_frame_B));
-	RID rid = joint_owner.make_rid(joint);
-	joint->set_self(rid);
-	return rid;
+	_joint_replace(prev_joint, joint);
+	return true;
 }
 
 void PhysicsServer3DSW::cone_twist_joint_set_param(RID p_joint, ConeTwistJointParam p_param, real_t p_value) {
@@ -1153,24 +1240,26 @@ real_t PhysicsServer3DSW::cone_twist_joint_get_param(RID p_joint, ConeTwistJoint
 	return cone_twist_joint->get_param(p_param);
 }
 
-RID PhysicsServer3DSW::joint_create_generic_6dof(RID p_body_A, const Transform &p_local_frame_A, RID p_body_B, const Transform &p_local_frame_B) {
+bool PhysicsServer3DSW::joint_make_generic_6dof(RID p_joint, RID p_body_A, const Transform &p_local_frame_A, RID p_body_B, const Transform &p_local_frame_B) {
+	Joint3DSW *prev_joint = joint_owner.getornull(p_joint);
+	ERR_FAIL_COND_V(!prev_joint, false);
+
 	Body3DSW *body_A = body_owner.getornull(p_body_A);
-	ERR_FAIL_COND_V(!body_A, RID());
+	ERR_FAIL_COND_V(!body_A, false);
 
 	if (!p_body_B.is_valid()) {
-		ERR_FAIL_COND_V(!body_A->get_space(), RID());
+		ERR_FAIL_COND_V(!body_A->get_space(), false);
 		p_body_B = body_A->get_space()->get_static_global_body();
 	}
 
 	Body3DSW *body_B = body_owner.getornull(p_body_B);
-	ERR_FAIL_COND_V(!body_B, RID());
+	ERR_FAIL_COND_V(!body_B, false);
 
-	ERR_FAIL_COND_V(body_A == body_B, RID());
+	ERR_FAIL_COND_V(body_A == body_B, false);
 
 	Joint3DSW *joint = memnew(Generic6DOFJoint3DSW(body_A, body_B, p_local_frame_A, p_local_frame_B, true));
-	RID rid = joint_owner.make_rid(joint);
-	joint->set_self(rid);
-	return rid;
+	_joint_replace(prev_joint, joint);
+	return true;
 }
 
 void PhysicsServer3DSW::generic_6dof_joint_set_param(RID p_joint, Vector3::Axis p_axis, G6DOFJointAxisParam p_param, real_t p_value) {
@@ -1378,6 +1467,10 @@ void PhysicsServer3DSW::flush_queries() {
 void PhysicsServer3DSW::finish() {
 	memdelete(stepper);
 	memdelete(direct_state);
+	if (motion_work_pool_started) {
+		motion_work_pool.finish();
+		motion_work_pool_started = false;
+	}
 };
 
 int PhysicsServer3DSW::get_process_info(ProcessInfo p_info) {
@@ -54,22 +54,36 @@ class PhysicsServer3DSW : public PhysicsServer3D {
 	bool flushing_queries;
 
 	Step3DSW *stepper;
+
+	// started on the first large motion batch
+	ThreadWorkPool motion_work_pool;
+	bool motion_work_pool_started = false;
+	LocalVector<Body3DSW *> motion_batch_bodies;
 	Set<const Space3DSW *> active_spaces;
 
 	PhysicsDirectBodyState3DSW *direct_state;
 
+	enum {
+		MOTION_BATCH_THREADED_MIN = 32
+	};
+
 	mutable RID_PtrOwner<Shape3DSW> shape_owner;
 	mutable RID_PtrOwner<Space3DSW> space_owner;
 	mutable RID_PtrOwner<Area3DSW> area_owner;
 	mutable RID_PtrOwner<Body3DSW> body_owner;
 	mutable RID_PtrOwner<Joint3DSW> joint_owner;
 
+	void _joint_replace(Joint3DSW *p_prev_joint, Joint3DSW *p_joint);
+
 	//void _clear_query(QuerySW *p_query);
 	friend class CollisionObject3DSW;
 	SelfList<CollisionObject3DSW>::List pending_shape_update_list;
 	void _update_shapes();
 
 public:
+	// statistics for benchmarks, which link the built-in server directly
+	const Space3DSW *get_space(RID p_space) const { return space_owner.getornull(p_space); }
+
 	static PhysicsServer3DSW *singleton;
 
 	struct CollCbkData {
@@ -86,6 +100,7 @@ public:
 
 	virtual ShapeType shape_get_type(RID p_shape) const override;
 	virtual Variant shape_get_data(RID p_shape) const override;
+	virtual Vector<uint8_t> shape_get_bvh_cache(RID p_shape) const override;
 
 	virtual void shape_set_margin(RID p_shape, real_t p_margin) override;
 	virtual real_t shape_get_margin(RID p_shape) const override;
@@ -108,6 +123,9 @@ public:
 	virtual Vector<Vector3> space_get_contacts(RID p_space) const override;
 	virtual int space_get_contact_count(RID p_space) const override;
 
+	virtual Vector<uint8_t> space_get_state_snapshot(RID p_space) override;
+	virtual Error space_set_state_snapshot(RID p_space, const Vector<uint8_t> &p_snapshot) override;
+
 	/* AREA API */
 
 	virtual RID area_create() override;
@@ -236,6 +254,7 @@ public:
 	virtual bool body_is_ray_pickable(RID p_body) const override;
 
 	virtual bool body_test_motion(RID p_body, const Transform &p_from, const Vector3 &p_motion, bool p_infinite_inertia, MotionResult *r_result = nullptr, bool p_exclude_raycast_shapes = true) override;
+	virtual int body_test_motion_batch(const RID *p_bodies, const Transform *p_from, const Vector3 *p_motions, int p_count, bool p_infinite_inertia, MotionResult *r_results, bool p_exclude_raycast_shapes = true) override;
 	virtual int body_test_ray_separation(RID p_body, const Transform &p_transform, bool p_infinite_inertia, Vector3 &r_recover_motion, SeparationResult *r_results, int p_result_max, float p_margin = 0.001) override;
 
 	// this function only works on physics process, errors and returns null otherwise
@@ -309,7 +328,9 @@ public:
 
 	/* JOINT API */
 
-	virtual RID joint_create_pin(RID p_body_A, const Vector3 &p_local_A, RID p_body_B, const Vector3 &p_local_B) override;
+	virtual RID joint_create() override;
+
+	virtual bool joint_make_pin(RID p_joint, RID p_body_A, const Vector3 &p_local_A, RID p_body_B, const Vector3 &p_local_B) override;
 
 	virtual void pin_joint_set_param(RID p_joint, PinJointParam p_param, real_t p_value) override;
 	virtual real_t pin_joint_get_param(RID p_joint, PinJointParam p_param) const override;
@@ -320,8 +341,8 @@ public:
 	virtual void pin_joint_set_local_b(RID p_joint, const Vector3 &p_B) override;
 	virtual Vector3 pin_joint_get_local_b(RID p_joint) const override;
 
-	virtual RID joint_create_hinge(RID p_body_A, const Transform &p_frame_A, RID p_body_B, const Transform &p_frame_B) override;
-	virtual RID joint_create_hinge_simple(RID p_body_A, const Vector3 &p_pivot_A, const Vector3 &p_axis_A, RID p_body_B, const Vector3 &p_pivot_B, const Vector3 &p_axis_B) override;
+	virtual bool joint_make_hinge(RID p_joint, RID p_body_A, const Transform &p_frame_A, RID p_body_B, const Transform &p_frame_B) override;
+	virtual bool joint_make_hinge_simple(RID p_joint, RID p_body_A, const Vector3 &p_pivot_A, const Vector3 &p_axis_A, RID p_body_B, const Vector3 &p_pivot_B, const Vector3 &p_axis_B) override;
 
 	virtual void hinge_joint_set_param(RID p_joint, HingeJointParam p_param, real_t p_value) override;
 	virtual real_t hinge_joint_get_param(RID p_joint, HingeJointParam p_param) const override;
@@ -329,17 +350,17 @@ public:
 	virtual void hinge_joint_set_flag(RID p_joint, HingeJointFlag p_flag, bool p_value) override;
 	virtual bool hinge_joint_get_flag(RID p_joint, HingeJointFlag p_flag) const override;
 
-	virtual RID joint_create_slider(RID p_body_A, const Transform &p_local_frame_A, RID p_body_B, const Transform &p_local_frame_B) override; //reference frame is A
+	virtual bool joint_make_slider(RID p_joint, RID p_body_A, const Transform &p_local_frame_A, RID p_body_B, const Transform &p_local_frame_B) override; //reference frame is A
 
 	virtual void slider_joint_set_param(RID p_joint, SliderJointParam p_param, real_t p_value) override;
 	virtual real_t slider_joint_get_param(RID p_joint, SliderJointParam p_param) const override;
 
-	virtual RID joint_create_cone_twist(RID p_body_A, const Transform &p_local_frame_A, RID p_body_B, const Transform &p_local_frame_B) override; //reference frame is A
+	virtual bool joint_make_cone_twist(RID p_joint, RID p_body_A, const Transform &p_local_frame_A, RID p_body_B, const Transform &p_local_frame_B) override; //reference frame is A
 
 	virtual void cone_twist_joint_set_param(RID p_joint, ConeTwistJointParam p_param, real_t p_value) override;
 	virtual real_t cone_twist_joint_get_param(RID p_joint, ConeTwistJointParam p_param) const override;
 
-	virtual RID joint_create_generic_6dof(RID p_body_A, const Transform &p_local_frame_A, RID p_body_B, const Transform &p_local_frame_B) override; //reference frame is A
+	virtual bool joint_make_generic_6dof(RID p_joint, RID p_body_A, const Transform &p_local_frame_A, RID p_body_B, const Transform &p_local_frame_B) override; //reference frame is A
 
 	virtual void generic_6dof_joint_set_param(RID p_joint, Vector3::Axis, G6DOFJointAxisParam p_param, real_t p_value) override;
 	virtual real_t generic_6dof_joint_get_param(RID p_joint, Vector3::Axis, G6DOFJointAxisParam p_param) override;
@@ -0,0 +1,295 @@
+/*************************************************************************/
+/*  physics_server_3d_wrap_mt.cpp                                        */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "physics_server_3d_wrap_mt.h"
+
+#include "core/os/os.h"
+
+void PhysicsServer3DWrapMT::thread_exit() {
+	exit = true;
+}
+
+void PhysicsServer3DWrapMT::thread_step(real_t p_delta) {
+	physics_3d_server->step(p_delta);
+	step_sem.post();
+}
+
+void PhysicsServer3DWrapMT::_thread_callback(void *_instance) {
+	PhysicsServer3DWrapMT *vsmt = reinterpret_cast<PhysicsServer3DWrapMT *>(_instance);
+
+	vsmt->thread_loop();
+}
+
+void PhysicsServer3DWrapMT::thread_loop() {
+	server_thread = Thread::get_caller_id();
+
+	physics_3d_server->init();
+
+	exit = false;
+	step_thread_up = true;
+	while (!exit) {
+		// flush commands one by one, until exit is requested
+		command_queue.wait_and_flush_one();
+	}
+
+	command_queue.flush_all(); // flush all
+
+	physics_3d_server->finish();
+}
+
+/* SHAPE AND BODY POOLS */
+
+int PhysicsServer3DWrapMT::shape_allocn(ShapeType p_shape) {
+	for (int i = 0; i < pool_max_size; i++) {
+		shape_id_pool[p_shape].push_back(physics_3d_server->shape_create(p_shape));
+	}
+	return 0;
+}
+
+void PhysicsServer3DWrapMT::shape_free_cached_ids() {
+	for (int i = 0; i < SHAPE_CUSTOM; i++) {
+		while (shape_id_pool[i].size()) {
+			physics_3d_server->free(shape_id_pool[i].front()->get());
+			shape_id_pool[i].pop_front();
+		}
+	}
+}
+
+RID PhysicsServer3DWrapMT::shape_create(ShapeType p_shape) {
+	if (Thread::get_caller_id() != server_thread) {
+		ERR_FAIL_INDEX_V(p_shape, SHAPE_CUSTOM, RID());
+
+		MutexLock lock(alloc_mutex);
+		if (shape_id_pool[p_shape].size() == 0) {
+			if (create_thread) {
+				int ret;
+				command_queue.push_and_ret(this, &PhysicsServer3DWrapMT::shape_allocn, p_shape, &ret);
+			} else {
+				MutexLock server_lock(server_mutex);
+				shape_allocn(p_shape);
+			}
+		}
+		RID rid = shape_id_pool[p_shape].front()->get();
+		shape_id_pool[p_shape].pop_front();
+		return rid;
+	} else {
+		MutexLock server_lock(server_mutex);
+		_flush_before_direct_call();
+		return physics_3d_server->shape_create(p_shape);
+	}
+}
+
+int PhysicsServer3DWrapMT::body_allocn() {
+	for (int i = 0; i < pool_max_size; i++) {
+		body_id_pool.push_back(physics_3d_server->body_create());
+	}
+	return 0;
+}
+
+void PhysicsServer3DWrapMT::body_free_cached_ids() {
+	while (body_id_pool.size()) {
+		physics_3d_server->free(body_id_pool.front()->get());
+		body_id_pool.pop_front();
+	}
+}
+
+RID PhysicsServer3DWrapMT::body_create(BodyMode p_mode, bool p_init_sleeping) {
+	if (Thread::get_caller_id() != server_thread) {
+		RID rid;
+		{
+			MutexLock lock(alloc_mutex);
+			if (body_id_pool.size() == 0) {
+				if (create_thread) {
+					int ret;
+					command_queue.push_and_ret(this, &PhysicsServer3DWrapMT::body_allocn, &ret);
+				} else {
+					MutexLock server_lock(server_mutex);
+					body_allocn();
+				}
+			}
+			rid = body_id_pool.front()->get();
+			body_id_pool.pop_front();
+		}
+
+		// Pooled bodies are created with the default arguments, queue the
+		// rest. This is what body_create() does with them as well.
+		if (p_mode != BODY_MODE_RIGID) {
+			command_queue.push(physics_3d_server, &PhysicsServer3D::body_set_mode, rid, p_mode);
+		}
+		if (p_init_sleeping) {
+			command_queue.push(physics_3d_server, &PhysicsServer3D::body_set_state, rid, BODY_STATE_SLEEPING, Variant(true));
+		}
+		return rid;
+	} else {
+		MutexLock server_lock(server_mutex);
+		_flush_before_direct_call();
+		return physics_3d_server->body_create(p_mode, p_init_sleeping);
+	}
+}
+
+int PhysicsServer3DWrapMT::soft_body_allocn() {
+	for (int i = 0; i < pool_max_size; i++) {
+		RID rid = physics_3d_server->soft_body_create();
+		if (!rid.is_valid()) {
+			break; // Not supported by this server.
+		}
+		soft_body_id_pool.push_back(rid);
+	}
+	return 0;
+}
+
+void PhysicsServer3DWrapMT::soft_body_free_cached_ids() {
+	while (soft_body_id_pool.size()) {
+		physics_3d_server->free(soft_body_id_pool.front()->get());
+		soft_body_id_pool.pop_front();
+	}
+}
+
+RID PhysicsServer3DWrapMT::soft_body_create(bool p_init_sleeping) {
+	if (Thread::get_caller_id() != server_thread) {
+		RID rid;
+		{
+			MutexLock lock(alloc_mutex);
+			if (soft_body_id_pool.size() == 0) {
+				if (create_thread) {
+					int ret;
+					command_queue.push_and_ret(this, &PhysicsServer3DWrapMT::soft_body_allocn, &ret);
+				} else {
+					MutexLock server_lock(server_mutex);
+					soft_body_allocn();
+				}
+				if (soft_body_id_pool.size() == 0) {
+					return RID();
+				}
+			}
+			rid = soft_body_id_pool.front()->get();
+			soft_body_id_pool.pop_front();
+		}
+
+		if (p_init_sleeping) {
+			command_queue.push(physics_3d_server, &PhysicsServer3D::soft_body_set_state, rid, BODY_STATE_SLEEPING, Variant(true));
+		}
+		return rid;
+	} else {
+		MutexLock server_lock(server_mutex);
+		_flush_before_direct_call();
+		return physics_3d_server->soft_body_create(p_init_sleeping);
+	}
+}
+
+/* EVENT QUEUING */
+
+void PhysicsServer3DWrapMT::step(float p_step) {
+	if (create_thread) {
+		command_queue.push(this, &PhysicsServer3DWrapMT::thread_step, p_step);
+	} else {
+		MutexLock server_lock(server_mutex);
+		command_queue.flush_all(); //flush all pending from other threads
+		stepping = true;
+		physics_3d_server->step(p_step);
+		stepping = false;
+	}
+}
+
+void PhysicsServer3DWrapMT::sync() {
+	if (thread) {
+		if (first_frame) {
+			first_frame = false;
+		} else {
+			step_sem.wait(); //must not wait if a step was not issued
+		}
+	}
+	MutexLock server_lock(server_mutex);
+	physics_3d_server->sync();
+}
+
+void PhysicsServer3DWrapMT::flush_queries() {
+	MutexLock server_lock(server_mutex);
+	stepping = true;
+	physics_3d_server->flush_queries();
+	stepping = false;
+}
+
+void PhysicsServer3DWrapMT::init() {
+	if (create_thread) {
+		thread = Thread::create(_thread_callback, this);
+		while (!step_thread_up) {
+			OS::get_singleton()->delay_usec(1000);
+		}
+	} else {
+		MutexLock server_lock(server_mutex);
+		physics_3d_server->init();
+	}
+}
+
+void PhysicsServer3DWrapMT::finish() {
+	if (thread) {
+		command_queue.push(this, &PhysicsServer3DWrapMT::thread_exit);
+		Thread::wait_to_finish(thread);
+		memdelete(thread);
+
+		thread = nullptr;
+	} else {
+		MutexLock server_lock(server_mutex);
+		physics_3d_server->finish();
+	}
+
+	shape_free_cached_ids();
+	space_free_cached_ids();
+	area_free_cached_ids();
+	body_free_cached_ids();
+	soft_body_free_cached_ids();
+	joint_free_cached_ids();
+}
+
+PhysicsServer3DWrapMT::PhysicsServer3DWrapMT(PhysicsServer3D *p_contained, bool p_create_thread) :
+		command_queue(p_create_thread) {
+	physics_3d_server = p_contained;
+	create_thread = p_create_thread;
+	thread = nullptr;
+	step_pending = 0;
+	step_thread_up = false;
+
+	pool_max_size = GLOBAL_GET("memory/limits/multithreaded_server/rid_pool_prealloc");
+
+	if (!p_create_thread) {
+		server_thread = Thread::get_caller_id();
+	} else {
+		server_thread = 0;
+	}
+
+	main_thread = Thread::get_caller_id();
+	first_frame = true;
+	stepping = false;
+}
+
+PhysicsServer3DWrapMT::~PhysicsServer3DWrapMT() {
+	memdelete(physics_3d_server);
+}
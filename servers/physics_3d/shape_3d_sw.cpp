@@ -30,6 +30,7 @@
 
 #include "shape_3d_sw.h"
 
+#include "core/io/marshalls.h"
 #include "core/math/geometry_3d.h"
 #include "core/math/quick_hull.h"
 #include "core/sort_array.h"
@@ -1074,52 +1075,44 @@ Vector3 ConcavePolygonShape3DSW::get_support(const Vector3 &p_normal) const {
 	return vptr[vert_support_idx];
 }
 
-void ConcavePolygonShape3DSW::_cull_segment(int p_idx, _SegmentCullParams *p_params) const {
-	const BVH *bvh = &p_params->bvh[p_idx];
+_FORCE_INLINE_ void ConcavePolygonShape3DSW::_quantize_aabb(const AABB &p_aabb, uint16_t *r_min, uint16_t *r_max, int p_pad) const {
+	Vector3 from = (p_aabb.position - bvh_origin) * bvh_scale;
+	Vector3 to = (p_aabb.position + p_aabb.size - bvh_origin) * bvh_scale;
 
-	/*
-	if (p_params->dir.dot(bvh->aabb.get_support(-p_params->dir))>p_params->min_d)
-		return; //test against whole AABB, which isn't very costly
-	*/
-
-	//printf("addr: %p\n",bvh);
-	if (!bvh->aabb.intersects_segment(p_params->from, p_params->to)) {
-		return;
+	for (int i = 0; i < 3; i++) {
+		r_min[i] = CLAMP(Math::floor(from[i]) - p_pad, 0, BVH_QUANTIZE_MAX);
+		r_max[i] = CLAMP(Math::ceil(to[i]) + p_pad, 0, BVH_QUANTIZE_MAX);
 	}
+}
 
-	if (bvh->face_index >= 0) {
-		Vector3 res;
-		Vector3 vertices[3] = {
-			p_params->vertices[p_params->faces[bvh->face_index].indices[0]],
-			p_params->vertices[p_params->faces[bvh->face_index].indices[1]],
-			p_params->vertices[p_params->faces[bvh->face_index].indices[2]]
-		};
+_FORCE_INLINE_ bool ConcavePolygonShape3DSW::_segment_intersects_node(const BVH &p_node, const Vector3 &p_from, const Vector3 &p_dir, const Vector3 &p_inv_dir, real_t p_max_t) const {
+	real_t min_t = 0;
+	real_t max_t = p_max_t;
+
+	for (int i = 0; i < 3; i++) {
+		real_t node_min = bvh_origin[i] + p_node.min[i] * bvh_inv_scale[i] - CMP_EPSILON;
+		real_t node_max = bvh_origin[i] + p_node.max[i] * bvh_inv_scale[i] + CMP_EPSILON;
 
-		if (Geometry3D::segment_intersects_triangle(
-					p_params->from,
-					p_params->to,
-					vertices[0],
-					vertices[1],
-					vertices[2],
-					&res)) {
-			real_t d = p_params->dir.dot(res) - p_params->dir.dot(p_params->from);
-			//TODO, seems segmen/triangle intersection is broken :(
-			if (d > 0 && d < p_params->min_d) {
-				p_params->min_d = d;
-				p_params->result = res;
-				p_params->normal = Plane(vertices[0], vertices[1], vertices[2]).normal;
-				p_params->collisions++;
+		if (Math::abs(p_dir[i]) < CMP_EPSILON) {
+			if (p_from[i] < node_min || p_from[i] > node_max) {
+				return false;
 			}
+			continue;
 		}
 
-	} else {
-		if (bvh->left >= 0) {
-			_cull_segment(bvh->left, p_params);
+		real_t t0 = (node_min - p_from[i]) * p_inv_dir[i];
+		real_t t1 = (node_max - p_from[i]) * p_inv_dir[i];
+		if (t0 > t1) {
+			SWAP(t0, t1);
 		}
-		if (bvh->right >= 0) {
-			_cull_segment(bvh->right, p_params);
+		min_t = MAX(min_t, t0);
+		max_t = MIN(max_t, t1);
+		if (min_t > max_t) {
+			return false;
 		}
 	}
+
+	return true;
 }
 
 bool ConcavePolygonShape3DSW::intersect_segment(const Vector3 &p_begin, const Vector3 &p_end, Vector3 &r_result, Vector3 &r_normal) const {
@@ -1131,28 +1124,59 @@ bool ConcavePolygonShape3DSW::intersect_segment(const Vector3 &p_begin, const Ve
 	const Face *fr = faces.ptr();
 	const Vector3 *vr = vertices.ptr();
 	const BVH *br = bvh.ptr();
+	const uint32_t *bfr = bvh_faces.ptr();
+	uint32_t node_count = bvh.size();
 
-	_SegmentCullParams params;
-	params.from = p_begin;
-	params.to = p_end;
-	params.collisions = 0;
-	params.dir = (p_end - p_begin).normalized();
+	Vector3 dir = p_end - p_begin;
+	real_t length = dir.length();
+	if (length < CMP_EPSILON) {
+		return false;
+	}
+	Vector3 normal_dir = dir / length;
+	Vector3 inv_dir;
+	for (int i = 0; i < 3; i++) {
+		inv_dir[i] = Math::abs(dir[i]) < CMP_EPSILON ? 0 : 1.0 / dir[i];
+	}
 
-	params.faces = fr;
-	params.vertices = vr;
-	params.bvh = br;
+	real_t min_d = 1e20;
+	int collisions = 0;
+	uint32_t node_idx = 0;
 
-	params.min_d = 1e20;
-	// cull
-	_cull_segment(0, &params);
+	while (node_idx < node_count) {
+		const BVH &node = br[node_idx];
+		// the segment is shortened to the closest hit found so far
+		bool hit = _segment_intersects_node(node, p_begin, dir, inv_dir, MIN(min_d / length, 1.0));
 
-	if (params.collisions > 0) {
-		r_result = params.result;
-		r_normal = params.normal;
-		return true;
-	} else {
-		return false;
+		if (!(node.data & BVH_LEAF_BIT)) {
+			node_idx = hit ? node_idx + 1 : node.data;
+			continue;
+		}
+
+		node_idx++;
+		if (!hit) {
+			continue;
+		}
+
+		uint32_t first = (node.data & ~BVH_LEAF_BIT) >> 2;
+		uint32_t count = (node.data & 3) + 1;
+
+		for (uint32_t i = first; i < first + count; i++) {
+			const Face &f = fr[bfr[i]];
+			Vector3 res;
+
+			if (Geometry3D::segment_intersects_triangle(p_begin, p_end, vr[f.indices[0]], vr[f.indices[1]], vr[f.indices[2]], &res)) {
+				real_t d = normal_dir.dot(res) - normal_dir.dot(p_begin);
+				if (d > 0 && d < min_d) {
+					min_d = d;
+					r_result = res;
+					r_normal = f.normal;
+					collisions++;
+				}
+			}
+		}
 	}
+
+	return collisions > 0;
 }
 
 bool ConcavePolygonShape3DSW::intersect_point(const Vector3 &p_point) const {
@@ -1163,59 +1187,68 @@ Vector3 ConcavePolygonShape3DSW::get_closest_point_to(const Vector3 &p_point) co
 	return Vector3();
 }
 
-void ConcavePolygonShape3DSW::_cull(int p_idx, _CullParams *p_params) const {
-	const BVH *bvh = &p_params->bvh[p_idx];
-
-	if (!p_params->aabb.intersects(bvh->aabb)) {
-		return;
-	}
-
-	if (bvh->face_index >= 0) {
-		const Face *f = &p_params->faces[bvh->face_index];
-		FaceShape3DSW *face = p_params->face;
-		face->normal = f->normal;
-		face->vertex[0] = p_params->vertices[f->indices[0]];
-		face->vertex[1] = p_params->vertices[f->indices[1]];
-		face->vertex[2] = p_params->vertices[f->indices[2]];
-		p_params->callback(p_params->userdata, face);
-
-	} else {
-		if (bvh->left >= 0) {
-			_cull(bvh->left, p_params);
-		}
-
-		if (bvh->right >= 0) {
-			_cull(bvh->right, p_params);
-		}
-	}
-}
-
 void ConcavePolygonShape3DSW::cull(const AABB &p_local_aabb, Callback p_callback, void *p_userdata) const {
 	// make matrix local to concave
 	if (faces.size() == 0) {
 		return;
 	}
 
-	AABB local_aabb = p_local_aabb;
+	if (!p_local_aabb.intersects(get_aabb())) {
+		return;
+	}
 
 	// unlock data
 	const Face *fr = faces.ptr();
 	const Vector3 *vr = vertices.ptr();
 	const BVH *br = bvh.ptr();
+	const uint32_t *bfr = bvh_faces.ptr();
+	uint32_t node_count = bvh.size();
+
+	uint16_t query_min[3];
+	uint16_t query_max[3];
+	_quantize_aabb(p_local_aabb, query_min, query_max, 0);
 
 	FaceShape3DSW face; // use this to send in the callback
 
-	_CullParams params;
-	params.aabb = local_aabb;
-	params.face = &face;
-	params.faces = fr;
-	params.vertices = vr;
-	params.bvh = br;
-	params.callback = p_callback;
-	params.userdata = p_userdata;
+	uint32_t node_idx = 0;
+
+	while (node_idx < node_count) {
+		const BVH &node = br[node_idx];
+		// integer compares, no branching until the result is needed
+		bool overlap = (node.min[0] <= query_max[0]) & (node.max[0] >= query_min[0]) &
+					   (node.min[1] <= query_max[1]) & (node.max[1] >= query_min[1]) &
+					   (node.min[2] <= query_max[2]) & (node.max[2] >= query_min[2]);
+
+		if (!(node.data & BVH_LEAF_BIT)) {
+			node_idx = overlap ? node_idx + 1 : node.data;
+			continue;
+		}
+
+		node_idx++;
+		if (!overlap) {
+			continue;
+		}
+
+		uint32_t first = (node.data & ~BVH_LEAF_BIT) >> 2;
+		uint32_t count = (node.data & 3) + 1;
 
-	// cull
-	_cull(0, &params);
+		for (uint32_t i = first; i < first + count; i++) {
+			const Face &f = fr[bfr[i]];
+
+			AABB face_aabb(vr[f.indices[0]], Vector3());
+			face_aabb.expand_to(vr[f.indices[1]]);
+			face_aabb.expand_to(vr[f.indices[2]]);
+			if (!p_local_aabb.intersects(face_aabb)) {
+				continue;
+			}
+
+			face.normal = f.normal;
+			face.vertex[0] = vr[f.indices[0]];
+			face.vertex[1] = vr[f.indices[1]];
+			face.vertex[2] = vr[f.indices[2]];
+			p_callback(p_userdata, &face);
+		}
+	}
 }
 
 Vector3 ConcavePolygonShape3DSW::get_moment_of_inertia(real_t p_mass) const {
@@ -1228,129 +1261,355 @@ Vector3 ConcavePolygonShape3DSW::get_moment_of_inertia(real_t p_mass) const {
 			(p_mass / 3.0) * (extents.y * extents.y + extents.y * extents.y));
 }
 
-struct _VolumeSW_BVH_Element {
-	AABB aabb;
-	Vector3 center;
-	int face_index;
-};
-
 struct _VolumeSW_BVH_CompareX {
-	_FORCE_INLINE_ bool operator()(const _VolumeSW_BVH_Element &a, const _VolumeSW_BVH_Element &b) const {
+	_FORCE_INLINE_ bool operator()(const ConcavePolygonShape3DSW::_BVHBuildFace &a, const ConcavePolygonShape3DSW::_BVHBuildFace &b) const {
 		return a.center.x < b.center.x;
 	}
 };
 
 struct _VolumeSW_BVH_CompareY {
-	_FORCE_INLINE_ bool operator()(const _VolumeSW_BVH_Element &a, const _VolumeSW_BVH_Element &b) const {
+	_FORCE_INLINE_ bool operator()(const ConcavePolygonShape3DSW::_BVHBuildFace &a, const ConcavePolygonShape3DSW::_BVHBuildFace &b) const {
 		return a.center.y < b.center.y;
 	}
 };
 
 struct _VolumeSW_BVH_CompareZ {
-	_FORCE_INLINE_ bool operator()(const _VolumeSW_BVH_Element &a, const _VolumeSW_BVH_Element &b) const {
+	_FORCE_INLINE_ bool operator()(const ConcavePolygonShape3DSW::_BVHBuildFace &a, const ConcavePolygonShape3DSW::_BVHBuildFace &b) const {
 		return a.center.z < b.center.z;
 	}
 };
 
-struct _VolumeSW_BVH {
-	AABB aabb;
-	_VolumeSW_BVH *left;
-	_VolumeSW_BVH *right;
+#define _BVH_SAH_BINS 12
+#define _BVH_SAH_TRAVERSAL_COST 1.0
+#define _BVH_SAH_MAX_DEPTH 64
+#define _BVH_DATA_VERSION 1
 
-	int face_index;
-};
+static _FORCE_INLINE_ real_t _bvh_surface_area(const AABB &p_aabb) {
+	return 2.0 * (p_aabb.size.x * p_aabb.size.y + p_aabb.size.y * p_aabb.size.z + p_aabb.size.z * p_aabb.size.x);
+}
+
+void ConcavePolygonShape3DSW::_build_bvh_node(_BVHBuildFace *p_faces, int p_count, int p_depth, LocalVector<BVH> &r_nodes, LocalVector<uint32_t> &r_faces) const {
+	uint32_t node_idx = r_nodes.size();
+	r_nodes.push_back(BVH());
+
+	AABB aabb = p_faces[0].aabb;
+	AABB centers(p_faces[0].center, Vector3());
+	for (int i = 1; i < p_count; i++) {
+		aabb.merge_with(p_faces[i].aabb);
+		centers.expand_to(p_faces[i].center);
+	}
+
+	// pad by one unit, so float to double imprecision in saved trees stays conservative
+	_quantize_aabb(aabb, r_nodes[node_idx].min, r_nodes[node_idx].max, 1);
+
+	// binned surface area heuristic, a leaf costs one unit per face
+
+	real_t best_cost = p_count <= BVH_MAX_LEAF_FACES ? real_t(p_count) : 1e20;
+	int best_axis = -1;
+	int best_bin = 0;
+	real_t area = _bvh_surface_area(aabb);
+	real_t inv_area = area > CMP_EPSILON ? 1.0 / area : 1.0;
+
+	for (int axis = 0; axis < 3 && p_depth < _BVH_SAH_MAX_DEPTH; axis++) {
+		real_t extent = centers.size[axis];
+		if (extent < CMP_EPSILON) {
+			continue;
+		}
+		real_t bin_scale = _BVH_SAH_BINS / extent;
+
+		int bin_count[_BVH_SAH_BINS] = {};
+		AABB bin_aabb[_BVH_SAH_BINS];
+
+		for (int i = 0; i < p_count; i++) {
+			int bin = MIN(int((p_faces[i].center[axis] - centers.position[axis]) * bin_scale), _BVH_SAH_BINS - 1);
+			if (bin_count[bin] == 0) {
+				bin_aabb[bin] = p_faces[i].aabb;
+			} else {
+				bin_aabb[bin].merge_with(p_faces[i].aabb);
+			}
+			bin_count[bin]++;
+		}
+
+		int right_count[_BVH_SAH_BINS];
+		real_t right_area[_BVH_SAH_BINS];
+		AABB accum;
+		int accum_count = 0;
+
+		for (int bin = _BVH_SAH_BINS - 1; bin > 0; bin--) {
+			if (bin_count[bin]) {
+				if (accum_count == 0) {
+					accum = bin_aabb[bin];
+				} else {
+					accum.merge_with(bin_aabb[bin]);
+				}
+				accum_count += bin_count[bin];
+			}
+			right_count[bin] = accum_count;
+			right_area[bin] = accum_count ? _bvh_surface_area(accum) : 0;
+		}
+
+		accum_count = 0;
+
+		for (int bin = 0; bin < _BVH_SAH_BINS - 1; bin++) {
+			if (bin_count[bin]) {
+				if (accum_count == 0) {
+					accum = bin_aabb[bin];
+				} else {
+					accum.merge_with(bin_aabb[bin]);
+				}
+				accum_count += bin_count[bin];
+			}
+
+			if (accum_count == 0 || right_count[bin + 1] == 0) {
+				continue;
+			}
 
-_VolumeSW_BVH *_volume_sw_build_bvh(_VolumeSW_BVH_Element *p_elements, int p_size, int &count) {
-	_VolumeSW_BVH *bvh = memnew(_VolumeSW_BVH);
+			real_t cost = _BVH_SAH_TRAVERSAL_COST + (_bvh_surface_area(accum) * accum_count + right_area[bin + 1] * right_count[bin + 1]) * inv_area;
+			if (cost < best_cost) {
+				best_cost = cost;
+				best_axis = axis;
+				best_bin = bin + 1;
+			}
+		}
+	}
 
-	if (p_size == 1) {
+	if (best_axis == -1 && p_count <= BVH_MAX_LEAF_FACES) {
 		//leaf
-		bvh->aabb = p_elements[0].aabb;
-		bvh->left = nullptr;
-		bvh->right = nullptr;
-		bvh->face_index = p_elements->face_index;
-		count++;
-		return bvh;
-	} else {
-		bvh->face_index = -1;
+		r_nodes[node_idx].data = BVH_LEAF_BIT | (r_faces.size() << 2) | (p_count - 1);
+		for (int i = 0; i < p_count; i++) {
+			r_faces.push_back(p_faces[i].face_index);
+		}
+		return;
 	}
 
-	AABB aabb;
-	for (int i = 0; i < p_size; i++) {
-		if (i == 0) {
-			aabb = p_elements[i].aabb;
-		} else {
-			aabb.merge_with(p_elements[i].aabb);
+	int split = 0;
+
+	if (best_axis != -1) {
+		real_t bin_scale = _BVH_SAH_BINS / centers.size[best_axis];
+		int last = p_count - 1;
+
+		while (split <= last) {
+			int bin = MIN(int((p_faces[split].center[best_axis] - centers.position[best_axis]) * bin_scale), _BVH_SAH_BINS - 1);
+			if (bin < best_bin) {
+				split++;
+			} else {
+				SWAP(p_faces[split], p_faces[last]);
+				last--;
+			}
+		}
+	} else {
+		// too deep or no useful split (coincident centers), fall back to a median split
+		switch (centers.get_longest_axis_index()) {
+			case 0: {
+				SortArray<_BVHBuildFace, _VolumeSW_BVH_CompareX> sort_x;
+				sort_x.sort(p_faces, p_count);
+			} break;
+			case 1: {
+				SortArray<_BVHBuildFace, _VolumeSW_BVH_CompareY> sort_y;
+				sort_y.sort(p_faces, p_count);
+			} break;
+			case 2: {
+				SortArray<_BVHBuildFace, _VolumeSW_BVH_CompareZ> sort_z;
+				sort_z.sort(p_faces, p_count);
+			} break;
 		}
+		split = p_count / 2;
 	}
-	bvh->aabb = aabb;
-	switch (aabb.get_longest_axis_index()) {
-		case 0: {
-			SortArray<_VolumeSW_BVH_Element, _VolumeSW_BVH_CompareX> sort_x;
-			sort_x.sort(p_elements, p_size);
 
-		} break;
-		case 1: {
-			SortArray<_VolumeSW_BVH_Element, _VolumeSW_BVH_CompareY> sort_y;
-			sort_y.sort(p_elements, p_size);
-		} break;
-		case 2: {
-			SortArray<_VolumeSW_BVH_Element, _VolumeSW_BVH_CompareZ> sort_z;
-			sort_z.sort(p_elements, p_size);
-		} break;
+	_build_bvh_node(p_faces, split, p_depth + 1, r_nodes, r_faces);
+	_build_bvh_node(&p_faces[split], p_count - split, p_depth + 1, r_nodes, r_faces);
+
+	r_nodes[node_idx].data = r_nodes.size(); // skip the whole subtree on a miss
+}
+
+void ConcavePolygonShape3DSW::_build_bvh() {
+	int face_count = faces.size();
+	const Face *fr = faces.ptr();
+	const Vector3 *vr = vertices.ptr();
+
+	LocalVector<_BVHBuildFace> build_faces;
+	build_faces.resize(face_count);
+
+	for (int i = 0; i < face_count; i++) {
+		AABB face_aabb(vr[fr[i].indices[0]], Vector3());
+		face_aabb.expand_to(vr[fr[i].indices[1]]);
+		face_aabb.expand_to(vr[fr[i].indices[2]]);
+		build_faces[i].aabb = face_aabb;
+		build_faces[i].center = face_aabb.position + face_aabb.size * 0.5;
+		build_faces[i].face_index = i;
 	}
 
-	int split = p_size / 2;
-	bvh->left = _volume_sw_build_bvh(p_elements, split, count);
-	bvh->right = _volume_sw_build_bvh(&p_elements[split], p_size - split, count);
+	LocalVector<BVH> nodes;
+	LocalVector<uint32_t> leaf_faces;
+	nodes.reserve(face_count);
+	leaf_faces.reserve(face_count);
 
-	//printf("branch at %p - %i: %i\n",bvh,count,bvh->face_index);
-	count++;
-	return bvh;
+	_build_bvh_node(build_faces.ptr(), face_count, 0, nodes, leaf_faces);
+
+	bvh.resize(nodes.size());
+	memcpy(bvh.ptrw(), nodes.ptr(), sizeof(BVH) * nodes.size());
+	bvh_faces.resize(leaf_faces.size());
+	memcpy(bvh_faces.ptrw(), leaf_faces.ptr(), sizeof(uint32_t) * leaf_faces.size());
 }
 
-void ConcavePolygonShape3DSW::_fill_bvh(_VolumeSW_BVH *p_bvh_tree, BVH *p_bvh_array, int &p_idx) {
-	int idx = p_idx;
+Vector<uint8_t> ConcavePolygonShape3DSW::get_bvh_data() const {
+	Vector<uint8_t> data;
+	if (bvh.size() == 0) {
+		return data;
+	}
 
-	p_bvh_array[idx].aabb = p_bvh_tree->aabb;
-	p_bvh_array[idx].face_index = p_bvh_tree->face_index;
-	//printf("%p - %i: %i(%p)  -- %p:%p\n",%p_bvh_array[idx],p_idx,p_bvh_array[i]->face_index,&p_bvh_tree->face_index,p_bvh_tree->left,p_bvh_tree->right);
+	int node_count = bvh.size();
+	int leaf_face_count = bvh_faces.size();
+	data.resize(4 + 4 * 4 + 6 * 4 + node_count * sizeof(BVH) + leaf_face_count * 4);
 
-	if (p_bvh_tree->left) {
-		p_bvh_array[idx].left = ++p_idx;
-		_fill_bvh(p_bvh_tree->left, p_bvh_array, p_idx);
+	uint8_t *w = data.ptrw();
+	w[0] = 'C';
+	w[1] = 'B';
+	w[2] = 'V';
+	w[3] = 'H';
+	w += 4;
+	w += encode_uint32(_BVH_DATA_VERSION, w);
+	w += encode_uint32(faces.size(), w);
+	w += encode_uint32(node_count, w);
+	w += encode_uint32(leaf_face_count, w);
+	for (int i = 0; i < 3; i++) {
+		w += encode_float(bvh_origin[i], w);
+	}
+	for (int i = 0; i < 3; i++) {
+		w += encode_float(bvh_inv_scale[i], w);
+	}
 
-	} else {
-		p_bvh_array[p_idx].left = -1;
+	const BVH *br = bvh.ptr();
+	for (int i = 0; i < node_count; i++) {
+		for (int j = 0; j < 3; j++) {
+			w += encode_uint16(br[i].min[j], w);
+		}
+		for (int j = 0; j < 3; j++) {
+			w += encode_uint16(br[i].max[j], w);
+		}
+		w += encode_uint32(br[i].data, w);
 	}
 
-	if (p_bvh_tree->right) {
-		p_bvh_array[idx].right = ++p_idx;
-		_fill_bvh(p_bvh_tree->right, p_bvh_array, p_idx);
+	const uint32_t *bfr = bvh_faces.ptr();
+	for (int i = 0; i < leaf_face_count; i++) {
+		w += encode_uint32(bfr[i], w);
+	}
 
-	} else {
-		p_bvh_array[p_idx].right = -1;
+	return data;
+}
+
+bool ConcavePolygonShape3DSW::_load_bvh(const Vector<uint8_t> &p_data) {
+	// a stale or damaged tree is not an error, the caller just builds a new one
+	int header_size = 4 + 4 * 4 + 6 * 4;
+	if (p_data.size() < header_size) {
+		return false;
+	}
+
+	const uint8_t *r = p_data.ptr();
+	if (r[0] != 'C' || r[1] != 'B' || r[2] != 'V' || r[3] != 'H') {
+		return false;
+	}
+	r += 4;
+
+	uint32_t version = decode_uint32(&r[0]);
+	uint32_t face_count = decode_uint32(&r[4]);
+	uint32_t node_count = decode_uint32(&r[8]);
+	uint32_t leaf_face_count = decode_uint32(&r[12]);
+	r += 16;
+
+	if (version != _BVH_DATA_VERSION || face_count != uint32_t(faces.size()) || leaf_face_count != face_count || node_count == 0 || node_count > face_count * 2) {
+		return false;
+	}
+	if (int64_t(p_data.size()) != header_size + int64_t(node_count) * int64_t(sizeof(BVH)) + int64_t(leaf_face_count) * 4) {
+		return false;
+	}
+
+	Vector3 origin;
+	Vector3 inv_scale;
+	for (int i = 0; i < 3; i++) {
+		origin[i] = decode_float(r);
+		r += 4;
+	}
+	for (int i = 0; i < 3; i++) {
+		inv_scale[i] = decode_float(r);
+		r += 4;
+	}
+
+	// the tree must have been built for these faces
+	const AABB &aabb = get_aabb();
+	real_t tolerance = MAX(aabb.size.x, MAX(aabb.size.y, aabb.size.z)) * 0.0001 + CMP_EPSILON;
+	if ((origin - aabb.position).length() > tolerance) {
+		return false;
+	}
+	if ((inv_scale * BVH_QUANTIZE_MAX - aabb.size).length() > tolerance) {
+		return false;
+	}
+
+	bvh.resize(node_count);
+	BVH *bw = bvh.ptrw();
+	for (uint32_t i = 0; i < node_count; i++) {
+		for (int j = 0; j < 3; j++) {
+			bw[i].min[j] = decode_uint16(r);
+			r += 2;
+		}
+		for (int j = 0; j < 3; j++) {
+			bw[i].max[j] = decode_uint16(r);
+			r += 2;
+		}
+		bw[i].data = decode_uint32(r);
+		r += 4;
+
+		if (bw[i].data & BVH_LEAF_BIT) {
+			uint32_t first = (bw[i].data & ~BVH_LEAF_BIT) >> 2;
+			uint32_t count = (bw[i].data & 3) + 1;
+			if (first + count > leaf_face_count) {
+				bvh.clear();
+				return false;
+			}
+		} else if (bw[i].data <= i + 1 || bw[i].data > node_count) {
+			bvh.clear();
+			return false;
+		}
 	}
 
-	memdelete(p_bvh_tree);
+	bvh_faces.resize(leaf_face_count);
+	uint32_t *bfw = bvh_faces.ptrw();
+	for (uint32_t i = 0; i < leaf_face_count; i++) {
+		bfw[i] = decode_uint32(r);
+		r += 4;
+		if (bfw[i] >= face_count) {
+			bvh.clear();
+			bvh_faces.clear();
+			return false;
+		}
+	}
+
+	bvh_origin = origin;
+	for (int i = 0; i < 3; i++) {
+		bvh_inv_scale[i] = inv_scale[i];
+		bvh_scale[i] = inv_scale[i] > 0 ? 1.0 / inv_scale[i] : 0;
+	}
+
+	return true;
 }
 
-void ConcavePolygonShape3DSW::_setup(Vector<Vector3> p_faces) {
+void ConcavePolygonShape3DSW::_setup(const Vector<Vector3> &p_faces, const Vector<uint8_t> &p_bvh_data) {
+	bvh.clear();
+	bvh_faces.clear();
+
 	int src_face_count = p_faces.size();
 	if (src_face_count == 0) {
+		faces.clear();
+		vertices.clear();
 		configure(AABB());
 		return;
 	}
 	ERR_FAIL_COND(src_face_count % 3);
 	src_face_count /= 3;
+	ERR_FAIL_COND_MSG(src_face_count >= BVH_MAX_FACES, "Too many faces in concave polygon shape.");
 
 	const Vector3 *facesr = p_faces.ptr();
 
-	Vector<_VolumeSW_BVH_Element> bvh_array;
-	bvh_array.resize(src_face_count);
-
-	_VolumeSW_BVH_Element *bvh_arrayw = bvh_array.ptrw();
-
 	faces.resize(src_face_count);
 	Face *facesw = faces.ptrw();
 
@@ -1363,9 +1622,6 @@ void ConcavePolygonShape3DSW::_setup(Vector<Vector3> p_faces) {
 	for (int i = 0; i < src_face_count; i++) {
 		Face3 face(facesr[i * 3 + 0], facesr[i * 3 + 1], facesr[i * 3 + 2]);
 
-		bvh_arrayw[i].aabb = face.get_aabb();
-		bvh_arrayw[i].center = bvh_arrayw[i].aabb.position + bvh_arrayw[i].aabb.size * 0.5;
-		bvh_arrayw[i].face_index = i;
 		facesw[i].indices[0] = i * 3 + 0;
 		facesw[i].indices[1] = i * 3 + 1;
 		facesw[i].indices[2] = i * 3 + 2;
@@ -1374,27 +1630,40 @@ void ConcavePolygonShape3DSW::_setup(Vector<Vector3> p_faces) {
 		verticesw[i * 3 + 1] = face.vertex[1];
 		verticesw[i * 3 + 2] = face.vertex[2];
 		if (i == 0) {
-			_aabb = bvh_arrayw[i].aabb;
+			_aabb = face.get_aabb();
 		} else {
-			_aabb.merge_with(bvh_arrayw[i].aabb);
+			_aabb.merge_with(face.get_aabb());
 		}
 	}
 
-	int count = 0;
-	_VolumeSW_BVH *bvh_tree = _volume_sw_build_bvh(bvh_arrayw, src_face_count, count);
-
-	bvh.resize(count + 1);
+	configure(_aabb); // this type of shape has no margin
 
-	BVH *bvh_arrayw2 = bvh.ptrw();
+	if (p_bvh_data.size() && _load_bvh(p_bvh_data)) {
+		return;
+	}
 
-	int idx = 0;
-	_fill_bvh(bvh_tree, bvh_arrayw2, idx);
+	bvh_origin = _aabb.position;
+	for (int i = 0; i < 3; i++) {
+		bvh_scale[i] = _aabb.size[i] > CMP_EPSILON ? BVH_QUANTIZE_MAX / _aabb.size[i] : 0;
+		bvh_inv_scale[i] = _aabb.size[i] > CMP_EPSILON ? _aabb.size[i] / BVH_QUANTIZE_MAX : 0;
+	}
 
-	configure(_aabb); // this type of shape has no margin
+	_build_bvh();
 }
 
 void ConcavePolygonShape3DSW::set_data(const Variant &p_data) {
-	_setup(p_data);
+	if (p_data.get_type() == Variant::DICTIONARY) {
+		// faces plus a tree previously returned by get_bvh_data()
+		Dictionary d = p_data;
+		ERR_FAIL_COND(!d.has("faces"));
+		Vector<uint8_t> bvh_data;
+		if (d.has("bvh")) {
+			bvh_data = d["bvh"];
+		}
+		_setup(d["faces"], bvh_data);
+	} else {
+		_setup(p_data, Vector<uint8_t>());
+	}
 }
 
 Variant ConcavePolygonShape3DSW::get_data() const {
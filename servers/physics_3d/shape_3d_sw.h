@@ -31,6 +31,7 @@
 #ifndef SHAPE_SW_H
 #define SHAPE_SW_H
 
+#include "core/local_vector.h"
 #include "core/math/geometry_3d.h"
 #include "servers/physics_server_3d.h"
 /*
@@ -276,7 +277,6 @@ public:
 	ConvexPolygonShape3DSW();
 };
 
-struct _VolumeSW_BVH;
 struct FaceShape3DSW;
 
 struct ConcavePolygonShape3DSW : public ConcaveShape3DSW {
@@ -290,49 +290,50 @@ struct ConcavePolygonShape3DSW : public ConcaveShape3DSW {
 	Vector<Face> faces;
 	Vector<Vector3> vertices;
 
-	struct BVH {
-		AABB aabb;
-		int left;
-		int right;
-
-		int face_index;
+	enum {
+		BVH_MAX_LEAF_FACES = 4,
+		BVH_MAX_FACES = 1 << 29,
+		BVH_QUANTIZE_MAX = 65535,
 	};
 
-	Vector<BVH> bvh;
+	enum : uint32_t {
+		BVH_LEAF_BIT = 0x80000000,
+	};
 
-	struct _CullParams {
-		AABB aabb;
-		Callback callback;
-		void *userdata;
-		const Face *faces;
-		const Vector3 *vertices;
-		const BVH *bvh;
-		FaceShape3DSW *face;
+	// Bounds are quantized to 16 bits inside the shape AABB, so four nodes fit a cache line.
+	// Nodes are stored depth first: a branch is followed by its left child and "data" is the
+	// index right past its subtree, which allows traversing without a stack.
+	// Leaves store BVH_LEAF_BIT | (first << 2) | (count - 1), indexing into bvh_faces.
+	struct BVH {
+		uint16_t min[3];
+		uint16_t max[3];
+		uint32_t data;
 	};
 
-	struct _SegmentCullParams {
-		Vector3 from;
-		Vector3 to;
-		const Face *faces;
-		const Vector3 *vertices;
-		const BVH *bvh;
-		Vector3 dir;
+	Vector<BVH> bvh;
+	Vector<uint32_t> bvh_faces;
+	Vector3 bvh_origin;
+	Vector3 bvh_scale;
+	Vector3 bvh_inv_scale;
 
-		Vector3 result;
-		Vector3 normal;
-		real_t min_d;
-		int collisions;
+	struct _BVHBuildFace {
+		AABB aabb;
+		Vector3 center;
+		uint32_t face_index;
 	};
 
-	void _cull_segment(int p_idx, _SegmentCullParams *p_params) const;
-	void _cull(int p_idx, _CullParams *p_params) const;
+	_FORCE_INLINE_ void _quantize_aabb(const AABB &p_aabb, uint16_t *r_min, uint16_t *r_max, int p_pad) const;
+	_FORCE_INLINE_ bool _segment_intersects_node(const BVH &p_node, const Vector3 &p_from, const Vector3 &p_dir, const Vector3 &p_inv_dir, real_t p_max_t) const;
 
-	void _fill_bvh(_VolumeSW_BVH *p_bvh_tree, BVH *p_bvh_array, int &p_idx);
+	void _build_bvh_node(_BVHBuildFace *p_faces, int p_count, int p_depth, LocalVector<BVH> &r_nodes, LocalVector<uint32_t> &r_faces) const;
+	void _build_bvh();
+	bool _load_bvh(const Vector<uint8_t> &p_data);
 
-	void _setup(Vector<Vector3> p_faces);
+	void _setup(const Vector<Vector3> &p_faces, const Vector<uint8_t> &p_bvh_data);
 
 public:
 	Vector<Vector3> get_faces() const;
+	Vector<uint8_t> get_bvh_data() const;
 
 	virtual PhysicsServer3D::ShapeType get_type() const { return PhysicsServer3D::SHAPE_CONCAVE_POLYGON; }
 
@@ -50,7 +50,7 @@ _FORCE_INLINE_ static bool _can_collide_with(CollisionObject3DSW *p_object, uint
 	return true;
 }
 
-int PhysicsDirectSpaceState3DSW::intersect_point(const Vector3 &p_point, ShapeResult *r_results, int p_result_max, const Set<RID> &p_exclude, uint32_t p_collision_mask, bool p_collide_with_bodies, bool p_collide_with_areas) {
+int PhysicsDirectSpaceState3DSW::intersect_point(const Vector3 &p_point, ShapeResult *r_results, int p_result_max, const PhysicsQueryFilter &p_exclude, uint32_t p_collision_mask, bool p_collide_with_bodies, bool p_collide_with_areas) {
 	ERR_FAIL_COND_V(space->locked, false);
 	int amount = space->broadphase->cull_point(p_point, space->intersection_query_results, Space3DSW::INTERSECTION_QUERY_MAX, space->intersection_query_subindex_results);
 	int cc = 0;
@@ -68,7 +68,7 @@ int PhysicsDirectSpaceState3DSW::intersect_point(const Vector3 &p_point, ShapeRe
 
 		//area can't be picked by ray (default)
 
-		if (p_exclude.has(space->intersection_query_results[i]->get_self())) {
+		if (p_exclude.is_excluded(space->intersection_query_results[i]->get_self(), space->intersection_query_results[i]->get_instance_id())) {
 			continue;
 		}
 
@@ -97,7 +97,7 @@ int PhysicsDirectSpaceState3DSW::intersect_point(const Vector3 &p_point, ShapeRe
 	return cc;
 }
 
-bool PhysicsDirectSpaceState3DSW::intersect_ray(const Vector3 &p_from, const Vector3 &p_to, RayResult &r_result, const Set<RID> &p_exclude, uint32_t p_collision_mask, bool p_collide_with_bodies, bool p_collide_with_areas, bool p_pick_ray) {
+bool PhysicsDirectSpaceState3DSW::intersect_ray(const Vector3 &p_from, const Vector3 &p_to, RayResult &r_result, const PhysicsQueryFilter &p_exclude, uint32_t p_collision_mask, bool p_collide_with_bodies, bool p_collide_with_areas, bool p_pick_ray) {
 	ERR_FAIL_COND_V(space->locked, false);
 
 	Vector3 begin, end;
@@ -125,7 +125,7 @@ bool PhysicsDirectSpaceState3DSW::intersect_ray(const Vector3 &p_from, const Vec
 			continue;
 		}
 
-		if (p_exclude.has(space->intersection_query_results[i]->get_self())) {
+		if (p_exclude.is_excluded(space->intersection_query_results[i]->get_self(), space->intersection_query_results[i]->get_instance_id())) {
 			continue;
 		}
 
@@ -176,7 +176,7 @@ bool PhysicsDirectSpaceState3DSW::intersect_ray(const Vector3 &p_from, const Vec
 	return true;
 }
 
-int PhysicsDirectSpaceState3DSW::intersect_shape(const RID &p_shape, const Transform &p_xform, real_t p_margin, ShapeResult *r_results, int p_result_max, const Set<RID> &p_exclude, uint32_t p_collision_mask, bool p_collide_with_bodies, bool p_collide_with_areas) {
+int PhysicsDirectSpaceState3DSW::intersect_shape(const RID &p_shape, const Transform &p_xform, real_t p_margin, ShapeResult *r_results, int p_result_max, const PhysicsQueryFilter &p_exclude, uint32_t p_collision_mask, bool p_collide_with_bodies, bool p_collide_with_areas) {
 	if (p_result_max <= 0) {
 		return 0;
 	}
@@ -203,7 +203,7 @@ int PhysicsDirectSpaceState3DSW::intersect_shape(const RID &p_shape, const Trans
 
 		//area can't be picked by ray (default)
 
-		if (p_exclude.has(space->intersection_query_results[i]->get_self())) {
+		if (p_exclude.is_excluded(space->intersection_query_results[i]->get_self(), space->intersection_query_results[i]->get_instance_id())) {
 			continue;
 		}
 
@@ -231,7 +231,7 @@ int PhysicsDirectSpaceState3DSW::intersect_shape(const RID &p_shape, const Trans
 	return cc;
 }
 
-bool PhysicsDirectSpaceState3DSW::cast_motion(const RID &p_shape, const Transform &p_xform, const Vector3 &p_motion, real_t p_margin, real_t &p_closest_safe, real_t &p_closest_unsafe, const Set<RID> &p_exclude, uint32_t p_collision_mask, bool p_collide_with_bodies, bool p_collide_with_areas, ShapeRestInfo *r_info) {
+bool PhysicsDirectSpaceState3DSW::cast_motion(const RID &p_shape, const Transform &p_xform, const Vector3 &p_motion, real_t p_margin, real_t &p_closest_safe, real_t &p_closest_unsafe, const PhysicsQueryFilter &p_exclude, uint32_t p_collision_mask, bool p_collide_with_bodies, bool p_collide_with_areas, ShapeRestInfo *r_info) {
 	Shape3DSW *shape = static_cast<PhysicsServer3DSW *>(PhysicsServer3D::get_singleton())->shape_owner.getornull(p_shape);
 	ERR_FAIL_COND_V(!shape, false);
 
@@ -258,7 +258,7 @@ bool PhysicsDirectSpaceState3DSW::cast_motion(const RID &p_shape, const Transfor
 			continue;
 		}
 
-		if (p_exclude.has(space->intersection_query_results[i]->get_self())) {
+		if (p_exclude.is_excluded(space->intersection_query_results[i]->get_self(), space->intersection_query_results[i]->get_instance_id())) {
 			continue; //ignore excluded
 		}
 
@@ -284,14 +284,14 @@ bool PhysicsDirectSpaceState3DSW::cast_motion(const RID &p_shape, const Transfor
 		//just do kinematic solving
 		real_t low = 0;
 		real_t hi = 1;
-		Vector3 mnormal = p_motion.normalized();
+		// Start from the axis that separated the shapes at rest. Each separated step writes
+		// its axis back, so the next one warm starts GJK close to the contact.
+		Vector3 sep = sep_axis;
 
 		for (int j = 0; j < 8; j++) { //steps should be customizable..
 
 			real_t ofs = (low + hi) * 0.5;
 
-			Vector3 sep = mnormal; //important optimization for this to work fast enough
-
 			mshape.motion = xform_inv.basis.xform(p_motion * ofs);
 
 			Vector3 lA, lB;
@@ -335,7 +335,7 @@ bool PhysicsDirectSpaceState3DSW::cast_motion(const RID &p_shape, const Transfor
 	return true;
 }
 
-bool PhysicsDirectSpaceState3DSW::collide_shape(RID p_shape, const Transform &p_shape_xform, real_t p_margin, Vector3 *r_results, int p_result_max, int &r_result_count, const Set<RID> &p_exclude, uint32_t p_collision_mask, bool p_collide_with_bodies, bool p_collide_with_areas) {
+bool PhysicsDirectSpaceState3DSW::collide_shape(RID p_shape, const Transform &p_shape_xform, real_t p_margin, Vector3 *r_results, int p_result_max, int &r_result_count, const PhysicsQueryFilter &p_exclude, uint32_t p_collision_mask, bool p_collide_with_bodies, bool p_collide_with_areas) {
 	if (p_result_max <= 0) {
 		return false;
 	}
@@ -367,7 +367,7 @@ bool PhysicsDirectSpaceState3DSW::collide_shape(RID p_shape, const Transform &p_
 		const CollisionObject3DSW *col_obj = space->intersection_query_results[i];
 		int shape_idx = space->intersection_query_subindex_results[i];
 
-		if (p_exclude.has(col_obj->get_self())) {
+		if (p_exclude.is_excluded(col_obj->get_self(), col_obj->get_instance_id())) {
 			continue;
 		}
 
@@ -411,7 +411,7 @@ static void _rest_cbk_result(const Vector3 &p_point_A, const Vector3 &p_point_B,
 	rd->best_shape = rd->shape;
 }
 
-bool PhysicsDirectSpaceState3DSW::rest_info(RID p_shape, const Transform &p_shape_xform, real_t p_margin, ShapeRestInfo *r_info, const Set<RID> &p_exclude, uint32_t p_collision_mask, bool p_collide_with_bodies, bool p_collide_with_areas) {
+bool PhysicsDirectSpaceState3DSW::rest_info(RID p_shape, const Transform &p_shape_xform, real_t p_margin, ShapeRestInfo *r_info, const PhysicsQueryFilter &p_exclude, uint32_t p_collision_mask, bool p_collide_with_bodies, bool p_collide_with_areas) {
 	Shape3DSW *shape = static_cast<PhysicsServer3DSW *>(PhysicsServer3D::get_singleton())->shape_owner.getornull(p_shape);
 	ERR_FAIL_COND_V(!shape, 0);
 
@@ -434,7 +434,7 @@ bool PhysicsDirectSpaceState3DSW::rest_info(RID p_shape, const Transform &p_shap
 		const CollisionObject3DSW *col_obj = space->intersection_query_results[i];
 		int shape_idx = space->intersection_query_subindex_results[i];
 
-		if (p_exclude.has(col_obj->get_self())) {
+		if (p_exclude.is_excluded(col_obj->get_self(), col_obj->get_instance_id())) {
 			continue;
 		}
 
@@ -545,6 +545,24 @@ int Space3DSW::_cull_aabb_for_body(Body3DSW *p_body, const AABB &p_aabb) {
 	return amount;
 }
 
+int Space3DSW::_cull_aabb_for_body(Body3DSW *p_body, const AABB &p_aabb, BodyCull &r_cull) {
+	if (!r_cull.use_candidates) {
+		return _cull_aabb_for_body(p_body, p_aabb);
+	}
+
+	// the candidates were already filtered against the body
+	int amount = 0;
+	for (int i = 0; i < r_cull.candidate_count; i++) {
+		if (r_cull.candidates[i]->get_shape_aabb(r_cull.candidate_subindices[i]).intersects(p_aabb)) {
+			r_cull.results[amount] = r_cull.candidates[i];
+			r_cull.subindex_results[amount] = r_cull.candidate_subindices[i];
+			amount++;
+		}
+	}
+
+	return amount;
+}
+
 int Space3DSW::test_body_ray_separation(Body3DSW *p_body, const Transform &p_transform, bool p_infinite_inertia, Vector3 &r_recover_motion, PhysicsServer3D::SeparationResult *r_results, int p_result_max, real_t p_margin) {
 	AABB body_aabb;
 
@@ -698,7 +716,7 @@ int Space3DSW::test_body_ray_separation(Body3DSW *p_body, const Transform &p_tra
 	return rays_found;
 }
 
-bool Space3DSW::test_body_motion(Body3DSW *p_body, const Transform &p_from, const Vector3 &p_motion, bool p_infinite_inertia, real_t p_margin, PhysicsServer3D::MotionResult *r_result, bool p_exclude_raycast_shapes) {
+bool Space3DSW::_test_body_motion(Body3DSW *p_body, const Transform &p_from, const Vector3 &p_motion, bool p_infinite_inertia, real_t p_margin, PhysicsServer3D::MotionResult *r_result, bool p_exclude_raycast_shapes, BodyCull &p_cull) {
 	//give me back regular physics engine logic
 	//this is madness
 	//and most people using this function will think
@@ -759,7 +777,7 @@ bool Space3DSW::test_body_motion(Body3DSW *p_body, const Transform &p_from, cons
 
 			bool collided = false;
 
-			int amount = _cull_aabb_for_body(p_body, body_aabb);
+			int amount = _cull_aabb_for_body(p_body, body_aabb, p_cull);
 
 			for (int j = 0; j < p_body->get_shape_count(); j++) {
 				if (p_body->is_shape_set_as_disabled(j)) {
@@ -773,8 +791,8 @@ bool Space3DSW::test_body_motion(Body3DSW *p_body, const Transform &p_from, cons
 				}
 
 				for (int i = 0; i < amount; i++) {
-					const CollisionObject3DSW *col_obj = intersection_query_results[i];
-					int shape_idx = intersection_query_subindex_results[i];
+					const CollisionObject3DSW *col_obj = p_cull.results[i];
+					int shape_idx = p_cull.subindex_results[i];
 
 					if (CollisionSolver3DSW::solve_static(body_shape, body_shape_xform, col_obj->get_shape(shape_idx), col_obj->get_transform() * col_obj->get_shape_transform(shape_idx), cbkres, cbkptr, nullptr, p_margin)) {
 						collided = cbk.amount > 0;
@@ -818,7 +836,7 @@ bool Space3DSW::test_body_motion(Body3DSW *p_body, const Transform &p_from, cons
 		motion_aabb.position += p_motion;
 		motion_aabb = motion_aabb.merge(body_aabb);
 
-		int amount = _cull_aabb_for_body(p_body, motion_aabb);
+		int amount = _cull_aabb_for_body(p_body, motion_aabb, p_cull);
 
 		for (int j = 0; j < p_body->get_shape_count(); j++) {
 			if (p_body->is_shape_set_as_disabled(j)) {
@@ -843,8 +861,8 @@ bool Space3DSW::test_body_motion(Body3DSW *p_body, const Transform &p_from, cons
 			real_t best_unsafe = 1;
 
 			for (int i = 0; i < amount; i++) {
-				const CollisionObject3DSW *col_obj = intersection_query_results[i];
-				int shape_idx = intersection_query_subindex_results[i];
+				const CollisionObject3DSW *col_obj = p_cull.results[i];
+				int shape_idx = p_cull.subindex_results[i];
 
 				//test initial overlap, does it collide if going all the way?
 				Vector3 point_A, point_B;
@@ -865,14 +883,13 @@ bool Space3DSW::test_body_motion(Body3DSW *p_body, const Transform &p_from, cons
 				//just do kinematic solving
 				real_t low = 0;
 				real_t hi = 1;
-				Vector3 mnormal = p_motion.normalized();
+				// Start from the axis that separated the shapes at rest, see cast_motion().
+				Vector3 sep = sep_axis;
 
 				for (int k = 0; k < 8; k++) { //steps should be customizable..
 
 					real_t ofs = (low + hi) * 0.5;
 
-					Vector3 sep = mnormal; //important optimization for this to work fast enough
-
 					mshape.motion = body_shape_xform_inv.basis.xform(p_motion * ofs);
 
 					Vector3 lA, lB;
@@ -937,11 +954,11 @@ bool Space3DSW::test_body_motion(Body3DSW *p_body, const Transform &p_from, cons
 
 		body_aabb.position += p_motion * unsafe;
 
-		int amount = _cull_aabb_for_body(p_body, body_aabb);
+		int amount = _cull_aabb_for_body(p_body, body_aabb, p_cull);
 
 		for (int i = 0; i < amount; i++) {
-			const CollisionObject3DSW *col_obj = intersection_query_results[i];
-			int shape_idx = intersection_query_subindex_results[i];
+			const CollisionObject3DSW *col_obj = p_cull.results[i];
+			int shape_idx = p_cull.subindex_results[i];
 
 			rcd.object = col_obj;
 			rcd.shape = shape_idx;
@@ -986,6 +1003,104 @@ bool Space3DSW::test_body_motion(Body3DSW *p_body, const Transform &p_from, cons
 	return collided;
 }
 
+bool Space3DSW::test_body_motion(Body3DSW *p_body, const Transform &p_from, const Vector3 &p_motion, bool p_infinite_inertia, real_t p_margin, PhysicsServer3D::MotionResult *r_result, bool p_exclude_raycast_shapes) {
+	BodyCull cull;
+	cull.results = intersection_query_results;
+	cull.subindex_results = intersection_query_subindex_results;
+
+	return _test_body_motion(p_body, p_from, p_motion, p_infinite_inertia, p_margin, r_result, p_exclude_raycast_shapes, cull);
+}
+
+void Space3DSW::_test_body_motion_batch_item(uint32_t p_index, void *p_userdata) {
+	BatchMotion &bm = batch_motions[p_index];
+
+	CollisionObject3DSW *results[INTERSECTION_QUERY_MAX];
+	int subindex_results[INTERSECTION_QUERY_MAX];
+
+	BodyCull cull;
+	cull.results = results;
+	cull.subindex_results = subindex_results;
+	cull.use_candidates = true;
+	cull.candidates = batch_candidates.ptr() + bm.candidate_from;
+	cull.candidate_subindices = batch_candidate_subindices.ptr() + bm.candidate_from;
+	cull.candidate_count = bm.candidate_count;
+
+	bm.collided = _test_body_motion(bm.body, bm.from, bm.motion, batch_infinite_inertia, bm.body->get_kinematic_margin(), bm.result, batch_exclude_raycast_shapes, cull);
+}
+
+int Space3DSW::test_body_motion_batch(Body3DSW *const *p_bodies, const Transform *p_from, const Vector3 *p_motions, int p_count, bool p_infinite_inertia, PhysicsServer3D::MotionResult *r_results, bool p_exclude_raycast_shapes, ThreadWorkPool *p_work_pool) {
+	batch_motions.resize(p_count);
+	batch_candidates.clear();
+	batch_candidate_subindices.clear();
+	batch_infinite_inertia = p_infinite_inertia;
+	batch_exclude_raycast_shapes = p_exclude_raycast_shapes;
+
+	// Gather everything each body may touch on this thread. The cull covers the whole motion,
+	// plus half the body size for the recovery steps that push it out of overlaps.
+
+	for (int i = 0; i < p_count; i++) {
+		BatchMotion &bm = batch_motions[i];
+		bm.body = p_bodies[i];
+		bm.from = p_from[i];
+		bm.motion = p_motions[i];
+		bm.result = &r_results[i];
+		bm.candidate_from = batch_candidates.size();
+		bm.candidate_count = 0;
+		bm.collided = false;
+
+		Body3DSW *body = p_bodies[i];
+		AABB body_aabb;
+		bool shapes_found = false;
+
+		for (int j = 0; j < body->get_shape_count(); j++) {
+			if (body->is_shape_set_as_disabled(j)) {
+				continue;
+			}
+
+			if (!shapes_found) {
+				body_aabb = body->get_shape_aabb(j);
+				shapes_found = true;
+			} else {
+				body_aabb = body_aabb.merge(body->get_shape_aabb(j));
+			}
+		}
+
+		if (!shapes_found) {
+			continue;
+		}
+
+		body_aabb = p_from[i].xform(body->get_inv_transform().xform(body_aabb));
+		AABB motion_aabb = body_aabb;
+		motion_aabb.position += p_motions[i];
+		motion_aabb = motion_aabb.merge(body_aabb);
+		motion_aabb = motion_aabb.grow(body->get_kinematic_margin() + body_aabb.get_longest_axis_size() * 0.5);
+
+		int amount = _cull_aabb_for_body(body, motion_aabb);
+		for (int j = 0; j < amount; j++) {
+			batch_candidates.push_back(intersection_query_results[j]);
+			batch_candidate_subindices.push_back(intersection_query_subindex_results[j]);
+		}
+		bm.candidate_count = amount;
+	}
+
+	if (p_work_pool) {
+		p_work_pool->do_work(p_count, this, &Space3DSW::_test_body_motion_batch_item, (void *)nullptr);
+	} else {
+		for (int i = 0; i < p_count; i++) {
+			_test_body_motion_batch_item(i, nullptr);
+		}
+	}
+
+	int collided = 0;
+	for (int i = 0; i < p_count; i++) {
+		if (batch_motions[i].collided) {
+			collided++;
+		}
+	}
+
+	return collided;
+}
+
 void *Space3DSW::_broadphase_pair(CollisionObject3DSW *A, int p_subindex_A, CollisionObject3DSW *B, int p_subindex_B, void *p_self) {
 	if (!A->test_collision_mask(B)) {
 		return nullptr;
@@ -1033,6 +1148,14 @@ void Space3DSW::_broadphase_unpair(CollisionObject3DSW *A, int p_subindex_A, Col
 	memdelete(c);
 }
 
+void Space3DSW::body_pair_add_to_list(SelfList<BodyPair3DSW> *p_pair) {
+	body_pair_list.add(p_pair);
+}
+
+void Space3DSW::body_pair_remove_from_list(SelfList<BodyPair3DSW> *p_pair) {
+	body_pair_list.remove(p_pair);
+}
+
 const SelfList<Body3DSW>::List &Space3DSW::get_active_body_list() const {
 	return active_list;
 }
@@ -1197,6 +1320,382 @@ PhysicsDirectSpaceState3DSW *Space3DSW::get_direct_state() {
 	return direct_access;
 }
 
+/* STATE SNAPSHOTS */
+
+// Snapshots are meant for rollback inside the same process, so values are stored in
+// native layout. Bodies are keyed by RID and pairs by their bodies and shapes, which keeps
+// the blob independent of allocation order.
+
+#define SNAPSHOT_MAGIC 0x33535350 // "PSS3"
+#define SNAPSHOT_VERSION 1
+
+template <class T>
+static _FORCE_INLINE_ void _snapshot_write(uint8_t *&r_ptr, const T &p_value) {
+	memcpy(r_ptr, &p_value, sizeof(T));
+	r_ptr += sizeof(T);
+}
+
+template <class T>
+static _FORCE_INLINE_ void _snapshot_read(const uint8_t *&r_ptr, T &r_value) {
+	memcpy(&r_value, r_ptr, sizeof(T));
+	r_ptr += sizeof(T);
+}
+
+struct _SnapshotBodySort {
+	_FORCE_INLINE_ bool operator()(const Body3DSW *p_a, const Body3DSW *p_b) const {
+		return p_a->get_self() < p_b->get_self();
+	}
+};
+
+enum {
+	SNAPSHOT_HEADER_SIZE = sizeof(uint32_t) * 6,
+	SNAPSHOT_BODY_SIZE = sizeof(uint64_t) + sizeof(Transform) * 2 + sizeof(Vector3) * 4 + sizeof(real_t) + sizeof(uint8_t),
+	SNAPSHOT_PAIR_SIZE = (sizeof(uint64_t) + sizeof(uint32_t)) * 2 + sizeof(Vector3) + sizeof(uint32_t),
+	SNAPSHOT_CONTACT_SIZE = sizeof(Vector3) * 4 + sizeof(real_t) * 3,
+};
+
+enum {
+	SNAPSHOT_BODY_ACTIVE = 1,
+	SNAPSHOT_BODY_FIRST_INTEGRATION = 2,
+	SNAPSHOT_BODY_FIRST_TIME_KINEMATIC = 4,
+};
+
+int Space3DSW::get_contact_count() const {
+	int count = 0;
+	for (const SelfList<BodyPair3DSW> *E = body_pair_list.first(); E; E = E->next()) {
+		count += E->self()->contact_count;
+	}
+	return count;
+}
+
+void Space3DSW::_snapshot_gather() {
+	snapshot_bodies.clear();
+	for (Set<CollisionObject3DSW *>::Element *E = objects.front(); E; E = E->next()) {
+		if (E->get()->get_type() == CollisionObject3DSW::TYPE_BODY) {
+			snapshot_bodies.push_back(static_cast<Body3DSW *>(E->get()));
+		}
+	}
+	snapshot_bodies.sort_custom<_SnapshotBodySort>();
+
+	snapshot_pairs.clear();
+	for (SelfList<BodyPair3DSW> *E = body_pair_list.first(); E; E = E->next()) {
+		BodyPair3DSW *pair = E->self();
+		SnapshotPair sp;
+		sp.A = pair->A->get_self();
+		sp.shape_A = pair->shape_A;
+		sp.B = pair->B->get_self();
+		sp.shape_B = pair->shape_B;
+		sp.pair = pair;
+		snapshot_pairs.push_back(sp);
+	}
+	snapshot_pairs.sort();
+}
+
+Vector<uint8_t> Space3DSW::get_state_snapshot() {
+	ERR_FAIL_COND_V_MSG(locked, Vector<uint8_t>(), "Can't take a snapshot of a space while it is being stepped.");
+
+	solve_in_order = true;
+
+	_snapshot_gather();
+
+	uint32_t active_count = 0;
+	for (const SelfList<Body3DSW> *E = active_list.first(); E; E = E->next()) {
+		active_count++;
+	}
+
+	uint32_t size = SNAPSHOT_HEADER_SIZE;
+	size += snapshot_bodies.size() * SNAPSHOT_BODY_SIZE;
+	size += active_count * sizeof(uint32_t);
+	for (uint32_t i = 0; i < snapshot_pairs.size(); i++) {
+		size += SNAPSHOT_PAIR_SIZE + snapshot_pairs[i].pair->contact_count * SNAPSHOT_CONTACT_SIZE;
+	}
+
+	Vector<uint8_t> snapshot;
+	snapshot.resize(size);
+	uint8_t *w = snapshot.ptrw();
+
+	_snapshot_write<uint32_t>(w, SNAPSHOT_MAGIC);
+	_snapshot_write<uint32_t>(w, SNAPSHOT_VERSION);
+	_snapshot_write<uint32_t>(w, sizeof(real_t));
+	_snapshot_write<uint32_t>(w, snapshot_bodies.size());
+	_snapshot_write<uint32_t>(w, active_count);
+	_snapshot_write<uint32_t>(w, snapshot_pairs.size());
+
+	for (uint32_t i = 0; i < snapshot_bodies.size(); i++) {
+		const Body3DSW *body = snapshot_bodies[i];
+		uint8_t flags = 0;
+		if (body->active) {
+			flags |= SNAPSHOT_BODY_ACTIVE;
+		}
+		if (body->first_integration) {
+			flags |= SNAPSHOT_BODY_FIRST_INTEGRATION;
+		}
+		if (body->first_time_kinematic) {
+			flags |= SNAPSHOT_BODY_FIRST_TIME_KINEMATIC;
+		}
+
+		_snapshot_write<uint64_t>(w, body->get_self().get_id());
+		_snapshot_write(w, body->get_transform());
+		_snapshot_write(w, body->new_transform);
+		_snapshot_write(w, body->linear_velocity);
+		_snapshot_write(w, body->angular_velocity);
+		_snapshot_write(w, body->applied_force);
+		_snapshot_write(w, body->applied_torque);
+		_snapshot_write(w, body->still_time);
+		_snapshot_write(w, flags);
+	}
+
+	// The active list order decides integration and island order, so it is part of the state.
+	for (const SelfList<Body3DSW> *E = active_list.first(); E; E = E->next()) {
+		uint32_t index = 0;
+		uint32_t count = snapshot_bodies.size();
+		while (count > 0) { // Binary search, bodies are sorted by RID.
+			uint32_t half = count / 2;
+			if (snapshot_bodies[index + half]->get_self() < E->self()->get_self()) {
+				index += half + 1;
+				count -= half + 1;
+			} else {
+				count = half;
+			}
+		}
+		_snapshot_write<uint32_t>(w, index);
+	}
+
+	for (uint32_t i = 0; i < snapshot_pairs.size(); i++) {
+		const SnapshotPair &sp = snapshot_pairs[i];
+		const BodyPair3DSW *pair = sp.pair;
+
+		_snapshot_write<uint64_t>(w, sp.A.get_id());
+		_snapshot_write<uint32_t>(w, sp.shape_A);
+		_snapshot_write<uint64_t>(w, sp.B.get_id());
+		_snapshot_write<uint32_t>(w, sp.shape_B);
+		_snapshot_write(w, pair->sep_axis);
+		_snapshot_write<uint32_t>(w, pair->contact_count);
+
+		for (int j = 0; j < pair->contact_count; j++) {
+			const BodyPair3DSW::Contact &c = pair->contacts[j];
+			_snapshot_write(w, c.local_A);
+			_snapshot_write(w, c.local_B);
+			_snapshot_write(w, c.normal);
+			_snapshot_write(w, c.acc_tangent_impulse);
+			_snapshot_write(w, c.acc_normal_impulse);
+			_snapshot_write(w, c.acc_bias_impulse);
+			_snapshot_write(w, c.acc_bias_impulse_center_of_mass);
+		}
+	}
+
+	CRASH_COND(w != snapshot.ptr() + size);
+
+	return snapshot;
+}
+
+// Walks the whole blob before anything is changed, so a corrupt snapshot can't leave
+// the space partially restored.
+bool Space3DSW::_snapshot_validate(const uint8_t *p_ptr, const uint8_t *p_end, uint32_t p_body_count, uint32_t p_active_count, uint32_t p_pair_count) {
+	if (p_end - p_ptr < (int64_t)p_body_count * SNAPSHOT_BODY_SIZE + (int64_t)p_active_count * (int64_t)sizeof(uint32_t)) {
+		return false;
+	}
+	p_ptr += p_body_count * SNAPSHOT_BODY_SIZE;
+
+	for (uint32_t i = 0; i < p_active_count; i++) {
+		uint32_t index;
+		_snapshot_read(p_ptr, index);
+		if (index >= p_body_count) {
+			return false;
+		}
+	}
+
+	for (uint32_t i = 0; i < p_pair_count; i++) {
+		if (p_end - p_ptr < SNAPSHOT_PAIR_SIZE) {
+			return false;
+		}
+		p_ptr += SNAPSHOT_PAIR_SIZE - sizeof(uint32_t);
+
+		uint32_t contact_count;
+		_snapshot_read(p_ptr, contact_count);
+		if (contact_count > BodyPair3DSW::MAX_CONTACTS || p_end - p_ptr < (int64_t)contact_count * SNAPSHOT_CONTACT_SIZE) {
+			return false;
+		}
+		p_ptr += contact_count * SNAPSHOT_CONTACT_SIZE;
+	}
+
+	return p_ptr == p_end;
+}
+
+Error Space3DSW::set_state_snapshot(const Vector<uint8_t> &p_snapshot) {
+	ERR_FAIL_COND_V_MSG(locked, ERR_LOCKED, "Can't restore a snapshot while the space is being stepped.");
+	ERR_FAIL_COND_V(p_snapshot.size() < SNAPSHOT_HEADER_SIZE, ERR_INVALID_DATA);
+
+	solve_in_order = true;
+
+	const uint8_t *r = p_snapshot.ptr();
+	const uint8_t *end = r + p_snapshot.size();
+
+	uint32_t magic, version, real_size, body_count, active_count, pair_count;
+	_snapshot_read(r, magic);
+	_snapshot_read(r, version);
+	_snapshot_read(r, real_size);
+	_snapshot_read(r, body_count);
+	_snapshot_read(r, active_count);
+	_snapshot_read(r, pair_count);
+
+	ERR_FAIL_COND_V_MSG(magic != SNAPSHOT_MAGIC || version != SNAPSHOT_VERSION, ERR_INVALID_DATA, "Invalid or incompatible physics space snapshot.");
+	ERR_FAIL_COND_V_MSG(real_size != sizeof(real_t), ERR_INVALID_DATA, "Physics space snapshot was taken with a different real_t precision.");
+	ERR_FAIL_COND_V_MSG(!_snapshot_validate(r, end, body_count, active_count, pair_count), ERR_INVALID_DATA, "Corrupt physics space snapshot.");
+
+	_snapshot_gather();
+
+	// Bodies, matched against the current ones by RID. Bodies created after the snapshot
+	// was taken are left as they are.
+
+	LocalVector<Body3DSW *> body_map;
+	body_map.resize(body_count);
+
+	uint32_t current = 0;
+	for (uint32_t i = 0; i < body_count; i++) {
+		uint64_t id;
+		Transform transform;
+		uint8_t flags;
+
+		_snapshot_read(r, id);
+		while (current < snapshot_bodies.size() && snapshot_bodies[current]->get_self().get_id() < id) {
+			current++;
+		}
+
+		if (current == snapshot_bodies.size() || snapshot_bodies[current]->get_self().get_id() != id) {
+			body_map[i] = nullptr; // Freed since the snapshot was taken.
+			r += SNAPSHOT_BODY_SIZE - sizeof(uint64_t);
+			continue;
+		}
+
+		Body3DSW *body = snapshot_bodies[current];
+		body_map[i] = body;
+
+		_snapshot_read(r, transform);
+		_snapshot_read(r, body->new_transform);
+		_snapshot_read(r, body->linear_velocity);
+		_snapshot_read(r, body->angular_velocity);
+		_snapshot_read(r, body->applied_force);
+		_snapshot_read(r, body->applied_torque);
+		_snapshot_read(r, body->still_time);
+		_snapshot_read(r, flags);
+
+		if (transform != body->get_transform()) {
+			body->_set_transform(transform);
+			body->_set_inv_transform(transform.affine_inverse());
+			body->_update_transform_dependant();
+		}
+
+		body->first_integration = flags & SNAPSHOT_BODY_FIRST_INTEGRATION;
+		body->first_time_kinematic = flags & SNAPSHOT_BODY_FIRST_TIME_KINEMATIC;
+		body->active = false; // Re-added below, in the original order.
+		body->biased_linear_velocity = Vector3();
+		body->biased_angular_velocity = Vector3();
+	}
+
+	// Rebuild the active list: restored bodies first, in snapshot order, then any body
+	// that is unknown to the snapshot but currently active.
+
+	LocalVector<Body3DSW *> unknown_active;
+	while (active_list.first()) {
+		Body3DSW *body = active_list.first()->self();
+		if (body->active) {
+			unknown_active.push_back(body);
+		}
+		active_list.remove(active_list.first());
+	}
+
+	for (uint32_t i = 0; i < active_count; i++) {
+		uint32_t index;
+		_snapshot_read(r, index);
+		Body3DSW *body = body_map[index];
+		if (body && !body->active) {
+			body->active = true;
+			active_list.add_last(&body->active_list);
+		}
+	}
+
+	for (uint32_t i = 0; i < unknown_active.size(); i++) {
+		active_list.add_last(&unknown_active[i]->active_list);
+	}
+
+	// Let the broadphase create and remove pairs for the restored transforms, then bring
+	// back the contact caches used for warm starting.
+
+	broadphase->update();
+	_snapshot_gather();
+
+	for (uint32_t i = 0; i < snapshot_pairs.size(); i++) {
+		BodyPair3DSW *pair = snapshot_pairs[i].pair;
+		pair->contact_count = 0;
+		pair->sep_axis = Vector3();
+		pair->collided = false;
+	}
+
+	current = 0;
+	for (uint32_t i = 0; i < pair_count; i++) {
+		uint64_t id_A, id_B;
+		uint32_t shape_A, shape_B, contact_count;
+		Vector3 sep_axis;
+
+		_snapshot_read(r, id_A);
+		_snapshot_read(r, shape_A);
+		_snapshot_read(r, id_B);
+		_snapshot_read(r, shape_B);
+		_snapshot_read(r, sep_axis);
+		_snapshot_read(r, contact_count);
+
+		while (current < snapshot_pairs.size()) {
+			const SnapshotPair &sp = snapshot_pairs[current];
+			if (sp.A.get_id() != id_A) {
+				if (sp.A.get_id() > id_A) {
+					break;
+				}
+			} else if (sp.shape_A != (int)shape_A) {
+				if (sp.shape_A > (int)shape_A) {
+					break;
+				}
+			} else if (sp.B.get_id() != id_B) {
+				if (sp.B.get_id() > id_B) {
+					break;
+				}
+			} else if (sp.shape_B >= (int)shape_B) {
+				break;
+			}
+			current++;
+		}
+
+		BodyPair3DSW *pair = nullptr;
+		if (current < snapshot_pairs.size()) {
+			const SnapshotPair &sp = snapshot_pairs[current];
+			if (sp.A.get_id() == id_A && sp.shape_A == (int)shape_A && sp.B.get_id() == id_B && sp.shape_B == (int)shape_B) {
+				pair = sp.pair;
+			}
+		}
+
+		if (!pair) {
+			r += contact_count * SNAPSHOT_CONTACT_SIZE;
+			continue;
+		}
+
+		pair->sep_axis = sep_axis;
+		pair->contact_count = contact_count;
+
+		for (uint32_t j = 0; j < contact_count; j++) {
+			BodyPair3DSW::Contact &c = pair->contacts[j];
+			_snapshot_read(r, c.local_A);
+			_snapshot_read(r, c.local_B);
+			_snapshot_read(r, c.normal);
+			_snapshot_read(r, c.acc_tangent_impulse);
+			_snapshot_read(r, c.acc_normal_impulse);
+			_snapshot_read(r, c.acc_bias_impulse);
+			_snapshot_read(r, c.acc_bias_impulse_center_of_mass);
+		}
+	}
+
+	return OK;
+}
+
 Space3DSW::Space3DSW() {
 	collision_pairs = 0;
 	active_objects = 0;
@@ -1215,6 +1714,7 @@ Space3DSW::Space3DSW() {
 	body_time_to_sleep = GLOBAL_DEF("physics/3d/time_before_sleep", 0.5);
 	ProjectSettings::get_singleton()->set_custom_property_info("physics/3d/time_before_sleep", PropertyInfo(Variant::FLOAT, "physics/3d/time_before_sleep", PROPERTY_HINT_RANGE, "0,5,0.01,or_greater"));
 	body_angular_velocity_damp_ratio = 10;
+	batched_contact_solver = GLOBAL_DEF("physics/3d/batched_contact_solver", false);
 
 	broadphase = BroadPhase3DSW::create_func();
 	broadphase->set_pair_callback(_broadphase_pair, this);
@@ -38,7 +38,9 @@
 #include "broad_phase_3d_sw.h"
 #include "collision_object_3d_sw.h"
 #include "core/hash_map.h"
+#include "core/local_vector.h"
 #include "core/project_settings.h"
+#include "core/thread_work_pool.h"
 #include "core/typedefs.h"
 
 class PhysicsDirectSpaceState3DSW : public PhysicsDirectSpaceState3D {
@@ -47,12 +49,12 @@ class PhysicsDirectSpaceState3DSW : public PhysicsDirectSpaceState3D {
 public:
 	Space3DSW *space;
 
-	virtual int intersect_point(const Vector3 &p_point, ShapeResult *r_results, int p_result_max, const Set<RID> &p_exclude = Set<RID>(), uint32_t p_collision_mask = 0xFFFFFFFF, bool p_collide_with_bodies = true, bool p_collide_with_areas = false) override;
-	virtual bool intersect_ray(const Vector3 &p_from, const Vector3 &p_to, RayResult &r_result, const Set<RID> &p_exclude = Set<RID>(), uint32_t p_collision_mask = 0xFFFFFFFF, bool p_collide_with_bodies = true, bool p_collide_with_areas = false, bool p_pick_ray = false) override;
-	virtual int intersect_shape(const RID &p_shape, const Transform &p_xform, real_t p_margin, ShapeResult *r_results, int p_result_max, const Set<RID> &p_exclude = Set<RID>(), uint32_t p_collision_mask = 0xFFFFFFFF, bool p_collide_with_bodies = true, bool p_collide_with_areas = false) override;
-	virtual bool cast_motion(const RID &p_shape, const Transform &p_xform, const Vector3 &p_motion, real_t p_margin, real_t &p_closest_safe, real_t &p_closest_unsafe, const Set<RID> &p_exclude = Set<RID>(), uint32_t p_collision_mask = 0xFFFFFFFF, bool p_collide_with_bodies = true, bool p_collide_with_areas = false, ShapeRestInfo *r_info = nullptr) override;
-	virtual bool collide_shape(RID p_shape, const Transform &p_shape_xform, real_t p_margin, Vector3 *r_results, int p_result_max, int &r_result_count, const Set<RID> &p_exclude = Set<RID>(), uint32_t p_collision_mask = 0xFFFFFFFF, bool p_collide_with_bodies = true, bool p_collide_with_areas = false) override;
-	virtual bool rest_info(RID p_shape, const Transform &p_shape_xform, real_t p_margin, ShapeRestInfo *r_info, const Set<RID> &p_exclude = Set<RID>(), uint32_t p_collision_mask = 0xFFFFFFFF, bool p_collide_with_bodies = true, bool p_collide_with_areas = false) override;
+	virtual int intersect_point(const Vector3 &p_point, ShapeResult *r_results, int p_result_max, const PhysicsQueryFilter &p_exclude = PhysicsQueryFilter(), uint32_t p_collision_mask = 0xFFFFFFFF, bool p_collide_with_bodies = true, bool p_collide_with_areas = false) override;
+	virtual bool intersect_ray(const Vector3 &p_from, const Vector3 &p_to, RayResult &r_result, const PhysicsQueryFilter &p_exclude = PhysicsQueryFilter(), uint32_t p_collision_mask = 0xFFFFFFFF, bool p_collide_with_bodies = true, bool p_collide_with_areas = false, bool p_pick_ray = false) override;
+	virtual int intersect_shape(const RID &p_shape, const Transform &p_xform, real_t p_margin, ShapeResult *r_results, int p_result_max, const PhysicsQueryFilter &p_exclude = PhysicsQueryFilter(), uint32_t p_collision_mask = 0xFFFFFFFF, bool p_collide_with_bodies = true, bool p_collide_with_areas = false) override;
+	virtual bool cast_motion(const RID &p_shape, const Transform &p_xform, const Vector3 &p_motion, real_t p_margin, real_t &p_closest_safe, real_t &p_closest_unsafe, const PhysicsQueryFilter &p_exclude = PhysicsQueryFilter(), uint32_t p_collision_mask = 0xFFFFFFFF, bool p_collide_with_bodies = true, bool p_collide_with_areas = false, ShapeRestInfo *r_info = nullptr) override;
+	virtual bool collide_shape(RID p_shape, const Transform &p_shape_xform, real_t p_margin, Vector3 *r_results, int p_result_max, int &r_result_count, const PhysicsQueryFilter &p_exclude = PhysicsQueryFilter(), uint32_t p_collision_mask = 0xFFFFFFFF, bool p_collide_with_bodies = true, bool p_collide_with_areas = false) override;
+	virtual bool rest_info(RID p_shape, const Transform &p_shape_xform, real_t p_margin, ShapeRestInfo *r_info, const PhysicsQueryFilter &p_exclude = PhysicsQueryFilter(), uint32_t p_collision_mask = 0xFFFFFFFF, bool p_collide_with_bodies = true, bool p_collide_with_areas = false) override;
 	virtual Vector3 get_closest_point_to_object_volume(RID p_object, const Vector3 p_point) const override;
 
 	PhysicsDirectSpaceState3DSW();
@@ -82,6 +84,7 @@ private:
 	SelfList<Body3DSW>::List state_query_list;
 	SelfList<Area3DSW>::List monitor_query_list;
 	SelfList<Area3DSW>::List area_moved_list;
+	SelfList<BodyPair3DSW>::List body_pair_list;
 
 	static void *_broadphase_pair(CollisionObject3DSW *A, int p_subindex_A, CollisionObject3DSW *B, int p_subindex_B, void *p_self);
 	static void _broadphase_unpair(CollisionObject3DSW *A, int p_subindex_A, CollisionObject3DSW *B, int p_subindex_B, void *p_data, void *p_self);
@@ -109,6 +112,8 @@ private:
 	real_t body_time_to_sleep;
 	real_t body_angular_velocity_damp_ratio;
 
+	bool batched_contact_solver;
+
 	bool locked;
 
 	int island_count;
@@ -124,6 +129,70 @@ private:
 
 	int _cull_aabb_for_body(Body3DSW *p_body, const AABB &p_aabb);
 
+	// Where the culls of a body motion test end up. By default they go through the broadphase
+	// into the space buffers. Batched motions instead filter candidates gathered up front,
+	// because the broadphase can't be queried from several threads.
+	struct BodyCull {
+		CollisionObject3DSW **results;
+		int *subindex_results;
+		bool use_candidates = false;
+		CollisionObject3DSW *const *candidates = nullptr;
+		const int *candidate_subindices = nullptr;
+		int candidate_count = 0;
+	};
+
+	int _cull_aabb_for_body(Body3DSW *p_body, const AABB &p_aabb, BodyCull &r_cull);
+	bool _test_body_motion(Body3DSW *p_body, const Transform &p_from, const Vector3 &p_motion, bool p_infinite_inertia, real_t p_margin, PhysicsServer3D::MotionResult *r_result, bool p_exclude_raycast_shapes, BodyCull &p_cull);
+
+	struct BatchMotion {
+		Body3DSW *body;
+		Transform from;
+		Vector3 motion;
+		PhysicsServer3D::MotionResult *result;
+		uint32_t candidate_from;
+		uint32_t candidate_count;
+		bool collided;
+	};
+
+	LocalVector<BatchMotion> batch_motions;
+	LocalVector<CollisionObject3DSW *> batch_candidates;
+	LocalVector<int> batch_candidate_subindices;
+	bool batch_infinite_inertia = false;
+	bool batch_exclude_raycast_shapes = true;
+
+	void _test_body_motion_batch_item(uint32_t p_index, void *p_userdata);
+
+	struct SnapshotPair {
+		RID A;
+		int shape_A;
+		RID B;
+		int shape_B;
+		BodyPair3DSW *pair;
+
+		_FORCE_INLINE_ bool operator<(const SnapshotPair &p_pair) const {
+			if (A != p_pair.A) {
+				return A < p_pair.A;
+			}
+			if (shape_A != p_pair.shape_A) {
+				return shape_A < p_pair.shape_A;
+			}
+			if (B != p_pair.B) {
+				return B < p_pair.B;
+			}
+			return shape_B < p_pair.shape_B;
+		}
+	};
+
+	// Set once snapshots are used. Constraints are then solved in a stable order,
+	// which re-simulating from a snapshot relies on but other spaces don't need.
+	bool solve_in_order = false;
+
+	LocalVector<Body3DSW *> snapshot_bodies;
+	LocalVector<SnapshotPair> snapshot_pairs;
+
+	void _snapshot_gather();
+	static bool _snapshot_validate(const uint8_t *p_ptr, const uint8_t *p_end, uint32_t p_body_count, uint32_t p_active_count, uint32_t p_pair_count);
+
 public:
 	_FORCE_INLINE_ void set_self(const RID &p_self) { self = p_self; }
 	_FORCE_INLINE_ RID get_self() const { return self; }
@@ -146,6 +215,9 @@ public:
 	void area_remove_from_moved_list(SelfList<Area3DSW> *p_area);
 	const SelfList<Area3DSW>::List &get_moved_area_list() const;
 
+	void body_pair_add_to_list(SelfList<BodyPair3DSW> *p_pair);
+	void body_pair_remove_from_list(SelfList<BodyPair3DSW> *p_pair);
+
 	BroadPhase3DSW *get_broadphase();
 
 	void add_object(CollisionObject3DSW *p_object);
@@ -160,6 +232,7 @@ public:
 	_FORCE_INLINE_ real_t get_body_angular_velocity_sleep_threshold() const { return body_angular_velocity_sleep_threshold; }
 	_FORCE_INLINE_ real_t get_body_time_to_sleep() const { return body_time_to_sleep; }
 	_FORCE_INLINE_ real_t get_body_angular_velocity_damp_ratio() const { return body_angular_velocity_damp_ratio; }
+	_FORCE_INLINE_ bool is_using_batched_contact_solver() const { return batched_contact_solver; }
 
 	void update();
 	void setup();
@@ -179,6 +252,7 @@ public:
 	int get_active_objects() const { return active_objects; }
 
 	int get_collision_pairs() const { return collision_pairs; }
+	int get_contact_count() const;
 
 	PhysicsDirectSpaceState3DSW *get_direct_state();
 
@@ -200,6 +274,12 @@ public:
 
 	int test_body_ray_separation(Body3DSW *p_body, const Transform &p_transform, bool p_infinite_inertia, Vector3 &r_recover_motion, PhysicsServer3D::SeparationResult *r_results, int p_result_max, real_t p_margin);
 	bool test_body_motion(Body3DSW *p_body, const Transform &p_from, const Vector3 &p_motion, bool p_infinite_inertia, real_t p_margin, PhysicsServer3D::MotionResult *r_result, bool p_exclude_raycast_shapes);
+	int test_body_motion_batch(Body3DSW *const *p_bodies, const Transform *p_from, const Vector3 *p_motions, int p_count, bool p_infinite_inertia, PhysicsServer3D::MotionResult *r_results, bool p_exclude_raycast_shapes, ThreadWorkPool *p_work_pool);
+
+	_FORCE_INLINE_ bool is_solving_in_order() const { return solve_in_order; }
+
+	Vector<uint8_t> get_state_snapshot();
+	Error set_state_snapshot(const Vector<uint8_t> &p_snapshot);
 
 	Space3DSW();
 	~Space3DSW();
@@ -60,6 +60,30 @@ void Step3DSW::_populate_island(Body3DSW *p_body, Body3DSW **p_island, Constrain
 	}
 }
 
+Constraint3DSW *Step3DSW::_sort_island(Constraint3DSW *p_island) {
+	// Islands are discovered through maps keyed by pointer, so their order depends on
+	// allocation. Sort them by a stable key to keep stepping deterministic.
+	sorted_constraints.clear();
+	for (Constraint3DSW *c = p_island; c; c = c->get_island_next()) {
+		SortedConstraint sc;
+		sc.key = c->get_order_key();
+		sc.constraint = c;
+		sorted_constraints.push_back(sc);
+	}
+
+	if (sorted_constraints.size() < 2) {
+		return p_island;
+	}
+
+	sorted_constraints.sort();
+
+	for (uint32_t i = 0; i < sorted_constraints.size(); i++) {
+		sorted_constraints[i].constraint->set_island_next(i + 1 < sorted_constraints.size() ? sorted_constraints[i + 1].constraint : nullptr);
+	}
+
+	return sorted_constraints[0].constraint;
+}
+
 void Step3DSW::_setup_island(Constraint3DSW *p_island, real_t p_delta) {
 	Constraint3DSW *ci = p_island;
 	while (ci) {
@@ -69,16 +93,61 @@ void Step3DSW::_setup_island(Constraint3DSW *p_island, real_t p_delta) {
 	}
 }
 
-void Step3DSW::_solve_island(Constraint3DSW *p_island, int p_iterations, real_t p_delta) {
+void Step3DSW::_solve_island(Constraint3DSW *p_island, int p_iterations, real_t p_delta, bool p_batch_contacts) {
+	bool batched = false;
+
+	if (p_batch_contacts) {
+		// Hand contacts over to the batched solver, everything else stays in the list.
+		contact_solver.begin(p_delta);
+
+		Constraint3DSW *ci = p_island;
+		Constraint3DSW *prev = nullptr;
+		while (ci) {
+			if (ci->add_to_contact_solver(&contact_solver)) {
+				if (prev) {
+					prev->set_island_next(ci->get_island_next()); //remove
+				} else {
+					p_island = ci->get_island_next();
+				}
+			} else {
+				prev = ci;
+			}
+
+			ci = ci->get_island_next();
+		}
+
+		batched = contact_solver.has_contacts();
+		if (batched) {
+			contact_solver.prepare();
+		}
+	}
+
 	int at_priority = 1;
 
-	while (p_island) {
+	while (p_island || batched) {
 		for (int i = 0; i < p_iterations; i++) {
+			if (batched) {
+				contact_solver.solve();
+				if (p_island) {
+					contact_solver.write_back_velocities();
+				}
+			}
+
 			Constraint3DSW *ci = p_island;
 			while (ci) {
 				ci->solve(p_delta);
 				ci = ci->get_island_next();
 			}
+
+			if (batched && p_island) {
+				contact_solver.read_velocities();
+			}
+		}
+
+		if (batched) {
+			// Contacts have the default priority, they are only solved in the first round.
+			contact_solver.finish();
+			batched = false;
 		}
 
 		at_priority++;
@@ -183,6 +252,9 @@ void Step3DSW::step(Space3DSW *p_space, real_t p_delta, int p_iterations) {
 			Body3DSW *island = nullptr;
 			Constraint3DSW *constraint_island = nullptr;
 			_populate_island(body, &island, &constraint_island);
+			if (p_space->is_solving_in_order()) {
+				constraint_island = _sort_island(constraint_island);
+			}
 
 			island->set_island_list_next(island_list);
 			island_list = island;
@@ -200,6 +272,8 @@ void Step3DSW::step(Space3DSW *p_space, real_t p_delta, int p_iterations) {
 
 	const SelfList<Area3DSW>::List &aml = p_space->get_moved_area_list();
 
+	const bool in_order = p_space->is_solving_in_order();
+	sorted_constraints.clear();
 	while (aml.first()) {
 		for (const Set<Constraint3DSW *>::Element *E = aml.first()->self()->get_constraints().front(); E; E = E->next()) {
 			Constraint3DSW *c = E->get();
@@ -208,12 +282,27 @@ void Step3DSW::step(Space3DSW *p_space, real_t p_delta, int p_iterations) {
 			}
 			c->set_island_step(_step);
 			c->set_island_next(nullptr);
-			c->set_island_list_next(constraint_island_list);
-			constraint_island_list = c;
+			if (in_order) {
+				SortedConstraint sc;
+				sc.key = c->get_order_key();
+				sc.constraint = c;
+				sorted_constraints.push_back(sc);
+			} else {
+				c->set_island_list_next(constraint_island_list);
+				constraint_island_list = c;
+			}
 		}
 		p_space->area_remove_from_moved_list((SelfList<Area3DSW> *)aml.first()); //faster to remove here
 	}
 
+	// Area pairs are set up in order too, as that decides how overlapping areas combine.
+	sorted_constraints.sort();
+	for (int i = sorted_constraints.size() - 1; i >= 0; i--) {
+		Constraint3DSW *c = sorted_constraints[i].constraint;
+		c->set_island_list_next(constraint_island_list);
+		constraint_island_list = c;
+	}
+
 	{ //profile
 		profile_endtime = OS::get_singleton()->get_ticks_usec();
 		p_space->set_elapsed_time(Space3DSW::ELAPSED_TIME_GENERATE_ISLANDS, profile_endtime - profile_begtime);
@@ -239,10 +328,11 @@ void Step3DSW::step(Space3DSW *p_space, real_t p_delta, int p_iterations) {
 	/* SOLVE CONSTRAINT ISLANDS */
 
 	{
+		bool batch_contacts = p_space->is_using_batched_contact_solver();
 		Constraint3DSW *ci = constraint_island_list;
 		while (ci) {
 			//iterating each island separatedly improves cache efficiency
-			_solve_island(ci, p_iterations, p_delta);
+			_solve_island(ci, p_iterations, p_delta, batch_contacts);
 			ci = ci->get_island_list_next();
 		}
 	}
@@ -31,14 +31,27 @@
 #ifndef STEP_SW_H
 #define STEP_SW_H
 
+#include "contact_solver_3d_sw.h"
 #include "space_3d_sw.h"
 
 class Step3DSW {
 	uint64_t _step;
 
+	ContactSolver3DSW contact_solver;
+
+	struct SortedConstraint {
+		Constraint3DSW::OrderKey key;
+		Constraint3DSW *constraint;
+
+		_FORCE_INLINE_ bool operator<(const SortedConstraint &p_other) const { return key < p_other.key; }
+	};
+
+	LocalVector<SortedConstraint> sorted_constraints;
+
 	void _populate_island(Body3DSW *p_body, Body3DSW **p_island, Constraint3DSW **p_constraint_island);
+	Constraint3DSW *_sort_island(Constraint3DSW *p_island);
 	void _setup_island(Constraint3DSW *p_island, real_t p_delta);
-	void _solve_island(Constraint3DSW *p_island, int p_iterations, real_t p_delta);
+	void _solve_island(Constraint3DSW *p_island, int p_iterations, real_t p_delta, bool p_batch_contacts);
 	void _check_suspend(Body3DSW *p_island, real_t p_delta);
 
 public:
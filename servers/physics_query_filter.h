@@ -0,0 +1,183 @@
+/*************************************************************************/
+/*  physics_query_filter.h                                               */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef PHYSICS_QUERY_FILTER_H
+#define PHYSICS_QUERY_FILTER_H
+
+#include "core/local_vector.h"
+#include "core/object_id.h"
+#include "core/rid.h"
+#include "core/set.h"
+
+// Exclusion filter for direct space state queries.
+// RIDs are kept sorted in a small inline array and only spill to the heap
+// for unusually long lists, so building a filter per query does not allocate
+// and checks are a short linear scan or a binary search. An optional callback
+// can reject further objects without having to list them up front.
+class PhysicsQueryFilter {
+public:
+	// Return true to exclude the object from the query results.
+	typedef bool (*ExcludeCallback)(void *p_userdata, const RID &p_rid, ObjectID p_instance_id);
+
+private:
+	enum {
+		INLINE_MAX = 8,
+		LINEAR_SCAN_MAX = 16,
+	};
+
+	RID inline_rids[INLINE_MAX];
+	LocalVector<RID> heap_rids;
+	uint32_t count = 0;
+
+	ExcludeCallback callback = nullptr;
+	void *callback_userdata = nullptr;
+
+	_FORCE_INLINE_ RID *_ptr() { return count > INLINE_MAX ? heap_rids.ptr() : inline_rids; }
+	_FORCE_INLINE_ const RID *_ptr() const { return count > INLINE_MAX ? heap_rids.ptr() : inline_rids; }
+
+	// Returns the position of p_rid, or where it would be inserted.
+	_FORCE_INLINE_ uint32_t _lower_bound(const RID &p_rid) const {
+		const RID *rids = _ptr();
+		uint32_t low = 0;
+		uint32_t high = count;
+		while (low < high) {
+			uint32_t middle = (low + high) / 2;
+			if (rids[middle] < p_rid) {
+				low = middle + 1;
+			} else {
+				high = middle;
+			}
+		}
+		return low;
+	}
+
+public:
+	_FORCE_INLINE_ bool has(const RID &p_rid) const {
+		if (count == 0) {
+			return false;
+		}
+		const RID *rids = _ptr();
+		if (count <= LINEAR_SCAN_MAX) {
+			for (uint32_t i = 0; i < count; i++) {
+				if (rids[i] == p_rid) {
+					return true;
+				}
+			}
+			return false;
+		}
+		uint32_t pos = _lower_bound(p_rid);
+		return pos < count && rids[pos] == p_rid;
+	}
+
+	_FORCE_INLINE_ bool is_excluded(const RID &p_rid, ObjectID p_instance_id) const {
+		if (has(p_rid)) {
+			return true;
+		}
+		return callback && callback(callback_userdata, p_rid, p_instance_id);
+	}
+
+	void insert(const RID &p_rid) {
+		uint32_t pos = _lower_bound(p_rid);
+		if (pos < count && _ptr()[pos] == p_rid) {
+			return;
+		}
+
+		if (count < INLINE_MAX) {
+			for (uint32_t i = count; i > pos; i--) {
+				inline_rids[i] = inline_rids[i - 1];
+			}
+			inline_rids[pos] = p_rid;
+		} else {
+			if (count == INLINE_MAX) {
+				heap_rids.resize(INLINE_MAX);
+				for (uint32_t i = 0; i < INLINE_MAX; i++) {
+					heap_rids[i] = inline_rids[i];
+				}
+			}
+			heap_rids.insert(pos, p_rid);
+		}
+		count++;
+	}
+
+	bool erase(const RID &p_rid) {
+		uint32_t pos = _lower_bound(p_rid);
+		if (pos >= count || _ptr()[pos] != p_rid) {
+			return false;
+		}
+
+		if (count > INLINE_MAX) {
+			heap_rids.remove(pos);
+			if (count - 1 == INLINE_MAX) {
+				for (uint32_t i = 0; i < INLINE_MAX; i++) {
+					inline_rids[i] = heap_rids[i];
+				}
+				heap_rids.clear();
+			}
+		} else {
+			for (uint32_t i = pos + 1; i < count; i++) {
+				inline_rids[i - 1] = inline_rids[i];
+			}
+		}
+		count--;
+		return true;
+	}
+
+	void clear() {
+		heap_rids.clear();
+		count = 0;
+	}
+
+	_FORCE_INLINE_ uint32_t size() const { return count; }
+	_FORCE_INLINE_ bool has_rids() const { return count > 0; }
+	_FORCE_INLINE_ const RID &operator[](uint32_t p_index) const {
+		CRASH_BAD_UNSIGNED_INDEX(p_index, count);
+		return _ptr()[p_index];
+	}
+
+	void set_callback(ExcludeCallback p_callback, void *p_userdata = nullptr) {
+		callback = p_callback;
+		callback_userdata = p_userdata;
+	}
+	_FORCE_INLINE_ ExcludeCallback get_callback() const { return callback; }
+	_FORCE_INLINE_ bool has_callback() const { return callback != nullptr; }
+
+	PhysicsQueryFilter() {}
+	explicit PhysicsQueryFilter(const RID &p_rid) {
+		insert(p_rid);
+	}
+	// Kept implicit so existing callers passing a Set<RID> still compile.
+	PhysicsQueryFilter(const Set<RID> &p_exclude) {
+		for (const Set<RID>::Element *E = p_exclude.front(); E; E = E->next()) {
+			insert(E->get()); // Set iterates in order, so this always appends.
+		}
+	}
+};
+
+#endif // PHYSICS_QUERY_FILTER_H
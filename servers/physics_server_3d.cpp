@@ -191,9 +191,8 @@ void PhysicsShapeQueryParameters3D::set_exclude(const Vector<RID> &p_exclude) {
 Vector<RID> PhysicsShapeQueryParameters3D::get_exclude() const {
 	Vector<RID> ret;
 	ret.resize(exclude.size());
-	int idx = 0;
-	for (Set<RID>::Element *E = exclude.front(); E; E = E->next()) {
-		ret.write[idx] = E->get();
+	for (uint32_t i = 0; i < exclude.size(); i++) {
+		ret.write[i] = exclude[i];
 	}
 	return ret;
 }
@@ -259,7 +258,7 @@ PhysicsShapeQueryParameters3D::PhysicsShapeQueryParameters3D() {
 
 Dictionary PhysicsDirectSpaceState3D::_intersect_ray(const Vector3 &p_from, const Vector3 &p_to, const Vector<RID> &p_exclude, uint32_t p_collision_mask, bool p_collide_with_bodies, bool p_collide_with_areas) {
 	RayResult inters;
-	Set<RID> exclude;
+	PhysicsQueryFilter exclude;
 	for (int i = 0; i < p_exclude.size(); i++) {
 		exclude.insert(p_exclude[i]);
 	}
@@ -407,6 +406,7 @@ void PhysicsServer3D::_bind_methods() {
 
 	ClassDB::bind_method(D_METHOD("shape_get_type", "shape"), &PhysicsServer3D::shape_get_type);
 	ClassDB::bind_method(D_METHOD("shape_get_data", "shape"), &PhysicsServer3D::shape_get_data);
+	ClassDB::bind_method(D_METHOD("shape_get_bvh_cache", "shape"), &PhysicsServer3D::shape_get_bvh_cache);
 
 	ClassDB::bind_method(D_METHOD("space_create"), &PhysicsServer3D::space_create);
 	ClassDB::bind_method(D_METHOD("space_set_active", "space", "active"), &PhysicsServer3D::space_set_active);
@@ -414,6 +414,8 @@ void PhysicsServer3D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("space_set_param", "space", "param", "value"), &PhysicsServer3D::space_set_param);
 	ClassDB::bind_method(D_METHOD("space_get_param", "space", "param"), &PhysicsServer3D::space_get_param);
 	ClassDB::bind_method(D_METHOD("space_get_direct_state", "space"), &PhysicsServer3D::space_get_direct_state);
+	ClassDB::bind_method(D_METHOD("space_get_state_snapshot", "space"), &PhysicsServer3D::space_get_state_snapshot);
+	ClassDB::bind_method(D_METHOD("space_set_state_snapshot", "space", "snapshot"), &PhysicsServer3D::space_set_state_snapshot);
 
 	ClassDB::bind_method(D_METHOD("area_create"), &PhysicsServer3D::area_create);
 	ClassDB::bind_method(D_METHOD("area_set_space", "area", "space"), &PhysicsServer3D::area_set_space);
@@ -521,6 +523,7 @@ void PhysicsServer3D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("body_is_ray_pickable", "body"), &PhysicsServer3D::body_is_ray_pickable);
 
 	ClassDB::bind_method(D_METHOD("body_get_direct_state", "body"), &PhysicsServer3D::body_get_direct_state);
+	ClassDB::bind_method(D_METHOD("body_test_motion_batch", "bodies", "from", "motions", "infinite_inertia", "exclude_raycast_shapes"), &PhysicsServer3D::_body_test_motion_batch, DEFVAL(true));
 
 	/* JOINT API */
 
@@ -718,6 +721,98 @@ void PhysicsServer3D::_bind_methods() {
 #endif
 }
 
+Array PhysicsServer3D::_body_test_motion_batch(const Vector<RID> &p_bodies, const Array &p_from, const PackedVector3Array &p_motions, bool p_infinite_inertia, bool p_exclude_raycast_shapes) {
+	int count = p_bodies.size();
+	ERR_FAIL_COND_V_MSG(p_from.size() != count || p_motions.size() != count, Array(), "A transform and a motion must be given for each body.");
+
+	Vector<Transform> from;
+	from.resize(count);
+	Transform *fw = from.ptrw();
+	for (int i = 0; i < count; i++) {
+		fw[i] = p_from[i];
+	}
+
+	Vector<MotionResult> results;
+	results.resize(count);
+	body_test_motion_batch(p_bodies.ptr(), from.ptr(), p_motions.ptr(), count, p_infinite_inertia, results.ptrw(), p_exclude_raycast_shapes);
+
+	Array ret;
+	ret.resize(count);
+	for (int i = 0; i < count; i++) {
+		const MotionResult &result = results[i];
+		Dictionary d;
+		d["motion"] = result.motion;
+		d["remainder"] = result.remainder;
+		if (result.collider.is_valid()) {
+			d["position"] = result.collision_point;
+			d["normal"] = result.collision_normal;
+			d["collider_velocity"] = result.collider_velocity;
+			d["collider_id"] = result.collider_id;
+			d["collider"] = ObjectDB::get_instance(result.collider_id);
+			d["rid"] = result.collider;
+			d["shape"] = result.collider_shape;
+			d["local_shape"] = result.collision_local_shape;
+		}
+		ret[i] = d;
+	}
+
+	return ret;
+}
+
+RID PhysicsServer3D::joint_create_pin(RID p_body_A, const Vector3 &p_local_A, RID p_body_B, const Vector3 &p_local_B) {
+	RID joint = joint_create();
+	if (!joint_make_pin(joint, p_body_A, p_local_A, p_body_B, p_local_B)) {
+		free(joint);
+		return RID();
+	}
+	return joint;
+}
+
+RID PhysicsServer3D::joint_create_hinge(RID p_body_A, const Transform &p_hinge_A, RID p_body_B, const Transform &p_hinge_B) {
+	RID joint = joint_create();
+	if (!joint_make_hinge(joint, p_body_A, p_hinge_A, p_body_B, p_hinge_B)) {
+		free(joint);
+		return RID();
+	}
+	return joint;
+}
+
+RID PhysicsServer3D::joint_create_hinge_simple(RID p_body_A, const Vector3 &p_pivot_A, const Vector3 &p_axis_A, RID p_body_B, const Vector3 &p_pivot_B, const Vector3 &p_axis_B) {
+	RID joint = joint_create();
+	if (!joint_make_hinge_simple(joint, p_body_A, p_pivot_A, p_axis_A, p_body_B, p_pivot_B, p_axis_B)) {
+		free(joint);
+		return RID();
+	}
+	return joint;
+}
+
+RID PhysicsServer3D::joint_create_slider(RID p_body_A, const Transform &p_local_frame_A, RID p_body_B, const Transform &p_local_frame_B) {
+	RID joint = joint_create();
+	if (!joint_make_slider(joint, p_body_A, p_local_frame_A, p_body_B, p_local_frame_B)) {
+		free(joint);
+		return RID();
+	}
+	return joint;
+}
+
+RID PhysicsServer3D::joint_create_cone_twist(RID p_body_A, const Transform &p_local_frame_A, RID p_body_B, const Transform &p_local_frame_B) {
+	RID joint = joint_create();
+	if (!joint_make_cone_twist(joint, p_body_A, p_local_frame_A, p_body_B, p_local_frame_B)) {
+		free(joint);
+		return RID();
+	}
+	return joint;
+}
+
+RID PhysicsServer3D::joint_create_generic_6dof(RID p_body_A, const Transform &p_local_frame_A, RID p_body_B, const Transform &p_local_frame_B) {
+	RID joint = joint_create();
+	if (!joint_make_generic_6dof(joint, p_body_A, p_local_frame_A, p_body_B, p_local_frame_B)) {
+		free(joint);
+		return RID();
+	}
+	return joint;
+}
+
 PhysicsServer3D::PhysicsServer3D() {
 	ERR_FAIL_COND(singleton != nullptr);
 	singleton = this;
@@ -60,6 +60,7 @@
 #include "physics_2d/physics_server_2d_sw.h"
 #include "physics_2d/physics_server_2d_wrap_mt.h"
 #include "physics_3d/physics_server_3d_sw.h"
+#include "physics_3d/physics_server_3d_wrap_mt.h"
 #include "physics_server_2d.h"
 #include "physics_server_3d.h"
 #include "rendering/rasterizer.h"
@@ -75,7 +76,7 @@
 ShaderTypes *shader_types = nullptr;
 
 PhysicsServer3D *_createGodotPhysics3DCallback() {
-	return memnew(PhysicsServer3DSW);
+	return PhysicsServer3DWrapMT::init_server<PhysicsServer3DSW>();
 }
 
 PhysicsServer2D *_createGodotPhysics2DCallback() {
@@ -0,0 +1,223 @@
+/*************************************************************************/
+/*  occlusion_buffer_sw.cpp                                              */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "occlusion_buffer_sw.h"
+
+#define OCCLUSION_DEPTH_CLEAR 1e20
+// Lets corners on an edge shared by two triangles pass both edge tests despite rounding.
+#define OCCLUSION_EDGE_EPSILON 1e-5
+
+void OcclusionBufferSW::set_size(int p_width, int p_height) {
+	ERR_FAIL_COND(p_width <= 0 || p_height <= 0);
+	width = p_width;
+	height = p_height;
+	depth.resize((width + 1) * (height + 1));
+	triangles_drawn = 0;
+}
+
+void OcclusionBufferSW::begin(const Transform &p_cam_transform, const CameraMatrix &p_projection) {
+	view_xform = p_cam_transform.affine_inverse();
+	projection = p_projection;
+	z_near = MAX(p_projection.get_z_near(), CMP_EPSILON);
+	triangles_drawn = 0;
+
+	float *ptr = depth.ptr();
+	for (uint32_t i = 0; i < depth.size(); i++) {
+		ptr[i] = OCCLUSION_DEPTH_CLEAR;
+	}
+}
+
+void OcclusionBufferSW::_project(ClipVertex &r_vertex) const {
+	Plane clip = projection.xform4(Plane(r_vertex.view, 1.0));
+	float inv_w = 1.0 / clip.d;
+	r_vertex.x = (clip.normal.x * inv_w * 0.5 + 0.5) * width;
+	r_vertex.y = (0.5 - clip.normal.y * inv_w * 0.5) * height;
+	r_vertex.inv_w = inv_w;
+	r_vertex.depth_over_w = -r_vertex.view.z * inv_w;
+}
+
+void OcclusionBufferSW::_rasterize(const ClipVertex &p_a, const ClipVertex &p_b, const ClipVertex &p_c) {
+	float area = (p_b.x - p_a.x) * (p_c.y - p_a.y) - (p_b.y - p_a.y) * (p_c.x - p_a.x);
+	if (Math::absf(area) < CMP_EPSILON) {
+		return;
+	}
+	// Occluders are double sided, so normalize the winding instead of culling.
+	float inv_area = 1.0 / area;
+
+	// Samples sit on pixel corners, at integer coordinates.
+	int min_x = MAX(int(Math::ceil(MIN(p_a.x, MIN(p_b.x, p_c.x)))), 0);
+	int max_x = MIN(int(Math::floor(MAX(p_a.x, MAX(p_b.x, p_c.x)))), width);
+	int min_y = MAX(int(Math::ceil(MIN(p_a.y, MIN(p_b.y, p_c.y)))), 0);
+	int max_y = MIN(int(Math::floor(MAX(p_a.y, MAX(p_b.y, p_c.y)))), height);
+	if (min_x > max_x || min_y > max_y) {
+		return;
+	}
+
+	// Edge functions are affine in screen space, so step them per sample and per row.
+	float e0_dx = (p_b.y - p_c.y) * inv_area;
+	float e0_dy = (p_c.x - p_b.x) * inv_area;
+	float e1_dx = (p_c.y - p_a.y) * inv_area;
+	float e1_dy = (p_a.x - p_c.x) * inv_area;
+
+	float start_x = min_x;
+	float start_y = min_y;
+	float e0_row = ((p_b.x - start_x) * (p_c.y - start_y) - (p_b.y - start_y) * (p_c.x - start_x)) * inv_area;
+	float e1_row = ((p_c.x - start_x) * (p_a.y - start_y) - (p_c.y - start_y) * (p_a.x - start_x)) * inv_area;
+
+	for (int y = min_y; y <= max_y; y++) {
+		float e0 = e0_row;
+		float e1 = e1_row;
+		float *row = &depth[y * (width + 1)];
+
+		for (int x = min_x; x <= max_x; x++) {
+			float e2 = 1.0 - e0 - e1;
+			if (e0 >= -OCCLUSION_EDGE_EPSILON && e1 >= -OCCLUSION_EDGE_EPSILON && e2 >= -OCCLUSION_EDGE_EPSILON) {
+				// 1/w and depth/w interpolate linearly in screen space, depth itself does not.
+				float inv_w = e0 * p_a.inv_w + e1 * p_b.inv_w + e2 * p_c.inv_w;
+				float d = (e0 * p_a.depth_over_w + e1 * p_b.depth_over_w + e2 * p_c.depth_over_w) / inv_w;
+				if (d < row[x]) {
+					row[x] = d;
+				}
+			}
+			e0 += e0_dx;
+			e1 += e1_dx;
+		}
+
+		e0_row += e0_dy;
+		e1_row += e1_dy;
+	}
+}
+
+void OcclusionBufferSW::draw_triangles(const Transform &p_xform, const Vector3 *p_vertices, const uint32_t *p_indices, uint32_t p_index_count) {
+	if (depth.empty()) {
+		return;
+	}
+
+	Transform xform = view_xform * p_xform;
+
+	for (uint32_t i = 0; i + 2 < p_index_count; i += 3) {
+		ClipVertex in[3];
+		for (int j = 0; j < 3; j++) {
+			in[j].view = xform.xform(p_vertices[p_indices[i + j]]);
+		}
+
+		// Clip against the near plane, a triangle becomes at most a quad.
+		ClipVertex out[4];
+		int out_count = 0;
+		for (int j = 0; j < 3; j++) {
+			const ClipVertex &a = in[j];
+			const ClipVertex &b = in[(j + 1) % 3];
+			float da = -a.view.z - z_near;
+			float db = -b.view.z - z_near;
+			if (da >= 0) {
+				out[out_count++] = a;
+			}
+			if ((da >= 0) != (db >= 0)) {
+				out[out_count].view = a.view.lerp(b.view, da / (da - db));
+				out_count++;
+			}
+		}
+
+		if (out_count < 3) {
+			continue;
+		}
+
+		for (int j = 0; j < out_count; j++) {
+			_project(out[j]);
+		}
+
+		_rasterize(out[0], out[1], out[2]);
+		if (out_count == 4) {
+			_rasterize(out[0], out[2], out[3]);
+		}
+		triangles_drawn++;
+	}
+}
+
+bool OcclusionBufferSW::is_occluded(const AABB &p_aabb) const {
+	if (triangles_drawn == 0) {
+		return false;
+	}
+
+	float min_x = 1e20;
+	float max_x = -1e20;
+	float min_y = 1e20;
+	float max_y = -1e20;
+	float min_depth = 1e20;
+
+	for (int i = 0; i < 8; i++) {
+		Vector3 corner = p_aabb.position;
+		if (i & 1) {
+			corner.x += p_aabb.size.x;
+		}
+		if (i & 2) {
+			corner.y += p_aabb.size.y;
+		}
+		if (i & 4) {
+			corner.z += p_aabb.size.z;
+		}
+
+		ClipVertex v;
+		v.view = view_xform.xform(corner);
+		float d = -v.view.z;
+		if (d < z_near) {
+			return false; // Crosses the near plane, too close to tell.
+		}
+		_project(v);
+
+		min_x = MIN(min_x, v.x);
+		max_x = MAX(max_x, v.x);
+		min_y = MIN(min_y, v.y);
+		max_y = MAX(max_y, v.y);
+		min_depth = MIN(min_depth, d);
+	}
+
+	// Every corner of the pixels the box touches must have an occluder in front of its nearest
+	// point. Within a convex occluder that covers the whole pixel, so partly covered pixels on
+	// its edges never hide anything.
+	int from_x = MAX(int(Math::floor(min_x)), 0);
+	int to_x = MIN(int(Math::ceil(max_x)), width);
+	int from_y = MAX(int(Math::floor(min_y)), 0);
+	int to_y = MIN(int(Math::ceil(max_y)), height);
+	if (from_x >= to_x || from_y >= to_y) {
+		return false;
+	}
+
+	for (int y = from_y; y <= to_y; y++) {
+		const float *row = &depth[y * (width + 1)];
+		for (int x = from_x; x <= to_x; x++) {
+			if (row[x] >= min_depth) {
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
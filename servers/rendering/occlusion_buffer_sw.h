@@ -0,0 +1,84 @@
+/*************************************************************************/
+/*  occlusion_buffer_sw.h                                                */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef OCCLUSION_BUFFER_SW_H
+#define OCCLUSION_BUFFER_SW_H
+
+#include "core/local_vector.h"
+#include "core/math/aabb.h"
+#include "core/math/camera_matrix.h"
+#include "core/math/transform.h"
+
+// Low resolution depth buffer rasterized on the CPU from occluder meshes.
+// It stores the view space distance of the nearest occluder at pixel corners,
+// so an AABB whose nearest point lies behind every corner around it can be
+// skipped. A pixel only counts as occluded when all its corners are covered,
+// which keeps partly covered pixels on occluder edges from hiding anything.
+// Testing only reads the buffer and is safe to do from several threads.
+class OcclusionBufferSW {
+	struct ClipVertex {
+		Vector3 view; // view space position
+		float x; // screen space, in pixels
+		float y;
+		float inv_w;
+		float depth_over_w;
+	};
+
+	int width = 0;
+	int height = 0;
+	LocalVector<float> depth; // (width + 1) * (height + 1) corner samples
+
+	Transform view_xform;
+	CameraMatrix projection;
+	float z_near = 0.05;
+	uint32_t triangles_drawn = 0;
+
+	_FORCE_INLINE_ void _project(ClipVertex &r_vertex) const;
+	void _rasterize(const ClipVertex &p_a, const ClipVertex &p_b, const ClipVertex &p_c);
+
+public:
+	void set_size(int p_width, int p_height);
+	_FORCE_INLINE_ int get_width() const { return width; }
+	_FORCE_INLINE_ int get_height() const { return height; }
+
+	// Clears the buffer and sets the camera subsequent draws and tests are made for.
+	void begin(const Transform &p_cam_transform, const CameraMatrix &p_projection);
+	void draw_triangles(const Transform &p_xform, const Vector3 *p_vertices, const uint32_t *p_indices, uint32_t p_index_count);
+
+	_FORCE_INLINE_ bool is_empty() const { return triangles_drawn == 0; }
+	// Farthest occluder distance over the corners of a pixel, the depth it is known to be hidden behind.
+	_FORCE_INLINE_ float get_depth(int p_x, int p_y) const {
+		const float *row = &depth[p_y * (width + 1) + p_x];
+		return MAX(MAX(row[0], row[1]), MAX(row[width + 1], row[width + 2]));
+	}
+	bool is_occluded(const AABB &p_aabb) const;
+};
+
+#endif // OCCLUSION_BUFFER_SW_H
@@ -365,6 +365,9 @@ public:
 
 	virtual void texture_set_force_redraw_if_visible(RID p_texture, bool p_enable) = 0;
 
+	virtual void texture_set_streaming_feedback(RID p_texture, bool p_enable) = 0;
+	virtual Vector<int> texture_get_streaming_demand(const Vector<RID> &p_textures) = 0;
+
 	virtual Size2 texture_size_with_proxy(RID p_proxy) = 0;
 
 	virtual void texture_add_to_decal_atlas(RID p_texture, bool p_panorama_to_dp = false) = 0;
@@ -1305,6 +1308,8 @@ public:
 	virtual void canvas_render_items(RID p_to_render_target, Item *p_item_list, const Color &p_modulate, Light *p_light_list, const Transform2D &p_canvas_transform) = 0;
 	virtual void canvas_debug_viewport_shadows(Light *p_lights_with_shadow) = 0;
 
+	virtual int get_render_info(RS::RenderInfo p_info) = 0;
+
 	struct LightOccluderInstance {
 		bool enabled;
 		RID canvas;
@@ -30,6 +30,8 @@
 
 #include "light_cluster_builder.h"
 
+#include "servers/rendering/rasterizer_rd/rasterizer_rd.h"
+
 void LightClusterBuilder::begin(const Transform &p_view_transform, const CameraMatrix &p_cam_projection) {
 	view_xform = p_view_transform;
 	projection = p_cam_projection;
@@ -41,136 +43,291 @@ void LightClusterBuilder::begin(const Transform &p_view_transform, const CameraM
 	refprobe_count = 0;
 	decal_count = 0;
 	item_count = 0;
-	sort_id_count = 0;
 }
 
-void LightClusterBuilder::bake_cluster() {
-	float slice_depth = (z_near - z_far) / depth;
+void LightClusterBuilder::_compute_slice_bounds(Slice &r_slice, float p_z_from, float p_z_to) const {
+	//unproject the cell boundaries at both ends of the slice, assuming the projection
+	//does not mix x and y (true for perspective, orthogonal and frustum cameras)
+	const real_t(*m)[4] = projection.matrix;
+	float w_from = m[2][3] * p_z_from + m[3][3];
+	float w_to = m[2][3] * p_z_to + m[3][3];
+
+	for (uint32_t i = 0; i < width; i++) {
+		float ndc_a = (float(i) / width) * 2.0 - 1.0;
+		float ndc_b = (float(i + 1) / width) * 2.0 - 1.0;
+		float a_from = (ndc_a * w_from - m[2][0] * p_z_from - m[3][0]) / m[0][0];
+		float a_to = (ndc_a * w_to - m[2][0] * p_z_to - m[3][0]) / m[0][0];
+		float b_from = (ndc_b * w_from - m[2][0] * p_z_from - m[3][0]) / m[0][0];
+		float b_to = (ndc_b * w_to - m[2][0] * p_z_to - m[3][0]) / m[0][0];
+		r_slice.column_min[i] = MIN(MIN(a_from, a_to), MIN(b_from, b_to));
+		r_slice.column_max[i] = MAX(MAX(a_from, a_to), MAX(b_from, b_to));
+	}
 
-	uint8_t *cluster_dataw = cluster_data.ptrw();
-	Cell *cluster_data_ptr = (Cell *)cluster_dataw;
-	//clear the cluster
-	zeromem(cluster_data_ptr, (width * height * depth * sizeof(Cell)));
+	for (uint32_t i = 0; i < height; i++) {
+		//rows go top to bottom
+		float ndc_a = 1.0 - (float(i) / height) * 2.0;
+		float ndc_b = 1.0 - (float(i + 1) / height) * 2.0;
+		float a_from = (ndc_a * w_from - m[2][1] * p_z_from - m[3][1]) / m[1][1];
+		float a_to = (ndc_a * w_to - m[2][1] * p_z_to - m[3][1]) / m[1][1];
+		float b_from = (ndc_b * w_from - m[2][1] * p_z_from - m[3][1]) / m[1][1];
+		float b_to = (ndc_b * w_to - m[2][1] * p_z_to - m[3][1]) / m[1][1];
+		r_slice.row_min[i] = MIN(MIN(a_from, a_to), MIN(b_from, b_to));
+		r_slice.row_max[i] = MAX(MAX(a_from, a_to), MAX(b_from, b_to));
+	}
+}
 
-	/* Step 1, create cell positions and count them */
+void LightClusterBuilder::_bin_slice(uint32_t p_slice, void *p_userdata) {
+	Slice &slice = slices[p_slice];
+	slice.sort_ids.clear();
 
-	for (uint32_t i = 0; i < item_count; i++) {
-		const Item &item = items[i];
+	if (slice.items.size() == 0) {
+		return;
+	}
 
-		int from_slice = Math::floor((z_near - (item.aabb.position.z + item.aabb.size.z)) / slice_depth);
-		int to_slice = Math::floor((z_near - item.aabb.position.z) / slice_depth);
+	float z_from = z_near - slice_depth * p_slice;
+	float z_to = z_near - slice_depth * (p_slice + 1);
 
-		if (from_slice >= (int)depth || to_slice < 0) {
-			continue; //sorry no go
-		}
+	_compute_slice_bounds(slice, z_from, z_to);
 
-		from_slice = MAX(0, from_slice);
-		to_slice = MIN((int)depth - 1, to_slice);
+	const float *column_min = slice.column_min.ptr();
+	const float *column_max = slice.column_max.ptr();
+	uint8_t *hits = slice.hits.ptr();
 
-		for (int j = from_slice; j <= to_slice; j++) {
-			Vector3 min = item.aabb.position;
-			Vector3 max = item.aabb.position + item.aabb.size;
+	float cell_z = (z_from + z_to) * 0.5;
+	float cell_half_z = (z_from - z_to) * 0.5;
 
-			float limit_near = MIN((z_near - slice_depth * j), max.z);
-			float limit_far = MAX((z_near - slice_depth * (j + 1)), min.z);
+	uint32_t slice_offset = p_slice * (width * height);
+	Cell *slice_cells = cells + slice_offset;
 
-			max.z = limit_near;
-			min.z = limit_near;
+	for (uint32_t i = 0; i < slice.items.size(); i++) {
+		const Item &item = items[slice.items[i]];
 
-			Vector3 proj_min = projection.xform(min);
-			Vector3 proj_max = projection.xform(max);
+		/* Find the rectangle of cells the aabb covers in this slice */
 
-			int near_from_x = int(Math::floor((proj_min.x * 0.5 + 0.5) * width));
-			int near_from_y = int(Math::floor((-proj_max.y * 0.5 + 0.5) * height));
-			int near_to_x = int(Math::floor((proj_max.x * 0.5 + 0.5) * width));
-			int near_to_y = int(Math::floor((-proj_min.y * 0.5 + 0.5) * height));
+		Vector3 min = item.aabb.position;
+		Vector3 max = item.aabb.position + item.aabb.size;
 
-			max.z = limit_far;
-			min.z = limit_far;
+		float limit_near = MIN(z_from, max.z);
+		float limit_far = MAX(z_to, min.z);
 
-			proj_min = projection.xform(min);
-			proj_max = projection.xform(max);
+		max.z = limit_near;
+		min.z = limit_near;
 
-			int far_from_x = int(Math::floor((proj_min.x * 0.5 + 0.5) * width));
-			int far_from_y = int(Math::floor((-proj_max.y * 0.5 + 0.5) * height));
-			int far_to_x = int(Math::floor((proj_max.x * 0.5 + 0.5) * width));
-			int far_to_y = int(Math::floor((-proj_min.y * 0.5 + 0.5) * height));
+		Vector3 proj_min = projection.xform(min);
+		Vector3 proj_max = projection.xform(max);
 
-			//print_line(itos(j) + " near - " + Vector2i(near_from_x, near_from_y) + " -> " + Vector2i(near_to_x, near_to_y));
-			//print_line(itos(j) + " far - " + Vector2i(far_from_x, far_from_y) + " -> " + Vector2i(far_to_x, far_to_y));
+		int near_from_x = int(Math::floor((proj_min.x * 0.5 + 0.5) * width));
+		int near_from_y = int(Math::floor((-proj_max.y * 0.5 + 0.5) * height));
+		int near_to_x = int(Math::floor((proj_max.x * 0.5 + 0.5) * width));
+		int near_to_y = int(Math::floor((-proj_min.y * 0.5 + 0.5) * height));
 
-			int from_x = MIN(near_from_x, far_from_x);
-			int from_y = MIN(near_from_y, far_from_y);
-			int to_x = MAX(near_to_x, far_to_x);
-			int to_y = MAX(near_to_y, far_to_y);
+		max.z = limit_far;
+		min.z = limit_far;
 
-			if (from_x >= (int)width || to_x < 0 || from_y >= (int)height || to_y < 0) {
-				continue;
-			}
+		proj_min = projection.xform(min);
+		proj_max = projection.xform(max);
 
-			int sx = MAX(0, from_x);
-			int sy = MAX(0, from_y);
-			int dx = MIN((int)width - 1, to_x);
-			int dy = MIN((int)height - 1, to_y);
+		int far_from_x = int(Math::floor((proj_min.x * 0.5 + 0.5) * width));
+		int far_from_y = int(Math::floor((-proj_max.y * 0.5 + 0.5) * height));
+		int far_to_x = int(Math::floor((proj_max.x * 0.5 + 0.5) * width));
+		int far_to_y = int(Math::floor((-proj_min.y * 0.5 + 0.5) * height));
 
-			//print_line(itos(j) + " - " + Vector2i(sx, sy) + " -> " + Vector2i(dx, dy));
+		int from_x = MIN(near_from_x, far_from_x);
+		int from_y = MIN(near_from_y, far_from_y);
+		int to_x = MAX(near_to_x, far_to_x);
+		int to_y = MAX(near_to_y, far_to_y);
 
-			for (int x = sx; x <= dx; x++) {
-				for (int y = sy; y <= dy; y++) {
-					uint32_t offset = j * (width * height) + y * width + x;
-
-					if (unlikely(sort_id_count == sort_id_max)) {
-						sort_id_max = nearest_power_of_2_templated(sort_id_max + 1);
-						sort_ids = (SortID *)memrealloc(sort_ids, sizeof(SortID) * sort_id_max);
-						if (ids.size()) {
-							ids.resize(sort_id_max);
-							RD::get_singleton()->free(items_buffer);
-							items_buffer = RD::get_singleton()->storage_buffer_create(sizeof(uint32_t) * sort_id_max);
-						}
-					}
+		if (from_x >= (int)width || to_x < 0 || from_y >= (int)height || to_y < 0) {
+			continue;
+		}
 
-					sort_ids[sort_id_count].cell_index = offset;
-					sort_ids[sort_id_count].item_index = item.index;
-					sort_ids[sort_id_count].item_type = item.type;
+		int sx = MAX(0, from_x);
+		int sy = MAX(0, from_y);
+		int dx = MIN((int)width - 1, to_x);
+		int dy = MIN((int)height - 1, to_y);
 
-					sort_id_count++;
+		/* Test the actual shape against each cell of the rectangle, one row at a time.
+		   The loops are branch free over plain float arrays so they vectorize. */
 
-					//for now, only count
-					cluster_data_ptr[offset].item_pointers[item.type]++;
-					//print_line("at offset " + itos(offset) + " value: " + itos(cluster_data_ptr[offset].item_pointers[item.type]));
+		float px = item.position.x;
+		float py = item.position.y;
+		float pz = item.position.z;
+
+		for (int y = sy; y <= dy; y++) {
+			float row_min = slice.row_min[y];
+			float row_max = slice.row_max[y];
+
+			switch (item.type) {
+				case ITEM_TYPE_OMNI_LIGHT: {
+					//sphere against the cell bounds
+					float ddy = MAX(MAX(row_min - py, py - row_max), 0.0f);
+					float ddz = MAX(MAX(z_to - pz, pz - z_from), 0.0f);
+					float range_left = item.range * item.range - ddy * ddy - ddz * ddz;
+
+					for (int x = sx; x <= dx; x++) {
+						float ddx = MAX(MAX(column_min[x] - px, px - column_max[x]), 0.0f);
+						hits[x] = ddx * ddx <= range_left;
+					}
+				} break;
+				case ITEM_TYPE_SPOT_LIGHT: {
+					//cone against the bounding sphere of the cell
+					float cy = (row_min + row_max) * 0.5 - py;
+					float cz = cell_z - pz;
+					float half_y = (row_max - row_min) * 0.5;
+					float half_yz2 = half_y * half_y + cell_half_z * cell_half_z;
+					float dir_x = item.direction.x;
+					float dir_y = item.direction.y;
+					float dir_z = item.direction.z;
+
+					for (int x = sx; x <= dx; x++) {
+						float cx = (column_min[x] + column_max[x]) * 0.5 - px;
+						float half_x = (column_max[x] - column_min[x]) * 0.5;
+						float radius = Math::sqrt(half_x * half_x + half_yz2);
+
+						float len2 = cx * cx + cy * cy + cz * cz;
+						float along = cx * dir_x + cy * dir_y + cz * dir_z;
+						float closest = item.cone_cos * Math::sqrt(MAX(len2 - along * along, 0.0f)) - along * item.cone_sin;
+
+						hits[x] = (closest <= radius) & (along <= radius + item.range) & (along >= -radius);
+					}
+				} break;
+				default: {
+					//oriented box against the bounding sphere of the cell
+					float cy = (row_min + row_max) * 0.5 - py;
+					float cz = cell_z - pz;
+					float half_y = (row_max - row_min) * 0.5;
+					float half_yz2 = half_y * half_y + cell_half_z * cell_half_z;
+					const Vector3 *axes = item.box_axes;
+					const Vector3 &extents = item.box_half_extents;
+
+					for (int x = sx; x <= dx; x++) {
+						float cx = (column_min[x] + column_max[x]) * 0.5 - px;
+						float half_x = (column_max[x] - column_min[x]) * 0.5;
+
+						float d0 = MAX(Math::abs(cx * axes[0].x + cy * axes[0].y + cz * axes[0].z) - extents.x, 0.0f);
+						float d1 = MAX(Math::abs(cx * axes[1].x + cy * axes[1].y + cz * axes[1].z) - extents.y, 0.0f);
+						float d2 = MAX(Math::abs(cx * axes[2].x + cy * axes[2].y + cz * axes[2].z) - extents.z, 0.0f);
+
+						hits[x] = d0 * d0 + d1 * d1 + d2 * d2 <= half_x * half_x + half_yz2;
+					}
+				} break;
+			}
+
+			for (int x = sx; x <= dx; x++) {
+				if (!hits[x]) {
+					continue;
+				}
+
+				uint32_t offset = y * width + x;
+				uint32_t &count = slice_cells[offset].item_pointers[item.type];
+				if (unlikely(count == COUNTER_MASK)) {
+					continue; //cell is full
 				}
+
+				//for now, only count
+				count++;
+
+				SortID id;
+				id.cell_index = slice_offset + offset;
+				id.item_index = item.index;
+				id.item_type = item.type;
+				slice.sort_ids.push_back(id);
 			}
 		}
 	}
+}
+
+void LightClusterBuilder::_place_slice(uint32_t p_slice, uint32_t *p_ids) {
+	const Slice &slice = slices[p_slice];
+
+	for (uint32_t i = 0; i < slice.sort_ids.size(); i++) {
+		const SortID &id = slice.sort_ids[i];
+		Cell &cell = cells[id.cell_index];
+		uint32_t pointer = cell.item_pointers[id.item_type] & POINTER_MASK;
+		uint32_t counter = cell.item_pointers[id.item_type] >> COUNTER_SHIFT;
+		p_ids[pointer + counter] = id.item_index;
 
-	/* Step 2, Assign pointers (and reset counters) */
+		cell.item_pointers[id.item_type] = pointer | ((counter + 1) << COUNTER_SHIFT);
+	}
+}
+
+void LightClusterBuilder::bake_cluster() {
+	slice_depth = (z_near - z_far) / depth;
+
+	cells = (Cell *)cluster_data.ptrw();
+	//clear the cluster
+	zeromem(cells, (width * height * depth * sizeof(Cell)));
+
+	/* Step 1, sort items into the slices they touch */
+
+	for (uint32_t i = 0; i < depth; i++) {
+		slices[i].items.clear();
+	}
+
+	for (uint32_t i = 0; i < item_count; i++) {
+		const Item &item = items[i];
+
+		int from_slice = Math::floor((z_near - (item.aabb.position.z + item.aabb.size.z)) / slice_depth);
+		int to_slice = Math::floor((z_near - item.aabb.position.z) / slice_depth);
+
+		if (from_slice >= (int)depth || to_slice < 0) {
+			continue; //sorry no go
+		}
+
+		from_slice = MAX(0, from_slice);
+		to_slice = MIN((int)depth - 1, to_slice);
+
+		for (int j = from_slice; j <= to_slice; j++) {
+			slices[j].items.push_back(i);
+		}
+	}
+
+	/* Step 2, find the cells covered and count them, slices are independent */
+
+	bool use_threads = item_count >= THREADED_MIN_ITEMS;
+
+	if (use_threads) {
+		RasterizerRD::thread_work_pool.do_work(depth, this, &LightClusterBuilder::_bin_slice, (void *)nullptr);
+	} else {
+		for (uint32_t i = 0; i < depth; i++) {
+			_bin_slice(i, nullptr);
+		}
+	}
+
+	/* Step 3, Assign pointers (and reset counters) */
 
 	uint32_t offset = 0;
 	for (uint32_t i = 0; i < (width * height * depth); i++) {
 		for (int j = 0; j < ITEM_TYPE_MAX; j++) {
-			uint32_t count = cluster_data_ptr[i].item_pointers[j]; //save count
-			cluster_data_ptr[i].item_pointers[j] = offset; //replace count by pointer
+			uint32_t count = cells[i].item_pointers[j]; //save count
+			cells[i].item_pointers[j] = offset; //replace count by pointer
 			offset += count; //increase offset by count;
 		}
 	}
 
-	//print_line("offset: " + itos(offset));
-	/* Step 3, Place item lists */
+	if (offset > ids_max) {
+		ids_max = nearest_power_of_2_templated(offset);
+		ids.resize(ids_max);
+		RD::get_singleton()->free(items_buffer);
+		items_buffer = RD::get_singleton()->storage_buffer_create(sizeof(uint32_t) * ids_max);
+	}
 
-	uint32_t *ids_ptr = ids.ptrw();
+	/* Step 4, Place item lists, each slice writes to its own cells */
 
-	for (uint32_t i = 0; i < sort_id_count; i++) {
-		const SortID &id = sort_ids[i];
-		Cell &cell = cluster_data_ptr[id.cell_index];
-		uint32_t pointer = cell.item_pointers[id.item_type] & POINTER_MASK;
-		uint32_t counter = cell.item_pointers[id.item_type] >> COUNTER_SHIFT;
-		ids_ptr[pointer + counter] = id.item_index;
+	uint32_t *ids_ptr = ids.ptrw();
 
-		cell.item_pointers[id.item_type] = pointer | ((counter + 1) << COUNTER_SHIFT);
+	if (use_threads) {
+		RasterizerRD::thread_work_pool.do_work(depth, this, &LightClusterBuilder::_place_slice, ids_ptr);
+	} else {
+		for (uint32_t i = 0; i < depth; i++) {
+			_place_slice(i, ids_ptr);
+		}
 	}
 
 	RD::get_singleton()->texture_update(cluster_texture, 0, cluster_data, true);
-	RD::get_singleton()->buffer_update(items_buffer, 0, offset * sizeof(uint32_t), ids_ptr, true);
+	if (offset) {
+		RD::get_singleton()->buffer_update(items_buffer, 0, offset * sizeof(uint32_t), ids_ptr, true);
+	}
 }
 
 void LightClusterBuilder::setup(uint32_t p_width, uint32_t p_height, uint32_t p_depth) {
@@ -187,6 +344,15 @@ void LightClusterBuilder::setup(uint32_t p_width, uint32_t p_height, uint32_t p_
 
 	cluster_data.resize(width * height * depth * sizeof(Cell));
 
+	slices.resize(depth);
+	for (uint32_t i = 0; i < depth; i++) {
+		slices[i].column_min.resize(width);
+		slices[i].column_max.resize(width);
+		slices[i].row_min.resize(height);
+		slices[i].row_max.resize(height);
+		slices[i].hits.resize(width);
+	}
+
 	{
 		RD::TextureFormat tf;
 		tf.format = RD::DATA_FORMAT_R32G32B32A32_UINT;
@@ -222,10 +388,9 @@ LightClusterBuilder::LightClusterBuilder() {
 	items = (Item *)memalloc(sizeof(Item) * 1024);
 	item_max = 1024;
 
-	sort_ids = (SortID *)memalloc(sizeof(SortID) * 1024);
-	ids.resize(2014);
-	items_buffer = RD::get_singleton()->storage_buffer_create(sizeof(uint32_t) * 1024);
-	item_max = 1024;
+	ids_max = 1024;
+	ids.resize(ids_max);
+	items_buffer = RD::get_singleton()->storage_buffer_create(sizeof(uint32_t) * ids_max);
 }
 
 LightClusterBuilder::~LightClusterBuilder() {
@@ -245,8 +410,7 @@ LightClusterBuilder::~LightClusterBuilder() {
 	if (items) {
 		memfree(items);
 	}
-	if (sort_ids) {
-		memfree(sort_ids);
+	if (items_buffer.is_valid()) {
 		RD::get_singleton()->free(items_buffer);
 	}
 }
@@ -31,6 +31,7 @@
 #ifndef LIGHT_CLUSTER_BUILDER_H
 #define LIGHT_CLUSTER_BUILDER_H
 
+#include "core/local_vector.h"
 #include "servers/rendering/rasterizer_rd/rasterizer_storage_rd.h"
 
 class LightClusterBuilder {
@@ -51,7 +52,8 @@ public:
 	enum {
 		COUNTER_SHIFT = 20, //one million total ids
 		POINTER_MASK = (1 << COUNTER_SHIFT) - 1,
-		COUNTER_MASK = 0xfff // 4096 items per cell
+		COUNTER_MASK = 0xfff, // 4096 items per cell
+		THREADED_MIN_ITEMS = 64 //below this, binning is not worth waking the threads
 	};
 
 private:
@@ -90,6 +92,15 @@ private:
 		AABB aabb;
 		ItemType type;
 		uint32_t index;
+
+		//view space shape, used to discard cells the aabb overlaps but the item does not
+		Vector3 position;
+		float range = 0; //omni and spot
+		Vector3 direction; //spot
+		float cone_cos = 0;
+		float cone_sin = 0;
+		Vector3 box_axes[3]; //reflection probes and decals, normalized
+		Vector3 box_half_extents;
 	};
 
 	Item *items = nullptr;
@@ -113,10 +124,27 @@ private:
 		ItemType item_type;
 	};
 
-	SortID *sort_ids = nullptr;
+	//slices are binned independently, so each one can go to a different thread
+	struct Slice {
+		LocalVector<uint32_t> items;
+		LocalVector<SortID> sort_ids;
+
+		//view space bounds of the cell columns and rows within the slice
+		LocalVector<float> column_min;
+		LocalVector<float> column_max;
+		LocalVector<float> row_min;
+		LocalVector<float> row_max;
+
+		//per cell scratch, one row at a time
+		LocalVector<uint8_t> hits;
+	};
+
+	LocalVector<Slice> slices;
+	Cell *cells = nullptr;
+	float slice_depth = 0;
+
 	Vector<uint32_t> ids;
-	uint32_t sort_id_count = 0;
-	uint32_t sort_id_max = 0;
+	uint32_t ids_max = 0;
 	RID items_buffer;
 
 	Transform view_xform;
@@ -124,7 +152,7 @@ private:
 	float z_far = 0;
 	float z_near = 0;
 
-	_FORCE_INLINE_ void _add_item(const AABB &p_aabb, ItemType p_type, uint32_t p_index) {
+	_FORCE_INLINE_ Item &_add_item(const AABB &p_aabb, ItemType p_type, uint32_t p_index) {
 		if (unlikely(item_count == item_max)) {
 			item_max = nearest_power_of_2_templated(item_max + 1);
 			items = (Item *)memrealloc(items, sizeof(Item) * item_max);
@@ -135,8 +163,21 @@ private:
 		item.index = p_index;
 		item.type = p_type;
 		item_count++;
+		return item;
+	}
+
+	_FORCE_INLINE_ void _set_box_shape(Item &r_item, const Vector3 &p_origin, const Vector3 &p_x_axis, const Vector3 &p_y_axis, const Vector3 &p_z_axis) {
+		r_item.position = p_origin;
+		r_item.box_half_extents = Vector3(p_x_axis.length(), p_y_axis.length(), p_z_axis.length());
+		r_item.box_axes[0] = p_x_axis.normalized();
+		r_item.box_axes[1] = p_y_axis.normalized();
+		r_item.box_axes[2] = p_z_axis.normalized();
 	}
 
+	void _compute_slice_bounds(Slice &r_slice, float p_z_from, float p_z_to) const;
+	void _bin_slice(uint32_t p_slice, void *p_userdata);
+	void _place_slice(uint32_t p_slice, uint32_t *p_ids);
+
 public:
 	void begin(const Transform &p_view_transform, const CameraMatrix &p_cam_projection);
 
@@ -167,7 +208,9 @@ public:
 				aabb.position -= aabb.size;
 				aabb.size *= 2.0;
 
-				_add_item(aabb, ITEM_TYPE_OMNI_LIGHT, light_count);
+				Item &item = _add_item(aabb, ITEM_TYPE_OMNI_LIGHT, light_count);
+				item.position = xform.origin;
+				item.range = ld.radius;
 			} break;
 			case LIGHT_TYPE_SPOT: {
 				float r = ld.radius;
@@ -178,7 +221,14 @@ public:
 				aabb.expand_to(xform.xform(Vector3(-len, len, -r)));
 				aabb.expand_to(xform.xform(Vector3(-len, -len, -r)));
 				aabb.expand_to(xform.xform(Vector3(len, -len, -r)));
-				_add_item(aabb, ITEM_TYPE_SPOT_LIGHT, light_count);
+
+				Item &item = _add_item(aabb, ITEM_TYPE_SPOT_LIGHT, light_count);
+				item.position = xform.origin;
+				item.range = ld.radius;
+				item.direction = -xform.basis.get_axis(2).normalized();
+				float aperture = Math::deg2rad(MIN(ld.spot_aperture, 90.0f));
+				item.cone_cos = Math::cos(aperture);
+				item.cone_sin = Math::sin(aperture);
 			} break;
 		}
 
@@ -225,7 +275,8 @@ public:
 		aabb.expand_to(origin - x_axis - y_axis + z_axis);
 		aabb.expand_to(origin - x_axis - y_axis - z_axis);
 
-		_add_item(aabb, ITEM_TYPE_REFLECTION_PROBE, refprobe_count);
+		Item &item = _add_item(aabb, ITEM_TYPE_REFLECTION_PROBE, refprobe_count);
+		_set_box_shape(item, origin, x_axis, y_axis, z_axis);
 
 		refprobe_count++;
 	}
@@ -271,7 +322,8 @@ public:
 		aabb.expand_to(origin - x_axis - y_axis + z_axis);
 		aabb.expand_to(origin - x_axis - y_axis - z_axis);
 
-		_add_item(aabb, ITEM_TYPE_DECAL, decal_count);
+		Item &item = _add_item(aabb, ITEM_TYPE_DECAL, decal_count);
+		_set_box_shape(item, origin, x_axis, y_axis, z_axis);
 
 		decal_count++;
 	}
@@ -477,7 +477,10 @@ Size2i RasterizerCanvasRD::_bind_texture_binding(TextureBindingID p_binding, RD:
 
 	RD::get_singleton()->draw_list_bind_uniform_set(p_draw_list, texture_binding->uniform_set, 0);
 	if (texture_binding->key.texture.is_valid()) {
-		return storage->texture_2d_get_size(texture_binding->key.texture);
+		Size2i size = storage->texture_2d_get_size(texture_binding->key.texture);
+		//2D has no sense of screen coverage here, ask for full size
+		storage->texture_add_streaming_demand(texture_binding->key.texture, MAX(size.width, size.height));
+		return size;
 	} else {
 		return Size2i(1, 1);
 	}
@@ -503,8 +506,8 @@ void RasterizerCanvasRD::_render_item(RD::DrawListID p_draw_list, const Item *p_
 	push_constant.color_texture_pixel_size[0] = 0;
 	push_constant.color_texture_pixel_size[1] = 0;
 
-	push_constant.pad[0] = 0;
-	push_constant.pad[1] = 0;
+	push_constant.batch_offset = 0;
+	push_constant.pad = 0;
 
 	push_constant.lights[0] = 0;
 	push_constant.lights[1] = 0;
@@ -557,6 +560,10 @@ void RasterizerCanvasRD::_render_item(RD::DrawListID p_draw_list, const Item *p_
 		base_flags |= light_count << FLAGS_LIGHT_COUNT_SHIFT;
 	}
 
+	if (light_count > 0) {
+		_flush_batch(p_draw_list);
+	}
+
 	{
 		RID &canvas_item_state = light_count ? state_data->state_uniform_set_with_light : state_data->state_uniform_set;
 
@@ -608,6 +615,14 @@ void RasterizerCanvasRD::_render_item(RD::DrawListID p_draw_list, const Item *p_
 				uniforms.push_back(u);
 			}
 
+			{
+				RD::Uniform u;
+				u.type = RD::UNIFORM_TYPE_STORAGE_BUFFER;
+				u.binding = 8;
+				u.ids.push_back(batch.instance_buffer);
+				uniforms.push_back(u);
+			}
+
 			//validate and update lighs if they are being used
 
 			if (light_count > 0) {
@@ -689,12 +704,24 @@ void RasterizerCanvasRD::_render_item(RD::DrawListID p_draw_list, const Item *p_
 		push_constant.flags = base_flags; //reset on each command for sanity
 		push_constant.specular_shininess = 0xFFFFFFFF;
 
+		if (c->type != Item::Command::TYPE_RECT && c->type != Item::Command::TYPE_TRANSFORM) {
+			_flush_batch(p_draw_list);
+		}
+
 		switch (c->type) {
 			case Item::Command::TYPE_RECT: {
 				const Item::CommandRect *rect = static_cast<const Item::CommandRect *>(c);
 
-				//bind pipeline
-				{
+				bool batched = batch.enabled && light_mode == PIPELINE_LIGHT_MODE_DISABLED && batch.instances.size() < batch.max_instances;
+
+				if (batched) {
+					if (batch.count && (batch.texture_binding != rect->texture_binding.binding_id || batch.pipeline_variants != pipeline_variants)) {
+						_flush_batch(p_draw_list);
+					}
+				} else {
+					_flush_batch(p_draw_list);
+
+					//bind pipeline
 					RID pipeline = pipeline_variants->variants[light_mode][PIPELINE_VARIANT_QUAD].get_render_pipeline(RD::INVALID_ID, p_framebuffer_format);
 					RD::get_singleton()->draw_list_bind_render_pipeline(p_draw_list, pipeline);
 				}
@@ -783,9 +810,23 @@ void RasterizerCanvasRD::_render_item(RD::DrawListID p_draw_list, const Item *p_
 				push_constant.color_texture_pixel_size[0] = texpixel_size.x;
 				push_constant.color_texture_pixel_size[1] = texpixel_size.y;
 
+				if (batched) {
+					if (batch.count == 0) {
+						batch.from = batch.instances.size();
+						batch.texture_binding = rect->texture_binding.binding_id;
+						batch.pipeline_variants = pipeline_variants;
+						batch.framebuffer_format = p_framebuffer_format;
+					}
+					batch.instances.push_back(push_constant);
+					batch.count++;
+					info.batched_commands++;
+					break;
+				}
+
 				RD::get_singleton()->draw_list_set_push_constant(p_draw_list, &push_constant, sizeof(PushConstant));
 				RD::get_singleton()->draw_list_bind_index_array(p_draw_list, shader.quad_index_array);
 				RD::get_singleton()->draw_list_draw(p_draw_list, true);
+				info.draw_calls++;
 
 			} break;
 
@@ -862,6 +903,7 @@ void RasterizerCanvasRD::_render_item(RD::DrawListID p_draw_list, const Item *p_
 				RD::get_singleton()->draw_list_set_push_constant(p_draw_list, &push_constant, sizeof(PushConstant));
 				RD::get_singleton()->draw_list_bind_index_array(p_draw_list, shader.quad_index_array);
 				RD::get_singleton()->draw_list_draw(p_draw_list, true);
+				info.draw_calls++;
 
 			} break;
 			case Item::Command::TYPE_POLYGON: {
@@ -917,6 +959,7 @@ void RasterizerCanvasRD::_render_item(RD::DrawListID p_draw_list, const Item *p_
 					RD::get_singleton()->draw_list_bind_index_array(p_draw_list, pb->indices);
 				}
 				RD::get_singleton()->draw_list_draw(p_draw_list, pb->indices.is_valid());
+				info.draw_calls++;
 
 			} break;
 			case Item::Command::TYPE_PRIMITIVE: {
@@ -955,6 +998,7 @@ void RasterizerCanvasRD::_render_item(RD::DrawListID p_draw_list, const Item *p_
 				}
 				RD::get_singleton()->draw_list_set_push_constant(p_draw_list, &push_constant, sizeof(PushConstant));
 				RD::get_singleton()->draw_list_draw(p_draw_list, true);
+				info.draw_calls++;
 
 				if (primitive->point_count == 4) {
 					for (uint32_t j = 1; j < 3; j++) {
@@ -970,6 +1014,7 @@ void RasterizerCanvasRD::_render_item(RD::DrawListID p_draw_list, const Item *p_
 
 					RD::get_singleton()->draw_list_set_push_constant(p_draw_list, &push_constant, sizeof(PushConstant));
 					RD::get_singleton()->draw_list_draw(p_draw_list, true);
+					info.draw_calls++;
 				}
 
 			} break;
@@ -1328,6 +1373,7 @@ void RasterizerCanvasRD::_render_items(RID p_to_render_target, int p_item_count,
 		Item *ci = items[i];
 
 		if (current_clip != ci->final_clip_owner) {
+			_flush_batch(draw_list);
 			current_clip = ci->final_clip_owner;
 
 			//setup clip
@@ -1340,6 +1386,8 @@ void RasterizerCanvasRD::_render_items(RID p_to_render_target, int p_item_count,
 		}
 
 		if (ci->material != prev_material) {
+			_flush_batch(draw_list);
+
 			MaterialData *material_data = nullptr;
 			if (ci->material.is_valid()) {
 				material_data = (MaterialData *)storage->material_get_data(ci->material, RasterizerStorageRD::SHADER_TYPE_2D);
@@ -1364,7 +1412,46 @@ void RasterizerCanvasRD::_render_items(RID p_to_render_target, int p_item_count,
 		prev_material = ci->material;
 	}
 
+	_flush_batch(draw_list);
+
 	RD::get_singleton()->draw_list_end();
+
+	_upload_batch_instances();
+
+	info.items += p_item_count;
+}
+
+void RasterizerCanvasRD::_flush_batch(RD::DrawListID p_draw_list) {
+	if (batch.count == 0) {
+		return;
+	}
+
+	RID pipeline = batch.pipeline_variants->variants[PIPELINE_LIGHT_MODE_DISABLED][PIPELINE_VARIANT_QUAD_BATCH].get_render_pipeline(RD::INVALID_ID, batch.framebuffer_format);
+	RD::get_singleton()->draw_list_bind_render_pipeline(p_draw_list, pipeline);
+
+	//only the offset is read, the rest comes from the instances
+	PushConstant push_constant = batch.instances[batch.from];
+	push_constant.batch_offset = batch.frame_region * batch.max_instances + batch.from;
+
+	RD::get_singleton()->draw_list_set_push_constant(p_draw_list, &push_constant, sizeof(PushConstant));
+	RD::get_singleton()->draw_list_bind_index_array(p_draw_list, shader.quad_index_array);
+	RD::get_singleton()->draw_list_draw(p_draw_list, true, batch.count);
+	info.draw_calls++;
+
+	batch.count = 0;
+}
+
+void RasterizerCanvasRD::_upload_batch_instances() {
+	uint32_t count = batch.instances.size() - batch.uploaded;
+	if (count == 0) {
+		return;
+	}
+
+	//not synced to draw, so it lands before anything drawn this frame. This is fine because
+	//each draw list of the frame uses its own range, and each frame in flight its own region.
+	uint32_t offset = batch.frame_region * batch.max_instances + batch.uploaded;
+	RD::get_singleton()->buffer_update(batch.instance_buffer, offset * sizeof(PushConstant), count * sizeof(PushConstant), &batch.instances[batch.uploaded]);
+	batch.uploaded = batch.instances.size();
 }
 
 void RasterizerCanvasRD::canvas_render_items(RID p_to_render_target, Item *p_item_list, const Color &p_modulate, Light *p_light_list, const Transform2D &p_canvas_transform) {
@@ -1915,6 +2002,7 @@ void RasterizerCanvasRD::ShaderData::set_code(const String &p_code) {
 				RD::RENDER_PRIMITIVE_LINES,
 				RD::RENDER_PRIMITIVE_LINESTRIPS,
 				RD::RENDER_PRIMITIVE_POINTS,
+				RD::RENDER_PRIMITIVE_TRIANGLES,
 			};
 
 			ShaderVariant shader_variants[PIPELINE_LIGHT_MODE_MAX][PIPELINE_VARIANT_MAX] = {
@@ -1928,7 +2016,8 @@ void RasterizerCanvasRD::ShaderData::set_code(const String &p_code) {
 						SHADER_VARIANT_ATTRIBUTES,
 						SHADER_VARIANT_ATTRIBUTES,
 						SHADER_VARIANT_ATTRIBUTES,
-						SHADER_VARIANT_ATTRIBUTES_POINTS },
+						SHADER_VARIANT_ATTRIBUTES_POINTS,
+						SHADER_VARIANT_QUAD_BATCH },
 				{ //lit
 						SHADER_VARIANT_QUAD_LIGHT,
 						SHADER_VARIANT_NINEPATCH_LIGHT,
@@ -1939,7 +2028,8 @@ void RasterizerCanvasRD::ShaderData::set_code(const String &p_code) {
 						SHADER_VARIANT_ATTRIBUTES_LIGHT,
 						SHADER_VARIANT_ATTRIBUTES_LIGHT,
 						SHADER_VARIANT_ATTRIBUTES_LIGHT,
-						SHADER_VARIANT_ATTRIBUTES_POINTS_LIGHT },
+						SHADER_VARIANT_ATTRIBUTES_POINTS_LIGHT,
+						SHADER_VARIANT_QUAD_BATCH }, //batches are never lit
 			};
 
 			RID shader_variant = canvas_singleton->shader.canvas_shader.version_get_shader(version, shader_variants[i][j]);
@@ -2165,6 +2255,29 @@ void RasterizerCanvasRD::set_time(double p_time) {
 
 void RasterizerCanvasRD::update() {
 	_dispose_bindings();
+
+	//called once per frame, after all viewports are drawn
+	info_last_frame = info;
+	info.items = 0;
+	info.draw_calls = 0;
+	info.batched_commands = 0;
+
+	batch.instances.clear();
+	batch.uploaded = 0;
+	batch.frame_region = (batch.frame_region + 1) % batch.frame_regions;
+}
+
+int RasterizerCanvasRD::get_render_info(RS::RenderInfo p_info) {
+	switch (p_info) {
+		case RS::INFO_2D_ITEMS_IN_FRAME:
+			return info_last_frame.items;
+		case RS::INFO_2D_DRAW_CALLS_IN_FRAME:
+			return info_last_frame.draw_calls;
+		case RS::INFO_2D_BATCHED_COMMANDS_IN_FRAME:
+			return info_last_frame.batched_commands;
+		default:
+			return 0;
+	}
 }
 
 RasterizerCanvasRD::RasterizerCanvasRD(RasterizerStorageRD *p_storage) {
@@ -2221,6 +2334,8 @@ RasterizerCanvasRD::RasterizerCanvasRD(RasterizerStorageRD *p_storage) {
 		variants.push_back("#define USE_LIGHTING\n#define USE_PRIMITIVE\n#define USE_POINT_SIZE\n"); //points need point size
 		variants.push_back("#define USE_LIGHTING\n#define USE_ATTRIBUTES\n"); // attributes for vertex arrays
 		variants.push_back("#define USE_LIGHTING\n#define USE_ATTRIBUTES\n#define USE_POINT_SIZE\n"); //attributes with point size
+		//batched rects, never lit
+		variants.push_back("#define USE_BATCH\n");
 
 		shader.canvas_shader.initialize(variants, global_defines);
 
@@ -2241,6 +2356,7 @@ RasterizerCanvasRD::RasterizerCanvasRD(RasterizerStorageRD *p_storage) {
 					RD::RENDER_PRIMITIVE_LINES,
 					RD::RENDER_PRIMITIVE_LINESTRIPS,
 					RD::RENDER_PRIMITIVE_POINTS,
+					RD::RENDER_PRIMITIVE_TRIANGLES,
 				};
 
 				ShaderVariant shader_variants[PIPELINE_LIGHT_MODE_MAX][PIPELINE_VARIANT_MAX] = {
@@ -2254,7 +2370,8 @@ RasterizerCanvasRD::RasterizerCanvasRD(RasterizerStorageRD *p_storage) {
 							SHADER_VARIANT_ATTRIBUTES,
 							SHADER_VARIANT_ATTRIBUTES,
 							SHADER_VARIANT_ATTRIBUTES,
-							SHADER_VARIANT_ATTRIBUTES_POINTS },
+							SHADER_VARIANT_ATTRIBUTES_POINTS,
+							SHADER_VARIANT_QUAD_BATCH },
 					{ //lit
 							SHADER_VARIANT_QUAD_LIGHT,
 							SHADER_VARIANT_NINEPATCH_LIGHT,
@@ -2265,7 +2382,8 @@ RasterizerCanvasRD::RasterizerCanvasRD(RasterizerStorageRD *p_storage) {
 							SHADER_VARIANT_ATTRIBUTES_LIGHT,
 							SHADER_VARIANT_ATTRIBUTES_LIGHT,
 							SHADER_VARIANT_ATTRIBUTES_LIGHT,
-							SHADER_VARIANT_ATTRIBUTES_POINTS_LIGHT },
+							SHADER_VARIANT_ATTRIBUTES_POINTS_LIGHT,
+							SHADER_VARIANT_QUAD_BATCH }, //batches are never lit
 				};
 
 				RID shader_variant = shader.canvas_shader.version_get_shader(shader.default_version, shader_variants[i][j]);
@@ -2332,7 +2450,7 @@ RasterizerCanvasRD::RasterizerCanvasRD(RasterizerStorageRD *p_storage) {
 		actions.base_uniform_string = "material.";
 		actions.default_filter = ShaderLanguage::FILTER_LINEAR;
 		actions.default_repeat = ShaderLanguage::REPEAT_DISABLE;
-		actions.base_varying_index = 4;
+		actions.base_varying_index = 5;
 
 		actions.global_buffer_array_variable = "global_variables.data";
 
@@ -2392,6 +2510,27 @@ RasterizerCanvasRD::RasterizerCanvasRD(RasterizerStorageRD *p_storage) {
 
 		{ //state allocate
 			state.canvas_state_buffer = RD::get_singleton()->uniform_buffer_create(sizeof(State::Buffer));
+
+			batch.enabled = GLOBAL_GET("rendering/quality/2d/use_batching");
+			batch.max_instances = MAX(int(GLOBAL_GET("rendering/quality/2d/batching_max_rects")), 1);
+			batch.frame_regions = RD::get_singleton()->get_frame_delay();
+			batch.frame_region = 0;
+			batch.uploaded = 0;
+			batch.from = 0;
+			batch.count = 0;
+			batch.texture_binding = 0;
+			batch.pipeline_variants = nullptr;
+			batch.framebuffer_format = 0;
+			if (batch.enabled) {
+				batch.instances.reserve(batch.max_instances);
+			}
+			//still needed when disabled, as the canvas item state references it
+			batch.instance_buffer = RD::get_singleton()->storage_buffer_create(sizeof(PushConstant) * (batch.enabled ? batch.max_instances * batch.frame_regions : 1));
+
+			info.items = 0;
+			info.draw_calls = 0;
+			info.batched_commands = 0;
+			info_last_frame = info;
 			state.lights_uniform_buffer = RD::get_singleton()->uniform_buffer_create(sizeof(LightUniform) * state.max_lights_per_render);
 
 			RD::SamplerState shadow_sampler_state;
@@ -2479,6 +2618,7 @@ RasterizerCanvasRD::~RasterizerCanvasRD() {
 
 		memdelete_arr(state.light_uniforms);
 		RD::get_singleton()->free(state.lights_uniform_buffer);
+		RD::get_singleton()->free(batch.instance_buffer);
 		RD::get_singleton()->free(shader.default_skeleton_uniform_buffer);
 		RD::get_singleton()->free(shader.default_skeleton_texture_buffer);
 	}
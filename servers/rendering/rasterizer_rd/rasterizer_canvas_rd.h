@@ -31,6 +31,7 @@
 #ifndef RASTERIZER_CANVAS_RD_H
 #define RASTERIZER_CANVAS_RD_H
 
+#include "core/local_vector.h"
 #include "servers/rendering/rasterizer.h"
 #include "servers/rendering/rasterizer_rd/rasterizer_storage_rd.h"
 #include "servers/rendering/rasterizer_rd/render_pipeline_vertex_format_cache_rd.h"
@@ -55,6 +56,7 @@ class RasterizerCanvasRD : public RasterizerCanvas {
 		SHADER_VARIANT_PRIMITIVE_POINTS_LIGHT,
 		SHADER_VARIANT_ATTRIBUTES_LIGHT,
 		SHADER_VARIANT_ATTRIBUTES_POINTS_LIGHT,
+		SHADER_VARIANT_QUAD_BATCH,
 		SHADER_VARIANT_MAX
 	};
 
@@ -119,6 +121,7 @@ class RasterizerCanvasRD : public RasterizerCanvas {
 		PIPELINE_VARIANT_ATTRIBUTE_LINES,
 		PIPELINE_VARIANT_ATTRIBUTE_LINES_STRIP,
 		PIPELINE_VARIANT_ATTRIBUTE_POINTS,
+		PIPELINE_VARIANT_QUAD_BATCH,
 		PIPELINE_VARIANT_MAX
 	};
 	enum PipelineLightMode {
@@ -432,7 +435,8 @@ class RasterizerCanvasRD : public RasterizerCanvas {
 				float ninepatch_margins[4];
 				float dst_rect[4];
 				float src_rect[4];
-				float pad[2];
+				uint32_t batch_offset; //first instance of a batch
+				uint32_t pad;
 			};
 			//primitive
 			struct {
@@ -450,11 +454,43 @@ class RasterizerCanvasRD : public RasterizerCanvas {
 		float skeleton_inverse[16];
 	};
 
+	//consecutive unlit rects sharing texture and material are drawn with a single
+	//instanced draw, reading their push constant data from a storage buffer
+
+	struct Batch {
+		bool enabled;
+		RID instance_buffer;
+		uint32_t max_instances; //per frame
+		uint32_t frame_regions; //frames in flight, each writes its own region
+		uint32_t frame_region;
+
+		LocalVector<PushConstant> instances; //this frame
+		uint32_t uploaded;
+
+		//batch being recorded
+		uint32_t from;
+		uint32_t count;
+		TextureBindingID texture_binding;
+		PipelineVariants *pipeline_variants;
+		RenderingDevice::FramebufferFormatID framebuffer_format;
+	} batch;
+
+	struct Info {
+		uint32_t items;
+		uint32_t draw_calls;
+		uint32_t batched_commands;
+	};
+
+	Info info; //being counted
+	Info info_last_frame;
+
 	Item *items[MAX_RENDER_ITEMS];
 
 	Size2i _bind_texture_binding(TextureBindingID p_binding, RenderingDevice::DrawListID p_draw_list, uint32_t &flags);
 	void _render_item(RenderingDevice::DrawListID p_draw_list, const Item *p_item, RenderingDevice::FramebufferFormatID p_framebuffer_format, const Transform2D &p_canvas_transform_inverse, Item *&current_clip, Light *p_lights, PipelineVariants *p_pipeline_variants);
 	void _render_items(RID p_to_render_target, int p_item_count, const Transform2D &p_canvas_transform_inverse, Light *p_lights, RID p_screen_uniform_set);
+	void _flush_batch(RenderingDevice::DrawListID p_draw_list);
+	void _upload_batch_instances();
 
 	_FORCE_INLINE_ void _update_transform_2d_to_mat2x4(const Transform2D &p_transform, float *p_mat2x4);
 	_FORCE_INLINE_ void _update_transform_2d_to_mat2x3(const Transform2D &p_transform, float *p_mat2x3);
@@ -486,6 +522,8 @@ public:
 
 	void draw_window_margins(int *p_margins, RID *p_margin_textures) {}
 
+	int get_render_info(RS::RenderInfo p_info);
+
 	void set_time(double p_time);
 	void update();
 	bool free(RID p_rid);
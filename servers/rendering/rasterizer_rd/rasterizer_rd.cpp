@@ -177,6 +177,11 @@ RasterizerRD::RasterizerRD() {
 	thread_work_pool.init();
 	time = 0;
 
+	if (GLOBAL_GET("rendering/high_end/shader_cache/enabled")) {
+		//must happen before any shader is compiled below
+		RenderingDevice::shader_set_cache_dir("user://shader_cache");
+	}
+
 	storage = memnew(RasterizerStorageRD);
 	canvas = memnew(RasterizerCanvasRD(storage));
 	scene = memnew(RasterizerSceneHighEndRD(storage));
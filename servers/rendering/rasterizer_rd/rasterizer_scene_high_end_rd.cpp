@@ -776,6 +776,82 @@ bool RasterizerSceneHighEndRD::free(RID p_rid) {
 	return false;
 }
 
+static _FORCE_INLINE_ uint32_t _depth_sort_key(float p_depth) {
+	// Flips the float bits so the unsigned integers sort in the same order as the floats.
+	uint32_t bits;
+	memcpy(&bits, &p_depth, sizeof(uint32_t));
+	return (bits & 0x80000000) ? ~bits : (bits | 0x80000000);
+}
+
+void RasterizerSceneHighEndRD::RenderList::_sort(Element **p_elements, uint32_t p_count, SortMode p_mode) {
+	if (p_count < 2) {
+		return;
+	}
+
+	if (sort_entries.size() < p_count) {
+		sort_entries.resize(p_count);
+		sort_scratch.resize(p_count);
+	}
+
+	SortEntry *src = sort_entries.ptr();
+	SortEntry *dst = sort_scratch.ptr();
+
+	// Least significant byte first, one histogram per key byte, all built in a single pass.
+	const uint32_t key_bytes = p_mode == SORT_BY_DEPTH ? 4 : 8;
+	uint32_t histograms[8][256];
+	memset(histograms, 0, sizeof(histograms));
+
+	for (uint32_t i = 0; i < p_count; i++) {
+		Element *e = p_elements[i];
+		uint64_t key;
+		switch (p_mode) {
+			case SORT_BY_KEY: {
+				key = e->sort_key;
+			} break;
+			case SORT_BY_DEPTH: {
+				key = _depth_sort_key(e->instance->depth);
+			} break;
+			default: {
+				// Ascending priority, then back to front.
+				key = (uint64_t(e->priority) << 32) | uint64_t(~_depth_sort_key(e->instance->depth));
+			} break;
+		}
+
+		src[i].key = key;
+		src[i].element = e;
+
+		for (uint32_t b = 0; b < key_bytes; b++) {
+			histograms[b][(key >> (b * 8)) & 0xFF]++;
+		}
+	}
+
+	for (uint32_t b = 0; b < key_bytes; b++) {
+		uint32_t *histogram = histograms[b];
+		const uint32_t shift = b * 8;
+
+		if (histogram[(src[0].key >> shift) & 0xFF] == p_count) {
+			continue; // All keys share this byte, nothing would move.
+		}
+
+		uint32_t offset = 0;
+		for (uint32_t i = 0; i < 256; i++) {
+			uint32_t count = histogram[i];
+			histogram[i] = offset;
+			offset += count;
+		}
+
+		for (uint32_t i = 0; i < p_count; i++) {
+			dst[histogram[(src[i].key >> shift) & 0xFF]++] = src[i];
+		}
+
+		SWAP(src, dst);
+	}
+
+	for (uint32_t i = 0; i < p_count; i++) {
+		p_elements[i] = src[i].element;
+	}
+}
+
 void RasterizerSceneHighEndRD::_fill_instances(RenderList::Element **p_elements, int p_element_count, bool p_for_depth, bool p_has_sdfgi, bool p_has_opaque_gi) {
 	uint32_t lightmap_captures_used = 0;
 
@@ -1025,12 +1101,12 @@ void RasterizerSceneHighEndRD::_render_list(RenderingDevice::DrawListID p_draw_l
 
 		switch (e->instance->base_type) {
 			case RS::INSTANCE_MESH: {
-				storage->mesh_surface_get_arrays_and_format(e->instance->base, e->surface_index, pipeline->get_vertex_input_mask(), vertex_array_rd, index_array_rd, vertex_format);
+				storage->mesh_surface_get_arrays_and_format(e->instance->base, e->surface_index, pipeline->get_vertex_input_mask(), vertex_array_rd, index_array_rd, vertex_format, e->lod_index);
 			} break;
 			case RS::INSTANCE_MULTIMESH: {
 				RID mesh = storage->multimesh_get_mesh(e->instance->base);
 				ERR_CONTINUE(!mesh.is_valid()); //should be a bug
-				storage->mesh_surface_get_arrays_and_format(mesh, e->surface_index, pipeline->get_vertex_input_mask(), vertex_array_rd, index_array_rd, vertex_format);
+				storage->mesh_surface_get_arrays_and_format(mesh, e->surface_index, pipeline->get_vertex_input_mask(), vertex_array_rd, index_array_rd, vertex_format, e->lod_index);
 			} break;
 			case RS::INSTANCE_IMMEDIATE: {
 				ERR_CONTINUE(true); //should be a bug
@@ -1332,7 +1408,7 @@ void RasterizerSceneHighEndRD::_setup_environment(RID p_environment, RID p_rende
 	RD::get_singleton()->buffer_update(scene_state.uniform_buffer, 0, sizeof(SceneState::UBO), &scene_state.ubo, true);
 }
 
-void RasterizerSceneHighEndRD::_add_geometry(InstanceBase *p_instance, uint32_t p_surface, RID p_material, PassMode p_pass_mode, uint32_t p_geometry_index, bool p_using_sdfgi) {
+void RasterizerSceneHighEndRD::_add_geometry(InstanceBase *p_instance, uint32_t p_surface, RID p_material, PassMode p_pass_mode, uint32_t p_geometry_index, bool p_using_sdfgi, uint32_t p_lod, uint32_t p_texture_demand) {
 	RID m_src;
 
 	m_src = p_instance->material_override.is_valid() ? p_instance->material_override : p_material;
@@ -1361,18 +1437,25 @@ void RasterizerSceneHighEndRD::_add_geometry(InstanceBase *p_instance, uint32_t
 
 	ERR_FAIL_COND(!material);
 
-	_add_geometry_with_material(p_instance, p_surface, material, m_src, p_pass_mode, p_geometry_index, p_using_sdfgi);
+	_add_geometry_with_material(p_instance, p_surface, material, m_src, p_pass_mode, p_geometry_index, p_using_sdfgi, p_lod, p_texture_demand);
 
 	while (material->next_pass.is_valid()) {
 		material = (MaterialData *)storage->material_get_data(material->next_pass, RasterizerStorageRD::SHADER_TYPE_3D);
 		if (!material || !material->shader_data->valid) {
 			break;
 		}
-		_add_geometry_with_material(p_instance, p_surface, material, material->next_pass, p_pass_mode, p_geometry_index, p_using_sdfgi);
+		_add_geometry_with_material(p_instance, p_surface, material, material->next_pass, p_pass_mode, p_geometry_index, p_using_sdfgi, p_lod, p_texture_demand);
 	}
 }
 
-void RasterizerSceneHighEndRD::_add_geometry_with_material(InstanceBase *p_instance, uint32_t p_surface, MaterialData *p_material, RID p_material_rid, PassMode p_pass_mode, uint32_t p_geometry_index, bool p_using_sdfgi) {
+void RasterizerSceneHighEndRD::_add_geometry_with_material(InstanceBase *p_instance, uint32_t p_surface, MaterialData *p_material, RID p_material_rid, PassMode p_pass_mode, uint32_t p_geometry_index, bool p_using_sdfgi, uint32_t p_lod, uint32_t p_texture_demand) {
+	if (p_texture_demand > 0) {
+		const RID *textures = p_material->streaming_textures.ptr();
+		for (int i = 0; i < p_material->streaming_textures.size(); i++) {
+			storage->texture_add_streaming_demand(textures[i], p_texture_demand);
+		}
+	}
+
 	bool has_read_screen_alpha = p_material->shader_data->uses_screen_texture || p_material->shader_data->uses_depth_texture || p_material->shader_data->uses_normal_texture;
 	bool has_base_alpha = (p_material->shader_data->uses_alpha || has_read_screen_alpha);
 	bool has_blend_alpha = p_material->shader_data->uses_blend_alpha;
@@ -1423,6 +1506,7 @@ void RasterizerSceneHighEndRD::_add_geometry_with_material(InstanceBase *p_insta
 	e->instance = p_instance;
 	e->material = p_material;
 	e->surface_index = p_surface;
+	e->lod_index = p_lod;
 	e->sort_key = 0;
 
 	if (e->material->last_pass != render_pass) {
@@ -1451,7 +1535,7 @@ void RasterizerSceneHighEndRD::_add_geometry_with_material(InstanceBase *p_insta
 	}
 }
 
-void RasterizerSceneHighEndRD::_fill_render_list(InstanceBase **p_cull_result, int p_cull_count, PassMode p_pass_mode, bool p_using_sdfgi) {
+void RasterizerSceneHighEndRD::_fill_render_list(InstanceBase **p_cull_result, int p_cull_count, PassMode p_pass_mode, bool p_using_sdfgi, const Vector3 &p_lod_camera_position, float p_lod_pixels_per_unit, bool p_lod_orthogonal) {
 	scene_state.current_shader_index = 0;
 	scene_state.current_material_index = 0;
 	scene_state.used_sss = false;
@@ -1461,11 +1545,42 @@ void RasterizerSceneHighEndRD::_fill_render_list(InstanceBase **p_cull_result, i
 
 	uint32_t geometry_index = 0;
 
+	bool use_lods = mesh_lod_threshold > 0.0 && p_lod_pixels_per_unit > 0.0;
+	bool use_texture_demand = p_lod_pixels_per_unit > 0.0;
+
 	//fill list
 
 	for (int i = 0; i < p_cull_count; i++) {
 		InstanceBase *inst = p_cull_result[i];
 
+		// Largest error, in the mesh's own units, that stays under the pixel threshold.
+		float lod_max_error = 0.0;
+		// Pixels the instance covers on screen, used as texture streaming feedback.
+		uint32_t texture_demand = 0;
+		if ((use_lods || use_texture_demand) && (inst->base_type == RS::INSTANCE_MESH || inst->base_type == RS::INSTANCE_MULTIMESH)) {
+			float distance = 1.0;
+			if (!p_lod_orthogonal) {
+				const AABB &aabb = inst->transformed_aabb;
+				Vector3 closest = p_lod_camera_position;
+				closest.x = CLAMP(closest.x, aabb.position.x, aabb.position.x + aabb.size.x);
+				closest.y = CLAMP(closest.y, aabb.position.y, aabb.position.y + aabb.size.y);
+				closest.z = CLAMP(closest.z, aabb.position.z, aabb.position.z + aabb.size.z);
+				distance = closest.distance_to(p_lod_camera_position);
+			}
+			if (use_lods) {
+				Vector3 scale = inst->transform.basis.get_scale_abs();
+				float max_scale = MAX(scale.x, MAX(scale.y, scale.z));
+				if (max_scale > 0.0) {
+					lod_max_error = mesh_lod_threshold * distance / (p_lod_pixels_per_unit * max_scale);
+				}
+			}
+			if (use_texture_demand) {
+				// Assumes the UVs span the texture once over the instance.
+				float pixels = inst->transformed_aabb.get_longest_axis_size() * p_lod_pixels_per_unit / MAX(distance, (float)CMP_EPSILON);
+				texture_demand = uint32_t(CLAMP(pixels, 1.0, 16384.0));
+			}
+		}
+
 		//add geometry for drawing
 		switch (inst->base_type) {
 			case RS::INSTANCE_MESH: {
@@ -1483,7 +1598,8 @@ void RasterizerSceneHighEndRD::_fill_render_list(InstanceBase **p_cull_result, i
 					RID material = inst_materials[j].is_valid() ? inst_materials[j] : materials[j];
 
 					uint32_t surface_index = storage->mesh_surface_get_render_pass_index(inst->base, j, render_pass, &geometry_index);
-					_add_geometry(inst, j, material, p_pass_mode, surface_index, p_using_sdfgi);
+					uint32_t lod = lod_max_error > 0.0 ? storage->mesh_surface_get_lod(inst->base, j, lod_max_error) : 0;
+					_add_geometry(inst, j, material, p_pass_mode, surface_index, p_using_sdfgi, lod, texture_demand);
 				}
 
 				//mesh->last_pass=frame;
@@ -1511,7 +1627,8 @@ void RasterizerSceneHighEndRD::_fill_render_list(InstanceBase **p_cull_result, i
 
 				for (uint32_t j = 0; j < surface_count; j++) {
 					uint32_t surface_index = storage->mesh_surface_get_multimesh_render_pass_index(mesh, j, render_pass, &geometry_index);
-					_add_geometry(inst, j, materials[j], p_pass_mode, surface_index, p_using_sdfgi);
+					uint32_t lod = lod_max_error > 0.0 ? storage->mesh_surface_get_lod(mesh, j, lod_max_error) : 0;
+					_add_geometry(inst, j, materials[j], p_pass_mode, surface_index, p_using_sdfgi, lod, texture_demand);
 				}
 
 			} break;
@@ -1694,8 +1811,15 @@ void RasterizerSceneHighEndRD::_render_scene(RID p_render_buffer, const Transfor
 
 	_update_render_base_uniform_set(); //may have changed due to the above (light buffer enlarged, as an example)
 
+	float lod_pixels_per_unit;
+	if (p_cam_ortogonal) {
+		lod_pixels_per_unit = vp_he.y > 0.0 ? screen_size.y / (vp_he.y * 2.0) : 0.0;
+	} else {
+		lod_pixels_per_unit = screen_size.y * 0.5 * p_cam_projection.matrix[1][1];
+	}
+
 	render_list.clear();
-	_fill_render_list(p_cull_result, p_cull_count, PASS_MODE_COLOR, using_sdfgi);
+	_fill_render_list(p_cull_result, p_cull_count, PASS_MODE_COLOR, using_sdfgi, p_cam_transform.origin, lod_pixels_per_unit, p_cam_ortogonal);
 
 	bool using_sss = render_buffer && scene_state.used_sss && sub_surface_scattering_get_quality() != RS::SUB_SURFACE_SCATTERING_QUALITY_DISABLED;
 
@@ -2780,6 +2904,8 @@ RasterizerSceneHighEndRD::RasterizerSceneHighEndRD(RasterizerStorageRD *p_storag
 	render_list.init();
 	render_pass = 0;
 
+	mesh_lod_threshold = GLOBAL_GET("rendering/quality/mesh_lod/threshold_pixels");
+
 	{
 		scene_state.max_instances = render_list.max_elements;
 		scene_state.instances = memnew_arr(InstanceData, scene_state.max_instances);
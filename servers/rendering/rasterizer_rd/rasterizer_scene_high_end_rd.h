@@ -31,6 +31,7 @@
 #ifndef RASTERIZER_SCENE_HIGHEND_RD_H
 #define RASTERIZER_SCENE_HIGHEND_RD_H
 
+#include "core/local_vector.h"
 #include "servers/rendering/rasterizer_rd/rasterizer_scene_rd.h"
 #include "servers/rendering/rasterizer_rd/rasterizer_storage_rd.h"
 #include "servers/rendering/rasterizer_rd/render_pipeline_vertex_format_cache_rd.h"
@@ -425,6 +426,7 @@ class RasterizerSceneHighEndRD : public RasterizerSceneRD {
 				uint64_t sort_key;
 			};
 			uint32_t surface_index;
+			uint32_t lod_index;
 		};
 
 		Element *base_elements;
@@ -438,58 +440,46 @@ class RasterizerSceneHighEndRD : public RasterizerSceneRD {
 			alpha_element_count = 0;
 		}
 
-		//should eventually be replaced by radix
+		// Sorting copies the keys next to the element pointers and radix sorts the pairs,
+		// so the comparisons never chase pointers. The buffers are kept between frames.
 
-		struct SortByKey {
-			_FORCE_INLINE_ bool operator()(const Element *A, const Element *B) const {
-				return A->sort_key < B->sort_key;
-			}
+		struct SortEntry {
+			uint64_t key;
+			Element *element;
+		};
+
+		LocalVector<SortEntry> sort_entries;
+		LocalVector<SortEntry> sort_scratch;
+
+		enum SortMode {
+			SORT_BY_KEY,
+			SORT_BY_DEPTH,
+			SORT_BY_REVERSE_DEPTH_AND_PRIORITY,
 		};
 
+		void _sort(Element **p_elements, uint32_t p_count, SortMode p_mode);
+
 		void sort_by_key(bool p_alpha) {
-			SortArray<Element *, SortByKey> sorter;
 			if (p_alpha) {
-				sorter.sort(&elements[max_elements - alpha_element_count], alpha_element_count);
+				_sort(&elements[max_elements - alpha_element_count], alpha_element_count, SORT_BY_KEY);
 			} else {
-				sorter.sort(elements, element_count);
+				_sort(elements, element_count, SORT_BY_KEY);
 			}
 		}
 
-		struct SortByDepth {
-			_FORCE_INLINE_ bool operator()(const Element *A, const Element *B) const {
-				return A->instance->depth < B->instance->depth;
-			}
-		};
-
 		void sort_by_depth(bool p_alpha) { //used for shadows
-
-			SortArray<Element *, SortByDepth> sorter;
 			if (p_alpha) {
-				sorter.sort(&elements[max_elements - alpha_element_count], alpha_element_count);
+				_sort(&elements[max_elements - alpha_element_count], alpha_element_count, SORT_BY_DEPTH);
 			} else {
-				sorter.sort(elements, element_count);
+				_sort(elements, element_count, SORT_BY_DEPTH);
 			}
 		}
 
-		struct SortByReverseDepthAndPriority {
-			_FORCE_INLINE_ bool operator()(const Element *A, const Element *B) const {
-				uint32_t layer_A = uint32_t(A->priority);
-				uint32_t layer_B = uint32_t(B->priority);
-				if (layer_A == layer_B) {
-					return A->instance->depth > B->instance->depth;
-				} else {
-					return layer_A < layer_B;
-				}
-			}
-		};
-
 		void sort_by_reverse_depth_and_priority(bool p_alpha) { //used for alpha
-
-			SortArray<Element *, SortByReverseDepthAndPriority> sorter;
 			if (p_alpha) {
-				sorter.sort(&elements[max_elements - alpha_element_count], alpha_element_count);
+				_sort(&elements[max_elements - alpha_element_count], alpha_element_count, SORT_BY_REVERSE_DEPTH_AND_PRIORITY);
 			} else {
-				sorter.sort(elements, element_count);
+				_sort(elements, element_count, SORT_BY_REVERSE_DEPTH_AND_PRIORITY);
 			}
 		}
 
@@ -568,10 +558,14 @@ class RasterizerSceneHighEndRD : public RasterizerSceneRD {
 
 	void _fill_instances(RenderList::Element **p_elements, int p_element_count, bool p_for_depth, bool p_has_sdfgi = false, bool p_has_opaque_gi = false);
 	void _render_list(RenderingDevice::DrawListID p_draw_list, RenderingDevice::FramebufferFormatID p_framebuffer_Format, RenderList::Element **p_elements, int p_element_count, bool p_reverse_cull, PassMode p_pass_mode, bool p_no_gi, RID p_radiance_uniform_set, RID p_render_buffers_uniform_set, bool p_force_wireframe = false, const Vector2 &p_uv_offset = Vector2());
-	_FORCE_INLINE_ void _add_geometry(InstanceBase *p_instance, uint32_t p_surface, RID p_material, PassMode p_pass_mode, uint32_t p_geometry_index, bool p_using_sdfgi = false);
-	_FORCE_INLINE_ void _add_geometry_with_material(InstanceBase *p_instance, uint32_t p_surface, MaterialData *p_material, RID p_material_rid, PassMode p_pass_mode, uint32_t p_geometry_index, bool p_using_sdfgi = false);
+	_FORCE_INLINE_ void _add_geometry(InstanceBase *p_instance, uint32_t p_surface, RID p_material, PassMode p_pass_mode, uint32_t p_geometry_index, bool p_using_sdfgi = false, uint32_t p_lod = 0, uint32_t p_texture_demand = 0);
+	_FORCE_INLINE_ void _add_geometry_with_material(InstanceBase *p_instance, uint32_t p_surface, MaterialData *p_material, RID p_material_rid, PassMode p_pass_mode, uint32_t p_geometry_index, bool p_using_sdfgi = false, uint32_t p_lod = 0, uint32_t p_texture_demand = 0);
+
+	// Maximum geometric error, in pixels, a mesh LOD may introduce on screen. Zero disables LOD selection.
+	float mesh_lod_threshold = 1.0;
 
-	void _fill_render_list(InstanceBase **p_cull_result, int p_cull_count, PassMode p_pass_mode, bool p_using_sdfgi = false);
+	// Pass p_lod_pixels_per_unit > 0 to select mesh LODs; shadow and bake passes keep full detail.
+	void _fill_render_list(InstanceBase **p_cull_result, int p_cull_count, PassMode p_pass_mode, bool p_using_sdfgi = false, const Vector3 &p_lod_camera_position = Vector3(), float p_lod_pixels_per_unit = 0.0, bool p_lod_orthogonal = false);
 
 	Map<Size2i, RID> sdfgi_framebuffer_size_cache;
 
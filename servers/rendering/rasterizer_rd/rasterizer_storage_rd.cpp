@@ -915,10 +915,14 @@ void RasterizerStorageRD::texture_replace(RID p_texture, RID p_by_texture) {
 
 	Vector<RID> proxies_to_update = tex->proxies;
 	Vector<RID> proxies_to_redirect = by_tex->proxies;
+	bool streaming_feedback = tex->streaming_feedback;
+	uint32_t streaming_demand = tex->streaming_demand;
 
 	*tex = *by_tex;
 
 	tex->proxies = proxies_to_update; //restore proxies, so they can be updated
+	tex->streaming_feedback = streaming_feedback; //streamed textures are replaced when mips come in, keep their feedback
+	tex->streaming_demand = streaming_demand;
 
 	for (int i = 0; i < proxies_to_update.size(); i++) {
 		texture_proxy_update(proxies_to_update[i], p_texture);
@@ -984,6 +988,31 @@ void RasterizerStorageRD::texture_set_proxy(RID p_proxy, RID p_base) {
 void RasterizerStorageRD::texture_set_force_redraw_if_visible(RID p_texture, bool p_enable) {
 }
 
+void RasterizerStorageRD::texture_set_streaming_feedback(RID p_texture, bool p_enable) {
+	Texture *tex = texture_owner.getornull(p_texture);
+	ERR_FAIL_COND(!tex);
+	tex->streaming_feedback = p_enable;
+	tex->streaming_demand = 0;
+}
+
+Vector<int> RasterizerStorageRD::texture_get_streaming_demand(const Vector<RID> &p_textures) {
+	Vector<int> demand;
+	demand.resize(p_textures.size());
+	int *w = demand.ptrw();
+
+	for (int i = 0; i < p_textures.size(); i++) {
+		Texture *tex = texture_owner.getornull(p_textures[i]);
+		if (!tex) {
+			w[i] = 0;
+			continue;
+		}
+		w[i] = tex->streaming_demand;
+		tex->streaming_demand = 0;
+	}
+
+	return demand;
+}
+
 Size2 RasterizerStorageRD::texture_size_with_proxy(RID p_proxy) {
 	return texture_2d_get_size(p_proxy);
 }
@@ -1842,6 +1871,8 @@ void RasterizerStorageRD::MaterialData::update_textures(const Map<StringName, Va
 	bool uses_global_textures = false;
 	global_textures_pass++;
 
+	streaming_textures.clear();
+
 	for (int i = 0; i < p_texture_uniforms.size(); i++) {
 		const StringName &uniform_name = p_texture_uniforms[i].name;
 
@@ -1914,6 +1945,9 @@ void RasterizerStorageRD::MaterialData::update_textures(const Map<StringName, Va
 
 			if (tex) {
 				rd_texture = (srgb && tex->rd_texture_srgb.is_valid()) ? tex->rd_texture_srgb : tex->rd_texture;
+				if (tex->streaming_feedback) {
+					streaming_textures.push_back(texture);
+				}
 #ifdef TOOLS_ENABLED
 				if (tex->detect_3d_callback && p_use_linear_color) {
 					tex->detect_3d_callback(tex->detect_3d_callback_ud);
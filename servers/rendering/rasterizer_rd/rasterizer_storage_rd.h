@@ -135,6 +135,9 @@ public:
 		virtual void update_parameters(const Map<StringName, Variant> &p_parameters, bool p_uniform_dirty, bool p_textures_dirty) = 0;
 		virtual ~MaterialData();
 
+		// Textures with streaming feedback, filled by update_textures().
+		Vector<RID> streaming_textures;
+
 	private:
 		friend class RasterizerStorageRD;
 		RID self;
@@ -221,6 +224,9 @@ private:
 
 		RS::TextureDetectRoughnessCallback detect_roughness_callback = nullptr;
 		void *detect_roughness_callback_ud = nullptr;
+
+		bool streaming_feedback = false;
+		uint32_t streaming_demand = 0;
 	};
 
 	struct TextureToRDFormat {
@@ -766,6 +772,16 @@ public:
 	virtual void texture_set_proxy(RID p_proxy, RID p_base);
 	virtual void texture_set_force_redraw_if_visible(RID p_texture, bool p_enable);
 
+	virtual void texture_set_streaming_feedback(RID p_texture, bool p_enable);
+	virtual Vector<int> texture_get_streaming_demand(const Vector<RID> &p_textures);
+
+	_FORCE_INLINE_ void texture_add_streaming_demand(RID p_texture, uint32_t p_pixels) {
+		Texture *tex = texture_owner.getornull(p_texture);
+		if (tex && tex->streaming_feedback) {
+			tex->streaming_demand = MAX(tex->streaming_demand, p_pixels);
+		}
+	}
+
 	virtual Size2 texture_size_with_proxy(RID p_proxy);
 
 	virtual void texture_add_to_decal_atlas(RID p_texture, bool p_panorama_to_dp = false);
@@ -912,14 +928,34 @@ public:
 		return mesh->surfaces[p_surface_index]->primitive;
 	}
 
-	_FORCE_INLINE_ void mesh_surface_get_arrays_and_format(RID p_mesh, uint32_t p_surface_index, uint32_t p_input_mask, RID &r_vertex_array_rd, RID &r_index_array_rd, RD::VertexFormatID &r_vertex_format) {
+	//returns 0 for the full mesh, otherwise the LOD index + 1; LOD edge_length holds the geometric error it introduces
+	_FORCE_INLINE_ uint32_t mesh_surface_get_lod(RID p_mesh, uint32_t p_surface_index, float p_max_error) {
+		Mesh *mesh = mesh_owner.getornull(p_mesh);
+		ERR_FAIL_COND_V(!mesh, 0);
+		ERR_FAIL_UNSIGNED_INDEX_V(p_surface_index, mesh->surface_count, 0);
+
+		const Mesh::Surface *s = mesh->surfaces[p_surface_index];
+
+		uint32_t lod = 0;
+		float lod_error = 0.0;
+		for (uint32_t i = 0; i < s->lod_count; i++) {
+			if (s->lods[i].edge_length <= p_max_error && s->lods[i].edge_length > lod_error) {
+				lod = i + 1;
+				lod_error = s->lods[i].edge_length;
+			}
+		}
+
+		return lod;
+	}
+
+	_FORCE_INLINE_ void mesh_surface_get_arrays_and_format(RID p_mesh, uint32_t p_surface_index, uint32_t p_input_mask, RID &r_vertex_array_rd, RID &r_index_array_rd, RD::VertexFormatID &r_vertex_format, uint32_t p_lod = 0) {
 		Mesh *mesh = mesh_owner.getornull(p_mesh);
 		ERR_FAIL_COND(!mesh);
 		ERR_FAIL_UNSIGNED_INDEX(p_surface_index, mesh->surface_count);
 
 		Mesh::Surface *s = mesh->surfaces[p_surface_index];
 
-		r_index_array_rd = s->index_array;
+		r_index_array_rd = (p_lod > 0 && p_lod <= s->lod_count) ? s->lods[p_lod - 1].index_array : s->index_array;
 
 		s->version_lock.lock();
 
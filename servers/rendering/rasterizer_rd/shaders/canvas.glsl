@@ -25,6 +25,13 @@ layout(location = 3) out vec2 pixel_size_interp;
 
 #endif
 
+#ifdef USE_BATCH
+
+layout(location = 4) flat out uint batch_index;
+#define draw_data batch_instances.data[batch_index]
+
+#endif
+
 #ifdef USE_MATERIAL_UNIFORMS
 layout(set = 1, binding = 1, std140) uniform MaterialUniforms{
 	/* clang-format off */
@@ -39,6 +46,9 @@ VERTEX_SHADER_GLOBALS
 
 void main() {
 	vec4 instance_custom = vec4(0.0);
+#ifdef USE_BATCH
+	batch_index = draw_batch.batch_offset + uint(gl_InstanceIndex);
+#endif
 #ifdef USE_PRIMITIVE
 
 	//weird bug,
@@ -223,6 +233,13 @@ layout(location = 3) in vec2 pixel_size_interp;
 
 #endif
 
+#ifdef USE_BATCH
+
+layout(location = 4) flat in uint batch_index;
+#define draw_data batch_instances.data[batch_index]
+
+#endif
+
 layout(location = 0) out vec4 frag_color;
 
 #ifdef USE_MATERIAL_UNIFORMS
@@ -45,13 +45,18 @@ layout(push_constant, binding = 0, std430) uniform DrawData {
 	vec4 ninepatch_margins;
 	vec4 dst_rect; //for built-in rect and UV
 	vec4 src_rect;
-	vec2 pad;
+	uint batch_offset; //first instance of a batch
+	uint pad;
 
 #endif
 	vec2 color_texture_pixel_size;
 	uint lights[4];
 }
+#ifdef USE_BATCH
+draw_batch;
+#else
 draw_data;
+#endif
 
 // The values passed per draw primitives are cached within it
 
@@ -137,6 +142,29 @@ layout(set = 2, binding = 7, std430) restrict readonly buffer GlobalVariableData
 }
 global_variables;
 
+//rects drawn in a batch, same layout as the rect draw data above
+
+struct BatchInstance {
+	vec2 world_x;
+	vec2 world_y;
+	vec2 world_ofs;
+	uint flags;
+	uint specular_shininess;
+	vec4 modulation;
+	vec4 ninepatch_margins;
+	vec4 dst_rect;
+	vec4 src_rect;
+	uint batch_offset;
+	uint pad;
+	vec2 color_texture_pixel_size;
+	uint lights[4];
+};
+
+layout(set = 2, binding = 8, std430) restrict readonly buffer BatchInstanceData {
+	BatchInstance data[];
+}
+batch_instances;
+
 /* SET3: Render Target Data */
 
 #ifdef SCREEN_TEXTURE_USED
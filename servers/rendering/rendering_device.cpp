@@ -30,6 +30,11 @@
 
 #include "rendering_device.h"
 #include "core/method_bind_ext.gen.inc"
+#include "core/os/dir_access.h"
+#include "core/os/file_access.h"
+#include "core/os/mutex.h"
+#include "core/version.h"
+#include "core/version_hash.gen.h"
 #include "rendering_device_binds.h"
 
 RenderingDevice *RenderingDevice::singleton = nullptr;
@@ -49,6 +54,66 @@ void RenderingDevice::shader_set_cache_function(ShaderCacheFunction p_function)
 	cache_function = p_function;
 }
 
+String RenderingDevice::shader_cache_dir;
+
+// Shaders are compiled from many threads at once; two of them may want to store the same entry.
+static Mutex shader_cache_save_mutex;
+
+#define SHADER_CACHE_MAGIC "GDSC"
+#define SHADER_CACHE_FORMAT_VERSION 1
+
+void RenderingDevice::shader_set_cache_dir(const String &p_dir) {
+	shader_cache_dir = String();
+	if (p_dir == String()) {
+		return;
+	}
+
+	DirAccessRef da = DirAccess::create_for_path(p_dir);
+	ERR_FAIL_COND(!da);
+	Error err = da->make_dir_recursive(p_dir);
+	ERR_FAIL_COND_MSG(err != OK && err != ERR_ALREADY_EXISTS, "Can't create shader cache directory: '" + p_dir + "'.");
+
+	shader_cache_dir = p_dir;
+}
+
+Vector<uint8_t> RenderingDevice::_shader_cache_load(const String &p_key) {
+	Vector<uint8_t> spir_v;
+
+	FileAccessRef f = FileAccess::open(shader_cache_dir.plus_file(p_key + ".spv"), FileAccess::READ);
+	if (!f) {
+		return spir_v;
+	}
+
+	uint8_t magic[4];
+	if (f->get_buffer(magic, 4) != 4 || memcmp(magic, SHADER_CACHE_MAGIC, 4) != 0 || f->get_32() != SHADER_CACHE_FORMAT_VERSION) {
+		return spir_v;
+	}
+
+	uint32_t size = f->get_32();
+	if (size == 0 || size % 4 != 0 || uint64_t(size) + 12 != f->get_len()) {
+		return spir_v; //truncated or corrupt, will be compiled and stored again
+	}
+
+	spir_v.resize(size);
+	if (f->get_buffer(spir_v.ptrw(), size) != int(size)) {
+		spir_v.clear();
+	}
+
+	return spir_v;
+}
+
+void RenderingDevice::_shader_cache_save(const String &p_key, const Vector<uint8_t> &p_spir_v) {
+	MutexLock lock(shader_cache_save_mutex);
+
+	FileAccessRef f = FileAccess::open(shader_cache_dir.plus_file(p_key + ".spv"), FileAccess::WRITE);
+	ERR_FAIL_COND_MSG(!f, "Can't write shader cache entry to '" + shader_cache_dir + "'.");
+
+	f->store_buffer((const uint8_t *)SHADER_CACHE_MAGIC, 4);
+	f->store_32(SHADER_CACHE_FORMAT_VERSION);
+	f->store_32(p_spir_v.size());
+	f->store_buffer(p_spir_v.ptr(), p_spir_v.size());
+}
+
 Vector<uint8_t> RenderingDevice::shader_compile_from_source(ShaderStage p_stage, const String &p_source_code, ShaderLanguage p_language, String *r_error, bool p_allow_cache) {
 	if (p_allow_cache && cache_function) {
 		Vector<uint8_t> cache = cache_function(p_stage, p_source_code, p_language);
@@ -57,9 +122,27 @@ Vector<uint8_t> RenderingDevice::shader_compile_from_source(ShaderStage p_stage,
 		}
 	}
 
+	String cache_key;
+	if (p_allow_cache && shader_cache_dir != String()) {
+		// The source already contains every define. The compiler ships with the engine, so the
+		// engine build identifies it; the SPIR-V does not depend on the GPU or driver.
+		cache_key = (String(VERSION_FULL_BUILD "." VERSION_HASH) + "\n" + itos(p_language) + "\n" + itos(p_stage) + "\n" + p_source_code).sha256_text();
+
+		Vector<uint8_t> cache = _shader_cache_load(cache_key);
+		if (cache.size()) {
+			return cache;
+		}
+	}
+
 	ERR_FAIL_COND_V(!compile_function, Vector<uint8_t>());
 
-	return compile_function(p_stage, p_source_code, p_language, r_error);
+	Vector<uint8_t> spir_v = compile_function(p_stage, p_source_code, p_language, r_error);
+
+	if (cache_key != String() && spir_v.size()) {
+		_shader_cache_save(cache_key, spir_v);
+	}
+
+	return spir_v;
 }
 
 RID RenderingDevice::_texture_create(const Ref<RDTextureFormat> &p_format, const Ref<RDTextureView> &p_view, const TypedArray<PackedByteArray> &p_data) {
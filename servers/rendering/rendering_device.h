@@ -77,6 +77,11 @@ private:
 	static ShaderCompileFunction compile_function;
 	static ShaderCacheFunction cache_function;
 
+	static String shader_cache_dir;
+
+	static Vector<uint8_t> _shader_cache_load(const String &p_key);
+	static void _shader_cache_save(const String &p_key, const Vector<uint8_t> &p_spir_v);
+
 	static RenderingDevice *singleton;
 
 protected:
@@ -588,6 +593,8 @@ public:
 
 	static void shader_set_compile_function(ShaderCompileFunction p_function);
 	static void shader_set_cache_function(ShaderCacheFunction p_function);
+	// Compiled SPIR-V is stored here, keyed by a hash of the full stage source. Empty disables it.
+	static void shader_set_cache_dir(const String &p_dir);
 
 	struct ShaderStageData {
 		ShaderStage shader_stage;
@@ -31,6 +31,7 @@
 #include "rendering_server_canvas.h"
 
 #include "core/math/geometry_2d.h"
+#include "core/project_settings.h"
 #include "rendering_server_globals.h"
 #include "rendering_server_raster.h"
 #include "rendering_server_viewport.h"
@@ -99,6 +100,367 @@ void _mark_ysort_dirty(RenderingServerCanvas::Item *ysort_owner, RID_PtrOwner<Re
 	} while (ysort_owner && ysort_owner->sort_y);
 }
 
+void RenderingServerCanvas::_canvas_item_bounds_changed(Item *p_item, bool p_content) {
+	if (!use_spatial_index) {
+		return;
+	}
+
+	//when only the transform, visibility or parent changed, the item's own bounds stay and just its part of the parent's is merged again
+	if (p_content) {
+		p_item->bounds_dirty = true;
+		p_item->bounds_rebuild = true;
+	}
+
+	//ancestors of a dirty item are always dirty, so stop at the first one that already is
+	Item *item = p_item;
+	while (true) {
+		Item *parent = canvas_item_owner.owns(item->parent) ? canvas_item_owner.getornull(item->parent) : nullptr;
+		if (!parent) {
+			break;
+		}
+
+		if (parent->child_grid && !item->grid_dirty) {
+			item->grid_dirty = true;
+			parent->child_grid->dirty.push_back(item);
+		}
+
+		if (!item->parent_bounds_queued) {
+			item->parent_bounds_queued = true;
+			parent->bounds_dirty_children.push_back(item);
+		}
+
+		if (parent->bounds_dirty) {
+			break;
+		}
+		parent->bounds_dirty = true;
+		item = parent;
+	}
+}
+
+static _FORCE_INLINE_ bool _bounds_touch_edge(const Rect2 &p_bounds, const Rect2 &p_rect) {
+	return p_rect.position.x <= p_bounds.position.x || p_rect.position.y <= p_bounds.position.y || p_rect.position.x + p_rect.size.x >= p_bounds.position.x + p_bounds.size.x || p_rect.position.y + p_rect.size.y >= p_bounds.position.y + p_bounds.size.y;
+}
+
+void RenderingServerCanvas::_canvas_item_bounds_detach(Item *p_parent, Item *p_child) {
+	if (p_child->parent_bounds_queued) {
+		p_parent->bounds_dirty_children.erase(p_child);
+		p_child->parent_bounds_queued = false;
+	}
+
+	//the parent's bounds only shrink if the child was on one of their edges
+	if (p_child->parent_bounds_state == Item::BOUNDS_INFINITE || (p_child->parent_bounds_state == Item::BOUNDS_RECT && _bounds_touch_edge(p_parent->bounds, p_child->parent_bounds))) {
+		_canvas_item_bounds_changed(p_parent);
+	}
+	p_child->parent_bounds_state = Item::BOUNDS_NONE;
+}
+
+static _FORCE_INLINE_ void _update_parent_bounds(RenderingServerCanvas::Item *p_child) {
+	if (!p_child->visible || (p_child->bounds_empty && !p_child->bounds_infinite)) {
+		p_child->parent_bounds_state = RenderingServerCanvas::Item::BOUNDS_NONE;
+	} else if (p_child->bounds_infinite) {
+		p_child->parent_bounds_state = RenderingServerCanvas::Item::BOUNDS_INFINITE;
+	} else {
+		p_child->parent_bounds_state = RenderingServerCanvas::Item::BOUNDS_RECT;
+		p_child->parent_bounds = p_child->xform.xform(p_child->bounds);
+	}
+}
+
+static _FORCE_INLINE_ void _merge_parent_bounds(RenderingServerCanvas::Item *p_item, const RenderingServerCanvas::Item *p_child) {
+	if (p_child->parent_bounds_state == RenderingServerCanvas::Item::BOUNDS_INFINITE) {
+		p_item->bounds_infinite = true;
+	} else if (p_child->parent_bounds_state == RenderingServerCanvas::Item::BOUNDS_RECT) {
+		if (p_item->bounds_empty) {
+			p_item->bounds = p_child->parent_bounds;
+			p_item->bounds_empty = false;
+		} else {
+			p_item->bounds = p_item->bounds.merge(p_child->parent_bounds);
+		}
+	}
+}
+
+void RenderingServerCanvas::_update_item_bounds(Item *p_item) {
+	p_item->bounds_dirty = false;
+
+	if (!p_item->bounds_rebuild) {
+		//grow to fit the children that changed, which is exact unless one of them shrank away from an edge
+		for (uint32_t i = 0; i < p_item->bounds_dirty_children.size(); i++) {
+			Item *child = p_item->bounds_dirty_children[i];
+			if (child->bounds_dirty) {
+				_update_item_bounds(child);
+			}
+
+			Item::BoundsState old_state = child->parent_bounds_state;
+			Rect2 old_bounds = child->parent_bounds;
+			_update_parent_bounds(child);
+
+			if (old_state == Item::BOUNDS_INFINITE && child->parent_bounds_state != Item::BOUNDS_INFINITE) {
+				p_item->bounds_rebuild = true;
+				break;
+			}
+			if (old_state == Item::BOUNDS_RECT && !(child->parent_bounds_state == Item::BOUNDS_RECT && child->parent_bounds.encloses(old_bounds)) && _bounds_touch_edge(p_item->bounds, old_bounds)) {
+				p_item->bounds_rebuild = true;
+				break;
+			}
+
+			child->parent_bounds_queued = false;
+			_merge_parent_bounds(p_item, child);
+		}
+
+		if (!p_item->bounds_rebuild) {
+			p_item->bounds_dirty_children.clear();
+			return;
+		}
+	}
+
+	for (uint32_t i = 0; i < p_item->bounds_dirty_children.size(); i++) {
+		p_item->bounds_dirty_children[i]->parent_bounds_queued = false;
+	}
+	p_item->bounds_dirty_children.clear();
+	p_item->bounds_rebuild = false;
+
+	p_item->bounds_empty = true;
+	p_item->bounds_infinite = p_item->copy_back_buffer || p_item->vp_render || p_item->update_when_visible || p_item->skeleton.is_valid();
+
+	if (p_item->commands) {
+		for (const Item::Command *c = p_item->commands; c; c = c->next) {
+			if (c->type == Item::Command::TYPE_MESH || c->type == Item::Command::TYPE_MULTIMESH || c->type == Item::Command::TYPE_PARTICLES) {
+				//their AABB can change without the item being told
+				p_item->bounds_infinite = true;
+				break;
+			}
+		}
+
+		p_item->bounds = p_item->get_rect();
+		p_item->bounds_empty = false;
+	}
+
+	int child_item_count = p_item->child_items.size();
+	Item **child_items = p_item->child_items.ptrw();
+
+	for (int i = 0; i < child_item_count; i++) {
+		Item *child = child_items[i];
+		if (child->bounds_dirty) {
+			_update_item_bounds(child); //must clean every child, even hidden ones
+		}
+
+		_update_parent_bounds(child);
+		_merge_parent_bounds(p_item, child);
+	}
+}
+
+static _FORCE_INLINE_ uint64_t _child_grid_key(int p_x, int p_y) {
+	return (uint64_t(uint32_t(p_x)) << 32) | uint64_t(uint32_t(p_y));
+}
+
+static void _child_grid_list_erase(LocalVector<RenderingServerCanvas::Item *> &p_list, RenderingServerCanvas::Item *p_item) {
+	int64_t idx = p_list.find(p_item);
+	if (idx >= 0) {
+		p_list[idx] = p_list[p_list.size() - 1];
+		p_list.resize(p_list.size() - 1);
+	}
+}
+
+static void _child_grid_unlink(RenderingServerCanvas::ChildGrid *p_grid, RenderingServerCanvas::Item *p_child) {
+	if (p_child->grid_state == RenderingServerCanvas::Item::GRID_CELLS) {
+		const Rect2i &cells = p_child->grid_cells;
+		for (int y = cells.position.y; y < cells.position.y + cells.size.y; y++) {
+			for (int x = cells.position.x; x < cells.position.x + cells.size.x; x++) {
+				uint64_t key = _child_grid_key(x, y);
+				LocalVector<RenderingServerCanvas::Item *> *cell = p_grid->cells.getptr(key);
+				if (cell) {
+					_child_grid_list_erase(*cell, p_child);
+					if (cell->empty()) {
+						p_grid->cells.erase(key);
+					}
+				}
+			}
+		}
+	} else if (p_child->grid_state == RenderingServerCanvas::Item::GRID_UNBOUNDED) {
+		_child_grid_list_erase(p_grid->unbounded, p_child);
+	}
+
+	p_child->grid_state = RenderingServerCanvas::Item::GRID_NONE;
+}
+
+void RenderingServerCanvas::_child_grid_place(ChildGrid *p_grid, Item *p_child) {
+	if (p_child->bounds_dirty) {
+		_update_item_bounds(p_child);
+	}
+
+	Item::GridState state = Item::GRID_NONE; //empty subtrees draw nothing and are left out
+	Rect2i cells;
+
+	if (p_child->bounds_infinite) {
+		state = Item::GRID_UNBOUNDED;
+	} else if (!p_child->bounds_empty) {
+		Rect2 r = p_child->xform.xform(p_child->bounds);
+		real_t inv_cell_size = 1.0 / p_grid->cell_size;
+		real_t x0 = Math::floor(r.position.x * inv_cell_size);
+		real_t y0 = Math::floor(r.position.y * inv_cell_size);
+		real_t x1 = Math::floor((r.position.x + r.size.x) * inv_cell_size);
+		real_t y1 = Math::floor((r.position.y + r.size.y) * inv_cell_size);
+
+		const real_t max_coord = 1 << 30;
+		if (MAX(MAX(ABS(x0), ABS(y0)), MAX(ABS(x1), ABS(y1))) > max_coord || (x1 - x0 + 1) * (y1 - y0 + 1) > CHILD_GRID_MAX_CELLS_PER_CHILD) {
+			state = Item::GRID_UNBOUNDED;
+		} else {
+			state = Item::GRID_CELLS;
+			cells = Rect2i(x0, y0, x1 - x0 + 1, y1 - y0 + 1);
+		}
+	}
+
+	if (state == p_child->grid_state && (state != Item::GRID_CELLS || cells == p_child->grid_cells)) {
+		return;
+	}
+
+	_child_grid_unlink(p_grid, p_child);
+
+	if (state == Item::GRID_CELLS) {
+		for (int y = cells.position.y; y < cells.position.y + cells.size.y; y++) {
+			for (int x = cells.position.x; x < cells.position.x + cells.size.x; x++) {
+				p_grid->cells[_child_grid_key(x, y)].push_back(p_child);
+			}
+		}
+	} else if (state == Item::GRID_UNBOUNDED) {
+		p_grid->unbounded.push_back(p_child);
+	}
+
+	p_child->grid_state = state;
+	p_child->grid_cells = cells;
+}
+
+void RenderingServerCanvas::_child_grid_remove(Item *p_parent, Item *p_child) {
+	ChildGrid *grid = p_parent->child_grid;
+	if (!grid) {
+		return;
+	}
+
+	_child_grid_unlink(grid, p_child);
+	if (p_child->grid_dirty) {
+		_child_grid_list_erase(grid->dirty, p_child);
+		p_child->grid_dirty = false;
+	}
+	p_child->grid_pass = 0;
+}
+
+void RenderingServerCanvas::_child_grid_build(Item *p_item) {
+	int child_item_count = p_item->child_items.size();
+	Item **child_items = p_item->child_items.ptrw();
+
+	//aim for cells about twice the size of a typical child, and not many more cells than children
+	real_t size_sum = 0.0;
+	int sized_count = 0;
+	Rect2 total;
+	for (int i = 0; i < child_item_count; i++) {
+		Item *child = child_items[i];
+		if (child->bounds_dirty) {
+			_update_item_bounds(child);
+		}
+		if (child->bounds_infinite || child->bounds_empty) {
+			continue;
+		}
+
+		Rect2 r = child->xform.xform(child->bounds);
+		size_sum += MAX(r.size.x, r.size.y);
+		total = sized_count == 0 ? r : total.merge(r);
+		sized_count++;
+	}
+
+	ChildGrid *grid = memnew(ChildGrid);
+	if (sized_count) {
+		grid->cell_size = MAX(size_sum / sized_count * 2.0, Math::sqrt(total.get_area() / sized_count));
+	}
+	grid->cell_size = MAX(grid->cell_size, (real_t)1.0);
+	p_item->child_grid = grid;
+
+	for (int i = 0; i < child_item_count; i++) {
+		Item *child = child_items[i];
+		child->grid_state = Item::GRID_NONE;
+		child->grid_dirty = false;
+		child->grid_pass = 0;
+		child->child_order = i;
+		_child_grid_place(grid, child);
+	}
+}
+
+void RenderingServerCanvas::_child_grid_clear(Item *p_item) {
+	int child_item_count = p_item->child_items.size();
+	Item **child_items = p_item->child_items.ptrw();
+	for (int i = 0; i < child_item_count; i++) {
+		child_items[i]->grid_state = Item::GRID_NONE;
+		child_items[i]->grid_dirty = false;
+		child_items[i]->grid_pass = 0;
+	}
+
+	memdelete(p_item->child_grid);
+	p_item->child_grid = nullptr;
+}
+
+struct _ChildGridOrderSort {
+	_FORCE_INLINE_ bool operator()(const RenderingServerCanvas::Item *p_left, const RenderingServerCanvas::Item *p_right) const {
+		return p_left->child_order < p_right->child_order;
+	}
+};
+
+bool RenderingServerCanvas::_child_grid_cull(Item *p_item, const Transform2D &p_xform, const Rect2 &p_clip_rect) {
+	ChildGrid *grid = p_item->child_grid;
+
+	for (uint32_t i = 0; i < grid->dirty.size(); i++) {
+		grid->dirty[i]->grid_dirty = false;
+		_child_grid_place(grid, grid->dirty[i]);
+	}
+	grid->dirty.clear();
+
+	int child_item_count = p_item->child_items.size();
+	if (grid->unbounded.size() * 2 > (uint32_t)child_item_count || p_xform.basis_determinant() == 0) {
+		return false; //the grid would not help, visit every child
+	}
+
+	//screen rect in the item's local space
+	Rect2 local = p_xform.affine_inverse().xform(Rect2(Point2(), p_clip_rect.size));
+	real_t inv_cell_size = 1.0 / grid->cell_size;
+	real_t x0 = Math::floor(local.position.x * inv_cell_size);
+	real_t y0 = Math::floor(local.position.y * inv_cell_size);
+	real_t x1 = Math::floor((local.position.x + local.size.x) * inv_cell_size);
+	real_t y1 = Math::floor((local.position.y + local.size.y) * inv_cell_size);
+
+	if ((x1 - x0 + 1) * (y1 - y0 + 1) > child_item_count) {
+		return false; //zoomed far out, looping over the children is cheaper
+	}
+
+	grid->pass++;
+	if (grid->pass == 0) {
+		grid->pass = 1;
+	}
+	grid->visible.clear();
+
+	for (int y = y0; y <= y1; y++) {
+		for (int x = x0; x <= x1; x++) {
+			LocalVector<Item *> *cell = grid->cells.getptr(_child_grid_key(x, y));
+			if (!cell) {
+				continue;
+			}
+			for (uint32_t i = 0; i < cell->size(); i++) {
+				Item *child = (*cell)[i];
+				if (child->grid_pass != grid->pass) {
+					child->grid_pass = grid->pass;
+					grid->visible.push_back(child);
+				}
+			}
+		}
+	}
+
+	for (uint32_t i = 0; i < grid->unbounded.size(); i++) {
+		grid->visible.push_back(grid->unbounded[i]);
+	}
+
+	//keep the draw order
+	SortArray<Item *, _ChildGridOrderSort> sorter;
+	sorter.sort(grid->visible.ptr(), grid->visible.size());
+
+	return true;
+}
+
 void RenderingServerCanvas::_cull_canvas_item(Item *p_canvas_item, const Transform2D &p_transform, const Rect2 &p_clip_rect, const Color &p_modulate, int p_z, RasterizerCanvas::Item **z_list, RasterizerCanvas::Item **z_last_list, Item *p_canvas_clip, Item *p_material_owner) {
 	Item *ci = p_canvas_item;
 
@@ -109,10 +471,25 @@ void RenderingServerCanvas::_cull_canvas_item(Item *p_canvas_item, const Transfo
 	if (ci->children_order_dirty) {
 		ci->child_items.sort_custom<ItemIndexSort>();
 		ci->children_order_dirty = false;
+
+		for (int i = 0; i < ci->child_items.size(); i++) {
+			ci->child_items[i]->child_order = i;
+		}
 	}
 
 	Rect2 rect = ci->get_rect();
 	Transform2D xform = p_transform * ci->xform;
+
+	if (use_spatial_index) {
+		if (ci->bounds_dirty) {
+			_update_item_bounds(ci);
+		}
+
+		//clip rect position is an offset applied to every item, see below
+		if (!ci->bounds_infinite && (ci->bounds_empty || !Rect2(Point2(), p_clip_rect.size).intersects(xform.xform(ci->bounds), true))) {
+			return; //nothing in this subtree reaches the screen
+		}
+	}
 	Rect2 global_rect = xform.xform(rect);
 	global_rect.position += p_clip_rect.position;
 
@@ -158,6 +535,21 @@ void RenderingServerCanvas::_cull_canvas_item(Item *p_canvas_item, const Transfo
 
 		SortArray<Item *, ItemPtrSort> sorter;
 		sorter.sort(child_items, child_item_count);
+
+		if (ci->child_grid) {
+			_child_grid_clear(ci);
+		}
+	} else if (use_spatial_index) {
+		if (!ci->child_grid && child_item_count >= CHILD_GRID_MIN_CHILDREN) {
+			_child_grid_build(ci);
+		} else if (ci->child_grid && child_item_count < CHILD_GRID_MIN_CHILDREN / 2) {
+			_child_grid_clear(ci);
+		}
+
+		if (ci->child_grid && _child_grid_cull(ci, xform, p_clip_rect)) {
+			child_items = ci->child_grid->visible.ptr();
+			child_item_count = ci->child_grid->visible.size();
+		}
 	}
 
 	if (ci->z_relative) {
@@ -345,6 +737,9 @@ void RenderingServerCanvas::canvas_item_set_parent(RID p_item, RID p_parent) {
 			Item *item_owner = canvas_item_owner.getornull(canvas_item->parent);
 			item_owner->child_items.erase(canvas_item);
 
+			_child_grid_remove(item_owner, canvas_item);
+			_canvas_item_bounds_detach(item_owner, canvas_item);
+
 			if (item_owner->sort_y) {
 				_mark_ysort_dirty(item_owner, canvas_item_owner);
 			}
@@ -375,11 +770,13 @@ void RenderingServerCanvas::canvas_item_set_parent(RID p_item, RID p_parent) {
 	}
 
 	canvas_item->parent = p_parent;
+	_canvas_item_bounds_changed(canvas_item, false);
 }
 
 void RenderingServerCanvas::canvas_item_set_visible(RID p_item, bool p_visible) {
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
+	_canvas_item_bounds_changed(canvas_item, false);
 
 	canvas_item->visible = p_visible;
 
@@ -396,6 +793,7 @@ void RenderingServerCanvas::canvas_item_set_light_mask(RID p_item, int p_mask) {
 void RenderingServerCanvas::canvas_item_set_transform(RID p_item, const Transform2D &p_transform) {
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
+	_canvas_item_bounds_changed(canvas_item, false);
 
 	canvas_item->xform = p_transform;
 }
@@ -417,6 +815,7 @@ void RenderingServerCanvas::canvas_item_set_distance_field_mode(RID p_item, bool
 void RenderingServerCanvas::canvas_item_set_custom_rect(RID p_item, bool p_custom_rect, const Rect2 &p_rect) {
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
+	_canvas_item_bounds_changed(canvas_item);
 
 	canvas_item->custom_rect = p_custom_rect;
 	canvas_item->rect = p_rect;
@@ -446,6 +845,7 @@ void RenderingServerCanvas::canvas_item_set_draw_behind_parent(RID p_item, bool
 void RenderingServerCanvas::canvas_item_set_update_when_visible(RID p_item, bool p_update) {
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
+	_canvas_item_bounds_changed(canvas_item);
 
 	canvas_item->update_when_visible = p_update;
 }
@@ -465,6 +865,7 @@ void RenderingServerCanvas::canvas_item_set_default_texture_repeat(RID p_item, R
 void RenderingServerCanvas::canvas_item_add_line(RID p_item, const Point2 &p_from, const Point2 &p_to, const Color &p_color, float p_width) {
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
+	_canvas_item_bounds_changed(canvas_item);
 
 	Item::CommandPrimitive *line = canvas_item->alloc_command<Item::CommandPrimitive>();
 	ERR_FAIL_COND(!line);
@@ -490,6 +891,7 @@ void RenderingServerCanvas::canvas_item_add_polyline(RID p_item, const Vector<Po
 	ERR_FAIL_COND(p_points.size() < 2);
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
+	_canvas_item_bounds_changed(canvas_item);
 
 	Item::CommandPolygon *pline = canvas_item->alloc_command<Item::CommandPolygon>();
 	ERR_FAIL_COND(!pline);
@@ -581,6 +983,7 @@ void RenderingServerCanvas::canvas_item_add_multiline(RID p_item, const Vector<P
 	ERR_FAIL_COND(p_points.size() < 2);
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
+	_canvas_item_bounds_changed(canvas_item);
 
 	Item::CommandPolygon *pline = canvas_item->alloc_command<Item::CommandPolygon>();
 	ERR_FAIL_COND(!pline);
@@ -600,6 +1003,7 @@ void RenderingServerCanvas::canvas_item_add_multiline(RID p_item, const Vector<P
 void RenderingServerCanvas::canvas_item_add_rect(RID p_item, const Rect2 &p_rect, const Color &p_color) {
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
+	_canvas_item_bounds_changed(canvas_item);
 
 	Item::CommandRect *rect = canvas_item->alloc_command<Item::CommandRect>();
 	ERR_FAIL_COND(!rect);
@@ -610,6 +1014,7 @@ void RenderingServerCanvas::canvas_item_add_rect(RID p_item, const Rect2 &p_rect
 void RenderingServerCanvas::canvas_item_add_circle(RID p_item, const Point2 &p_pos, float p_radius, const Color &p_color) {
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
+	_canvas_item_bounds_changed(canvas_item);
 
 	Item::CommandPolygon *circle = canvas_item->alloc_command<Item::CommandPolygon>();
 	ERR_FAIL_COND(!circle);
@@ -647,6 +1052,7 @@ void RenderingServerCanvas::canvas_item_add_circle(RID p_item, const Point2 &p_p
 void RenderingServerCanvas::canvas_item_add_texture_rect(RID p_item, const Rect2 &p_rect, RID p_texture, bool p_tile, const Color &p_modulate, bool p_transpose, RID p_normal_map, RID p_specular_map, const Color &p_specular_color_shininess, RenderingServer::CanvasItemTextureFilter p_filter, RenderingServer::CanvasItemTextureRepeat p_repeat) {
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
+	_canvas_item_bounds_changed(canvas_item);
 
 	Item::CommandRect *rect = canvas_item->alloc_command<Item::CommandRect>();
 	ERR_FAIL_COND(!rect);
@@ -678,6 +1084,7 @@ void RenderingServerCanvas::canvas_item_add_texture_rect(RID p_item, const Rect2
 void RenderingServerCanvas::canvas_item_add_texture_rect_region(RID p_item, const Rect2 &p_rect, RID p_texture, const Rect2 &p_src_rect, const Color &p_modulate, bool p_transpose, RID p_normal_map, RID p_specular_map, const Color &p_specular_color_shininess, bool p_clip_uv, RenderingServer::CanvasItemTextureFilter p_filter, RenderingServer::CanvasItemTextureRepeat p_repeat) {
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
+	_canvas_item_bounds_changed(canvas_item);
 
 	Item::CommandRect *rect = canvas_item->alloc_command<Item::CommandRect>();
 	ERR_FAIL_COND(!rect);
@@ -718,6 +1125,7 @@ void RenderingServerCanvas::canvas_item_add_texture_rect_region(RID p_item, cons
 void RenderingServerCanvas::canvas_item_add_nine_patch(RID p_item, const Rect2 &p_rect, const Rect2 &p_source, RID p_texture, const Vector2 &p_topleft, const Vector2 &p_bottomright, RS::NinePatchAxisMode p_x_axis_mode, RS::NinePatchAxisMode p_y_axis_mode, bool p_draw_center, const Color &p_modulate, RID p_normal_map, RID p_specular_map, const Color &p_specular_color_shininess, RenderingServer::CanvasItemTextureFilter p_filter, RenderingServer::CanvasItemTextureRepeat p_repeat) {
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
+	_canvas_item_bounds_changed(canvas_item);
 
 	Item::CommandNinePatch *style = canvas_item->alloc_command<Item::CommandNinePatch>();
 	ERR_FAIL_COND(!style);
@@ -741,6 +1149,7 @@ void RenderingServerCanvas::canvas_item_add_primitive(RID p_item, const Vector<P
 
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
+	_canvas_item_bounds_changed(canvas_item);
 
 	Item::CommandPrimitive *prim = canvas_item->alloc_command<Item::CommandPrimitive>();
 	ERR_FAIL_COND(!prim);
@@ -768,6 +1177,7 @@ void RenderingServerCanvas::canvas_item_add_primitive(RID p_item, const Vector<P
 void RenderingServerCanvas::canvas_item_add_polygon(RID p_item, const Vector<Point2> &p_points, const Vector<Color> &p_colors, const Vector<Point2> &p_uvs, RID p_texture, RID p_normal_map, RID p_specular_map, const Color &p_specular_color_shininess, RenderingServer::CanvasItemTextureFilter p_filter, RenderingServer::CanvasItemTextureRepeat p_repeat) {
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
+	_canvas_item_bounds_changed(canvas_item);
 #ifdef DEBUG_ENABLED
 	int pointcount = p_points.size();
 	ERR_FAIL_COND(pointcount < 3);
@@ -790,6 +1200,7 @@ void RenderingServerCanvas::canvas_item_add_polygon(RID p_item, const Vector<Poi
 void RenderingServerCanvas::canvas_item_add_triangle_array(RID p_item, const Vector<int> &p_indices, const Vector<Point2> &p_points, const Vector<Color> &p_colors, const Vector<Point2> &p_uvs, const Vector<int> &p_bones, const Vector<float> &p_weights, RID p_texture, int p_count, RID p_normal_map, RID p_specular_map, const Color &p_specular_color_shininess, RenderingServer::CanvasItemTextureFilter p_filter, RenderingServer::CanvasItemTextureRepeat p_repeat) {
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
+	_canvas_item_bounds_changed(canvas_item);
 
 	int vertex_count = p_points.size();
 	ERR_FAIL_COND(vertex_count == 0);
@@ -812,6 +1223,7 @@ void RenderingServerCanvas::canvas_item_add_triangle_array(RID p_item, const Vec
 void RenderingServerCanvas::canvas_item_add_set_transform(RID p_item, const Transform2D &p_transform) {
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
+	_canvas_item_bounds_changed(canvas_item);
 
 	Item::CommandTransform *tr = canvas_item->alloc_command<Item::CommandTransform>();
 	ERR_FAIL_COND(!tr);
@@ -821,6 +1233,7 @@ void RenderingServerCanvas::canvas_item_add_set_transform(RID p_item, const Tran
 void RenderingServerCanvas::canvas_item_add_mesh(RID p_item, const RID &p_mesh, const Transform2D &p_transform, const Color &p_modulate, RID p_texture, RID p_normal_map, RID p_specular_map, const Color &p_specular_color_shininess, RenderingServer::CanvasItemTextureFilter p_filter, RenderingServer::CanvasItemTextureRepeat p_repeat) {
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
+	_canvas_item_bounds_changed(canvas_item);
 
 	Item::CommandMesh *m = canvas_item->alloc_command<Item::CommandMesh>();
 	ERR_FAIL_COND(!m);
@@ -834,6 +1247,7 @@ void RenderingServerCanvas::canvas_item_add_mesh(RID p_item, const RID &p_mesh,
 void RenderingServerCanvas::canvas_item_add_particles(RID p_item, RID p_particles, RID p_texture, RID p_normal_map, RID p_specular_map, const Color &p_specular_color_shininess, RenderingServer::CanvasItemTextureFilter p_filter, RenderingServer::CanvasItemTextureRepeat p_repeat) {
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
+	_canvas_item_bounds_changed(canvas_item);
 
 	Item::CommandParticles *part = canvas_item->alloc_command<Item::CommandParticles>();
 	ERR_FAIL_COND(!part);
@@ -848,6 +1262,7 @@ void RenderingServerCanvas::canvas_item_add_particles(RID p_item, RID p_particle
 void RenderingServerCanvas::canvas_item_add_multimesh(RID p_item, RID p_mesh, RID p_texture, RID p_normal_map, RID p_specular_map, const Color &p_specular_color_shininess, RenderingServer::CanvasItemTextureFilter p_filter, RenderingServer::CanvasItemTextureRepeat p_repeat) {
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
+	_canvas_item_bounds_changed(canvas_item);
 
 	Item::CommandMultiMesh *mm = canvas_item->alloc_command<Item::CommandMultiMesh>();
 	ERR_FAIL_COND(!mm);
@@ -859,6 +1274,7 @@ void RenderingServerCanvas::canvas_item_add_multimesh(RID p_item, RID p_mesh, RI
 void RenderingServerCanvas::canvas_item_add_clip_ignore(RID p_item, bool p_ignore) {
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
+	_canvas_item_bounds_changed(canvas_item);
 
 	Item::CommandClipIgnore *ci = canvas_item->alloc_command<Item::CommandClipIgnore>();
 	ERR_FAIL_COND(!ci);
@@ -893,6 +1309,7 @@ void RenderingServerCanvas::canvas_item_set_z_as_relative_to_parent(RID p_item,
 void RenderingServerCanvas::canvas_item_attach_skeleton(RID p_item, RID p_skeleton) {
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
+	_canvas_item_bounds_changed(canvas_item);
 
 	canvas_item->skeleton = p_skeleton;
 }
@@ -900,6 +1317,7 @@ void RenderingServerCanvas::canvas_item_attach_skeleton(RID p_item, RID p_skelet
 void RenderingServerCanvas::canvas_item_set_copy_to_backbuffer(RID p_item, bool p_enable, const Rect2 &p_rect) {
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
+	_canvas_item_bounds_changed(canvas_item);
 	if (bool(canvas_item->copy_back_buffer != nullptr) != p_enable) {
 		if (p_enable) {
 			canvas_item->copy_back_buffer = memnew(RasterizerCanvas::Item::CopyBackBuffer);
@@ -918,6 +1336,7 @@ void RenderingServerCanvas::canvas_item_set_copy_to_backbuffer(RID p_item, bool
 void RenderingServerCanvas::canvas_item_clear(RID p_item) {
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
+	_canvas_item_bounds_changed(canvas_item);
 
 	canvas_item->clear();
 }
@@ -1315,14 +1734,23 @@ bool RenderingServerCanvas::free(RID p_rid) {
 				Item *item_owner = canvas_item_owner.getornull(canvas_item->parent);
 				item_owner->child_items.erase(canvas_item);
 
+				_child_grid_remove(item_owner, canvas_item);
+				_canvas_item_bounds_detach(item_owner, canvas_item);
+
 				if (item_owner->sort_y) {
 					_mark_ysort_dirty(item_owner, canvas_item_owner);
 				}
 			}
 		}
 
+		if (canvas_item->child_grid) {
+			_child_grid_clear(canvas_item);
+		}
+
 		for (int i = 0; i < canvas_item->child_items.size(); i++) {
 			canvas_item->child_items[i]->parent = RID();
+			canvas_item->child_items[i]->parent_bounds_state = Item::BOUNDS_NONE;
+			canvas_item->child_items[i]->parent_bounds_queued = false;
 		}
 
 		/*
@@ -1394,6 +1822,7 @@ RenderingServerCanvas::RenderingServerCanvas() {
 	z_last_list = (RasterizerCanvas::Item **)memalloc(z_range * sizeof(RasterizerCanvas::Item *));
 
 	disable_scale = false;
+	use_spatial_index = GLOBAL_DEF("rendering/quality/2d/use_spatial_index", true);
 }
 
 RenderingServerCanvas::~RenderingServerCanvas() {
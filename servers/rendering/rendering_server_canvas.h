@@ -31,11 +31,31 @@
 #ifndef VISUALSERVERCANVAS_H
 #define VISUALSERVERCANVAS_H
 
+#include "core/hash_map.h"
+#include "core/local_vector.h"
 #include "rasterizer.h"
 #include "rendering_server_viewport.h"
 
 class RenderingServerCanvas {
 public:
+	enum {
+		CHILD_GRID_MIN_CHILDREN = 256, // items with fewer children just loop over them
+		CHILD_GRID_MAX_CELLS_PER_CHILD = 16,
+	};
+
+	struct Item;
+
+	// Children of an item with many children are binned in a uniform grid, in the parent's
+	// local space, so culling only looks at the cells that overlap the screen.
+	struct ChildGrid {
+		real_t cell_size = 1.0;
+		HashMap<uint64_t, LocalVector<Item *>> cells;
+		LocalVector<Item *> unbounded; // too large for the grid, always visited
+		LocalVector<Item *> dirty; // moved or changed since the last cull
+		LocalVector<Item *> visible;
+		uint32_t pass = 0;
+	};
+
 	struct Item : public RasterizerCanvas::Item {
 		RID parent; // canvas it belongs to
 		List<Item *>::Element *E;
@@ -56,6 +76,40 @@ public:
 
 		Vector<Item *> child_items;
 
+		// Bounds of this item and its visible descendants, in local space. Infinite when
+		// something below can't be bounded (back buffer copies, meshes, particles, skeletons, items
+		// that update when visible), in which case the subtree is always visited.
+		Rect2 bounds;
+		bool bounds_dirty;
+		bool bounds_empty;
+		bool bounds_infinite;
+		bool bounds_rebuild; // own content changed or a child shrank away from an edge, merge every child again
+		LocalVector<Item *> bounds_dirty_children; // only these are merged again otherwise
+
+		enum BoundsState {
+			BOUNDS_NONE,
+			BOUNDS_RECT,
+			BOUNDS_INFINITE,
+		};
+
+		// What this item added to its parent's bounds the last time they were updated.
+		BoundsState parent_bounds_state;
+		Rect2 parent_bounds;
+		bool parent_bounds_queued; // in the parent's bounds_dirty_children
+
+		enum GridState {
+			GRID_NONE,
+			GRID_CELLS,
+			GRID_UNBOUNDED,
+		};
+
+		ChildGrid *child_grid;
+		GridState grid_state; // placement in the parent's grid
+		Rect2i grid_cells;
+		bool grid_dirty;
+		uint32_t grid_pass;
+		uint32_t child_order; // position in the parent's sorted child list
+
 		Item() {
 			children_order_dirty = true;
 			E = nullptr;
@@ -71,6 +125,23 @@ public:
 			ysort_pos = Vector2();
 			texture_filter = RS::CANVAS_ITEM_TEXTURE_FILTER_DEFAULT;
 			texture_repeat = RS::CANVAS_ITEM_TEXTURE_REPEAT_DEFAULT;
+			bounds_dirty = true;
+			bounds_empty = true;
+			bounds_infinite = false;
+			bounds_rebuild = true;
+			parent_bounds_state = BOUNDS_NONE;
+			parent_bounds_queued = false;
+			child_grid = nullptr;
+			grid_state = GRID_NONE;
+			grid_dirty = false;
+			grid_pass = 0;
+			child_order = 0;
+		}
+
+		~Item() {
+			if (child_grid) {
+				memdelete(child_grid);
+			}
 		}
 	};
 
@@ -154,8 +225,20 @@ public:
 	RID_PtrOwner<RasterizerCanvas::Light> canvas_light_owner;
 
 	bool disable_scale;
+	bool use_spatial_index;
+
+	// Called lazily when culling, public so the index can be checked without a rasterizer.
+	void _update_item_bounds(Item *p_item);
+	void _child_grid_build(Item *p_item);
+	bool _child_grid_cull(Item *p_item, const Transform2D &p_xform, const Rect2 &p_clip_rect);
 
 private:
+	void _canvas_item_bounds_changed(Item *p_item, bool p_content = true);
+	void _canvas_item_bounds_detach(Item *p_parent, Item *p_child);
+	void _child_grid_place(ChildGrid *p_grid, Item *p_child);
+	void _child_grid_remove(Item *p_parent, Item *p_child);
+	void _child_grid_clear(Item *p_item);
+
 	void _render_canvas_item_tree(RID p_to_render_target, Canvas::ChildItem *p_child_items, int p_child_item_count, Item *p_canvas_item, const Transform2D &p_transform, const Rect2 &p_clip_rect, const Color &p_modulate, RasterizerCanvas::Light *p_lights);
 	void _cull_canvas_item(Item *p_canvas_item, const Transform2D &p_transform, const Rect2 &p_clip_rect, const Color &p_modulate, int p_z, RasterizerCanvas::Item **z_list, RasterizerCanvas::Item **z_last_list, Item *p_canvas_clip, Item *p_material_owner);
 	void _light_mask_canvas_items(int p_z, RasterizerCanvas::Item *p_canvas_item, RasterizerCanvas::Light *p_masked_lights);
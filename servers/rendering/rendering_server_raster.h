@@ -197,6 +197,9 @@ public:
 
 	BIND2(texture_set_force_redraw_if_visible, RID, bool)
 
+	BIND2(texture_set_streaming_feedback, RID, bool)
+	BIND1R(Vector<int>, texture_get_streaming_demand, const Vector<RID> &)
+
 	/* SHADER API */
 
 	BIND0R(RID, shader_create)
@@ -467,6 +470,11 @@ public:
 	BIND2(camera_set_camera_effects, RID, RID)
 	BIND2(camera_set_use_vertical_aspect, RID, bool)
 
+	/* OCCLUDER API */
+
+	BIND0R(RID, occluder_create)
+	BIND3(occluder_set_mesh, RID, const PackedVector3Array &, const PackedInt32Array &)
+
 #undef BINDBASE
 //from now on, calls forwarded to this singleton
 #define BINDBASE RSG::viewport
@@ -612,6 +620,7 @@ public:
 	BIND2(instance_set_scenario, RID, RID)
 	BIND2(instance_set_layer_mask, RID, uint32_t)
 	BIND2(instance_set_transform, RID, const Transform &)
+	BIND2(instances_set_transforms, const Vector<RID> &, const Vector<Transform> &)
 	BIND2(instance_attach_object_instance_id, RID, ObjectID)
 	BIND3(instance_set_blend_shape_weight, RID, int, float)
 	BIND3(instance_set_surface_material, RID, int, RID)
@@ -635,6 +644,7 @@ public:
 
 	BIND5(instance_geometry_set_draw_range, RID, float, float, float, float)
 	BIND2(instance_geometry_set_as_instance_lod, RID, RID)
+	BIND2(instance_set_visibility_parent, RID, RID)
 	BIND4(instance_geometry_set_lightmap, RID, RID, const Rect2 &, int)
 
 	BIND3(instance_geometry_set_shader_parameter, RID, const StringName &, const Variant &)
@@ -31,6 +31,7 @@
 #include "rendering_server_scene.h"
 
 #include "core/os/os.h"
+#include "core/project_settings.h"
 #include "rendering_server_globals.h"
 #include "rendering_server_raster.h"
 
@@ -102,6 +103,46 @@ void RenderingServerScene::camera_set_use_vertical_aspect(RID p_camera, bool p_e
 	camera->vaspect = p_enable;
 }
 
+/* OCCLUDER API */
+
+RID RenderingServerScene::occluder_create() {
+	Occluder *occluder = memnew(Occluder);
+	return occluder_owner.make_rid(occluder);
+}
+
+void RenderingServerScene::occluder_set_mesh(RID p_occluder, const PackedVector3Array &p_vertices, const PackedInt32Array &p_indices) {
+	Occluder *occluder = occluder_owner.getornull(p_occluder);
+	ERR_FAIL_COND(!occluder);
+	ERR_FAIL_COND_MSG(p_indices.size() % 3 != 0, "Occluder indices must describe triangles.");
+
+	int vertex_count = p_vertices.size();
+	const int32_t *indices = p_indices.ptr();
+	for (int i = 0; i < p_indices.size(); i++) {
+		ERR_FAIL_INDEX_MSG(indices[i], vertex_count, "Occluder index is out of range.");
+	}
+
+	occluder->vertices.resize(vertex_count);
+	occluder->aabb = AABB();
+	const Vector3 *vertices = p_vertices.ptr();
+	for (int i = 0; i < vertex_count; i++) {
+		occluder->vertices[i] = vertices[i];
+		if (i == 0) {
+			occluder->aabb.position = vertices[i];
+		} else {
+			occluder->aabb.expand_to(vertices[i]);
+		}
+	}
+
+	occluder->indices.resize(p_indices.size());
+	for (int i = 0; i < p_indices.size(); i++) {
+		occluder->indices[i] = indices[i];
+	}
+
+	for (Set<Instance *>::Element *E = occluder->users.front(); E; E = E->next()) {
+		_instance_queue_update(E->get(), true, false);
+	}
+}
+
 /* SCENARIO API */
 
 void *RenderingServerScene::_instance_pair(void *p_self, OctreeElementID, Instance *p_A, int, OctreeElementID, Instance *p_B, int) {
@@ -126,6 +167,7 @@ void *RenderingServerScene::_instance_pair(void *p_self, OctreeElementID, Instan
 
 		if (geom->can_cast_shadows) {
 			light->shadow_dirty = true;
+			light->shadow_casters_dirty = true;
 		}
 		geom->lighting_dirty = true;
 
@@ -219,6 +261,7 @@ void RenderingServerScene::_instance_unpair(void *p_self, OctreeElementID, Insta
 
 		if (geom->can_cast_shadows) {
 			light->shadow_dirty = true;
+			light->shadow_casters_dirty = true;
 		}
 		geom->lighting_dirty = true;
 
@@ -364,6 +407,7 @@ void RenderingServerScene::instance_set_base(RID p_instance, RID p_base) {
 		if (scenario && instance->octree_id) {
 			scenario->octree.erase(instance->octree_id); //make dependencies generated by the octree go away
 			instance->octree_id = 0;
+			_scenario_cull_remove(instance);
 		}
 
 		switch (instance->base_type) {
@@ -404,6 +448,17 @@ void RenderingServerScene::instance_set_base(RID p_instance, RID p_base) {
 					instance_geometry_set_lightmap(lightmap_data->users.front()->get()->self, RID(), Rect2(), 0);
 				}
 			} break;
+			case RS::INSTANCE_OCCLUDER: {
+				InstanceOccluderData *occluder_data = static_cast<InstanceOccluderData *>(instance->base_data);
+				if (scenario && occluder_data->E) {
+					scenario->occluders.erase(occluder_data->E);
+					occluder_data->E = nullptr;
+				}
+				Occluder *occluder = occluder_owner.getornull(instance->base);
+				if (occluder) {
+					occluder->users.erase(instance);
+				}
+			} break;
 			case RS::INSTANCE_GI_PROBE: {
 				InstanceGIProbeData *gi_probe = static_cast<InstanceGIProbeData *>(instance->base_data);
 #ifdef DEBUG_ENABLED
@@ -440,7 +495,11 @@ void RenderingServerScene::instance_set_base(RID p_instance, RID p_base) {
 	instance->base = RID();
 
 	if (p_base.is_valid()) {
-		instance->base_type = RSG::storage->get_base_type(p_base);
+		if (occluder_owner.owns(p_base)) {
+			instance->base_type = RS::INSTANCE_OCCLUDER;
+		} else {
+			instance->base_type = RSG::storage->get_base_type(p_base);
+		}
 		ERR_FAIL_COND(instance->base_type == RS::INSTANCE_NONE);
 
 		switch (instance->base_type) {
@@ -484,6 +543,15 @@ void RenderingServerScene::instance_set_base(RID p_instance, RID p_base) {
 				instance->base_data = lightmap_data;
 				//lightmap_data->instance = RSG::scene_render->lightmap_data_instance_create(p_base);
 			} break;
+			case RS::INSTANCE_OCCLUDER: {
+				InstanceOccluderData *occluder_data = memnew(InstanceOccluderData);
+				instance->base_data = occluder_data;
+				occluder_owner.getornull(p_base)->users.insert(instance);
+
+				if (scenario) {
+					occluder_data->E = scenario->occluders.push_back(instance);
+				}
+			} break;
 			case RS::INSTANCE_GI_PROBE: {
 				InstanceGIProbeData *gi_probe = memnew(InstanceGIProbeData);
 				instance->base_data = gi_probe;
@@ -515,10 +583,17 @@ void RenderingServerScene::instance_set_scenario(RID p_instance, RID p_scenario)
 
 	if (instance->scenario) {
 		instance->scenario->instances.remove(&instance->scenario_item);
+		if (instance->visibility_range_item.in_list()) {
+			instance->scenario->visibility_range_instances.remove(&instance->visibility_range_item);
+			instance->visibility_range_state = VISIBILITY_RANGE_VISIBLE;
+			instance->visibility_range_culled = false;
+			instance->visibility_parent_culled = false;
+		}
 
 		if (instance->octree_id) {
 			instance->scenario->octree.erase(instance->octree_id); //make dependencies generated by the octree go away
 			instance->octree_id = 0;
+			_scenario_cull_remove(instance);
 		}
 
 		switch (instance->base_type) {
@@ -534,6 +609,13 @@ void RenderingServerScene::instance_set_scenario(RID p_instance, RID p_scenario)
 					light->D = nullptr;
 				}
 			} break;
+			case RS::INSTANCE_OCCLUDER: {
+				InstanceOccluderData *occluder_data = static_cast<InstanceOccluderData *>(instance->base_data);
+				if (occluder_data->E) {
+					instance->scenario->occluders.erase(occluder_data->E);
+					occluder_data->E = nullptr;
+				}
+			} break;
 			case RS::INSTANCE_REFLECTION_PROBE: {
 				InstanceReflectionProbeData *reflection_probe = static_cast<InstanceReflectionProbeData *>(instance->base_data);
 				RSG::scene_render->reflection_probe_release_atlas_index(reflection_probe->instance);
@@ -571,6 +653,7 @@ void RenderingServerScene::instance_set_scenario(RID p_instance, RID p_scenario)
 		instance->scenario = scenario;
 
 		scenario->instances.add(&instance->scenario_item);
+		_instance_update_visibility_range_list(instance);
 
 		switch (instance->base_type) {
 			case RS::INSTANCE_LIGHT: {
@@ -580,6 +663,10 @@ void RenderingServerScene::instance_set_scenario(RID p_instance, RID p_scenario)
 					light->D = scenario->directional_lights.push_back(instance);
 				}
 			} break;
+			case RS::INSTANCE_OCCLUDER: {
+				InstanceOccluderData *occluder_data = static_cast<InstanceOccluderData *>(instance->base_data);
+				occluder_data->E = scenario->occluders.push_back(instance);
+			} break;
 			case RS::INSTANCE_GI_PROBE: {
 				InstanceGIProbeData *gi_probe = static_cast<InstanceGIProbeData *>(instance->base_data);
 				if (!gi_probe->update_element.in_list()) {
@@ -626,6 +713,39 @@ void RenderingServerScene::instance_set_transform(RID p_instance, const Transfor
 	_instance_queue_update(instance, true);
 }
 
+void RenderingServerScene::instances_set_transforms(const Vector<RID> &p_instances, const Vector<Transform> &p_transforms) {
+	ERR_FAIL_COND(p_instances.size() != p_transforms.size());
+
+	int count = p_instances.size();
+	const RID *instances = p_instances.ptr();
+	const Transform *transforms = p_transforms.ptr();
+
+	//only queued here, octree moves for all of them happen in a single pass in update_dirty_instances()
+	for (int i = 0; i < count; i++) {
+		Instance *instance = instance_owner.getornull(instances[i]);
+		ERR_CONTINUE(!instance);
+
+		const Transform &transform = transforms[i];
+		if (instance->transform == transform) {
+			continue;
+		}
+
+#ifdef DEBUG_ENABLED
+		bool valid = true;
+		for (int j = 0; j < 4; j++) {
+			const Vector3 &v = j < 3 ? transform.basis.elements[j] : transform.origin;
+			if (Math::is_inf(v.x) || Math::is_nan(v.x) || Math::is_inf(v.y) || Math::is_nan(v.y) || Math::is_inf(v.z) || Math::is_nan(v.z)) {
+				valid = false;
+				break;
+			}
+		}
+		ERR_CONTINUE_MSG(!valid, "Transform for instance at index " + itos(i) + " is not finite.");
+#endif
+		instance->transform = transform;
+		_instance_queue_update(instance, true);
+	}
+}
+
 void RenderingServerScene::instance_attach_object_instance_id(RID p_instance, ObjectID p_id) {
 	Instance *instance = instance_owner.getornull(p_instance);
 	ERR_FAIL_COND(!instance);
@@ -671,6 +791,18 @@ void RenderingServerScene::instance_set_visible(RID p_instance, bool p_visible)
 
 	instance->visible = p_visible;
 
+	if ((1 << instance->base_type) & RS::INSTANCE_GEOMETRY_MASK) {
+		InstanceGeometryData *geom = static_cast<InstanceGeometryData *>(instance->base_data);
+		//hidden geometry must leave the cached shadow casters
+		if (geom->can_cast_shadows) {
+			for (List<Instance *>::Element *E = geom->lighting.front(); E; E = E->next()) {
+				InstanceLightData *light = static_cast<InstanceLightData *>(E->get()->base_data);
+				light->shadow_dirty = true;
+				light->shadow_casters_dirty = true;
+			}
+		}
+	}
+
 	switch (instance->base_type) {
 		case RS::INSTANCE_LIGHT: {
 			if (RSG::storage->light_get_type(instance->base) != RS::LIGHT_DIRECTIONAL && instance->octree_id && instance->scenario) {
@@ -856,6 +988,7 @@ void RenderingServerScene::instance_geometry_set_flag(RID p_instance, RS::Instan
 				//remove from octree, it needs to be re-paired
 				instance->scenario->octree.erase(instance->octree_id);
 				instance->octree_id = 0;
+				_scenario_cull_remove(instance);
 				_instance_queue_update(instance, true, true);
 			}
 
@@ -889,9 +1022,84 @@ void RenderingServerScene::instance_geometry_set_material_override(RID p_instanc
 }
 
 void RenderingServerScene::instance_geometry_set_draw_range(RID p_instance, float p_min, float p_max, float p_min_margin, float p_max_margin) {
+	Instance *instance = instance_owner.getornull(p_instance);
+	ERR_FAIL_COND(!instance);
+
+	instance->lod_begin = MAX(p_min, 0);
+	instance->lod_end = MAX(p_max, 0);
+	instance->lod_begin_hysteresis = MAX(p_min_margin, 0);
+	instance->lod_end_hysteresis = MAX(p_max_margin, 0);
+
+	_instance_update_visibility_range_list(instance);
 }
 
 void RenderingServerScene::instance_geometry_set_as_instance_lod(RID p_instance, RID p_as_lod_of_instance) {
+	// p_instance is the coarse version, so it becomes the visibility parent of the detailed one.
+	instance_set_visibility_parent(p_as_lod_of_instance, p_instance);
+}
+
+void RenderingServerScene::instance_set_visibility_parent(RID p_instance, RID p_parent_instance) {
+	Instance *instance = instance_owner.getornull(p_instance);
+	ERR_FAIL_COND(!instance);
+
+	Instance *parent = nullptr;
+	if (p_parent_instance.is_valid()) {
+		parent = instance_owner.getornull(p_parent_instance);
+		ERR_FAIL_COND(!parent);
+		for (Instance *E = parent; E; E = E->visibility_parent) {
+			ERR_FAIL_COND_MSG(E == instance, "An instance can't be its own visibility ancestor.");
+		}
+	}
+
+	_instance_link_visibility_parent(instance, parent);
+}
+
+void RenderingServerScene::_instance_link_visibility_parent(Instance *p_instance, Instance *p_parent) {
+	Instance *old_parent = p_instance->visibility_parent;
+	if (old_parent == p_parent) {
+		return;
+	}
+
+	if (old_parent) {
+		old_parent->visibility_children.erase(p_instance);
+	}
+
+	p_instance->visibility_parent = p_parent;
+
+	if (p_parent) {
+		p_parent->visibility_children.push_back(p_instance);
+	}
+
+	if (p_instance->scenario) {
+		p_instance->scenario->visibility_ranges_changed = true;
+	}
+
+	_instance_update_visibility_range_list(p_instance);
+	if (old_parent) {
+		_instance_update_visibility_range_list(old_parent);
+	}
+	if (p_parent) {
+		_instance_update_visibility_range_list(p_parent);
+	}
+}
+
+void RenderingServerScene::_instance_update_visibility_range_list(Instance *p_instance) {
+	// Parents are in the list too, even without a range of their own, as the update starts from them.
+	bool needs_range = p_instance->scenario && (p_instance->visibility_parent || !p_instance->visibility_children.empty() || p_instance->lod_begin > 0 || p_instance->lod_end > 0);
+
+	if (needs_range == p_instance->visibility_range_item.in_list()) {
+		return;
+	}
+
+	if (needs_range) {
+		p_instance->scenario->visibility_range_instances.add(&p_instance->visibility_range_item);
+		p_instance->scenario->visibility_ranges_changed = true;
+	} else {
+		p_instance->visibility_range_item.remove_from_list();
+		p_instance->visibility_range_state = VISIBILITY_RANGE_VISIBLE;
+		p_instance->visibility_range_culled = false;
+		p_instance->visibility_parent_culled = false;
+	}
 }
 
 void RenderingServerScene::instance_geometry_set_lightmap(RID p_instance, RID p_lightmap, const Rect2 &p_lightmap_uv_scale, int p_slice_index) {
@@ -974,6 +1182,70 @@ void RenderingServerScene::instance_geometry_get_shader_parameter_list(RID p_ins
 	}
 }
 
+uint32_t RenderingServerScene::_scenario_cull_get_cell(Scenario *p_scenario, const AABB &p_aabb) {
+	if (p_aabb.size.x > cull_cell_size || p_aabb.size.y > cull_cell_size || p_aabb.size.z > cull_cell_size) {
+		return 0;
+	}
+
+	// 21 bits per axis, anything further out than that goes with the oversized instances.
+	const int64_t limit = 1 << 20;
+	Vector3 center = (p_aabb.position + p_aabb.size * 0.5) / cull_cell_size;
+	int64_t x = int64_t(Math::floor(center.x));
+	int64_t y = int64_t(Math::floor(center.y));
+	int64_t z = int64_t(Math::floor(center.z));
+	if (x < -limit || x >= limit || y < -limit || y >= limit || z < -limit || z >= limit) {
+		return 0;
+	}
+
+	uint64_t key = (uint64_t(x & 0x1FFFFF) << 42) | (uint64_t(y & 0x1FFFFF) << 21) | uint64_t(z & 0x1FFFFF);
+	const uint32_t *index = p_scenario->cull_cell_map.getptr(key);
+	if (index) {
+		return *index;
+	}
+
+	uint32_t new_index = p_scenario->cull_cells.size();
+	p_scenario->cull_cells.resize(new_index + 1);
+	Vector3 cell_size(cull_cell_size, cull_cell_size, cull_cell_size);
+	p_scenario->cull_cells[new_index].bounds = AABB(Vector3(x, y, z) * cull_cell_size - cell_size * 0.5, cell_size * 2.0);
+	p_scenario->cull_cell_map.set(key, new_index);
+	return new_index;
+}
+
+void RenderingServerScene::_scenario_cull_add(Instance *p_instance) {
+	ERR_FAIL_COND(p_instance->cull_index != -1);
+	Scenario *scenario = p_instance->scenario;
+	uint32_t cell = _scenario_cull_get_cell(scenario, p_instance->transformed_aabb);
+	p_instance->cull_cell = cell;
+	p_instance->cull_index = scenario->cull_cells[cell].instances.size();
+	scenario->cull_cells[cell].instances.push_back(p_instance);
+	scenario->cull_instance_count++;
+}
+
+void RenderingServerScene::_scenario_cull_remove(Instance *p_instance) {
+	if (p_instance->cull_index == -1) {
+		return;
+	}
+
+	LocalVector<Instance *> &cell_instances = p_instance->scenario->cull_cells[p_instance->cull_cell].instances;
+	uint32_t last = cell_instances.size() - 1;
+	if (uint32_t(p_instance->cull_index) != last) {
+		cell_instances[p_instance->cull_index] = cell_instances[last];
+		cell_instances[p_instance->cull_index]->cull_index = p_instance->cull_index;
+	}
+	cell_instances.resize(last);
+	p_instance->scenario->cull_instance_count--;
+	p_instance->cull_cell = -1;
+	p_instance->cull_index = -1;
+}
+
+void RenderingServerScene::_scenario_cull_move(Instance *p_instance) {
+	if (p_instance->cull_index == -1 || uint32_t(p_instance->cull_cell) == _scenario_cull_get_cell(p_instance->scenario, p_instance->transformed_aabb)) {
+		return;
+	}
+	_scenario_cull_remove(p_instance);
+	_scenario_cull_add(p_instance);
+}
+
 void RenderingServerScene::_update_instance(Instance *p_instance) {
 	p_instance->version++;
 
@@ -983,6 +1255,7 @@ void RenderingServerScene::_update_instance(Instance *p_instance) {
 		RSG::scene_render->light_instance_set_transform(light->instance, p_instance->transform);
 		RSG::scene_render->light_instance_set_aabb(light->instance, p_instance->transform.xform(p_instance->aabb));
 		light->shadow_dirty = true;
+		light->shadow_casters_dirty = true;
 
 		RS::LightBakeMode bake_mode = RSG::storage->light_get_bake_mode(p_instance->base);
 		if (RSG::storage->light_get_type(p_instance->base) != RS::LIGHT_DIRECTIONAL && bake_mode != light->bake_mode) {
@@ -1038,6 +1311,7 @@ void RenderingServerScene::_update_instance(Instance *p_instance) {
 			for (List<Instance *>::Element *E = geom->lighting.front(); E; E = E->next()) {
 				InstanceLightData *light = static_cast<InstanceLightData *>(E->get()->base_data);
 				light->shadow_dirty = true;
+				light->shadow_casters_dirty = true;
 			}
 		}
 
@@ -1093,6 +1367,7 @@ void RenderingServerScene::_update_instance(Instance *p_instance) {
 
 		// not inside octree
 		p_instance->octree_id = p_instance->scenario->octree.create(p_instance, new_aabb, 0, pairable, base_type, pairable_mask);
+		_scenario_cull_add(p_instance);
 
 	} else {
 		/*
@@ -1101,6 +1376,7 @@ void RenderingServerScene::_update_instance(Instance *p_instance) {
 		*/
 
 		p_instance->scenario->octree.move(p_instance->octree_id, new_aabb);
+		_scenario_cull_move(p_instance);
 	}
 }
 
@@ -1165,6 +1441,12 @@ void RenderingServerScene::_update_instance_aabb(Instance *p_instance) {
 		case RenderingServer::INSTANCE_LIGHTMAP: {
 			new_aabb = RSG::storage->lightmap_get_aabb(p_instance->base);
 
+		} break;
+		case RenderingServer::INSTANCE_OCCLUDER: {
+			Occluder *occluder = occluder_owner.getornull(p_instance->base);
+			ERR_FAIL_COND(!occluder);
+			new_aabb = occluder->aabb;
+
 		} break;
 		default: {
 		}
@@ -1281,7 +1563,8 @@ bool RenderingServerScene::_light_instance_update_shadow(Instance *p_instance, c
 			if (depth_range_mode == RS::LIGHT_DIRECTIONAL_SHADOW_DEPTH_RANGE_OPTIMIZED) {
 				//optimize min/max
 				Vector<Plane> planes = p_cam_projection.get_projection_planes(p_cam_transform);
-				int cull_count = p_scenario->octree.cull_convex(planes, instance_shadow_cull_result, MAX_INSTANCE_CULL, RS::INSTANCE_GEOMETRY_MASK);
+				instance_shadow_cull_result.resize(p_scenario->cull_instance_count);
+				int cull_count = p_scenario->octree.cull_convex(planes, instance_shadow_cull_result.ptr(), instance_shadow_cull_result.size(), RS::INSTANCE_GEOMETRY_MASK);
 				Plane base(p_cam_transform.origin, -p_cam_transform.basis.get_axis(2));
 				//check distance max and min
 
@@ -1291,7 +1574,7 @@ bool RenderingServerScene::_light_instance_update_shadow(Instance *p_instance, c
 
 				for (int i = 0; i < cull_count; i++) {
 					Instance *instance = instance_shadow_cull_result[i];
-					if (!instance->visible || !((1 << instance->base_type) & RS::INSTANCE_GEOMETRY_MASK) || !static_cast<InstanceGeometryData *>(instance->base_data)->can_cast_shadows) {
+					if (!instance->visible || instance->visibility_range_culled || !((1 << instance->base_type) & RS::INSTANCE_GEOMETRY_MASK) || !static_cast<InstanceGeometryData *>(instance->base_data)->can_cast_shadows) {
 						continue;
 					}
 
@@ -1505,7 +1788,8 @@ bool RenderingServerScene::_light_instance_update_shadow(Instance *p_instance, c
 				light_frustum_planes.write[4] = Plane(z_vec, z_max + 1e6);
 				light_frustum_planes.write[5] = Plane(-z_vec, -z_min); // z_min is ok, since casters further than far-light plane are not needed
 
-				int cull_count = p_scenario->octree.cull_convex(light_frustum_planes, instance_shadow_cull_result, MAX_INSTANCE_CULL, RS::INSTANCE_GEOMETRY_MASK);
+				instance_shadow_cull_result.resize(p_scenario->cull_instance_count);
+				int cull_count = p_scenario->octree.cull_convex(light_frustum_planes, instance_shadow_cull_result.ptr(), instance_shadow_cull_result.size(), RS::INSTANCE_GEOMETRY_MASK);
 
 				// a pre pass will need to be needed to determine the actual z-near to be used
 
@@ -1515,7 +1799,7 @@ bool RenderingServerScene::_light_instance_update_shadow(Instance *p_instance, c
 				for (int j = 0; j < cull_count; j++) {
 					real_t min, max;
 					Instance *instance = instance_shadow_cull_result[j];
-					if (!instance->visible || !((1 << instance->base_type) & RS::INSTANCE_GEOMETRY_MASK) || !static_cast<InstanceGeometryData *>(instance->base_data)->can_cast_shadows) {
+					if (!instance->visible || instance->visibility_range_culled || !((1 << instance->base_type) & RS::INSTANCE_GEOMETRY_MASK) || !static_cast<InstanceGeometryData *>(instance->base_data)->can_cast_shadows) {
 						cull_count--;
 						SWAP(instance_shadow_cull_result[j], instance_shadow_cull_result[cull_count]);
 						j--;
@@ -1628,145 +1912,166 @@ bool RenderingServerScene::_light_instance_update_shadow(Instance *p_instance, c
 					RSG::scene_render->light_instance_set_shadow_transform(light->instance, ortho_camera, ortho_transform, z_max - z_min_cam, distances[i + 1], i, radius * 2.0 / texture_size, bias_scale * aspect_bias_scale * min_distance_bias_scale, z_max, uv_scale);
 				}
 
-				RSG::scene_render->render_shadow(light->instance, p_shadow_atlas, i, (RasterizerScene::InstanceBase **)instance_shadow_cull_result, cull_count);
+				RSG::scene_render->render_shadow(light->instance, p_shadow_atlas, i, (RasterizerScene::InstanceBase **)instance_shadow_cull_result.ptr(), cull_count);
 			}
 
 		} break;
-		case RS::LIGHT_OMNI: {
-			RS::LightOmniShadowMode shadow_mode = RSG::storage->light_omni_get_shadow_mode(p_instance->base);
-
-			if (shadow_mode == RS::LIGHT_OMNI_SHADOW_DUAL_PARABOLOID || !RSG::scene_render->light_instances_can_render_shadow_cube()) {
-				for (int i = 0; i < 2; i++) {
-					//using this one ensures that raster deferred will have it
-					RENDER_TIMESTAMP("Culling Shadow Paraboloid" + itos(i));
-
-					real_t radius = RSG::storage->light_get_param(p_instance->base, RS::LIGHT_PARAM_RANGE);
-
-					real_t z = i == 0 ? -1 : 1;
-					Vector<Plane> planes;
-					planes.resize(6);
-					planes.write[0] = light_transform.xform(Plane(Vector3(0, 0, z), radius));
-					planes.write[1] = light_transform.xform(Plane(Vector3(1, 0, z).normalized(), radius));
-					planes.write[2] = light_transform.xform(Plane(Vector3(-1, 0, z).normalized(), radius));
-					planes.write[3] = light_transform.xform(Plane(Vector3(0, 1, z).normalized(), radius));
-					planes.write[4] = light_transform.xform(Plane(Vector3(0, -1, z).normalized(), radius));
-					planes.write[5] = light_transform.xform(Plane(Vector3(0, 0, -z), 0));
-
-					int cull_count = p_scenario->octree.cull_convex(planes, instance_shadow_cull_result, MAX_INSTANCE_CULL, RS::INSTANCE_GEOMETRY_MASK);
-					Plane near_plane(light_transform.origin, light_transform.basis.get_axis(2) * z);
-
-					for (int j = 0; j < cull_count; j++) {
-						Instance *instance = instance_shadow_cull_result[j];
-						if (!instance->visible || !((1 << instance->base_type) & RS::INSTANCE_GEOMETRY_MASK) || !static_cast<InstanceGeometryData *>(instance->base_data)->can_cast_shadows) {
-							cull_count--;
-							SWAP(instance_shadow_cull_result[j], instance_shadow_cull_result[cull_count]);
-							j--;
-						} else {
-							if (static_cast<InstanceGeometryData *>(instance->base_data)->material_is_animated) {
-								animated_material_found = true;
-							}
+		case RS::LIGHT_OMNI:
+		case RS::LIGHT_SPOT: {
+			if (light->shadow_casters_dirty) {
+				_light_instance_setup_shadow_passes(p_instance);
+				_light_instance_cull_shadow_casters(0, &p_instance);
+			}
 
-							instance->depth = near_plane.distance_to(instance->transform.origin);
-							instance->depth_layer = 0;
-						}
-					}
+			animated_material_found = _light_instance_render_shadow_passes(p_instance, p_shadow_atlas);
+		} break;
+	}
 
-					RSG::scene_render->light_instance_set_shadow_transform(light->instance, CameraMatrix(), light_transform, radius, 0, i, 0);
-					RSG::scene_render->render_shadow(light->instance, p_shadow_atlas, i, (RasterizerScene::InstanceBase **)instance_shadow_cull_result, cull_count);
-				}
-			} else { //shadow cube
-
-				real_t radius = RSG::storage->light_get_param(p_instance->base, RS::LIGHT_PARAM_RANGE);
-				CameraMatrix cm;
-				cm.set_perspective(90, 1, 0.01, radius);
-
-				for (int i = 0; i < 6; i++) {
-					RENDER_TIMESTAMP("Culling Shadow Cube side" + itos(i));
-					//using this one ensures that raster deferred will have it
-
-					static const Vector3 view_normals[6] = {
-						Vector3(+1, 0, 0),
-						Vector3(-1, 0, 0),
-						Vector3(0, -1, 0),
-						Vector3(0, +1, 0),
-						Vector3(0, 0, +1),
-						Vector3(0, 0, -1)
-					};
-					static const Vector3 view_up[6] = {
-						Vector3(0, -1, 0),
-						Vector3(0, -1, 0),
-						Vector3(0, 0, -1),
-						Vector3(0, 0, +1),
-						Vector3(0, -1, 0),
-						Vector3(0, -1, 0)
-					};
-
-					Transform xform = light_transform * Transform().looking_at(view_normals[i], view_up[i]);
-
-					Vector<Plane> planes = cm.get_projection_planes(xform);
-
-					int cull_count = p_scenario->octree.cull_convex(planes, instance_shadow_cull_result, MAX_INSTANCE_CULL, RS::INSTANCE_GEOMETRY_MASK);
-
-					Plane near_plane(xform.origin, -xform.basis.get_axis(2));
-					for (int j = 0; j < cull_count; j++) {
-						Instance *instance = instance_shadow_cull_result[j];
-						if (!instance->visible || !((1 << instance->base_type) & RS::INSTANCE_GEOMETRY_MASK) || !static_cast<InstanceGeometryData *>(instance->base_data)->can_cast_shadows) {
-							cull_count--;
-							SWAP(instance_shadow_cull_result[j], instance_shadow_cull_result[cull_count]);
-							j--;
-						} else {
-							if (static_cast<InstanceGeometryData *>(instance->base_data)->material_is_animated) {
-								animated_material_found = true;
-							}
-							instance->depth = near_plane.distance_to(instance->transform.origin);
-							instance->depth_layer = 0;
-						}
-					}
+	return animated_material_found;
+}
 
-					RSG::scene_render->light_instance_set_shadow_transform(light->instance, cm, xform, radius, 0, i, 0);
-					RSG::scene_render->render_shadow(light->instance, p_shadow_atlas, i, (RasterizerScene::InstanceBase **)instance_shadow_cull_result, cull_count);
-				}
+void RenderingServerScene::_light_instance_setup_shadow_passes(Instance *p_instance) {
+	InstanceLightData *light = static_cast<InstanceLightData *>(p_instance->base_data);
 
-				//restore the regular DP matrix
-				RSG::scene_render->light_instance_set_shadow_transform(light->instance, CameraMatrix(), light_transform, radius, 0, 0, 0);
-			}
+	Transform light_transform = p_instance->transform;
+	light_transform.orthonormalize(); //scale does not count on lights
 
-		} break;
-		case RS::LIGHT_SPOT: {
-			RENDER_TIMESTAMP("Culling Spot Light");
+	real_t radius = RSG::storage->light_get_param(p_instance->base, RS::LIGHT_PARAM_RANGE);
+
+	light->shadow_light_transform = light_transform;
+	light->shadow_range = radius;
+	light->shadow_cube = false;
+
+	if (RSG::storage->light_get_type(p_instance->base) == RS::LIGHT_SPOT) {
+		real_t angle = RSG::storage->light_get_param(p_instance->base, RS::LIGHT_PARAM_SPOT_ANGLE);
+
+		InstanceLightData::ShadowPass &pass = light->shadow_passes[0];
+		pass.projection.set_perspective(angle * 2.0, 1.0, 0.01, radius);
+		pass.transform = light_transform;
+		pass.planes = pass.projection.get_projection_planes(light_transform);
+		pass.near_plane = Plane(light_transform.origin, -light_transform.basis.get_axis(2));
+		light->shadow_pass_count = 1;
+
+	} else if (RSG::storage->light_omni_get_shadow_mode(p_instance->base) == RS::LIGHT_OMNI_SHADOW_DUAL_PARABOLOID || !RSG::scene_render->light_instances_can_render_shadow_cube()) {
+		for (int i = 0; i < 2; i++) {
+			real_t z = i == 0 ? -1 : 1;
+
+			InstanceLightData::ShadowPass &pass = light->shadow_passes[i];
+			pass.projection = CameraMatrix();
+			pass.transform = light_transform;
+			pass.planes.resize(6);
+			pass.planes.write[0] = light_transform.xform(Plane(Vector3(0, 0, z), radius));
+			pass.planes.write[1] = light_transform.xform(Plane(Vector3(1, 0, z).normalized(), radius));
+			pass.planes.write[2] = light_transform.xform(Plane(Vector3(-1, 0, z).normalized(), radius));
+			pass.planes.write[3] = light_transform.xform(Plane(Vector3(0, 1, z).normalized(), radius));
+			pass.planes.write[4] = light_transform.xform(Plane(Vector3(0, -1, z).normalized(), radius));
+			pass.planes.write[5] = light_transform.xform(Plane(Vector3(0, 0, -z), 0));
+			pass.near_plane = Plane(light_transform.origin, light_transform.basis.get_axis(2) * z);
+		}
+		light->shadow_pass_count = 2;
 
-			real_t radius = RSG::storage->light_get_param(p_instance->base, RS::LIGHT_PARAM_RANGE);
-			real_t angle = RSG::storage->light_get_param(p_instance->base, RS::LIGHT_PARAM_SPOT_ANGLE);
+	} else { //shadow cube
+		static const Vector3 view_normals[6] = {
+			Vector3(+1, 0, 0),
+			Vector3(-1, 0, 0),
+			Vector3(0, -1, 0),
+			Vector3(0, +1, 0),
+			Vector3(0, 0, +1),
+			Vector3(0, 0, -1)
+		};
+		static const Vector3 view_up[6] = {
+			Vector3(0, -1, 0),
+			Vector3(0, -1, 0),
+			Vector3(0, 0, -1),
+			Vector3(0, 0, +1),
+			Vector3(0, -1, 0),
+			Vector3(0, -1, 0)
+		};
 
-			CameraMatrix cm;
-			cm.set_perspective(angle * 2.0, 1.0, 0.01, radius);
+		CameraMatrix cm;
+		cm.set_perspective(90, 1, 0.01, radius);
 
-			Vector<Plane> planes = cm.get_projection_planes(light_transform);
-			int cull_count = p_scenario->octree.cull_convex(planes, instance_shadow_cull_result, MAX_INSTANCE_CULL, RS::INSTANCE_GEOMETRY_MASK);
+		for (int i = 0; i < 6; i++) {
+			Transform xform = light_transform * Transform().looking_at(view_normals[i], view_up[i]);
 
-			Plane near_plane(light_transform.origin, -light_transform.basis.get_axis(2));
-			for (int j = 0; j < cull_count; j++) {
-				Instance *instance = instance_shadow_cull_result[j];
-				if (!instance->visible || !((1 << instance->base_type) & RS::INSTANCE_GEOMETRY_MASK) || !static_cast<InstanceGeometryData *>(instance->base_data)->can_cast_shadows) {
-					cull_count--;
-					SWAP(instance_shadow_cull_result[j], instance_shadow_cull_result[cull_count]);
-					j--;
-				} else {
-					if (static_cast<InstanceGeometryData *>(instance->base_data)->material_is_animated) {
-						animated_material_found = true;
-					}
-					instance->depth = near_plane.distance_to(instance->transform.origin);
-					instance->depth_layer = 0;
-				}
+			InstanceLightData::ShadowPass &pass = light->shadow_passes[i];
+			pass.projection = cm;
+			pass.transform = xform;
+			pass.planes = cm.get_projection_planes(xform);
+			pass.near_plane = Plane(xform.origin, -xform.basis.get_axis(2));
+		}
+		light->shadow_pass_count = 6;
+		light->shadow_cube = true;
+	}
+
+	for (uint32_t i = 0; i < light->shadow_pass_count; i++) {
+		InstanceLightData::ShadowPass &pass = light->shadow_passes[i];
+		pass.points = Geometry3D::compute_convex_mesh_points(pass.planes.ptr(), pass.planes.size());
+	}
+}
+
+void RenderingServerScene::_light_instance_cull_shadow_casters(uint32_t p_index, Instance **p_lights) {
+	// Only reads the geometry paired with the light, so several lights can be culled at once.
+	// The paired geometry overlaps the light's AABB, which contains every pass volume.
+	InstanceLightData *light = static_cast<InstanceLightData *>(p_lights[p_index]->base_data);
+
+	bool animated_material_found = false;
+
+	for (uint32_t i = 0; i < light->shadow_pass_count; i++) {
+		InstanceLightData::ShadowPass &pass = light->shadow_passes[i];
+		pass.casters.clear();
+
+		if (pass.points.empty()) {
+			continue;
+		}
+
+		for (List<InstanceLightData::PairInfo>::Element *E = light->geometries.front(); E; E = E->next()) {
+			Instance *instance = E->get().geometry;
+			InstanceGeometryData *geom = static_cast<InstanceGeometryData *>(instance->base_data);
+			if (!instance->visible || instance->visibility_range_culled || !geom->can_cast_shadows) {
+				continue;
 			}
 
-			RSG::scene_render->light_instance_set_shadow_transform(light->instance, cm, light_transform, radius, 0, 0, 0);
-			RSG::scene_render->render_shadow(light->instance, p_shadow_atlas, 0, (RasterizerScene::InstanceBase **)instance_shadow_cull_result, cull_count);
+			if (!instance->transformed_aabb.intersects_convex_shape(pass.planes.ptr(), pass.planes.size(), pass.points.ptr(), pass.points.size())) {
+				continue;
+			}
 
-		} break;
+			if (geom->material_is_animated) {
+				animated_material_found = true;
+			}
+
+			pass.casters.push_back(instance);
+		}
 	}
 
-	return animated_material_found;
+	light->shadow_casters_animated = animated_material_found;
+	light->shadow_casters_dirty = false;
+}
+
+bool RenderingServerScene::_light_instance_render_shadow_passes(Instance *p_instance, RID p_shadow_atlas) {
+	InstanceLightData *light = static_cast<InstanceLightData *>(p_instance->base_data);
+
+	for (uint32_t i = 0; i < light->shadow_pass_count; i++) {
+		RENDER_TIMESTAMP("Rendering Shadow Pass " + itos(i));
+
+		InstanceLightData::ShadowPass &pass = light->shadow_passes[i];
+
+		for (uint32_t j = 0; j < pass.casters.size(); j++) {
+			Instance *instance = pass.casters[j];
+			instance->depth = pass.near_plane.distance_to(instance->transform.origin);
+			instance->depth_layer = 0;
+		}
+
+		RSG::scene_render->light_instance_set_shadow_transform(light->instance, pass.projection, pass.transform, light->shadow_range, 0, i, 0);
+		RSG::scene_render->render_shadow(light->instance, p_shadow_atlas, i, (RasterizerScene::InstanceBase **)pass.casters.ptr(), pass.casters.size());
+	}
+
+	if (light->shadow_cube) {
+		//restore the regular DP matrix
+		RSG::scene_render->light_instance_set_shadow_transform(light->instance, CameraMatrix(), light->shadow_light_transform, light->shadow_range, 0, 0, 0);
+	}
+
+	return light->shadow_casters_animated;
 }
 
 void RenderingServerScene::render_camera(RID p_render_buffers, RID p_camera, RID p_scenario, Size2 p_viewport_size, RID p_shadow_atlas) {
@@ -1903,150 +2208,120 @@ void RenderingServerScene::render_camera(RID p_render_buffers, Ref<XRInterface>
 	_render_scene(p_render_buffers, cam_transform, camera_matrix, false, environment, camera->effects, p_scenario, p_shadow_atlas, RID(), -1);
 };
 
-void RenderingServerScene::_prepare_scene(const Transform p_cam_transform, const CameraMatrix &p_cam_projection, bool p_cam_orthogonal, bool p_cam_vaspect, RID p_render_buffers, RID p_environment, uint32_t p_visible_layers, RID p_scenario, RID p_shadow_atlas, RID p_reflection_probe, bool p_using_shadows) {
-	// Note, in stereo rendering:
-	// - p_cam_transform will be a transform in the middle of our two eyes
-	// - p_cam_projection is a wider frustrum that encompasses both eyes
+void RenderingServerScene::_instance_update_visibility_range(Instance *p_instance, const Vector3 &p_camera_position, bool p_parent_culled, bool p_walk_hidden) {
+	if (p_parent_culled && p_instance->visibility_parent_culled && !p_walk_hidden) {
+		return; // Hidden by an ancestor since the last update, and so is everything below.
+	}
 
-	Scenario *scenario = scenario_owner.getornull(p_scenario);
+	bool was_culled = p_instance->visibility_range_culled;
 
-	render_pass++;
-	uint32_t camera_layer_mask = p_visible_layers;
+	if (!p_parent_culled) {
+		float begin = p_instance->lod_begin;
+		float end = p_instance->lod_end;
+		if (!was_culled) {
+			// Once shown, only hide past the margins, so instances sitting on a boundary don't flicker.
+			begin -= p_instance->lod_begin_hysteresis;
+			end += p_instance->lod_end_hysteresis;
+		}
 
-	RSG::scene_render->set_scene_pass(render_pass);
+		const AABB &aabb = p_instance->transformed_aabb;
+		float distance = p_camera_position.distance_to(aabb.position + aabb.size * 0.5);
 
-	if (p_render_buffers.is_valid()) {
-		RSG::scene_render->sdfgi_update(p_render_buffers, p_environment, p_cam_transform.origin); //update conditions for SDFGI (whether its used or not)
+		if (p_instance->lod_begin > 0 && distance < begin) {
+			p_instance->visibility_range_state = VISIBILITY_RANGE_TOO_CLOSE;
+		} else if (p_instance->lod_end > 0 && distance > end) {
+			p_instance->visibility_range_state = VISIBILITY_RANGE_TOO_FAR;
+		} else {
+			p_instance->visibility_range_state = VISIBILITY_RANGE_VISIBLE;
+		}
 	}
 
-	RENDER_TIMESTAMP("Frustum Culling");
+	p_instance->visibility_parent_culled = p_parent_culled;
+	p_instance->visibility_range_culled = p_parent_culled || p_instance->visibility_range_state != VISIBILITY_RANGE_VISIBLE;
 
-	//rasterizer->set_camera(camera->transform, camera_matrix,ortho);
-
-	Vector<Plane> planes = p_cam_projection.get_projection_planes(p_cam_transform);
+	if (p_instance->visibility_range_culled != was_culled && ((1 << p_instance->base_type) & RS::INSTANCE_GEOMETRY_MASK)) {
+		// Shadow casters are culled with the camera's ranges, lights have to cull them again.
+		InstanceGeometryData *geom = static_cast<InstanceGeometryData *>(p_instance->base_data);
+		if (geom->can_cast_shadows) {
+			for (List<Instance *>::Element *E = geom->lighting.front(); E; E = E->next()) {
+				InstanceLightData *light = static_cast<InstanceLightData *>(E->get()->base_data);
+				light->shadow_dirty = true;
+				light->shadow_casters_dirty = true;
+			}
+		}
+	}
 
-	Plane near_plane(p_cam_transform.origin, -p_cam_transform.basis.get_axis(2).normalized());
-	float z_far = p_cam_projection.get_z_far();
+	// Children swap in exactly when the parent swaps out, the parent's hysteresis applies to both.
+	bool children_culled = p_parent_culled || p_instance->visibility_range_state != VISIBILITY_RANGE_TOO_CLOSE;
+	for (uint32_t i = 0; i < p_instance->visibility_children.size(); i++) {
+		Instance *child = p_instance->visibility_children[i];
+		if (child->scenario == p_instance->scenario) {
+			_instance_update_visibility_range(child, p_camera_position, children_culled, p_walk_hidden);
+		}
+	}
+}
 
-	/* STEP 2 - CULL */
-	instance_cull_count = scenario->octree.cull_convex(planes, instance_cull_result, MAX_INSTANCE_CULL);
-	light_cull_count = 0;
+void RenderingServerScene::_scene_update_visibility_ranges(Scenario *p_scenario, const Vector3 &p_camera_position) {
+	// Done before the threaded cull, as it walks down from each root and the cull only reads the result.
+	for (SelfList<Instance> *E = p_scenario->visibility_range_instances.first(); E; E = E->next()) {
+		Instance *instance = E->self();
+		if (!instance->visibility_parent || instance->visibility_parent->scenario != p_scenario) {
+			_instance_update_visibility_range(instance, p_camera_position, false, p_scenario->visibility_ranges_changed);
+		}
+	}
+	p_scenario->visibility_ranges_changed = false;
+}
 
-	reflection_probe_cull_count = 0;
-	decal_cull_count = 0;
-	gi_probe_cull_count = 0;
-	lightmap_cull_count = 0;
+void RenderingServerScene::_scene_cull_partition(uint32_t p_partition, SceneCullData *p_data) {
+	CullPartition &partition = cull_partitions[p_partition];
+	partition.geometry.clear();
+	partition.particles.clear();
+	partition.others.clear();
+	partition.redraw = false;
 
-	//light_samplers_culled=0;
+	uint32_t from = p_partition * CULL_PARTITION_SIZE;
+	uint32_t to = MIN(from + CULL_PARTITION_SIZE, p_data->instance_count);
 
-	/*
-	print_line("OT: "+rtos( (OS::get_singleton()->get_ticks_usec()-t)/1000.0));
-	print_line("OTO: "+itos(p_scenario->octree.get_octant_count()));
-	print_line("OTE: "+itos(p_scenario->octree.get_elem_count()));
-	print_line("OTP: "+itos(p_scenario->octree.get_pair_count()));
-	*/
+	for (uint32_t i = from; i < to; i++) {
+		Instance *ins = p_data->instances[i];
 
-	/* STEP 3 - PROCESS PORTALS, VALIDATE ROOMS */
-	//removed, will replace with culling
-
-	/* STEP 4 - REMOVE FURTHER CULLED OBJECTS, ADD LIGHTS */
-	uint64_t frame_number = RSG::rasterizer->get_frame_number();
-	float lightmap_probe_update_speed = RSG::storage->lightmap_get_probe_capture_update_speed() * RSG::rasterizer->get_frame_delta_time();
+		if (ins->visibility_range_culled) {
+			// Out of range or replaced by a coarser ancestor, skip culling it altogether.
+			ins->last_render_pass = 0;
+			ins->last_frame_pass = p_data->frame_number;
+			continue;
+		}
 
-	for (int i = 0; i < instance_cull_count; i++) {
-		Instance *ins = instance_cull_result[i];
+		if (!ins->transformed_aabb.intersects_convex_shape(p_data->planes, p_data->plane_count, p_data->points, p_data->point_count)) {
+			continue;
+		}
 
+		// Everything below only touches this instance, anything shared is left to _prepare_scene.
 		bool keep = false;
 
-		if ((camera_layer_mask & ins->layer_mask) == 0) {
+		if ((p_data->camera_layer_mask & ins->layer_mask) == 0 || !ins->visible) {
 			//failure
-		} else if (ins->base_type == RS::INSTANCE_LIGHT && ins->visible) {
-			if (light_cull_count < MAX_LIGHTS_CULLED) {
-				InstanceLightData *light = static_cast<InstanceLightData *>(ins->base_data);
-
-				if (!light->geometries.empty()) {
-					//do not add this light if no geometry is affected by it..
-					light_cull_result[light_cull_count] = ins;
-					light_instance_cull_result[light_cull_count] = light->instance;
-					if (p_shadow_atlas.is_valid() && RSG::storage->light_has_shadow(ins->base)) {
-						RSG::scene_render->light_instance_mark_visible(light->instance); //mark it visible for shadow allocation later
-					}
-
-					light_cull_count++;
-				}
-			}
-		} else if (ins->base_type == RS::INSTANCE_REFLECTION_PROBE && ins->visible) {
-			if (reflection_probe_cull_count < MAX_REFLECTION_PROBES_CULLED) {
-				InstanceReflectionProbeData *reflection_probe = static_cast<InstanceReflectionProbeData *>(ins->base_data);
-
-				if (p_reflection_probe != reflection_probe->instance) {
-					//avoid entering The Matrix
-
-					if (!reflection_probe->geometries.empty()) {
-						//do not add this light if no geometry is affected by it..
-
-						if (reflection_probe->reflection_dirty || RSG::scene_render->reflection_probe_instance_needs_redraw(reflection_probe->instance)) {
-							if (!reflection_probe->update_list.in_list()) {
-								reflection_probe->render_step = 0;
-								reflection_probe_render_list.add_last(&reflection_probe->update_list);
-							}
-
-							reflection_probe->reflection_dirty = false;
-						}
-
-						if (RSG::scene_render->reflection_probe_instance_has_reflection(reflection_probe->instance)) {
-							reflection_probe_instance_cull_result[reflection_probe_cull_count] = reflection_probe->instance;
-							reflection_probe_cull_count++;
-						}
-					}
-				}
-			}
-		} else if (ins->base_type == RS::INSTANCE_DECAL && ins->visible) {
-			if (decal_cull_count < MAX_DECALS_CULLED) {
-				InstanceDecalData *decal = static_cast<InstanceDecalData *>(ins->base_data);
-
-				if (!decal->geometries.empty()) {
-					//do not add this decal if no geometry is affected by it..
-					decal_instance_cull_result[decal_cull_count] = decal->instance;
-					decal_cull_count++;
-				}
-			}
-
-		} else if (ins->base_type == RS::INSTANCE_GI_PROBE && ins->visible) {
-			InstanceGIProbeData *gi_probe = static_cast<InstanceGIProbeData *>(ins->base_data);
-			if (!gi_probe->update_element.in_list()) {
-				gi_probe_update_list.add(&gi_probe->update_element);
-			}
-
-			if (gi_probe_cull_count < MAX_GI_PROBES_CULLED) {
-				gi_probe_instance_cull_result[gi_probe_cull_count] = gi_probe->probe_instance;
-				gi_probe_cull_count++;
-			}
-		} else if (ins->base_type == RS::INSTANCE_LIGHTMAP && ins->visible) {
-			if (lightmap_cull_count < MAX_LIGHTMAPS_CULLED) {
-				lightmap_cull_result[lightmap_cull_count] = ins;
-				lightmap_cull_count++;
+		} else if (ins->base_type == RS::INSTANCE_LIGHT || ins->base_type == RS::INSTANCE_REFLECTION_PROBE || ins->base_type == RS::INSTANCE_DECAL || ins->base_type == RS::INSTANCE_GI_PROBE || ins->base_type == RS::INSTANCE_LIGHTMAP) {
+			partition.others.push_back(ins);
+		} else if (((1 << ins->base_type) & RS::INSTANCE_GEOMETRY_MASK) && ins->cast_shadows != RS::SHADOW_CASTING_SETTING_SHADOWS_ONLY) {
+			if (p_data->occlusion && p_data->occlusion->is_occluded(ins->transformed_aabb)) {
+				ins->last_render_pass = 0;
+				ins->last_frame_pass = p_data->frame_number;
+				continue;
 			}
 
-		} else if (((1 << ins->base_type) & RS::INSTANCE_GEOMETRY_MASK) && ins->visible && ins->cast_shadows != RS::SHADOW_CASTING_SETTING_SHADOWS_ONLY) {
 			keep = true;
 
 			InstanceGeometryData *geom = static_cast<InstanceGeometryData *>(ins->base_data);
 
 			if (ins->redraw_if_visible) {
-				RenderingServerRaster::redraw_request();
+				partition.redraw = true;
 			}
 
 			if (ins->base_type == RS::INSTANCE_PARTICLES) {
-				//particles visible? process them
-				if (RSG::storage->particles_is_inactive(ins->base)) {
-					//but if nothing is going on, don't do it.
-					keep = false;
-				} else {
-					RSG::storage->particles_request_process(ins->base);
-					//particles visible? request redraw
-					RenderingServerRaster::redraw_request();
-				}
+				partition.particles.push_back(ins);
+			} else {
+				partition.geometry.push_back(ins);
 			}
 
 			if (geom->lighting_dirty) {
@@ -2091,30 +2366,260 @@ void RenderingServerScene::_prepare_scene(const Transform p_cam_transform, const
 				geom->gi_probes_dirty = false;
 			}
 
-			if (ins->last_frame_pass != frame_number && !ins->lightmap_target_sh.empty() && !ins->lightmap_sh.empty()) {
+			if (ins->last_frame_pass != p_data->frame_number && !ins->lightmap_target_sh.empty() && !ins->lightmap_sh.empty()) {
 				Color *sh = ins->lightmap_sh.ptrw();
 				const Color *target_sh = ins->lightmap_target_sh.ptr();
 				for (uint32_t j = 0; j < 9; j++) {
-					sh[j] = sh[j].lerp(target_sh[j], MIN(1.0, lightmap_probe_update_speed));
+					sh[j] = sh[j].lerp(target_sh[j], MIN(1.0, p_data->lightmap_probe_update_speed));
 				}
 			}
 
-			ins->depth = near_plane.distance_to(ins->transform.origin);
-			ins->depth_layer = CLAMP(int(ins->depth * 16 / z_far), 0, 15);
+			ins->depth = p_data->near_plane.distance_to(ins->transform.origin);
+			ins->depth_layer = CLAMP(int(ins->depth * 16 / p_data->z_far), 0, 15);
 		}
 
-		if (!keep) {
-			// remove, no reason to keep
-			instance_cull_count--;
-			SWAP(instance_cull_result[i], instance_cull_result[instance_cull_count]);
-			i--;
-			ins->last_render_pass = 0; // make invalid
-		} else {
-			ins->last_render_pass = render_pass;
+		ins->last_render_pass = keep ? render_pass : 0; // 0 makes it invalid
+		ins->last_frame_pass = p_data->frame_number;
+	}
+}
+
+void RenderingServerScene::_prepare_scene(const Transform p_cam_transform, const CameraMatrix &p_cam_projection, bool p_cam_orthogonal, bool p_cam_vaspect, RID p_render_buffers, RID p_environment, uint32_t p_visible_layers, RID p_scenario, RID p_shadow_atlas, RID p_reflection_probe, bool p_using_shadows) {
+	// Note, in stereo rendering:
+	// - p_cam_transform will be a transform in the middle of our two eyes
+	// - p_cam_projection is a wider frustrum that encompasses both eyes
+
+	Scenario *scenario = scenario_owner.getornull(p_scenario);
+
+	render_pass++;
+	uint32_t camera_layer_mask = p_visible_layers;
+
+	RSG::scene_render->set_scene_pass(render_pass);
+
+	if (p_render_buffers.is_valid()) {
+		RSG::scene_render->sdfgi_update(p_render_buffers, p_environment, p_cam_transform.origin); //update conditions for SDFGI (whether its used or not)
+	}
+
+	RENDER_TIMESTAMP("Frustum Culling");
+
+	//rasterizer->set_camera(camera->transform, camera_matrix,ortho);
+
+	Vector<Plane> planes = p_cam_projection.get_projection_planes(p_cam_transform);
+
+	Plane near_plane(p_cam_transform.origin, -p_cam_transform.basis.get_axis(2).normalized());
+	float z_far = p_cam_projection.get_z_far();
+
+	/* STEP 2 - CULL */
+
+	// Culling and the per-geometry work run over fixed size ranges of a candidate list,
+	// each range filling its own partition. Small scenarios take the candidates from the
+	// octree and stay on this thread. Large ones take them from the grid cells in view and
+	// test them in parallel instead, as the octree can't be culled from several threads
+	// (it marks elements with a shared pass counter).
+	Vector<Vector3> convex_points = Geometry3D::compute_convex_mesh_points(planes.ptr(), planes.size());
+
+	_scene_update_visibility_ranges(scenario, p_cam_transform.origin);
+
+	SceneCullData cull_data;
+	cull_data.scenario = scenario;
+	cull_data.planes = planes.ptr();
+	cull_data.plane_count = planes.size();
+	cull_data.points = convex_points.ptr();
+	cull_data.point_count = convex_points.size();
+	cull_data.camera_layer_mask = camera_layer_mask;
+	cull_data.frame_number = RSG::rasterizer->get_frame_number();
+	cull_data.lightmap_probe_update_speed = RSG::storage->lightmap_get_probe_capture_update_speed() * RSG::rasterizer->get_frame_delta_time();
+	cull_data.near_plane = near_plane;
+	cull_data.z_far = z_far;
+	cull_data.occlusion = nullptr;
+
+	if (occlusion_culling_enabled && !scenario->occluders.empty() && convex_points.size()) {
+		RENDER_TIMESTAMP("Occlusion Buffer");
+
+		int buffer_height = CLAMP(int(occlusion_buffer_width / p_cam_projection.get_aspect()), 1, occlusion_buffer_width * 4);
+		if (occlusion_buffer.get_width() != occlusion_buffer_width || occlusion_buffer.get_height() != buffer_height) {
+			occlusion_buffer.set_size(occlusion_buffer_width, buffer_height);
+		}
+		occlusion_buffer.begin(p_cam_transform, p_cam_projection);
+
+		for (List<Instance *>::Element *E = scenario->occluders.front(); E; E = E->next()) {
+			Instance *ins = E->get();
+			if (!ins->visible || (camera_layer_mask & ins->layer_mask) == 0) {
+				continue;
+			}
+			if (!ins->transformed_aabb.intersects_convex_shape(planes.ptr(), planes.size(), convex_points.ptr(), convex_points.size())) {
+				continue;
+			}
+
+			Occluder *occluder = occluder_owner.getornull(ins->base);
+			if (occluder && occluder->indices.size()) {
+				occlusion_buffer.draw_triangles(ins->transform, occluder->vertices.ptr(), occluder->indices.ptr(), occluder->indices.size());
+			}
+		}
+
+		if (!occlusion_buffer.is_empty()) {
+			cull_data.occlusion = &occlusion_buffer;
+		}
+	}
+
+	bool threaded = scenario->cull_instance_count >= cull_threaded_min_instances && scenario->cull_instance_count > CULL_PARTITION_SIZE;
+
+	if (!convex_points.size()) {
+		cull_candidates.clear();
+	} else if (threaded) {
+		cull_candidates.clear();
+		for (uint32_t i = 0; i < scenario->cull_cells.size(); i++) {
+			const Scenario::CullCell &cell = scenario->cull_cells[i];
+			if (cell.instances.empty() || (i > 0 && !cell.bounds.intersects_convex_shape(planes.ptr(), planes.size(), convex_points.ptr(), convex_points.size()))) {
+				continue;
+			}
+			uint32_t from = cull_candidates.size();
+			cull_candidates.resize(from + cell.instances.size());
+			memcpy(cull_candidates.ptr() + from, cell.instances.ptr(), cell.instances.size() * sizeof(Instance *));
+		}
+	} else {
+		// The result can't be larger than the octree contents, so it is never truncated.
+		cull_candidates.resize(scenario->cull_instance_count);
+		cull_candidates.resize(scenario->octree.cull_convex(planes, cull_candidates.ptr(), cull_candidates.size()));
+	}
+	cull_data.instances = cull_candidates.ptr();
+	cull_data.instance_count = cull_candidates.size();
+
+	uint32_t partition_count = (cull_data.instance_count + CULL_PARTITION_SIZE - 1) / CULL_PARTITION_SIZE;
+	if (cull_partitions.size() < partition_count) {
+		cull_partitions.resize(partition_count);
+	}
+
+	if (threaded && partition_count > 1) {
+		if (!cull_work_pool_started) {
+			cull_work_pool.init();
+			cull_work_pool_started = true;
+		}
+		cull_work_pool.do_work(partition_count, this, &RenderingServerScene::_scene_cull_partition, &cull_data);
+	} else {
+		for (uint32_t i = 0; i < partition_count; i++) {
+			_scene_cull_partition(i, &cull_data);
 		}
-		ins->last_frame_pass = frame_number;
 	}
 
+	instance_cull_result.clear();
+	light_cull_count = 0;
+
+	reflection_probe_cull_count = 0;
+	decal_cull_count = 0;
+	gi_probe_cull_count = 0;
+	lightmap_cull_count = 0;
+
+	/* STEP 3 - PROCESS PORTALS, VALIDATE ROOMS */
+	//removed, will replace with culling
+
+	/* STEP 4 - MERGE PARTITIONS, ADD LIGHTS */
+
+	bool redraw = false;
+
+	for (uint32_t p = 0; p < partition_count; p++) {
+		CullPartition &partition = cull_partitions[p];
+
+		for (uint32_t i = 0; i < partition.others.size(); i++) {
+			Instance *ins = partition.others[i];
+
+			if (ins->base_type == RS::INSTANCE_LIGHT) {
+				if (light_cull_count < MAX_LIGHTS_CULLED) {
+					InstanceLightData *light = static_cast<InstanceLightData *>(ins->base_data);
+
+					if (!light->geometries.empty()) {
+						//do not add this light if no geometry is affected by it..
+						light_cull_result[light_cull_count] = ins;
+						light_instance_cull_result[light_cull_count] = light->instance;
+						if (p_shadow_atlas.is_valid() && RSG::storage->light_has_shadow(ins->base)) {
+							RSG::scene_render->light_instance_mark_visible(light->instance); //mark it visible for shadow allocation later
+						}
+
+						light_cull_count++;
+					}
+				}
+			} else if (ins->base_type == RS::INSTANCE_REFLECTION_PROBE) {
+				if (reflection_probe_cull_count < MAX_REFLECTION_PROBES_CULLED) {
+					InstanceReflectionProbeData *reflection_probe = static_cast<InstanceReflectionProbeData *>(ins->base_data);
+
+					if (p_reflection_probe != reflection_probe->instance) {
+						//avoid entering The Matrix
+
+						if (!reflection_probe->geometries.empty()) {
+							//do not add this light if no geometry is affected by it..
+
+							if (reflection_probe->reflection_dirty || RSG::scene_render->reflection_probe_instance_needs_redraw(reflection_probe->instance)) {
+								if (!reflection_probe->update_list.in_list()) {
+									reflection_probe->render_step = 0;
+									reflection_probe_render_list.add_last(&reflection_probe->update_list);
+								}
+
+								reflection_probe->reflection_dirty = false;
+							}
+
+							if (RSG::scene_render->reflection_probe_instance_has_reflection(reflection_probe->instance)) {
+								reflection_probe_instance_cull_result[reflection_probe_cull_count] = reflection_probe->instance;
+								reflection_probe_cull_count++;
+							}
+						}
+					}
+				}
+			} else if (ins->base_type == RS::INSTANCE_DECAL) {
+				if (decal_cull_count < MAX_DECALS_CULLED) {
+					InstanceDecalData *decal = static_cast<InstanceDecalData *>(ins->base_data);
+
+					if (!decal->geometries.empty()) {
+						//do not add this decal if no geometry is affected by it..
+						decal_instance_cull_result[decal_cull_count] = decal->instance;
+						decal_cull_count++;
+					}
+				}
+
+			} else if (ins->base_type == RS::INSTANCE_GI_PROBE) {
+				InstanceGIProbeData *gi_probe = static_cast<InstanceGIProbeData *>(ins->base_data);
+				if (!gi_probe->update_element.in_list()) {
+					gi_probe_update_list.add(&gi_probe->update_element);
+				}
+
+				if (gi_probe_cull_count < MAX_GI_PROBES_CULLED) {
+					gi_probe_instance_cull_result[gi_probe_cull_count] = gi_probe->probe_instance;
+					gi_probe_cull_count++;
+				}
+			} else if (ins->base_type == RS::INSTANCE_LIGHTMAP) {
+				if (lightmap_cull_count < MAX_LIGHTMAPS_CULLED) {
+					lightmap_cull_result[lightmap_cull_count] = ins;
+					lightmap_cull_count++;
+				}
+			}
+		}
+
+		for (uint32_t i = 0; i < partition.particles.size(); i++) {
+			Instance *ins = partition.particles[i];
+
+			//particles visible? process them
+			if (RSG::storage->particles_is_inactive(ins->base)) {
+				//but if nothing is going on, don't do it.
+				ins->last_render_pass = 0; // make invalid
+			} else {
+				RSG::storage->particles_request_process(ins->base);
+				//particles visible? request redraw
+				redraw = true;
+				instance_cull_result.push_back(ins);
+			}
+		}
+
+		for (uint32_t i = 0; i < partition.geometry.size(); i++) {
+			instance_cull_result.push_back(partition.geometry[i]);
+		}
+
+		redraw = redraw || partition.redraw;
+	}
+
+	if (redraw) {
+		RenderingServerRaster::redraw_request();
+	}
+
+	instance_cull_count = instance_cull_result.size();
+
 	/* STEP 5 - PROCESS LIGHTS */
 
 	RID *directional_light_ptr = &light_instance_cull_result[light_cull_count];
@@ -2160,6 +2665,8 @@ void RenderingServerScene::_prepare_scene(const Transform p_cam_transform, const
 
 	if (p_using_shadows) { //setup shadow maps
 
+		shadow_redraw_lights.clear();
+
 		//SortArray<Instance*,_InstanceLightsort> sorter;
 		//sorter.sort(light_cull_result,light_cull_count);
 		for (int i = 0; i < light_cull_count; i++) {
@@ -2250,11 +2757,43 @@ void RenderingServerScene::_prepare_scene(const Transform p_cam_transform, const
 
 			if (redraw) {
 				//must redraw!
-				RENDER_TIMESTAMP(">Rendering Light " + itos(i));
-				light->shadow_dirty = _light_instance_update_shadow(ins, p_cam_transform, p_cam_projection, p_cam_orthogonal, p_cam_vaspect, p_shadow_atlas, scenario);
-				RENDER_TIMESTAMP("<Rendering Light " + itos(i));
+				shadow_redraw_lights.push_back(ins);
+			}
+		}
+
+		// Lights whose casters are unchanged (only the atlas slot or an animated material
+		// asked for a redraw) render their previous lists. The rest are culled together.
+		shadow_cull_lights.clear();
+		for (uint32_t i = 0; i < shadow_redraw_lights.size(); i++) {
+			Instance *ins = shadow_redraw_lights[i];
+			if (static_cast<InstanceLightData *>(ins->base_data)->shadow_casters_dirty) {
+				_light_instance_setup_shadow_passes(ins);
+				shadow_cull_lights.push_back(ins);
+			}
+		}
+
+		RENDER_TIMESTAMP("Culling Shadow Casters");
+
+		if (shadow_cull_lights.size() >= SHADOW_CULL_THREADED_MIN_LIGHTS) {
+			if (!cull_work_pool_started) {
+				cull_work_pool.init();
+				cull_work_pool_started = true;
+			}
+			cull_work_pool.do_work(shadow_cull_lights.size(), this, &RenderingServerScene::_light_instance_cull_shadow_casters, shadow_cull_lights.ptr());
+		} else {
+			for (uint32_t i = 0; i < shadow_cull_lights.size(); i++) {
+				_light_instance_cull_shadow_casters(i, shadow_cull_lights.ptr());
 			}
 		}
+
+		for (uint32_t i = 0; i < shadow_redraw_lights.size(); i++) {
+			Instance *ins = shadow_redraw_lights[i];
+			InstanceLightData *light = static_cast<InstanceLightData *>(ins->base_data);
+
+			RENDER_TIMESTAMP(">Rendering Light " + itos(i));
+			light->shadow_dirty = _light_instance_render_shadow_passes(ins, p_shadow_atlas);
+			RENDER_TIMESTAMP("<Rendering Light " + itos(i));
+		}
 	}
 
 	/* UPDATE SDFGI */
@@ -2279,7 +2818,8 @@ void RenderingServerScene::_prepare_scene(const Transform p_cam_transform, const
 				sdfgi_light_cull_pass++;
 				prev_cascade = region_cascade;
 			}
-			uint32_t sdfgi_cull_count = scenario->octree.cull_aabb(region, instance_shadow_cull_result, MAX_INSTANCE_CULL);
+			instance_shadow_cull_result.resize(scenario->cull_instance_count);
+			uint32_t sdfgi_cull_count = scenario->octree.cull_aabb(region, instance_shadow_cull_result.ptr(), instance_shadow_cull_result.size());
 
 			for (uint32_t j = 0; j < sdfgi_cull_count; j++) {
 				Instance *ins = instance_shadow_cull_result[j];
@@ -2311,7 +2851,7 @@ void RenderingServerScene::_prepare_scene(const Transform p_cam_transform, const
 				}
 			}
 
-			RSG::scene_render->render_sdfgi(p_render_buffers, i, (RasterizerScene::InstanceBase **)instance_shadow_cull_result, sdfgi_cull_count);
+			RSG::scene_render->render_sdfgi(p_render_buffers, i, (RasterizerScene::InstanceBase **)instance_shadow_cull_result.ptr(), sdfgi_cull_count);
 			//have to save updated cascades, then update static lights.
 		}
 
@@ -2356,7 +2896,7 @@ void RenderingServerScene::_render_scene(RID p_render_buffers, const Transform p
 	/* PROCESS GEOMETRY AND DRAW SCENE */
 
 	RENDER_TIMESTAMP("Render Scene ");
-	RSG::scene_render->render_scene(p_render_buffers, p_cam_transform, p_cam_projection, p_cam_orthogonal, (RasterizerScene::InstanceBase **)instance_cull_result, instance_cull_count, light_instance_cull_result, light_cull_count + directional_light_count, reflection_probe_instance_cull_result, reflection_probe_cull_count, gi_probe_instance_cull_result, gi_probe_cull_count, decal_instance_cull_result, decal_cull_count, (RasterizerScene::InstanceBase **)lightmap_cull_result, lightmap_cull_count, p_environment, camera_effects, p_shadow_atlas, p_reflection_probe.is_valid() ? RID() : scenario->reflection_atlas, p_reflection_probe, p_reflection_probe_pass);
+	RSG::scene_render->render_scene(p_render_buffers, p_cam_transform, p_cam_projection, p_cam_orthogonal, (RasterizerScene::InstanceBase **)instance_cull_result.ptr(), instance_cull_count, light_instance_cull_result, light_cull_count + directional_light_count, reflection_probe_instance_cull_result, reflection_probe_cull_count, gi_probe_instance_cull_result, gi_probe_cull_count, decal_instance_cull_result, decal_cull_count, (RasterizerScene::InstanceBase **)lightmap_cull_result, lightmap_cull_count, p_environment, camera_effects, p_shadow_atlas, p_reflection_probe.is_valid() ? RID() : scenario->reflection_atlas, p_reflection_probe, p_reflection_probe_pass);
 }
 
 void RenderingServerScene::render_empty_scene(RID p_render_buffers, RID p_scenario, RID p_shadow_atlas) {
@@ -2642,35 +3182,34 @@ void RenderingServerScene::render_probes() {
 			update_lights = true;
 		}
 
-		instance_cull_count = 0;
+		instance_cull_result.clear();
 		for (List<InstanceGIProbeData::PairInfo>::Element *E = probe->dynamic_geometries.front(); E; E = E->next()) {
-			if (instance_cull_count < MAX_INSTANCE_CULL) {
-				Instance *ins = E->get().geometry;
-				if (!ins->visible) {
-					continue;
-				}
-				InstanceGeometryData *geom = (InstanceGeometryData *)ins->base_data;
-
-				if (geom->gi_probes_dirty) {
-					//giprobes may be dirty, so update
-					int l = 0;
-					//only called when reflection probe AABB enter/exit this geometry
-					ins->gi_probe_instances.resize(geom->gi_probes.size());
+			Instance *ins = E->get().geometry;
+			if (!ins->visible) {
+				continue;
+			}
+			InstanceGeometryData *geom = (InstanceGeometryData *)ins->base_data;
 
-					for (List<Instance *>::Element *F = geom->gi_probes.front(); F; F = F->next()) {
-						InstanceGIProbeData *gi_probe2 = static_cast<InstanceGIProbeData *>(F->get()->base_data);
+			if (geom->gi_probes_dirty) {
+				//giprobes may be dirty, so update
+				int l = 0;
+				//only called when reflection probe AABB enter/exit this geometry
+				ins->gi_probe_instances.resize(geom->gi_probes.size());
 
-						ins->gi_probe_instances.write[l++] = gi_probe2->probe_instance;
-					}
+				for (List<Instance *>::Element *F = geom->gi_probes.front(); F; F = F->next()) {
+					InstanceGIProbeData *gi_probe2 = static_cast<InstanceGIProbeData *>(F->get()->base_data);
 
-					geom->gi_probes_dirty = false;
+					ins->gi_probe_instances.write[l++] = gi_probe2->probe_instance;
 				}
 
-				instance_cull_result[instance_cull_count++] = E->get().geometry;
+				geom->gi_probes_dirty = false;
 			}
+
+			instance_cull_result.push_back(E->get().geometry);
 		}
+		instance_cull_count = instance_cull_result.size();
 
-		RSG::scene_render->gi_probe_update(probe->probe_instance, update_lights, probe->light_instances, instance_cull_count, (RasterizerScene::InstanceBase **)instance_cull_result);
+		RSG::scene_render->gi_probe_update(probe->probe_instance, update_lights, probe->light_instances, instance_cull_count, (RasterizerScene::InstanceBase **)instance_cull_result.ptr());
 
 		gi_probe_update_list.remove(gi_probe);
 
@@ -2881,6 +3420,7 @@ void RenderingServerScene::_update_dirty_instance(Instance *p_instance) {
 				for (List<Instance *>::Element *E = geom->lighting.front(); E; E = E->next()) {
 					InstanceLightData *light = static_cast<InstanceLightData *>(E->get()->base_data);
 					light->shadow_dirty = true;
+					light->shadow_casters_dirty = true;
 				}
 
 				geom->can_cast_shadows = can_cast_shadows;
@@ -2935,6 +3475,15 @@ bool RenderingServerScene::free(RID p_rid) {
 		camera_owner.free(p_rid);
 		memdelete(camera);
 
+	} else if (occluder_owner.owns(p_rid)) {
+		Occluder *occluder = occluder_owner.getornull(p_rid);
+
+		while (occluder->users.front()) {
+			instance_set_base(occluder->users.front()->get()->self, RID());
+		}
+		occluder_owner.free(p_rid);
+		memdelete(occluder);
+
 	} else if (scenario_owner.owns(p_rid)) {
 		Scenario *scenario = scenario_owner.getornull(p_rid);
 
@@ -2954,6 +3503,10 @@ bool RenderingServerScene::free(RID p_rid) {
 		Instance *instance = instance_owner.getornull(p_rid);
 
 		instance_geometry_set_lightmap(p_rid, RID(), Rect2(), 0);
+		instance_set_visibility_parent(p_rid, RID());
+		while (instance->visibility_children.size()) {
+			instance_set_visibility_parent(instance->visibility_children[0]->self, RID());
+		}
 		instance_set_scenario(p_rid, RID());
 		instance_set_base(p_rid, RID());
 		instance_geometry_set_material_override(p_rid, RID());
@@ -2983,7 +3536,19 @@ RenderingServerScene *RenderingServerScene::singleton = nullptr;
 RenderingServerScene::RenderingServerScene() {
 	render_pass = 1;
 	singleton = this;
+
+	cull_threaded_min_instances = GLOBAL_DEF("rendering/quality/culling/threaded_cull_minimum_instances", 4096);
+	ProjectSettings::get_singleton()->set_custom_property_info("rendering/quality/culling/threaded_cull_minimum_instances", PropertyInfo(Variant::INT, "rendering/quality/culling/threaded_cull_minimum_instances", PROPERTY_HINT_RANGE, "0,65536,1,or_greater"));
+	cull_cell_size = MAX(real_t(GLOBAL_DEF("rendering/quality/culling/threaded_cull_cell_size", 32.0)), real_t(0.01));
+	ProjectSettings::get_singleton()->set_custom_property_info("rendering/quality/culling/threaded_cull_cell_size", PropertyInfo(Variant::FLOAT, "rendering/quality/culling/threaded_cull_cell_size", PROPERTY_HINT_RANGE, "0.01,1024,0.01,or_greater"));
+
+	occlusion_culling_enabled = GLOBAL_DEF("rendering/quality/culling/use_occlusion_culling", true);
+	occlusion_buffer_width = GLOBAL_DEF("rendering/quality/culling/occlusion_buffer_width", 256);
+	ProjectSettings::get_singleton()->set_custom_property_info("rendering/quality/culling/occlusion_buffer_width", PropertyInfo(Variant::INT, "rendering/quality/culling/occlusion_buffer_width", PROPERTY_HINT_RANGE, "32,1024,1"));
 }
 
 RenderingServerScene::~RenderingServerScene() {
+	if (cull_work_pool_started) {
+		cull_work_pool.finish();
+	}
 }
@@ -33,6 +33,7 @@
 
 #include "servers/rendering/rasterizer.h"
 
+#include "core/hash_map.h"
 #include "core/local_vector.h"
 #include "core/math/geometry_3d.h"
 #include "core/math/octree.h"
@@ -40,13 +41,14 @@
 #include "core/os/thread.h"
 #include "core/rid_owner.h"
 #include "core/self_list.h"
+#include "core/thread_work_pool.h"
+#include "servers/rendering/occlusion_buffer_sw.h"
 #include "servers/xr/xr_interface.h"
 
 class RenderingServerScene {
 public:
 	enum {
 
-		MAX_INSTANCE_CULL = 65536,
 		MAX_LIGHTS_CULLED = 4096,
 		MAX_REFLECTION_PROBES_CULLED = 4096,
 		MAX_DECALS_CULLED = 4096,
@@ -54,6 +56,8 @@ public:
 		MAX_ROOM_CULL = 32,
 		MAX_LIGHTMAPS_CULLED = 4096,
 		MAX_EXTERIOR_PORTALS = 128,
+		CULL_PARTITION_SIZE = 1024, // instances per scene culling job
+		SHADOW_CULL_THREADED_MIN_LIGHTS = 4, // shadow lights to re-cull before using the work pool
 	};
 
 	uint64_t render_pass;
@@ -104,10 +108,28 @@ public:
 	virtual void camera_set_camera_effects(RID p_camera, RID p_fx);
 	virtual void camera_set_use_vertical_aspect(RID p_camera, bool p_enable);
 
-	/* SCENARIO API */
+	/* OCCLUDER API */
 
 	struct Instance;
 
+	struct Occluder {
+		LocalVector<Vector3> vertices;
+		LocalVector<uint32_t> indices;
+		AABB aabb;
+		Set<Instance *> users;
+	};
+
+	mutable RID_PtrOwner<Occluder> occluder_owner;
+
+	virtual RID occluder_create();
+	virtual void occluder_set_mesh(RID p_occluder, const PackedVector3Array &p_vertices, const PackedInt32Array &p_indices);
+
+	OcclusionBufferSW occlusion_buffer;
+	bool occlusion_culling_enabled;
+	int occlusion_buffer_width;
+
+	/* SCENARIO API */
+
 	struct Scenario {
 		RS::ScenarioDebugMode debug;
 		RID self;
@@ -115,6 +137,7 @@ public:
 		Octree<Instance, true> octree;
 
 		List<Instance *> directional_lights;
+		List<Instance *> occluders;
 		RID environment;
 		RID fallback_environment;
 		RID camera_effects;
@@ -122,10 +145,25 @@ public:
 		RID reflection_atlas;
 
 		SelfList<Instance>::List instances;
+		// Loose grid over the octree contents, culled in parallel by _prepare_scene in large
+		// scenarios. Instances sit in the cell holding the center of their AABB, which can
+		// stick out of it by up to half a cell. Those larger than a cell go in the first one.
+		struct CullCell {
+			AABB bounds; // the cell grown by half its size on each side
+			LocalVector<Instance *> instances;
+		};
+		LocalVector<CullCell> cull_cells;
+		HashMap<uint64_t, uint32_t> cull_cell_map;
+		uint32_t cull_instance_count = 0;
+		SelfList<Instance>::List visibility_range_instances; // instances with a draw range, a visibility parent or children
+		bool visibility_ranges_changed = false; // a hidden subtree may have new members, walk it again
 
 		LocalVector<RID> dynamic_lights;
 
-		Scenario() { debug = RS::SCENARIO_DEBUG_DISABLED; }
+		Scenario() {
+			debug = RS::SCENARIO_DEBUG_DISABLED;
+			cull_cells.resize(1); // oversized instances, never culled as a whole
+		}
 	};
 
 	mutable RID_PtrOwner<Scenario> scenario_owner;
@@ -147,10 +185,18 @@ public:
 		virtual ~InstanceBaseData() {}
 	};
 
+	enum VisibilityRangeState {
+		VISIBILITY_RANGE_VISIBLE,
+		VISIBILITY_RANGE_TOO_CLOSE,
+		VISIBILITY_RANGE_TOO_FAR,
+	};
+
 	struct Instance : RasterizerScene::InstanceBase {
 		RID self;
 		//scenario stuff
 		OctreeElementID octree_id;
+		int32_t cull_cell;
+		int32_t cull_index;
 		Scenario *scenario;
 		SelfList<Instance> scenario_item;
 
@@ -168,7 +214,15 @@ public:
 		float lod_end;
 		float lod_begin_hysteresis;
 		float lod_end_hysteresis;
-		RID lod_instance;
+
+		// Hierarchical LOD: an instance with a visibility parent is only drawn
+		// while the parent is hidden for being closer than its begin distance.
+		Instance *visibility_parent;
+		LocalVector<Instance *> visibility_children;
+		SelfList<Instance> visibility_range_item;
+		uint8_t visibility_range_state;
+		bool visibility_range_culled; // hidden by its own range or by an ancestor
+		bool visibility_parent_culled; // hidden by an ancestor only
 
 		Vector<Color> lightmap_target_sh; //target is used for incrementally changing the SH over time, this avoids pops in some corner cases and when going interior <-> exterior
 
@@ -195,8 +249,11 @@ public:
 
 		Instance() :
 				scenario_item(this),
-				update_item(this) {
+				update_item(this),
+				visibility_range_item(this) {
 			octree_id = 0;
+			cull_cell = -1;
+			cull_index = -1;
 			scenario = nullptr;
 
 			update_aabb = false;
@@ -211,6 +268,11 @@ public:
 			lod_begin_hysteresis = 0;
 			lod_end_hysteresis = 0;
 
+			visibility_parent = nullptr;
+			visibility_range_state = VISIBILITY_RANGE_VISIBLE;
+			visibility_range_culled = false;
+			visibility_parent_culled = false;
+
 			last_render_pass = 0;
 			last_frame_pass = 0;
 			version = 1;
@@ -232,6 +294,12 @@ public:
 	SelfList<Instance>::List _instance_update_list;
 	void _instance_queue_update(Instance *p_instance, bool p_update_aabb, bool p_update_dependencies = false);
 
+	// These only touch the instances and their scenario, so they can be run on a bare hierarchy.
+	static void _instance_link_visibility_parent(Instance *p_instance, Instance *p_parent);
+	static void _instance_update_visibility_range_list(Instance *p_instance);
+	static void _instance_update_visibility_range(Instance *p_instance, const Vector3 &p_camera_position, bool p_parent_culled, bool p_walk_hidden);
+	static void _scene_update_visibility_ranges(Scenario *p_scenario, const Vector3 &p_camera_position);
+
 	struct InstanceGeometryData : public InstanceBaseData {
 		List<Instance *> lighting;
 		bool lighting_dirty;
@@ -303,12 +371,31 @@ public:
 			Instance *geometry;
 		};
 
+		struct ShadowPass {
+			CameraMatrix projection;
+			Transform transform;
+			Plane near_plane;
+			Vector<Plane> planes;
+			Vector<Vector3> points;
+			LocalVector<Instance *> casters;
+		};
+
 		RID instance;
 		uint64_t last_version;
 		List<Instance *>::Element *D; // directional light in scenario
 
 		bool shadow_dirty;
 
+		// Omni and spot shadow passes. Casters only depend on the light and the geometry
+		// paired with it, so the lists are kept until either of them changes.
+		ShadowPass shadow_passes[6];
+		uint32_t shadow_pass_count = 0;
+		Transform shadow_light_transform;
+		real_t shadow_range = 0;
+		bool shadow_cube = false;
+		bool shadow_casters_dirty = true;
+		bool shadow_casters_animated = false;
+
 		List<PairInfo> geometries;
 
 		Instance *baked_light;
@@ -372,6 +459,10 @@ public:
 
 	SelfList<InstanceGIProbeData>::List gi_probe_update_list;
 
+	struct InstanceOccluderData : public InstanceBaseData {
+		List<Instance *>::Element *E = nullptr; // in the scenario's occluder list
+	};
+
 	struct InstanceLightmapData : public InstanceBaseData {
 		struct PairInfo {
 			List<Instance *>::Element *L; //iterator in geometry
@@ -386,8 +477,8 @@ public:
 	};
 
 	int instance_cull_count;
-	Instance *instance_cull_result[MAX_INSTANCE_CULL];
-	Instance *instance_shadow_cull_result[MAX_INSTANCE_CULL]; //used for generating shadowmaps
+	LocalVector<Instance *> instance_cull_result;
+	LocalVector<Instance *> instance_shadow_cull_result; //used for generating shadowmaps, sized to the octree contents
 	Instance *light_cull_result[MAX_LIGHTS_CULLED];
 	RID sdfgi_light_cull_result[MAX_LIGHTS_CULLED];
 	RID light_instance_cull_result[MAX_LIGHTS_CULLED];
@@ -411,6 +502,7 @@ public:
 	virtual void instance_set_scenario(RID p_instance, RID p_scenario);
 	virtual void instance_set_layer_mask(RID p_instance, uint32_t p_mask);
 	virtual void instance_set_transform(RID p_instance, const Transform &p_transform);
+	virtual void instances_set_transforms(const Vector<RID> &p_instances, const Vector<Transform> &p_transforms);
 	virtual void instance_attach_object_instance_id(RID p_instance, ObjectID p_id);
 	virtual void instance_set_blend_shape_weight(RID p_instance, int p_shape, float p_weight);
 	virtual void instance_set_surface_material(RID p_instance, int p_surface, RID p_material);
@@ -434,6 +526,7 @@ public:
 
 	virtual void instance_geometry_set_draw_range(RID p_instance, float p_min, float p_max, float p_min_margin, float p_max_margin);
 	virtual void instance_geometry_set_as_instance_lod(RID p_instance, RID p_as_lod_of_instance);
+	virtual void instance_set_visibility_parent(RID p_instance, RID p_parent_instance);
 	virtual void instance_geometry_set_lightmap(RID p_instance, RID p_lightmap, const Rect2 &p_lightmap_uv_scale, int p_slice_index);
 
 	void _update_instance_shader_parameters_from_material(Map<StringName, RasterizerScene::InstanceBase::InstanceShaderParameter> &isparams, const Map<StringName, RasterizerScene::InstanceBase::InstanceShaderParameter> &existing_isparams, RID p_material);
@@ -449,10 +542,52 @@ public:
 	_FORCE_INLINE_ void _update_instance_lightmap_captures(Instance *p_instance);
 
 	_FORCE_INLINE_ bool _light_instance_update_shadow(Instance *p_instance, const Transform p_cam_transform, const CameraMatrix &p_cam_projection, bool p_cam_orthogonal, bool p_cam_vaspect, RID p_shadow_atlas, Scenario *p_scenario);
+	void _light_instance_setup_shadow_passes(Instance *p_instance);
+	void _light_instance_cull_shadow_casters(uint32_t p_index, Instance **p_lights);
+	bool _light_instance_render_shadow_passes(Instance *p_instance, RID p_shadow_atlas);
 
 	RID _render_get_environment(RID p_camera, RID p_scenario);
 
 	bool _render_reflection_probe_step(Instance *p_instance, int p_step);
+	struct CullPartition {
+		LocalVector<Instance *> geometry;
+		LocalVector<Instance *> particles; // need the storage, so they are resolved on the render thread
+		LocalVector<Instance *> others; // lights, probes, decals and lightmaps, classified on the render thread
+		bool redraw = false;
+	};
+
+	struct SceneCullData {
+		Scenario *scenario;
+		Instance *const *instances; // candidates split into partitions, from the octree or the grid cells in view
+		uint32_t instance_count;
+		const Plane *planes;
+		int plane_count;
+		const Vector3 *points;
+		int point_count;
+		uint32_t camera_layer_mask;
+		uint64_t frame_number;
+		float lightmap_probe_update_speed;
+		Plane near_plane;
+		float z_far;
+		const OcclusionBufferSW *occlusion; // nullptr when nothing occludes
+	};
+
+	LocalVector<CullPartition> cull_partitions;
+	LocalVector<Instance *> cull_candidates;
+	ThreadWorkPool cull_work_pool;
+	bool cull_work_pool_started = false;
+	uint32_t cull_threaded_min_instances;
+	real_t cull_cell_size;
+
+	uint32_t _scenario_cull_get_cell(Scenario *p_scenario, const AABB &p_aabb);
+	void _scenario_cull_add(Instance *p_instance);
+	void _scenario_cull_remove(Instance *p_instance);
+	void _scenario_cull_move(Instance *p_instance);
+	void _scene_cull_partition(uint32_t p_partition, SceneCullData *p_data);
+
+	LocalVector<Instance *> shadow_redraw_lights;
+	LocalVector<Instance *> shadow_cull_lights;
+
 	void _prepare_scene(const Transform p_cam_transform, const CameraMatrix &p_cam_projection, bool p_cam_orthogonal, bool p_cam_vaspect, RID p_render_buffers, RID p_environment, uint32_t p_visible_layers, RID p_scenario, RID p_shadow_atlas, RID p_reflection_probe, bool p_using_shadows = true);
 	void _render_scene(RID p_render_buffers, const Transform p_cam_transform, const CameraMatrix &p_cam_projection, bool p_cam_orthogonal, RID p_environment, RID p_force_camera_effects, RID p_scenario, RID p_shadow_atlas, RID p_reflection_probe, int p_reflection_probe_pass);
 	void render_empty_scene(RID p_render_buffers, RID p_scenario, RID p_shadow_atlas);
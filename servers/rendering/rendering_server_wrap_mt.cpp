@@ -125,6 +125,7 @@ void RenderingServerWrapMT::finish() {
 	lightmap_free_cached_ids();
 	particles_free_cached_ids();
 	camera_free_cached_ids();
+	occluder_free_cached_ids();
 	viewport_free_cached_ids();
 	environment_free_cached_ids();
 	camera_effects_free_cached_ids();
@@ -69,6 +69,12 @@ class RenderingServerWrapMT : public RenderingServer {
 #else
 #define SYNC_DEBUG
 #endif
+#define SERVER_WAIT_CHECK(m_ret)
+#define SERVER_DIRECT_CALL
+#define SERVER_POOL_REFILL(m_allocn)                                     \
+	int ret;                                                             \
+	command_queue.push_and_ret(this, &ServerNameWrapMT::m_allocn, &ret); \
+	SYNC_DEBUG
 
 public:
 #define ServerName RenderingServer
@@ -116,6 +122,9 @@ public:
 
 	FUNC2(texture_set_force_redraw_if_visible, RID, bool)
 
+	FUNC2(texture_set_streaming_feedback, RID, bool)
+	FUNC1R(Vector<int>, texture_get_streaming_demand, const Vector<RID> &)
+
 	/* SHADER API */
 
 	FUNCRID(shader)
@@ -380,6 +389,11 @@ public:
 	FUNC2(camera_set_camera_effects, RID, RID)
 	FUNC2(camera_set_use_vertical_aspect, RID, bool)
 
+	/* OCCLUDER API */
+
+	FUNCRID(occluder)
+	FUNC3(occluder_set_mesh, RID, const PackedVector3Array &, const PackedInt32Array &)
+
 	/* VIEWPORT TARGET API */
 
 	FUNCRID(viewport)
@@ -519,6 +533,7 @@ public:
 	FUNC2(instance_set_scenario, RID, RID)
 	FUNC2(instance_set_layer_mask, RID, uint32_t)
 	FUNC2(instance_set_transform, RID, const Transform &)
+	FUNC2(instances_set_transforms, const Vector<RID> &, const Vector<Transform> &)
 	FUNC2(instance_attach_object_instance_id, RID, ObjectID)
 	FUNC3(instance_set_blend_shape_weight, RID, int, float)
 	FUNC3(instance_set_surface_material, RID, int, RID)
@@ -542,6 +557,7 @@ public:
 
 	FUNC5(instance_geometry_set_draw_range, RID, float, float, float, float)
 	FUNC2(instance_geometry_set_as_instance_lod, RID, RID)
+	FUNC2(instance_set_visibility_parent, RID, RID)
 	FUNC4(instance_geometry_set_lightmap, RID, RID, const Rect2 &, int)
 
 	FUNC3(instance_geometry_set_shader_parameter, RID, const StringName &, const Variant &)
@@ -742,5 +758,8 @@ public:
 #undef DEBUG_SYNC
 #endif
 #undef SYNC_DEBUG
+#undef SERVER_WAIT_CHECK
+#undef SERVER_DIRECT_CALL
+#undef SERVER_POOL_REFILL
 
 #endif
@@ -105,6 +105,34 @@ Array RenderingServer::_instances_cull_convex_bind(const Array &p_convex, RID p_
 	return to_array(ids);
 }
 
+void RenderingServer::_instances_set_transforms_bind(const Array &p_instances, const Vector<float> &p_transforms) {
+	int count = p_instances.size();
+	ERR_FAIL_COND(p_transforms.size() != count * 12);
+
+	Vector<RID> instances;
+	instances.resize(count);
+	Vector<Transform> transforms;
+	transforms.resize(count);
+
+	RID *instances_ptr = instances.ptrw();
+	Transform *transforms_ptr = transforms.ptrw();
+	const float *r = p_transforms.ptr();
+
+	//same layout as multimesh transforms
+	for (int i = 0; i < count; i++) {
+		instances_ptr[i] = p_instances[i];
+
+		const float *f = &r[i * 12];
+		Transform &t = transforms_ptr[i];
+		t.basis.elements[0] = Vector3(f[0], f[1], f[2]);
+		t.basis.elements[1] = Vector3(f[4], f[5], f[6]);
+		t.basis.elements[2] = Vector3(f[8], f[9], f[10]);
+		t.origin = Vector3(f[3], f[7], f[11]);
+	}
+
+	instances_set_transforms(instances, transforms);
+}
+
 RID RenderingServer::get_test_texture() {
 	if (test_texture.is_valid()) {
 		return test_texture;
@@ -1372,7 +1400,7 @@ Dictionary RenderingServer::mesh_surface_get_lods(RID p_mesh, int p_surface) con
 			const uint16_t *rptr = (const uint16_t *)r;
 			int *w = lods.ptrw();
 			for (uint32_t j = 0; j < lc; j++) {
-				w[j] = rptr[i];
+				w[j] = rptr[j];
 			}
 		} else {
 			uint32_t lc = sd.lods[i].index_data.size() / 4;
@@ -1381,7 +1409,7 @@ Dictionary RenderingServer::mesh_surface_get_lods(RID p_mesh, int p_surface) con
 			const uint32_t *rptr = (const uint32_t *)r;
 			int *w = lods.ptrw();
 			for (uint32_t j = 0; j < lc; j++) {
-				w[j] = rptr[i];
+				w[j] = rptr[j];
 			}
 		}
 
@@ -1705,6 +1733,9 @@ void RenderingServer::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("camera_set_environment", "camera", "env"), &RenderingServer::camera_set_environment);
 	ClassDB::bind_method(D_METHOD("camera_set_use_vertical_aspect", "camera", "enable"), &RenderingServer::camera_set_use_vertical_aspect);
 
+	ClassDB::bind_method(D_METHOD("occluder_create"), &RenderingServer::occluder_create);
+	ClassDB::bind_method(D_METHOD("occluder_set_mesh", "occluder", "vertices", "indices"), &RenderingServer::occluder_set_mesh);
+
 	ClassDB::bind_method(D_METHOD("viewport_create"), &RenderingServer::viewport_create);
 	ClassDB::bind_method(D_METHOD("viewport_set_use_xr", "viewport", "use_xr"), &RenderingServer::viewport_set_use_xr);
 	ClassDB::bind_method(D_METHOD("viewport_set_size", "viewport", "width", "height"), &RenderingServer::viewport_set_size);
@@ -1762,6 +1793,7 @@ void RenderingServer::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("instance_set_scenario", "instance", "scenario"), &RenderingServer::instance_set_scenario);
 	ClassDB::bind_method(D_METHOD("instance_set_layer_mask", "instance", "mask"), &RenderingServer::instance_set_layer_mask);
 	ClassDB::bind_method(D_METHOD("instance_set_transform", "instance", "transform"), &RenderingServer::instance_set_transform);
+	ClassDB::bind_method(D_METHOD("instances_set_transforms", "instances", "transforms"), &RenderingServer::_instances_set_transforms_bind);
 	ClassDB::bind_method(D_METHOD("instance_attach_object_instance_id", "instance", "id"), &RenderingServer::instance_attach_object_instance_id);
 	ClassDB::bind_method(D_METHOD("instance_set_blend_shape_weight", "instance", "shape", "weight"), &RenderingServer::instance_set_blend_shape_weight);
 	ClassDB::bind_method(D_METHOD("instance_set_surface_material", "instance", "surface", "material"), &RenderingServer::instance_set_surface_material);
@@ -1776,6 +1808,7 @@ void RenderingServer::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("instance_geometry_set_material_override", "instance", "material"), &RenderingServer::instance_geometry_set_material_override);
 	ClassDB::bind_method(D_METHOD("instance_geometry_set_draw_range", "instance", "min", "max", "min_margin", "max_margin"), &RenderingServer::instance_geometry_set_draw_range);
 	ClassDB::bind_method(D_METHOD("instance_geometry_set_as_instance_lod", "instance", "as_lod_of_instance"), &RenderingServer::instance_geometry_set_as_instance_lod);
+	ClassDB::bind_method(D_METHOD("instance_set_visibility_parent", "instance", "parent"), &RenderingServer::instance_set_visibility_parent);
 
 	ClassDB::bind_method(D_METHOD("instances_cull_aabb", "aabb", "scenario"), &RenderingServer::_instances_cull_aabb_bind, DEFVAL(RID()));
 	ClassDB::bind_method(D_METHOD("instances_cull_ray", "from", "to", "scenario"), &RenderingServer::_instances_cull_ray_bind, DEFVAL(RID()));
@@ -2152,6 +2185,7 @@ void RenderingServer::_bind_methods() {
 	BIND_ENUM_CONSTANT(INSTANCE_DECAL);
 	BIND_ENUM_CONSTANT(INSTANCE_GI_PROBE);
 	BIND_ENUM_CONSTANT(INSTANCE_LIGHTMAP);
+	BIND_ENUM_CONSTANT(INSTANCE_OCCLUDER);
 	BIND_ENUM_CONSTANT(INSTANCE_MAX);
 	BIND_ENUM_CONSTANT(INSTANCE_GEOMETRY_MASK);
 
@@ -2238,6 +2272,9 @@ void RenderingServer::_bind_methods() {
 	BIND_ENUM_CONSTANT(INFO_VIDEO_MEM_USED);
 	BIND_ENUM_CONSTANT(INFO_TEXTURE_MEM_USED);
 	BIND_ENUM_CONSTANT(INFO_VERTEX_MEM_USED);
+	BIND_ENUM_CONSTANT(INFO_2D_ITEMS_IN_FRAME);
+	BIND_ENUM_CONSTANT(INFO_2D_DRAW_CALLS_IN_FRAME);
+	BIND_ENUM_CONSTANT(INFO_2D_BATCHED_COMMANDS_IN_FRAME);
 
 	BIND_ENUM_CONSTANT(FEATURE_SHADERS);
 	BIND_ENUM_CONSTANT(FEATURE_MULTITHREADED);
@@ -2361,6 +2398,13 @@ RenderingServer::RenderingServer() {
 	GLOBAL_DEF("rendering/quality/shading/force_blinn_over_ggx", false);
 	GLOBAL_DEF("rendering/quality/shading/force_blinn_over_ggx.mobile", true);
 
+	GLOBAL_DEF("rendering/quality/2d/use_batching", true);
+	GLOBAL_DEF("rendering/quality/2d/batching_max_rects", 16384);
+	ProjectSettings::get_singleton()->set_custom_property_info("rendering/quality/2d/batching_max_rects", PropertyInfo(Variant::INT, "rendering/quality/2d/batching_max_rects", PROPERTY_HINT_RANGE, "1024,262144,1"));
+
+	GLOBAL_DEF("rendering/quality/mesh_lod/threshold_pixels", 1.0);
+	ProjectSettings::get_singleton()->set_custom_property_info("rendering/quality/mesh_lod/threshold_pixels", PropertyInfo(Variant::FLOAT, "rendering/quality/mesh_lod/threshold_pixels", PROPERTY_HINT_RANGE, "0,1024,0.1"));
+
 	GLOBAL_DEF("rendering/quality/depth_prepass/enable", true);
 	GLOBAL_DEF("rendering/quality/depth_prepass/disable_for_vendors", "PowerVR,Mali,Adreno,Apple");
 
@@ -2399,6 +2443,7 @@ RenderingServer::RenderingServer() {
 	ProjectSettings::get_singleton()->set_custom_property_info("rendering/quality/subsurface_scattering/subsurface_scattering_depth_scale", PropertyInfo(Variant::FLOAT, "rendering/quality/subsurface_scattering/subsurface_scattering_depth_scale", PROPERTY_HINT_RANGE, "0.001,1,0.001"));
 
 	GLOBAL_DEF("rendering/high_end/global_shader_variables_buffer_size", 65536);
+	GLOBAL_DEF("rendering/high_end/shader_cache/enabled", true);
 
 	GLOBAL_DEF("rendering/lightmapper/probe_capture_update_speed", 15);
 	ProjectSettings::get_singleton()->set_custom_property_info("rendering/lightmapper/probe_capture_update_speed", PropertyInfo(Variant::FLOAT, "rendering/lightmapper/probe_capture_update_speed", PROPERTY_HINT_RANGE, "0.001,256,0.001"));
@@ -28,167 +28,170 @@
 /* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
 /*************************************************************************/
 
+// Wrappers define SYNC_DEBUG, SERVER_WAIT_CHECK, SERVER_DIRECT_CALL and SERVER_POOL_REFILL
+// before including this. SERVER_WAIT_CHECK(m_ret) runs before a call from another thread
+// waits on the server, and SERVER_DIRECT_CALL before a call made straight to the server from
+// the thread that owns it. SERVER_POOL_REFILL(m_allocn) refills an empty RID pool for another
+// thread, with alloc_mutex held.
+
 #define FUNC0R(m_r, m_type)                                                     \
 	virtual m_r m_type() {                                                      \
 		if (Thread::get_caller_id() != server_thread) {                         \
+			SERVER_WAIT_CHECK(m_r())                                            \
 			m_r ret;                                                            \
 			command_queue.push_and_ret(server_name, &ServerName::m_type, &ret); \
 			SYNC_DEBUG                                                          \
 			return ret;                                                         \
 		} else {                                                                \
+			SERVER_DIRECT_CALL                                                  \
 			return server_name->m_type();                                       \
 		}                                                                       \
 	}
 
-#define FUNCRID(m_type)                                                                    \
-	List<RID> m_type##_id_pool;                                                            \
-	int m_type##allocn() {                                                                 \
-		for (int i = 0; i < pool_max_size; i++) {                                          \
-			m_type##_id_pool.push_back(server_name->m_type##_create());                    \
-		}                                                                                  \
-		return 0;                                                                          \
-	}                                                                                      \
-	void m_type##_free_cached_ids() {                                                      \
-		while (m_type##_id_pool.size()) {                                                  \
-			server_name->free(m_type##_id_pool.front()->get());                            \
-			m_type##_id_pool.pop_front();                                                  \
-		}                                                                                  \
-	}                                                                                      \
-	virtual RID m_type##_create() {                                                        \
-		if (Thread::get_caller_id() != server_thread) {                                    \
-			RID rid;                                                                       \
-			MutexLock lock(alloc_mutex);                                                   \
-			if (m_type##_id_pool.size() == 0) {                                            \
-				int ret;                                                                   \
-				command_queue.push_and_ret(this, &ServerNameWrapMT::m_type##allocn, &ret); \
-				SYNC_DEBUG                                                                 \
-			}                                                                              \
-			rid = m_type##_id_pool.front()->get();                                         \
-			m_type##_id_pool.pop_front();                                                  \
-			return rid;                                                                    \
-		} else {                                                                           \
-			return server_name->m_type##_create();                                         \
-		}                                                                                  \
-	}
-
-#define FUNC1RID(m_type, m_arg1)                                                               \
-	int m_type##allocn() {                                                                     \
-		for (int i = 0; i < m_type##_pool_max_size; i++) {                                     \
-			m_type##_id_pool.push_back(server_name->m_type##_create());                        \
-		}                                                                                      \
-		return 0;                                                                              \
-	}                                                                                          \
-	void m_type##_free_cached_ids() {                                                          \
-		while (m_type##_id_pool.size()) {                                                      \
-			free(m_type##_id_pool.front()->get());                                             \
-			m_type##_id_pool.pop_front();                                                      \
-		}                                                                                      \
-	}                                                                                          \
-	virtual RID m_type##_create(m_arg1 p1) {                                                   \
-		if (Thread::get_caller_id() != server_thread) {                                        \
-			RID rid;                                                                           \
-			MutexLock lock(alloc_mutex);                                                       \
-			if (m_type##_id_pool.size() == 0) {                                                \
-				int ret;                                                                       \
-				command_queue.push_and_ret(this, &ServerNameWrapMT::m_type##allocn, p1, &ret); \
-				SYNC_DEBUG                                                                     \
-			}                                                                                  \
-			rid = m_type##_id_pool.front()->get();                                             \
-			m_type##_id_pool.pop_front();                                                      \
-			return rid;                                                                        \
-		} else {                                                                               \
-			return server_name->m_type##_create(p1);                                           \
-		}                                                                                      \
-	}
-
-#define FUNC2RID(m_type, m_arg1, m_arg2)                                                           \
-	int m_type##allocn() {                                                                         \
-		for (int i = 0; i < m_type##_pool_max_size; i++) {                                         \
-			m_type##_id_pool.push_back(server_name->m_type##_create());                            \
-		}                                                                                          \
-		return 0;                                                                                  \
-	}                                                                                              \
-	void m_type##_free_cached_ids() {                                                              \
-		while (m_type##_id_pool.size()) {                                                          \
-			free(m_type##_id_pool.front()->get());                                                 \
-			m_type##_id_pool.pop_front();                                                          \
-		}                                                                                          \
-	}                                                                                              \
-	virtual RID m_type##_create(m_arg1 p1, m_arg2 p2) {                                            \
-		if (Thread::get_caller_id() != server_thread) {                                            \
-			RID rid;                                                                               \
-			MutexLock lock(alloc_mutex);                                                           \
-			if (m_type##_id_pool.size() == 0) {                                                    \
-				int ret;                                                                           \
-				command_queue.push_and_ret(this, &ServerNameWrapMT::m_type##allocn, p1, p2, &ret); \
-				SYNC_DEBUG                                                                         \
-			}                                                                                      \
-			rid = m_type##_id_pool.front()->get();                                                 \
-			m_type##_id_pool.pop_front();                                                          \
-			return rid;                                                                            \
-		} else {                                                                                   \
-			return server_name->m_type##_create(p1, p2);                                           \
-		}                                                                                          \
-	}
-
-#define FUNC3RID(m_type, m_arg1, m_arg2, m_arg3)                                                       \
-	int m_type##allocn() {                                                                             \
-		for (int i = 0; i < m_type##_pool_max_size; i++) {                                             \
-			m_type##_id_pool.push_back(server_name->m_type##_create());                                \
-		}                                                                                              \
-		return 0;                                                                                      \
-	}                                                                                                  \
-	void m_type##_free_cached_ids() {                                                                  \
-		while (m_type##_id_pool.size()) {                                                              \
-			free(m_type##_id_pool.front()->get());                                                     \
-			m_type##_id_pool.pop_front();                                                              \
-		}                                                                                              \
-	}                                                                                                  \
-	virtual RID m_type##_create(m_arg1 p1, m_arg2 p2, m_arg3 p3) {                                     \
-		if (Thread::get_caller_id() != server_thread) {                                                \
-			RID rid;                                                                                   \
-			MutexLock lock(alloc_mutex);                                                               \
-			if (m_type##_id_pool.size() == 0) {                                                        \
-				int ret;                                                                               \
-				command_queue.push_and_ret(this, &ServerNameWrapMT::m_type##allocn, p1, p2, p3, &ret); \
-				SYNC_DEBUG                                                                             \
-			}                                                                                          \
-			rid = m_type##_id_pool.front()->get();                                                     \
-			m_type##_id_pool.pop_front();                                                              \
-			return rid;                                                                                \
-		} else {                                                                                       \
-			return server_name->m_type##_create(p1, p2, p3);                                           \
-		}                                                                                              \
-	}
-
-#define FUNC4RID(m_type, m_arg1, m_arg2, m_arg3, m_arg4)                                                   \
-	int m_type##allocn() {                                                                                 \
-		for (int i = 0; i < m_type##_pool_max_size; i++) {                                                 \
-			m_type##_id_pool.push_back(server_name->m_type##_create());                                    \
-		}                                                                                                  \
-		return 0;                                                                                          \
-	}                                                                                                      \
-	void m_type##_free_cached_ids() {                                                                      \
-		while (m_type##_id_pool.size()) {                                                                  \
-			free(m_type##_id_pool.front()->get());                                                         \
-			m_type##_id_pool.pop_front();                                                                  \
-		}                                                                                                  \
-	}                                                                                                      \
-	virtual RID m_type##_create(m_arg1 p1, m_arg2 p2, m_arg3 p3, m_arg4 p4) {                              \
-		if (Thread::get_caller_id() != server_thread) {                                                    \
-			RID rid;                                                                                       \
-			MutexLock lock(alloc_mutex);                                                                   \
-			if (m_type##_id_pool.size() == 0) {                                                            \
-				int ret;                                                                                   \
-				command_queue.push_and_ret(this, &ServerNameWrapMT::m_type##allocn, p1, p2, p3, p4, &ret); \
-				SYNC_DEBUG                                                                                 \
-			}                                                                                              \
-			rid = m_type##_id_pool.front()->get();                                                         \
-			m_type##_id_pool.pop_front();                                                                  \
-			return rid;                                                                                    \
-		} else {                                                                                           \
-			return server_name->m_type##_create(p1, p2, p3, p4);                                           \
-		}                                                                                                  \
+#define FUNCRID(m_type)                                                 \
+	List<RID> m_type##_id_pool;                                         \
+	int m_type##allocn() {                                              \
+		for (int i = 0; i < pool_max_size; i++) {                       \
+			m_type##_id_pool.push_back(server_name->m_type##_create()); \
+		}                                                               \
+		return 0;                                                       \
+	}                                                                   \
+	void m_type##_free_cached_ids() {                                   \
+		while (m_type##_id_pool.size()) {                               \
+			server_name->free(m_type##_id_pool.front()->get());         \
+			m_type##_id_pool.pop_front();                               \
+		}                                                               \
+	}                                                                   \
+	virtual RID m_type##_create() {                                     \
+		if (Thread::get_caller_id() != server_thread) {                 \
+			RID rid;                                                    \
+			MutexLock lock(alloc_mutex);                                \
+			if (m_type##_id_pool.size() == 0) {                         \
+				SERVER_POOL_REFILL(m_type##allocn)                      \
+			}                                                           \
+			rid = m_type##_id_pool.front()->get();                      \
+			m_type##_id_pool.pop_front();                               \
+			return rid;                                                 \
+		} else {                                                        \
+			SERVER_DIRECT_CALL                                          \
+			return server_name->m_type##_create();                      \
+		}                                                               \
+	}
+
+#define FUNC1RID(m_type, m_arg1)                                        \
+	int m_type##allocn() {                                              \
+		for (int i = 0; i < m_type##_pool_max_size; i++) {              \
+			m_type##_id_pool.push_back(server_name->m_type##_create()); \
+		}                                                               \
+		return 0;                                                       \
+	}                                                                   \
+	void m_type##_free_cached_ids() {                                   \
+		while (m_type##_id_pool.size()) {                               \
+			free(m_type##_id_pool.front()->get());                      \
+			m_type##_id_pool.pop_front();                               \
+		}                                                               \
+	}                                                                   \
+	virtual RID m_type##_create(m_arg1 p1) {                            \
+		if (Thread::get_caller_id() != server_thread) {                 \
+			RID rid;                                                    \
+			MutexLock lock(alloc_mutex);                                \
+			if (m_type##_id_pool.size() == 0) {                         \
+				SERVER_POOL_REFILL(m_type##allocn)                      \
+			}                                                           \
+			rid = m_type##_id_pool.front()->get();                      \
+			m_type##_id_pool.pop_front();                               \
+			return rid;                                                 \
+		} else {                                                        \
+			SERVER_DIRECT_CALL                                          \
+			return server_name->m_type##_create(p1);                    \
+		}                                                               \
+	}
+
+#define FUNC2RID(m_type, m_arg1, m_arg2)                                \
+	int m_type##allocn() {                                              \
+		for (int i = 0; i < m_type##_pool_max_size; i++) {              \
+			m_type##_id_pool.push_back(server_name->m_type##_create()); \
+		}                                                               \
+		return 0;                                                       \
+	}                                                                   \
+	void m_type##_free_cached_ids() {                                   \
+		while (m_type##_id_pool.size()) {                               \
+			free(m_type##_id_pool.front()->get());                      \
+			m_type##_id_pool.pop_front();                               \
+		}                                                               \
+	}                                                                   \
+	virtual RID m_type##_create(m_arg1 p1, m_arg2 p2) {                 \
+		if (Thread::get_caller_id() != server_thread) {                 \
+			RID rid;                                                    \
+			MutexLock lock(alloc_mutex);                                \
+			if (m_type##_id_pool.size() == 0) {                         \
+				SERVER_POOL_REFILL(m_type##allocn)                      \
+			}                                                           \
+			rid = m_type##_id_pool.front()->get();                      \
+			m_type##_id_pool.pop_front();                               \
+			return rid;                                                 \
+		} else {                                                        \
+			SERVER_DIRECT_CALL                                          \
+			return server_name->m_type##_create(p1, p2);                \
+		}                                                               \
+	}
+
+#define FUNC3RID(m_type, m_arg1, m_arg2, m_arg3)                        \
+	int m_type##allocn() {                                              \
+		for (int i = 0; i < m_type##_pool_max_size; i++) {              \
+			m_type##_id_pool.push_back(server_name->m_type##_create()); \
+		}                                                               \
+		return 0;                                                       \
+	}                                                                   \
+	void m_type##_free_cached_ids() {                                   \
+		while (m_type##_id_pool.size()) {                               \
+			free(m_type##_id_pool.front()->get());                      \
+			m_type##_id_pool.pop_front();                               \
+		}                                                               \
+	}                                                                   \
+	virtual RID m_type##_create(m_arg1 p1, m_arg2 p2, m_arg3 p3) {      \
+		if (Thread::get_caller_id() != server_thread) {                 \
+			RID rid;                                                    \
+			MutexLock lock(alloc_mutex);                                \
+			if (m_type##_id_pool.size() == 0) {                         \
+				SERVER_POOL_REFILL(m_type##allocn)                      \
+			}                                                           \
+			rid = m_type##_id_pool.front()->get();                      \
+			m_type##_id_pool.pop_front();                               \
+			return rid;                                                 \
+		} else {                                                        \
+			SERVER_DIRECT_CALL                                          \
+			return server_name->m_type##_create(p1, p2, p3);            \
+		}                                                               \
+	}
+
+#define FUNC4RID(m_type, m_arg1, m_arg2, m_arg3, m_arg4)                      \
+	int m_type##allocn() {                                                    \
+		for (int i = 0; i < m_type##_pool_max_size; i++) {                    \
+			m_type##_id_pool.push_back(server_name->m_type##_create());       \
+		}                                                                     \
+		return 0;                                                             \
+	}                                                                         \
+	void m_type##_free_cached_ids() {                                         \
+		while (m_type##_id_pool.size()) {                                     \
+			free(m_type##_id_pool.front()->get());                            \
+			m_type##_id_pool.pop_front();                                     \
+		}                                                                     \
+	}                                                                         \
+	virtual RID m_type##_create(m_arg1 p1, m_arg2 p2, m_arg3 p3, m_arg4 p4) { \
+		if (Thread::get_caller_id() != server_thread) {                       \
+			RID rid;                                                          \
+			MutexLock lock(alloc_mutex);                                      \
+			if (m_type##_id_pool.size() == 0) {                               \
+				SERVER_POOL_REFILL(m_type##allocn)                            \
+			}                                                                 \
+			rid = m_type##_id_pool.front()->get();                            \
+			m_type##_id_pool.pop_front();                                     \
+			return rid;                                                       \
+		} else {                                                              \
+			SERVER_DIRECT_CALL                                                \
+			return server_name->m_type##_create(p1, p2, p3, p4);              \
+		}                                                                     \
 	}
 
 #define FUNC5RID(m_type, m_arg1, m_arg2, m_arg3, m_arg4, m_arg5)                                               \
@@ -218,6 +221,7 @@
 			m_type##_id_pool.pop_front();                                                                      \
 			return rid;                                                                                        \
 		} else {                                                                                               \
+			SERVER_DIRECT_CALL                                                                                 \
 			return server_name->m_type##_create(p1, p2, p3, p4, p5);                                           \
 		}                                                                                                      \
 	}
@@ -225,11 +229,13 @@
 #define FUNC0RC(m_r, m_type)                                                    \
 	virtual m_r m_type() const {                                                \
 		if (Thread::get_caller_id() != server_thread) {                         \
+			SERVER_WAIT_CHECK(m_r())                                            \
 			m_r ret;                                                            \
 			command_queue.push_and_ret(server_name, &ServerName::m_type, &ret); \
 			SYNC_DEBUG                                                          \
 			return ret;                                                         \
 		} else {                                                                \
+			SERVER_DIRECT_CALL                                                  \
 			return server_name->m_type();                                       \
 		}                                                                       \
 	}
@@ -239,6 +245,7 @@
 		if (Thread::get_caller_id() != server_thread) {           \
 			command_queue.push(server_name, &ServerName::m_type); \
 		} else {                                                  \
+			SERVER_DIRECT_CALL                                    \
 			server_name->m_type();                                \
 		}                                                         \
 	}
@@ -248,6 +255,7 @@
 		if (Thread::get_caller_id() != server_thread) {           \
 			command_queue.push(server_name, &ServerName::m_type); \
 		} else {                                                  \
+			SERVER_DIRECT_CALL                                    \
 			server_name->m_type();                                \
 		}                                                         \
 	}
@@ -255,9 +263,11 @@
 #define FUNC0S(m_type)                                                     \
 	virtual void m_type() {                                                \
 		if (Thread::get_caller_id() != server_thread) {                    \
+			SERVER_WAIT_CHECK()                                            \
 			command_queue.push_and_sync(server_name, &ServerName::m_type); \
 			SYNC_DEBUG                                                     \
 		} else {                                                           \
+			SERVER_DIRECT_CALL                                             \
 			server_name->m_type();                                         \
 		}                                                                  \
 	}
@@ -265,9 +275,11 @@
 #define FUNC0SC(m_type)                                                    \
 	virtual void m_type() const {                                          \
 		if (Thread::get_caller_id() != server_thread) {                    \
+			SERVER_WAIT_CHECK()                                            \
 			command_queue.push_and_sync(server_name, &ServerName::m_type); \
 			SYNC_DEBUG                                                     \
 		} else {                                                           \
+			SERVER_DIRECT_CALL                                             \
 			server_name->m_type();                                         \
 		}                                                                  \
 	}
@@ -277,11 +289,13 @@
 #define FUNC1R(m_r, m_type, m_arg1)                                                 \
 	virtual m_r m_type(m_arg1 p1) {                                                 \
 		if (Thread::get_caller_id() != server_thread) {                             \
+			SERVER_WAIT_CHECK(m_r())                                                \
 			m_r ret;                                                                \
 			command_queue.push_and_ret(server_name, &ServerName::m_type, p1, &ret); \
 			SYNC_DEBUG                                                              \
 			return ret;                                                             \
 		} else {                                                                    \
+			SERVER_DIRECT_CALL                                                      \
 			return server_name->m_type(p1);                                         \
 		}                                                                           \
 	}
@@ -289,11 +303,13 @@
 #define FUNC1RC(m_r, m_type, m_arg1)                                                \
 	virtual m_r m_type(m_arg1 p1) const {                                           \
 		if (Thread::get_caller_id() != server_thread) {                             \
+			SERVER_WAIT_CHECK(m_r())                                                \
 			m_r ret;                                                                \
 			command_queue.push_and_ret(server_name, &ServerName::m_type, p1, &ret); \
 			SYNC_DEBUG                                                              \
 			return ret;                                                             \
 		} else {                                                                    \
+			SERVER_DIRECT_CALL                                                      \
 			return server_name->m_type(p1);                                         \
 		}                                                                           \
 	}
@@ -301,9 +317,11 @@
 #define FUNC1S(m_type, m_arg1)                                                 \
 	virtual void m_type(m_arg1 p1) {                                           \
 		if (Thread::get_caller_id() != server_thread) {                        \
+			SERVER_WAIT_CHECK()                                                \
 			command_queue.push_and_sync(server_name, &ServerName::m_type, p1); \
 			SYNC_DEBUG                                                         \
 		} else {                                                               \
+			SERVER_DIRECT_CALL                                                 \
 			server_name->m_type(p1);                                           \
 		}                                                                      \
 	}
@@ -311,9 +329,11 @@
 #define FUNC1SC(m_type, m_arg1)                                                \
 	virtual void m_type(m_arg1 p1) const {                                     \
 		if (Thread::get_caller_id() != server_thread) {                        \
+			SERVER_WAIT_CHECK()                                                \
 			command_queue.push_and_sync(server_name, &ServerName::m_type, p1); \
 			SYNC_DEBUG                                                         \
 		} else {                                                               \
+			SERVER_DIRECT_CALL                                                 \
 			server_name->m_type(p1);                                           \
 		}                                                                      \
 	}
@@ -323,6 +343,7 @@
 		if (Thread::get_caller_id() != server_thread) {               \
 			command_queue.push(server_name, &ServerName::m_type, p1); \
 		} else {                                                      \
+			SERVER_DIRECT_CALL                                        \
 			server_name->m_type(p1);                                  \
 		}                                                             \
 	}
@@ -332,6 +353,7 @@
 		if (Thread::get_caller_id() != server_thread) {               \
 			command_queue.push(server_name, &ServerName::m_type, p1); \
 		} else {                                                      \
+			SERVER_DIRECT_CALL                                        \
 			server_name->m_type(p1);                                  \
 		}                                                             \
 	}
@@ -339,11 +361,13 @@
 #define FUNC2R(m_r, m_type, m_arg1, m_arg2)                                             \
 	virtual m_r m_type(m_arg1 p1, m_arg2 p2) {                                          \
 		if (Thread::get_caller_id() != server_thread) {                                 \
+			SERVER_WAIT_CHECK(m_r())                                                    \
 			m_r ret;                                                                    \
 			command_queue.push_and_ret(server_name, &ServerName::m_type, p1, p2, &ret); \
 			SYNC_DEBUG                                                                  \
 			return ret;                                                                 \
 		} else {                                                                        \
+			SERVER_DIRECT_CALL                                                          \
 			return server_name->m_type(p1, p2);                                         \
 		}                                                                               \
 	}
@@ -351,11 +375,13 @@
 #define FUNC2RC(m_r, m_type, m_arg1, m_arg2)                                            \
 	virtual m_r m_type(m_arg1 p1, m_arg2 p2) const {                                    \
 		if (Thread::get_caller_id() != server_thread) {                                 \
+			SERVER_WAIT_CHECK(m_r())                                                    \
 			m_r ret;                                                                    \
 			command_queue.push_and_ret(server_name, &ServerName::m_type, p1, p2, &ret); \
 			SYNC_DEBUG                                                                  \
 			return ret;                                                                 \
 		} else {                                                                        \
+			SERVER_DIRECT_CALL                                                          \
 			return server_name->m_type(p1, p2);                                         \
 		}                                                                               \
 	}
@@ -363,9 +389,11 @@
 #define FUNC2S(m_type, m_arg1, m_arg2)                                             \
 	virtual void m_type(m_arg1 p1, m_arg2 p2) {                                    \
 		if (Thread::get_caller_id() != server_thread) {                            \
+			SERVER_WAIT_CHECK()                                                    \
 			command_queue.push_and_sync(server_name, &ServerName::m_type, p1, p2); \
 			SYNC_DEBUG                                                             \
 		} else {                                                                   \
+			SERVER_DIRECT_CALL                                                     \
 			server_name->m_type(p1, p2);                                           \
 		}                                                                          \
 	}
@@ -373,9 +401,11 @@
 #define FUNC2SC(m_type, m_arg1, m_arg2)                                            \
 	virtual void m_type(m_arg1 p1, m_arg2 p2) const {                              \
 		if (Thread::get_caller_id() != server_thread) {                            \
+			SERVER_WAIT_CHECK()                                                    \
 			command_queue.push_and_sync(server_name, &ServerName::m_type, p1, p2); \
 			SYNC_DEBUG                                                             \
 		} else {                                                                   \
+			SERVER_DIRECT_CALL                                                     \
 			server_name->m_type(p1, p2);                                           \
 		}                                                                          \
 	}
@@ -385,6 +415,7 @@
 		if (Thread::get_caller_id() != server_thread) {                   \
 			command_queue.push(server_name, &ServerName::m_type, p1, p2); \
 		} else {                                                          \
+			SERVER_DIRECT_CALL                                            \
 			server_name->m_type(p1, p2);                                  \
 		}                                                                 \
 	}
@@ -394,6 +425,7 @@
 		if (Thread::get_caller_id() != server_thread) {                   \
 			command_queue.push(server_name, &ServerName::m_type, p1, p2); \
 		} else {                                                          \
+			SERVER_DIRECT_CALL                                            \
 			server_name->m_type(p1, p2);                                  \
 		}                                                                 \
 	}
@@ -401,11 +433,13 @@
 #define FUNC3R(m_r, m_type, m_arg1, m_arg2, m_arg3)                                         \
 	virtual m_r m_type(m_arg1 p1, m_arg2 p2, m_arg3 p3) {                                   \
 		if (Thread::get_caller_id() != server_thread) {                                     \
+			SERVER_WAIT_CHECK(m_r())                                                        \
 			m_r ret;                                                                        \
 			command_queue.push_and_ret(server_name, &ServerName::m_type, p1, p2, p3, &ret); \
 			SYNC_DEBUG                                                                      \
 			return ret;                                                                     \
 		} else {                                                                            \
+			SERVER_DIRECT_CALL                                                              \
 			return server_name->m_type(p1, p2, p3);                                         \
 		}                                                                                   \
 	}
@@ -413,11 +447,13 @@
 #define FUNC3RC(m_r, m_type, m_arg1, m_arg2, m_arg3)                                        \
 	virtual m_r m_type(m_arg1 p1, m_arg2 p2, m_arg3 p3) const {                             \
 		if (Thread::get_caller_id() != server_thread) {                                     \
+			SERVER_WAIT_CHECK(m_r())                                                        \
 			m_r ret;                                                                        \
 			command_queue.push_and_ret(server_name, &ServerName::m_type, p1, p2, p3, &ret); \
 			SYNC_DEBUG                                                                      \
 			return ret;                                                                     \
 		} else {                                                                            \
+			SERVER_DIRECT_CALL                                                              \
 			return server_name->m_type(p1, p2, p3);                                         \
 		}                                                                                   \
 	}
@@ -425,9 +461,11 @@
 #define FUNC3S(m_type, m_arg1, m_arg2, m_arg3)                                         \
 	virtual void m_type(m_arg1 p1, m_arg2 p2, m_arg3 p3) {                             \
 		if (Thread::get_caller_id() != server_thread) {                                \
+			SERVER_WAIT_CHECK()                                                        \
 			command_queue.push_and_sync(server_name, &ServerName::m_type, p1, p2, p3); \
 			SYNC_DEBUG                                                                 \
 		} else {                                                                       \
+			SERVER_DIRECT_CALL                                                         \
 			server_name->m_type(p1, p2, p3);                                           \
 		}                                                                              \
 	}
@@ -435,9 +473,11 @@
 #define FUNC3SC(m_type, m_arg1, m_arg2, m_arg3)                                        \
 	virtual void m_type(m_arg1 p1, m_arg2 p2, m_arg3 p3) const {                       \
 		if (Thread::get_caller_id() != server_thread) {                                \
+			SERVER_WAIT_CHECK()                                                        \
 			command_queue.push_and_sync(server_name, &ServerName::m_type, p1, p2, p3); \
 			SYNC_DEBUG                                                                 \
 		} else {                                                                       \
+			SERVER_DIRECT_CALL                                                         \
 			server_name->m_type(p1, p2, p3);                                           \
 		}                                                                              \
 	}
@@ -447,6 +487,7 @@
 		if (Thread::get_caller_id() != server_thread) {                       \
 			command_queue.push(server_name, &ServerName::m_type, p1, p2, p3); \
 		} else {                                                              \
+			SERVER_DIRECT_CALL                                                \
 			server_name->m_type(p1, p2, p3);                                  \
 		}                                                                     \
 	}
@@ -456,6 +497,7 @@
 		if (Thread::get_caller_id() != server_thread) {                       \
 			command_queue.push(server_name, &ServerName::m_type, p1, p2, p3); \
 		} else {                                                              \
+			SERVER_DIRECT_CALL                                                \
 			server_name->m_type(p1, p2, p3);                                  \
 		}                                                                     \
 	}
@@ -463,11 +505,13 @@
 #define FUNC4R(m_r, m_type, m_arg1, m_arg2, m_arg3, m_arg4)                                     \
 	virtual m_r m_type(m_arg1 p1, m_arg2 p2, m_arg3 p3, m_arg4 p4) {                            \
 		if (Thread::get_caller_id() != server_thread) {                                         \
+			SERVER_WAIT_CHECK(m_r())                                                            \
 			m_r ret;                                                                            \
 			command_queue.push_and_ret(server_name, &ServerName::m_type, p1, p2, p3, p4, &ret); \
 			SYNC_DEBUG                                                                          \
 			return ret;                                                                         \
 		} else {                                                                                \
+			SERVER_DIRECT_CALL                                                                  \
 			return server_name->m_type(p1, p2, p3, p4);                                         \
 		}                                                                                       \
 	}
@@ -475,11 +519,13 @@
 #define FUNC4RC(m_r, m_type, m_arg1, m_arg2, m_arg3, m_arg4)                                    \
 	virtual m_r m_type(m_arg1 p1, m_arg2 p2, m_arg3 p3, m_arg4 p4) const {                      \
 		if (Thread::get_caller_id() != server_thread) {                                         \
+			SERVER_WAIT_CHECK(m_r())                                                            \
 			m_r ret;                                                                            \
 			command_queue.push_and_ret(server_name, &ServerName::m_type, p1, p2, p3, p4, &ret); \
 			SYNC_DEBUG                                                                          \
 			return ret;                                                                         \
 		} else {                                                                                \
+			SERVER_DIRECT_CALL                                                                  \
 			return server_name->m_type(p1, p2, p3, p4);                                         \
 		}                                                                                       \
 	}
@@ -487,9 +533,11 @@
 #define FUNC4S(m_type, m_arg1, m_arg2, m_arg3, m_arg4)                                     \
 	virtual void m_type(m_arg1 p1, m_arg2 p2, m_arg3 p3, m_arg4 p4) {                      \
 		if (Thread::get_caller_id() != server_thread) {                                    \
+			SERVER_WAIT_CHECK()                                                            \
 			command_queue.push_and_sync(server_name, &ServerName::m_type, p1, p2, p3, p4); \
 			SYNC_DEBUG                                                                     \
 		} else {                                                                           \
+			SERVER_DIRECT_CALL                                                             \
 			server_name->m_type(p1, p2, p3, p4);                                           \
 		}                                                                                  \
 	}
@@ -497,9 +545,11 @@
 #define FUNC4SC(m_type, m_arg1, m_arg2, m_arg3, m_arg4)                                    \
 	virtual void m_type(m_arg1 p1, m_arg2 p2, m_arg3 p3, m_arg4 p4) const {                \
 		if (Thread::get_caller_id() != server_thread) {                                    \
+			SERVER_WAIT_CHECK()                                                            \
 			command_queue.push_and_sync(server_name, &ServerName::m_type, p1, p2, p3, p4); \
 			SYNC_DEBUG                                                                     \
 		} else {                                                                           \
+			SERVER_DIRECT_CALL                                                             \
 			server_name->m_type(p1, p2, p3, p4);                                           \
 		}                                                                                  \
 	}
@@ -509,6 +559,7 @@
 		if (Thread::get_caller_id() != server_thread) {                           \
 			command_queue.push(server_name, &ServerName::m_type, p1, p2, p3, p4); \
 		} else {                                                                  \
+			SERVER_DIRECT_CALL                                                    \
 			server_name->m_type(p1, p2, p3, p4);                                  \
 		}                                                                         \
 	}
@@ -518,6 +569,7 @@
 		if (Thread::get_caller_id() != server_thread) {                           \
 			command_queue.push(server_name, &ServerName::m_type, p1, p2, p3, p4); \
 		} else {                                                                  \
+			SERVER_DIRECT_CALL                                                    \
 			server_name->m_type(p1, p2, p3, p4);                                  \
 		}                                                                         \
 	}
@@ -525,11 +577,13 @@
 #define FUNC5R(m_r, m_type, m_arg1, m_arg2, m_arg3, m_arg4, m_arg5)                                 \
 	virtual m_r m_type(m_arg1 p1, m_arg2 p2, m_arg3 p3, m_arg4 p4, m_arg5 p5) {                     \
 		if (Thread::get_caller_id() != server_thread) {                                             \
+			SERVER_WAIT_CHECK(m_r())                                                                \
 			m_r ret;                                                                                \
 			command_queue.push_and_ret(server_name, &ServerName::m_type, p1, p2, p3, p4, p5, &ret); \
 			SYNC_DEBUG                                                                              \
 			return ret;                                                                             \
 		} else {                                                                                    \
+			SERVER_DIRECT_CALL                                                                      \
 			return server_name->m_type(p1, p2, p3, p4, p5);                                         \
 		}                                                                                           \
 	}
@@ -537,11 +591,13 @@
 #define FUNC5RC(m_r, m_type, m_arg1, m_arg2, m_arg3, m_arg4, m_arg5)                                \
 	virtual m_r m_type(m_arg1 p1, m_arg2 p2, m_arg3 p3, m_arg4 p4, m_arg5 p5) const {               \
 		if (Thread::get_caller_id() != server_thread) {                                             \
+			SERVER_WAIT_CHECK(m_r())                                                                \
 			m_r ret;                                                                                \
 			command_queue.push_and_ret(server_name, &ServerName::m_type, p1, p2, p3, p4, p5, &ret); \
 			SYNC_DEBUG                                                                              \
 			return ret;                                                                             \
 		} else {                                                                                    \
+			SERVER_DIRECT_CALL                                                                      \
 			return server_name->m_type(p1, p2, p3, p4, p5);                                         \
 		}                                                                                           \
 	}
@@ -549,9 +605,11 @@
 #define FUNC5S(m_type, m_arg1, m_arg2, m_arg3, m_arg4, m_arg5)                                 \
 	virtual void m_type(m_arg1 p1, m_arg2 p2, m_arg3 p3, m_arg4 p4, m_arg5 p5) {               \
 		if (Thread::get_caller_id() != server_thread) {                                        \
+			SERVER_WAIT_CHECK()                                                                \
 			command_queue.push_and_sync(server_name, &ServerName::m_type, p1, p2, p3, p4, p5); \
 			SYNC_DEBUG                                                                         \
 		} else {                                                                               \
+			SERVER_DIRECT_CALL                                                                 \
 			server_name->m_type(p1, p2, p3, p4, p5);                                           \
 		}                                                                                      \
 	}
@@ -559,9 +617,11 @@
 #define FUNC5SC(m_type, m_arg1, m_arg2, m_arg3, m_arg4, m_arg5)                                \
 	virtual void m_type(m_arg1 p1, m_arg2 p2, m_arg3 p3, m_arg4 p4, m_arg5 p5) const {         \
 		if (Thread::get_caller_id() != server_thread) {                                        \
+			SERVER_WAIT_CHECK()                                                                \
 			command_queue.push_and_sync(server_name, &ServerName::m_type, p1, p2, p3, p4, p5); \
 			SYNC_DEBUG                                                                         \
 		} else {                                                                               \
+			SERVER_DIRECT_CALL                                                                 \
 			server_name->m_type(p1, p2, p3, p4, p5);                                           \
 		}                                                                                      \
 	}
@@ -571,6 +631,7 @@
 		if (Thread::get_caller_id() != server_thread) {                               \
 			command_queue.push(server_name, &ServerName::m_type, p1, p2, p3, p4, p5); \
 		} else {                                                                      \
+			SERVER_DIRECT_CALL                                                        \
 			server_name->m_type(p1, p2, p3, p4, p5);                                  \
 		}                                                                             \
 	}
@@ -580,6 +641,7 @@
 		if (Thread::get_caller_id() != server_thread) {                                \
 			command_queue.push(server_name, &ServerName::m_type, p1, p2, p3, p4, p5);  \
 		} else {                                                                       \
+			SERVER_DIRECT_CALL                                                         \
 			server_name->m_type(p1, p2, p3, p4, p5);                                   \
 		}                                                                              \
 	}
@@ -587,11 +649,13 @@
 #define FUNC6R(m_r, m_type, m_arg1, m_arg2, m_arg3, m_arg4, m_arg5, m_arg6)                             \
 	virtual m_r m_type(m_arg1 p1, m_arg2 p2, m_arg3 p3, m_arg4 p4, m_arg5 p5, m_arg6 p6) {              \
 		if (Thread::get_caller_id() != server_thread) {                                                 \
+			SERVER_WAIT_CHECK(m_r())                                                                    \
 			m_r ret;                                                                                    \
 			command_queue.push_and_ret(server_name, &ServerName::m_type, p1, p2, p3, p4, p5, p6, &ret); \
 			SYNC_DEBUG                                                                                  \
 			return ret;                                                                                 \
 		} else {                                                                                        \
+			SERVER_DIRECT_CALL                                                                          \
 			return server_name->m_type(p1, p2, p3, p4, p5, p6);                                         \
 		}                                                                                               \
 	}
@@ -599,11 +663,13 @@
 #define FUNC6RC(m_r, m_type, m_arg1, m_arg2, m_arg3, m_arg4, m_arg5, m_arg6)                            \
 	virtual m_r m_type(m_arg1 p1, m_arg2 p2, m_arg3 p3, m_arg4 p4, m_arg5 p5, m_arg6 p6) const {        \
 		if (Thread::get_caller_id() != server_thread) {                                                 \
+			SERVER_WAIT_CHECK(m_r())                                                                    \
 			m_r ret;                                                                                    \
 			command_queue.push_and_ret(server_name, &ServerName::m_type, p1, p2, p3, p4, p5, p6, &ret); \
 			SYNC_DEBUG                                                                                  \
 			return ret;                                                                                 \
 		} else {                                                                                        \
+			SERVER_DIRECT_CALL                                                                          \
 			return server_name->m_type(p1, p2, p3, p4, p5, p6);                                         \
 		}                                                                                               \
 	}
@@ -611,9 +677,11 @@
 #define FUNC6S(m_type, m_arg1, m_arg2, m_arg3, m_arg4, m_arg5, m_arg6)                             \
 	virtual void m_type(m_arg1 p1, m_arg2 p2, m_arg3 p3, m_arg4 p4, m_arg5 p5, m_arg6 p6) {        \
 		if (Thread::get_caller_id() != server_thread) {                                            \
+			SERVER_WAIT_CHECK()                                                                    \
 			command_queue.push_and_sync(server_name, &ServerName::m_type, p1, p2, p3, p4, p5, p6); \
 			SYNC_DEBUG                                                                             \
 		} else {                                                                                   \
+			SERVER_DIRECT_CALL                                                                     \
 			server_name->m_type(p1, p2, p3, p4, p5, p6);                                           \
 		}                                                                                          \
 	}
@@ -621,9 +689,11 @@
 #define FUNC6SC(m_type, m_arg1, m_arg2, m_arg3, m_arg4, m_arg5, m_arg6)                            \
 	virtual void m_type(m_arg1 p1, m_arg2 p2, m_arg3 p3, m_arg4 p4, m_arg5 p5, m_arg6 p6) const {  \
 		if (Thread::get_caller_id() != server_thread) {                                            \
+			SERVER_WAIT_CHECK()                                                                    \
 			command_queue.push_and_sync(server_name, &ServerName::m_type, p1, p2, p3, p4, p5, p6); \
 			SYNC_DEBUG                                                                             \
 		} else {                                                                                   \
+			SERVER_DIRECT_CALL                                                                     \
 			server_name->m_type(p1, p2, p3, p4, p5, p6);                                           \
 		}                                                                                          \
 	}
@@ -633,6 +703,7 @@
 		if (Thread::get_caller_id() != server_thread) {                                     \
 			command_queue.push(server_name, &ServerName::m_type, p1, p2, p3, p4, p5, p6);   \
 		} else {                                                                            \
+			SERVER_DIRECT_CALL                                                              \
 			server_name->m_type(p1, p2, p3, p4, p5, p6);                                    \
 		}                                                                                   \
 	}
@@ -642,6 +713,7 @@
 		if (Thread::get_caller_id() != server_thread) {                                           \
 			command_queue.push(server_name, &ServerName::m_type, p1, p2, p3, p4, p5, p6);         \
 		} else {                                                                                  \
+			SERVER_DIRECT_CALL                                                                    \
 			server_name->m_type(p1, p2, p3, p4, p5, p6);                                          \
 		}                                                                                         \
 	}
@@ -649,11 +721,13 @@
 #define FUNC7R(m_r, m_type, m_arg1, m_arg2, m_arg3, m_arg4, m_arg5, m_arg6, m_arg7)                         \
 	virtual m_r m_type(m_arg1 p1, m_arg2 p2, m_arg3 p3, m_arg4 p4, m_arg5 p5, m_arg6 p6, m_arg7 p7) {       \
 		if (Thread::get_caller_id() != server_thread) {                                                     \
+			SERVER_WAIT_CHECK(m_r())                                                                        \
 			m_r ret;                                                                                        \
 			command_queue.push_and_ret(server_name, &ServerName::m_type, p1, p2, p3, p4, p5, p6, p7, &ret); \
 			SYNC_DEBUG                                                                                      \
 			return ret;                                                                                     \
 		} else {                                                                                            \
+			SERVER_DIRECT_CALL                                                                              \
 			return server_name->m_type(p1, p2, p3, p4, p5, p6, p7);                                         \
 		}                                                                                                   \
 	}
@@ -661,11 +735,13 @@
 #define FUNC7RC(m_r, m_type, m_arg1, m_arg2, m_arg3, m_arg4, m_arg5, m_arg6, m_arg7)                        \
 	virtual m_r m_type(m_arg1 p1, m_arg2 p2, m_arg3 p3, m_arg4 p4, m_arg5 p5, m_arg6 p6, m_arg7 p7) const { \
 		if (Thread::get_caller_id() != server_thread) {                                                     \
+			SERVER_WAIT_CHECK(m_r())                                                                        \
 			m_r ret;                                                                                        \
 			command_queue.push_and_ret(server_name, &ServerName::m_type, p1, p2, p3, p4, p5, p6, p7, &ret); \
 			SYNC_DEBUG                                                                                      \
 			return ret;                                                                                     \
 		} else {                                                                                            \
+			SERVER_DIRECT_CALL                                                                              \
 			return server_name->m_type(p1, p2, p3, p4, p5, p6, p7);                                         \
 		}                                                                                                   \
 	}
@@ -673,9 +749,11 @@
 #define FUNC7S(m_type, m_arg1, m_arg2, m_arg3, m_arg4, m_arg5, m_arg6, m_arg7)                         \
 	virtual void m_type(m_arg1 p1, m_arg2 p2, m_arg3 p3, m_arg4 p4, m_arg5 p5, m_arg6 p6, m_arg7 p7) { \
 		if (Thread::get_caller_id() != server_thread) {                                                \
+			SERVER_WAIT_CHECK()                                                                        \
 			command_queue.push_and_sync(server_name, &ServerName::m_type, p1, p2, p3, p4, p5, p6, p7); \
 			SYNC_DEBUG                                                                                 \
 		} else {                                                                                       \
+			SERVER_DIRECT_CALL                                                                         \
 			server_name->m_type(p1, p2, p3, p4, p5, p6, p7);                                           \
 		}                                                                                              \
 	}
@@ -683,9 +761,11 @@
 #define FUNC7SC(m_type, m_arg1, m_arg2, m_arg3, m_arg4, m_arg5, m_arg6, m_arg7)                              \
 	virtual void m_type(m_arg1 p1, m_arg2 p2, m_arg3 p3, m_arg4 p4, m_arg5 p5, m_arg6 p6, m_arg7 p7) const { \
 		if (Thread::get_caller_id() != server_thread) {                                                      \
+			SERVER_WAIT_CHECK()                                                                              \
 			command_queue.push_and_sync(server_name, &ServerName::m_type, p1, p2, p3, p4, p5, p6, p7);       \
 			SYNC_DEBUG                                                                                       \
 		} else {                                                                                             \
+			SERVER_DIRECT_CALL                                                                               \
 			server_name->m_type(p1, p2, p3, p4, p5, p6, p7);                                                 \
 		}                                                                                                    \
 	}
@@ -695,6 +775,7 @@
 		if (Thread::get_caller_id() != server_thread) {                                                \
 			command_queue.push(server_name, &ServerName::m_type, p1, p2, p3, p4, p5, p6, p7);          \
 		} else {                                                                                       \
+			SERVER_DIRECT_CALL                                                                         \
 			server_name->m_type(p1, p2, p3, p4, p5, p6, p7);                                           \
 		}                                                                                              \
 	}
@@ -704,6 +785,7 @@
 		if (Thread::get_caller_id() != server_thread) {                                                      \
 			command_queue.push(server_name, &ServerName::m_type, p1, p2, p3, p4, p5, p6, p7);                \
 		} else {                                                                                             \
+			SERVER_DIRECT_CALL                                                                               \
 			server_name->m_type(p1, p2, p3, p4, p5, p6, p7);                                                 \
 		}                                                                                                    \
 	}
@@ -711,11 +793,13 @@
 #define FUNC8R(m_r, m_type, m_arg1, m_arg2, m_arg3, m_arg4, m_arg5, m_arg6, m_arg7, m_arg8)                      \
 	virtual m_r m_type(m_arg1 p1, m_arg2 p2, m_arg3 p3, m_arg4 p4, m_arg5 p5, m_arg6 p6, m_arg7 p7, m_arg8 p8) { \
 		if (Thread::get_caller_id() != server_thread) {                                                          \
+			SERVER_WAIT_CHECK(m_r())                                                                             \
 			m_r ret;                                                                                             \
 			command_queue.push_and_ret(server_name, &ServerName::m_type, p1, p2, p3, p4, p5, p6, p7, p8, &ret);  \
 			SYNC_DEBUG                                                                                           \
 			return ret;                                                                                          \
 		} else {                                                                                                 \
+			SERVER_DIRECT_CALL                                                                                   \
 			return server_name->m_type(p1, p2, p3, p4, p5, p6, p7, p8);                                          \
 		}                                                                                                        \
 	}
@@ -723,11 +807,13 @@
 #define FUNC8RC(m_r, m_type, m_arg1, m_arg2, m_arg3, m_arg4, m_arg5, m_arg6, m_arg7, m_arg8)                           \
 	virtual m_r m_type(m_arg1 p1, m_arg2 p2, m_arg3 p3, m_arg4 p4, m_arg5 p5, m_arg6 p6, m_arg7 p7, m_arg8 p8) const { \
 		if (Thread::get_caller_id() != server_thread) {                                                                \
+			SERVER_WAIT_CHECK(m_r())                                                                                   \
 			m_r ret;                                                                                                   \
 			command_queue.push_and_ret(server_name, &ServerName::m_type, p1, p2, p3, p4, p5, p6, p7, p8, &ret);        \
 			SYNC_DEBUG                                                                                                 \
 			return ret;                                                                                                \
 		} else {                                                                                                       \
+			SERVER_DIRECT_CALL                                                                                         \
 			return server_name->m_type(p1, p2, p3, p4, p5, p6, p7, p8);                                                \
 		}                                                                                                              \
 	}
@@ -735,9 +821,11 @@
 #define FUNC8S(m_type, m_arg1, m_arg2, m_arg3, m_arg4, m_arg5, m_arg6, m_arg7, m_arg8)                            \
 	virtual void m_type(m_arg1 p1, m_arg2 p2, m_arg3 p3, m_arg4 p4, m_arg5 p5, m_arg6 p6, m_arg7 p7, m_arg8 p8) { \
 		if (Thread::get_caller_id() != server_thread) {                                                           \
+			SERVER_WAIT_CHECK()                                                                                   \
 			command_queue.push_and_sync(server_name, &ServerName::m_type, p1, p2, p3, p4, p5, p6, p7, p8);        \
 			SYNC_DEBUG                                                                                            \
 		} else {                                                                                                  \
+			SERVER_DIRECT_CALL                                                                                    \
 			server_name->m_type(p1, p2, p3, p4, p5, p6, p7, p8);                                                  \
 		}                                                                                                         \
 	}
@@ -745,9 +833,11 @@
 #define FUNC8SC(m_type, m_arg1, m_arg2, m_arg3, m_arg4, m_arg5, m_arg6, m_arg7, m_arg8)                                 \
 	virtual void m_type(m_arg1 p1, m_arg2 p2, m_arg3 p3, m_arg4 p4, m_arg5 p5, m_arg6 p6, m_arg7 p7, m_arg8 p8) const { \
 		if (Thread::get_caller_id() != server_thread) {                                                                 \
+			SERVER_WAIT_CHECK()                                                                                         \
 			command_queue.push_and_sync(server_name, &ServerName::m_type, p1, p2, p3, p4, p5, p6, p7, p8);              \
 			SYNC_DEBUG                                                                                                  \
 		} else {                                                                                                        \
+			SERVER_DIRECT_CALL                                                                                          \
 			server_name->m_type(p1, p2, p3, p4, p5, p6, p7, p8);                                                        \
 		}                                                                                                               \
 	}
@@ -757,6 +847,7 @@
 		if (Thread::get_caller_id() != server_thread) {                                                           \
 			command_queue.push(server_name, &ServerName::m_type, p1, p2, p3, p4, p5, p6, p7, p8);                 \
 		} else {                                                                                                  \
+			SERVER_DIRECT_CALL                                                                                    \
 			server_name->m_type(p1, p2, p3, p4, p5, p6, p7, p8);                                                  \
 		}                                                                                                         \
 	}
@@ -766,6 +857,7 @@
 		if (Thread::get_caller_id() != server_thread) {                                                                 \
 			command_queue.push(server_name, &ServerName::m_type, p1, p2, p3, p4, p5, p6, p7, p8);                       \
 		} else {                                                                                                        \
+			SERVER_DIRECT_CALL                                                                                          \
 			server_name->m_type(p1, p2, p3, p4, p5, p6, p7, p8);                                                        \
 		}                                                                                                               \
 	}
@@ -775,6 +867,7 @@
 		if (Thread::get_caller_id() != server_thread) {                                                                      \
 			command_queue.push(server_name, &ServerName::m_type, p1, p2, p3, p4, p5, p6, p7, p8, p9);                        \
 		} else {                                                                                                             \
+			SERVER_DIRECT_CALL                                                                                               \
 			server_name->m_type(p1, p2, p3, p4, p5, p6, p7, p8, p9);                                                         \
 		}                                                                                                                    \
 	}
@@ -784,6 +877,7 @@
 		if (Thread::get_caller_id() != server_thread) {                                                                                   \
 			command_queue.push(server_name, &ServerName::m_type, p1, p2, p3, p4, p5, p6, p7, p8, p9, p10);                                \
 		} else {                                                                                                                          \
+			SERVER_DIRECT_CALL                                                                                                            \
 			server_name->m_type(p1, p2, p3, p4, p5, p6, p7, p8, p9, p10);                                                                 \
 		}                                                                                                                                 \
 	}
@@ -793,6 +887,7 @@
 		if (Thread::get_caller_id() != server_thread) {                                                                                                \
 			command_queue.push(server_name, &ServerName::m_type, p1, p2, p3, p4, p5, p6, p7, p8, p9, p10, p11);                                        \
 		} else {                                                                                                                                       \
+			SERVER_DIRECT_CALL                                                                                                                         \
 			server_name->m_type(p1, p2, p3, p4, p5, p6, p7, p8, p9, p10, p11);                                                                         \
 		}                                                                                                                                              \
 	}
@@ -802,6 +897,7 @@
 		if (Thread::get_caller_id() != server_thread) {                                                                                                             \
 			command_queue.push(server_name, &ServerName::m_type, p1, p2, p3, p4, p5, p6, p7, p8, p9, p10, p11, p12);                                                \
 		} else {                                                                                                                                                    \
+			SERVER_DIRECT_CALL                                                                                                                                      \
 			server_name->m_type(p1, p2, p3, p4, p5, p6, p7, p8, p9, p10, p11, p12);                                                                                 \
 		}                                                                                                                                                           \
 	}
@@ -811,6 +907,7 @@
 		if (Thread::get_caller_id() != server_thread) {                                                                                                                          \
 			command_queue.push(server_name, &ServerName::m_type, p1, p2, p3, p4, p5, p6, p7, p8, p9, p10, p11, p12, p13);                                                        \
 		} else {                                                                                                                                                                 \
+			SERVER_DIRECT_CALL                                                                                                                                                   \
 			server_name->m_type(p1, p2, p3, p4, p5, p6, p7, p8, p9, p10, p11, p12, p13);                                                                                         \
 		}                                                                                                                                                                        \
 	}
@@ -820,6 +917,7 @@
 		if (Thread::get_caller_id() != server_thread) {                                                                                                                                       \
 			command_queue.push(server_name, &ServerName::m_type, p1, p2, p3, p4, p5, p6, p7, p8, p9, p10, p11, p12, p13, p14);                                                                \
 		} else {                                                                                                                                                                              \
+			SERVER_DIRECT_CALL                                                                                                                                                                \
 			server_name->m_type(p1, p2, p3, p4, p5, p6, p7, p8, p9, p10, p11, p12, p13, p14);                                                                                                 \
 		}                                                                                                                                                                                     \
 	}
@@ -829,6 +927,7 @@
 		if (Thread::get_caller_id() != server_thread) {                                                                                                                                                    \
 			command_queue.push(server_name, &ServerName::m_type, p1, p2, p3, p4, p5, p6, p7, p8, p9, p10, p11, p12, p13, p14, p15);                                                                        \
 		} else {                                                                                                                                                                                           \
+			SERVER_DIRECT_CALL                                                                                                                                                                             \
 			server_name->m_type(p1, p2, p3, p4, p5, p6, p7, p8, p9, p10, p11, p12, p13, p14, p15);                                                                                                         \
 		}                                                                                                                                                                                                  \
 	}
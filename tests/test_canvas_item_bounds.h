@@ -0,0 +1,199 @@
+/*************************************************************************/
+/*  test_canvas_item_bounds.h                                            */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_CANVAS_ITEM_BOUNDS_H
+#define TEST_CANVAS_ITEM_BOUNDS_H
+
+#include "servers/rendering/rendering_server_canvas.h"
+
+#include "tests/test_macros.h"
+
+namespace TestCanvasItemBounds {
+
+// Bounds of the visible subtree, computed from scratch.
+static bool expected_bounds(const RenderingServerCanvas::Item *p_item, Rect2 &r_bounds) {
+	bool empty = true;
+	if (p_item->commands) {
+		r_bounds = p_item->get_rect();
+		empty = false;
+	}
+	for (int i = 0; i < p_item->child_items.size(); i++) {
+		const RenderingServerCanvas::Item *child = p_item->child_items[i];
+		Rect2 child_bounds;
+		if (!child->visible || !expected_bounds(child, child_bounds)) {
+			continue;
+		}
+		child_bounds = child->xform.xform(child_bounds);
+		r_bounds = empty ? child_bounds : r_bounds.merge(child_bounds);
+		empty = false;
+	}
+	return !empty;
+}
+
+static bool bounds_match(RenderingServerCanvas *p_canvas, RID p_item) {
+	RenderingServerCanvas::Item *item = p_canvas->canvas_item_owner.getornull(p_item);
+	p_canvas->_update_item_bounds(item);
+
+	Rect2 expected;
+	if (!expected_bounds(item, expected)) {
+		return item->bounds_empty && !item->bounds_infinite;
+	}
+	return !item->bounds_empty && !item->bounds_infinite && item->bounds.is_equal_approx(expected);
+}
+
+// Every child overlapping a 100x100 screen is returned, in draw order, and far fewer than all of them.
+static void check_grid_cull(RenderingServerCanvas *p_canvas, RenderingServerCanvas::Item *p_parent, const Vector<RID> &p_children) {
+	const Rect2 screen(0, 0, 100, 100);
+	REQUIRE(p_canvas->_child_grid_cull(p_parent, Transform2D(), screen));
+
+	const LocalVector<RenderingServerCanvas::Item *> &visible = p_parent->child_grid->visible;
+	bool sorted = true;
+	for (uint32_t i = 1; i < visible.size(); i++) {
+		sorted = sorted && visible[i - 1]->child_order < visible[i]->child_order;
+	}
+	CHECK(sorted);
+	CHECK(visible.size() < 20);
+
+	bool all_found = true;
+	for (int i = 0; i < p_children.size(); i++) {
+		RenderingServerCanvas::Item *child = p_canvas->canvas_item_owner.getornull(p_children[i]);
+		if (child->visible && screen.intersects(child->xform.xform(child->get_rect()))) {
+			all_found = all_found && visible.find(child) >= 0;
+		}
+	}
+	CHECK_MESSAGE(all_found, "Every child on screen should be visited.");
+}
+
+TEST_CASE("[CanvasItemBounds] Subtree bounds follow moved, hidden and removed children") {
+	RenderingServerCanvas *canvas = memnew(RenderingServerCanvas);
+	canvas->use_spatial_index = true;
+
+	RID root = canvas->canvas_item_create();
+	RID branch = canvas->canvas_item_create();
+	canvas->canvas_item_set_parent(branch, root);
+
+	Vector<RID> leaves;
+	for (int i = 0; i < 8; i++) {
+		RID leaf = canvas->canvas_item_create();
+		canvas->canvas_item_add_rect(leaf, Rect2(0, 0, 10, 10), Color(1, 1, 1));
+		canvas->canvas_item_set_transform(leaf, Transform2D(0, Vector2(i * 20, i * 5)));
+		canvas->canvas_item_set_parent(leaf, branch);
+		leaves.push_back(leaf);
+	}
+	canvas->canvas_item_set_transform(branch, Transform2D(0, Vector2(100, 0)));
+	CHECK(bounds_match(canvas, root));
+
+	// Inside the current bounds, nothing changes.
+	canvas->canvas_item_set_transform(leaves[3], Transform2D(0, Vector2(40, 10)));
+	CHECK(bounds_match(canvas, root));
+
+	// Past an edge, the bounds grow.
+	canvas->canvas_item_set_transform(leaves[3], Transform2D(0, Vector2(-50, 200)));
+	CHECK(bounds_match(canvas, root));
+
+	// Back from that edge, the bounds shrink again.
+	canvas->canvas_item_set_transform(leaves[3], Transform2D(0, Vector2(40, 10)));
+	CHECK(bounds_match(canvas, root));
+
+	// Hiding and removing children on an edge.
+	canvas->canvas_item_set_visible(leaves[7], false);
+	CHECK(bounds_match(canvas, root));
+	canvas->canvas_item_set_visible(leaves[7], true);
+	CHECK(bounds_match(canvas, root));
+	canvas->canvas_item_set_parent(leaves[0], RID());
+	CHECK(bounds_match(canvas, root));
+	canvas->free(leaves[7]);
+	leaves.remove(7);
+	CHECK(bounds_match(canvas, root));
+
+	// Changing the drawing of a child, and of the branch itself.
+	canvas->canvas_item_clear(leaves[4]);
+	canvas->canvas_item_add_rect(leaves[4], Rect2(-300, 0, 5, 5), Color(1, 1, 1));
+	CHECK(bounds_match(canvas, root));
+	canvas->canvas_item_clear(leaves[4]);
+	canvas->canvas_item_add_rect(leaves[4], Rect2(0, 0, 5, 5), Color(1, 1, 1));
+	CHECK(bounds_match(canvas, root));
+	canvas->canvas_item_add_rect(branch, Rect2(0, -400, 5, 5), Color(1, 1, 1));
+	CHECK(bounds_match(canvas, root));
+	canvas->canvas_item_clear(branch);
+	CHECK(bounds_match(canvas, root));
+
+	// Reparenting the whole branch away empties the root.
+	canvas->canvas_item_set_parent(branch, RID());
+	CHECK(bounds_match(canvas, root));
+
+	for (int i = 0; i < leaves.size(); i++) {
+		canvas->free(leaves[i]);
+	}
+	canvas->free(branch);
+	canvas->free(root);
+	memdelete(canvas);
+}
+
+TEST_CASE("[CanvasItemBounds] The child grid only returns children near the screen, in draw order") {
+	RenderingServerCanvas *canvas = memnew(RenderingServerCanvas);
+	canvas->use_spatial_index = true;
+
+	RID parent = canvas->canvas_item_create();
+	Vector<RID> children;
+	for (int i = 0; i < 300; i++) {
+		RID child = canvas->canvas_item_create();
+		canvas->canvas_item_add_rect(child, Rect2(0, 0, 10, 10), Color(1, 1, 1));
+		canvas->canvas_item_set_transform(child, Transform2D(0, Vector2(i * 20, 0)));
+		canvas->canvas_item_set_parent(child, parent);
+		children.push_back(child);
+	}
+
+	RenderingServerCanvas::Item *parent_item = canvas->canvas_item_owner.getornull(parent);
+	canvas->_update_item_bounds(parent_item);
+	canvas->_child_grid_build(parent_item);
+	REQUIRE(parent_item->child_grid);
+
+	check_grid_cull(canvas, parent_item, children);
+
+	// Moving children in and out of the screen only re-bins those children.
+	canvas->canvas_item_set_transform(children[299], Transform2D(0, Vector2(50, 50)));
+	canvas->canvas_item_set_transform(children[0], Transform2D(0, Vector2(3000, 500)));
+	CHECK(parent_item->child_grid->dirty.size() == 2);
+	check_grid_cull(canvas, parent_item, children);
+	CHECK(parent_item->child_grid->dirty.size() == 0);
+	CHECK(parent_item->child_grid->visible.find(canvas->canvas_item_owner.getornull(children[0])) < 0);
+	CHECK(bounds_match(canvas, parent));
+
+	for (int i = 0; i < children.size(); i++) {
+		canvas->free(children[i]);
+	}
+	canvas->free(parent);
+	memdelete(canvas);
+}
+
+} // namespace TestCanvasItemBounds
+
+#endif // TEST_CANVAS_ITEM_BOUNDS_H
@@ -0,0 +1,239 @@
+/*************************************************************************/
+/*  test_concave_polygon_shape_3d.h                                      */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_CONCAVE_POLYGON_SHAPE_3D_H
+#define TEST_CONCAVE_POLYGON_SHAPE_3D_H
+
+#include "core/math/geometry_3d.h"
+#include "core/math/random_pcg.h"
+#include "servers/physics_3d/shape_3d_sw.h"
+
+#include "tests/test_macros.h"
+
+namespace TestConcavePolygonShape3D {
+
+// A bumpy grid, large enough for the tree to have several levels.
+static Vector<Vector3> make_terrain(int p_size) {
+	Vector<Vector3> faces;
+	for (int z = 0; z < p_size; z++) {
+		for (int x = 0; x < p_size; x++) {
+			Vector3 v[4];
+			for (int i = 0; i < 4; i++) {
+				real_t vx = x + (i & 1);
+				real_t vz = z + (i >> 1);
+				v[i] = Vector3(vx, Math::sin(vx * 0.7) * Math::cos(vz * 0.4) * 2.0, vz);
+			}
+			faces.push_back(v[0]);
+			faces.push_back(v[1]);
+			faces.push_back(v[2]);
+			faces.push_back(v[2]);
+			faces.push_back(v[1]);
+			faces.push_back(v[3]);
+		}
+	}
+	return faces;
+}
+
+static bool brute_force_segment(const Vector<Vector3> &p_faces, const Vector3 &p_begin, const Vector3 &p_end, Vector3 &r_result, Vector3 &r_normal) {
+	real_t min_d = 1e20;
+	bool found = false;
+	Vector3 dir = (p_end - p_begin).normalized();
+	for (int i = 0; i < p_faces.size(); i += 3) {
+		Vector3 res;
+		if (Geometry3D::segment_intersects_triangle(p_begin, p_end, p_faces[i], p_faces[i + 1], p_faces[i + 2], &res)) {
+			real_t d = dir.dot(res) - dir.dot(p_begin);
+			if (d > 0 && d < min_d) {
+				min_d = d;
+				r_result = res;
+				r_normal = Face3(p_faces[i], p_faces[i + 1], p_faces[i + 2]).get_plane().normal;
+				found = true;
+			}
+		}
+	}
+	return found;
+}
+
+static int brute_force_aabb(const Vector<Vector3> &p_faces, const AABB &p_aabb) {
+	int count = 0;
+	for (int i = 0; i < p_faces.size(); i += 3) {
+		AABB face_aabb(p_faces[i], Vector3());
+		face_aabb.expand_to(p_faces[i + 1]);
+		face_aabb.expand_to(p_faces[i + 2]);
+		if (p_aabb.intersects(face_aabb)) {
+			count++;
+		}
+	}
+	return count;
+}
+
+template <class T>
+static bool is_same(const Vector<T> &p_a, const Vector<T> &p_b) {
+	if (p_a.size() != p_b.size()) {
+		return false;
+	}
+	for (int i = 0; i < p_a.size(); i++) {
+		if (p_a[i] != p_b[i]) {
+			return false;
+		}
+	}
+	return true;
+}
+
+struct CullResult {
+	AABB aabb;
+	int count = 0;
+	bool outside = false;
+};
+
+static void cull_callback(void *p_userdata, Shape3DSW *p_convex) {
+	CullResult *result = (CullResult *)p_userdata;
+	FaceShape3DSW *face = (FaceShape3DSW *)p_convex;
+	AABB face_aabb(face->vertex[0], Vector3());
+	face_aabb.expand_to(face->vertex[1]);
+	face_aabb.expand_to(face->vertex[2]);
+	if (!result->aabb.intersects(face_aabb)) {
+		result->outside = true;
+	}
+	result->count++;
+}
+
+TEST_CASE("[Physics][ConcavePolygonShape3DSW] Segment queries match a brute force search") {
+	Vector<Vector3> faces = make_terrain(24);
+	ConcavePolygonShape3DSW shape;
+	shape.set_data(faces);
+	REQUIRE(shape.bvh.size() > 1);
+
+	RandomPCG rng(1234);
+	int hits = 0;
+	for (int i = 0; i < 200; i++) {
+		Vector3 begin(rng.random(-2.0, 26.0), rng.random(-5.0, 5.0), rng.random(-2.0, 26.0));
+		Vector3 end(rng.random(-2.0, 26.0), rng.random(-5.0, 5.0), rng.random(-2.0, 26.0));
+
+		Vector3 expected_point, expected_normal;
+		bool expected = brute_force_segment(faces, begin, end, expected_point, expected_normal);
+
+		Vector3 point, normal;
+		bool hit = shape.intersect_segment(begin, end, point, normal);
+
+		CHECK_MESSAGE(hit == expected, vformat("Segment %d should %s the shape.", i, expected ? "hit" : "miss"));
+		if (hit && expected) {
+			CHECK_MESSAGE(point.is_equal_approx(expected_point), vformat("Segment %d should report the closest hit.", i));
+			CHECK_MESSAGE(normal.is_equal_approx(expected_normal), vformat("Segment %d should report the normal of the closest face.", i));
+			hits++;
+		}
+	}
+	CHECK_MESSAGE(hits > 20, "The random segments should hit the shape a fair number of times.");
+
+	Vector3 point, normal;
+	CHECK_MESSAGE(shape.intersect_segment(Vector3(12.3, 10, 7.7), Vector3(12.3, -10, 7.7), point, normal), "A vertical segment should hit the terrain.");
+	CHECK_MESSAGE(!shape.intersect_segment(Vector3(12.3, 10, 7.7), Vector3(12.3, 5, 7.7), point, normal), "A segment above the terrain should miss it.");
+}
+
+TEST_CASE("[Physics][ConcavePolygonShape3DSW] AABB queries match a brute force search") {
+	Vector<Vector3> faces = make_terrain(24);
+	ConcavePolygonShape3DSW shape;
+	shape.set_data(faces);
+
+	RandomPCG rng(4321);
+	for (int i = 0; i < 200; i++) {
+		CullResult result;
+		result.aabb = AABB(Vector3(rng.random(-4.0, 26.0), rng.random(-4.0, 4.0), rng.random(-4.0, 26.0)), Vector3(rng.random(0.0, 6.0), rng.random(0.0, 3.0), rng.random(0.0, 6.0)));
+		shape.cull(result.aabb, cull_callback, &result);
+
+		CHECK_MESSAGE(result.count == brute_force_aabb(faces, result.aabb), vformat("AABB %d should report every overlapping face once.", i));
+		CHECK_MESSAGE(!result.outside, vformat("AABB %d should not report faces outside of it.", i));
+	}
+
+	CullResult all;
+	all.aabb = shape.get_aabb().grow(1.0);
+	shape.cull(all.aabb, cull_callback, &all);
+	CHECK_MESSAGE(all.count == faces.size() / 3, "An AABB around the shape should report all faces.");
+}
+
+TEST_CASE("[Physics][ConcavePolygonShape3DSW] BVH cache round trip") {
+	Vector<Vector3> faces = make_terrain(16);
+	ConcavePolygonShape3DSW shape;
+	shape.set_data(faces);
+
+	Vector<uint8_t> cache = shape.get_bvh_data();
+	REQUIRE(cache.size() > 0);
+
+	Dictionary data;
+	data["faces"] = faces;
+	data["bvh"] = cache;
+
+	ConcavePolygonShape3DSW loaded;
+	loaded.set_data(data);
+
+	CHECK_MESSAGE(is_same(loaded.get_bvh_data(), cache), "A loaded tree should be saved back unchanged.");
+	REQUIRE(loaded.bvh.size() == shape.bvh.size());
+	REQUIRE(loaded.bvh_faces.size() == shape.bvh_faces.size());
+	bool same_nodes = true;
+	for (int i = 0; i < shape.bvh.size(); i++) {
+		const ConcavePolygonShape3DSW::BVH &a = shape.bvh[i];
+		const ConcavePolygonShape3DSW::BVH &b = loaded.bvh[i];
+		for (int j = 0; j < 3; j++) {
+			same_nodes = same_nodes && a.min[j] == b.min[j] && a.max[j] == b.max[j];
+		}
+		same_nodes = same_nodes && a.data == b.data;
+	}
+	CHECK_MESSAGE(same_nodes, "A loaded tree should have the same nodes.");
+	CHECK_MESSAGE(is_same(loaded.bvh_faces, shape.bvh_faces), "A loaded tree should have the same leaf faces.");
+
+	Vector3 point, normal;
+	CHECK_MESSAGE(loaded.intersect_segment(Vector3(8.5, 10, 8.5), Vector3(8.5, -10, 8.5), point, normal), "A loaded tree should be usable for queries.");
+
+	SUBCASE("Caches that don't match are rejected") {
+		CHECK_MESSAGE(loaded._load_bvh(cache), "The cache should load for the faces it was built for.");
+
+		Vector<uint8_t> truncated = cache;
+		truncated.resize(cache.size() - 4);
+		CHECK_MESSAGE(!loaded._load_bvh(truncated), "A truncated cache should be rejected.");
+
+		Vector<uint8_t> corrupt = cache;
+		corrupt.write[0] = 'X';
+		CHECK_MESSAGE(!loaded._load_bvh(corrupt), "A cache with a bad header should be rejected.");
+
+		ConcavePolygonShape3DSW other;
+		other.set_data(make_terrain(12));
+		CHECK_MESSAGE(!other._load_bvh(cache), "A cache built for other faces should be rejected.");
+
+		Dictionary mismatched;
+		mismatched["faces"] = make_terrain(12);
+		mismatched["bvh"] = cache;
+		other.set_data(mismatched);
+		CHECK_MESSAGE(other.bvh.size() > 0, "A rejected cache should be replaced by a new tree.");
+		CHECK_MESSAGE(other.intersect_segment(Vector3(6.5, 10, 6.5), Vector3(6.5, -10, 6.5), point, normal), "A rebuilt tree should be usable for queries.");
+	}
+}
+
+} // namespace TestConcavePolygonShape3D
+
+#endif // TEST_CONCAVE_POLYGON_SHAPE_3D_H
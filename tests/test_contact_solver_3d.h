@@ -0,0 +1,187 @@
+/*************************************************************************/
+/*  test_contact_solver_3d.h                                             */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_CONTACT_SOLVER_3D_H
+#define TEST_CONTACT_SOLVER_3D_H
+
+#include "core/project_settings.h"
+#include "servers/physics_3d/physics_server_3d_sw.h"
+
+#include "tests/test_macros.h"
+
+namespace TestContactSolver3D {
+
+struct BodyResult {
+	Transform transform;
+	Vector3 linear_velocity;
+	Vector3 angular_velocity;
+};
+
+// Boxes resting, sliding and spinning on a floor, far enough apart to never touch each
+// other. The batched solver reorders contacts between bodies, so only contacts that share
+// no dynamic body are expected to give the same result in both solvers.
+static Vector<BodyResult> simulate(bool p_batched, int p_frames) {
+	PhysicsServer3DSW *ps = memnew(PhysicsServer3DSW);
+	ps->init();
+
+	// Spaces read the setting when they are created.
+	Variant batched_setting = ProjectSettings::get_singleton()->get("physics/3d/batched_contact_solver");
+	ProjectSettings::get_singleton()->set("physics/3d/batched_contact_solver", p_batched);
+	RID space = ps->space_create();
+	ProjectSettings::get_singleton()->set("physics/3d/batched_contact_solver", batched_setting);
+	ps->space_set_active(space, true);
+	REQUIRE(ps->get_space(space)->is_using_batched_contact_solver() == p_batched);
+
+	RID floor_shape = ps->shape_create(PhysicsServer3D::SHAPE_BOX);
+	ps->shape_set_data(floor_shape, Vector3(50, 1, 50));
+	RID floor = ps->body_create(PhysicsServer3D::BODY_MODE_STATIC);
+	ps->body_set_space(floor, space);
+	ps->body_add_shape(floor, floor_shape);
+	ps->body_set_state(floor, PhysicsServer3D::BODY_STATE_TRANSFORM, Transform(Basis(), Vector3(0, -1, 0)));
+
+	RID box_shape = ps->shape_create(PhysicsServer3D::SHAPE_BOX);
+	ps->shape_set_data(box_shape, Vector3(0.5, 0.5, 0.5));
+
+	Vector<RID> boxes;
+	for (int i = 0; i < 8; i++) {
+		RID box = ps->body_create(PhysicsServer3D::BODY_MODE_RIGID);
+		ps->body_set_space(box, space);
+		ps->body_add_shape(box, box_shape);
+		// Start slightly inside the floor, so the bias impulses have work to do.
+		Transform xform(Basis(Vector3(0, 1, 0), i * 0.3), Vector3((i - 4) * 3.0, 0.45 + i * 0.01, 0));
+		ps->body_set_state(box, PhysicsServer3D::BODY_STATE_TRANSFORM, xform);
+		ps->body_set_state(box, PhysicsServer3D::BODY_STATE_LINEAR_VELOCITY, Vector3(i * 0.5, -1, (i & 1) ? 1 : -1));
+		ps->body_set_state(box, PhysicsServer3D::BODY_STATE_ANGULAR_VELOCITY, Vector3(0, i * 0.7, 0));
+		boxes.push_back(box);
+	}
+
+	for (int i = 0; i < p_frames; i++) {
+		ps->step(1.0 / 60.0);
+		ps->flush_queries();
+	}
+
+	Vector<BodyResult> results;
+	for (int i = 0; i < boxes.size(); i++) {
+		BodyResult result;
+		result.transform = ps->body_get_state(boxes[i], PhysicsServer3D::BODY_STATE_TRANSFORM);
+		result.linear_velocity = ps->body_get_state(boxes[i], PhysicsServer3D::BODY_STATE_LINEAR_VELOCITY);
+		result.angular_velocity = ps->body_get_state(boxes[i], PhysicsServer3D::BODY_STATE_ANGULAR_VELOCITY);
+		results.push_back(result);
+		ps->free(boxes[i]);
+	}
+
+	ps->free(floor);
+	ps->free(box_shape);
+	ps->free(floor_shape);
+	ps->free(space);
+	ps->finish();
+	memdelete(ps);
+
+	return results;
+}
+
+static bool is_close(const Vector3 &p_a, const Vector3 &p_b) {
+	// Only rounding differs between the two solvers.
+	return (p_a - p_b).length() < 1e-3;
+}
+
+TEST_CASE("[Physics][ContactSolver3D] Scalar bias impulses push a box straight out of the floor") {
+	PhysicsServer3DSW *ps = memnew(PhysicsServer3DSW);
+	ps->init();
+
+	Variant batched_setting = ProjectSettings::get_singleton()->get("physics/3d/batched_contact_solver");
+	ProjectSettings::get_singleton()->set("physics/3d/batched_contact_solver", false);
+	RID space = ps->space_create();
+	ProjectSettings::get_singleton()->set("physics/3d/batched_contact_solver", batched_setting);
+	ps->space_set_active(space, true);
+
+	RID floor_shape = ps->shape_create(PhysicsServer3D::SHAPE_BOX);
+	ps->shape_set_data(floor_shape, Vector3(50, 1, 50));
+	RID floor = ps->body_create(PhysicsServer3D::BODY_MODE_STATIC);
+	ps->body_set_space(floor, space);
+	ps->body_add_shape(floor, floor_shape);
+	ps->body_set_state(floor, PhysicsServer3D::BODY_STATE_TRANSFORM, Transform(Basis(), Vector3(0, -1, 0)));
+
+	// A flat box sunk into the floor, away from the origin. Only the bias impulses move
+	// it, and its contacts are symmetric, so it must come out without drifting or tilting.
+	RID box_shape = ps->shape_create(PhysicsServer3D::SHAPE_BOX);
+	ps->shape_set_data(box_shape, Vector3(0.5, 0.5, 0.5));
+	RID box = ps->body_create(PhysicsServer3D::BODY_MODE_RIGID);
+	ps->body_set_space(box, space);
+	ps->body_add_shape(box, box_shape);
+	ps->body_set_state(box, PhysicsServer3D::BODY_STATE_TRANSFORM, Transform(Basis(), Vector3(6, 0.4, 3)));
+
+	for (int i = 0; i < 10; i++) {
+		ps->step(1.0 / 60.0);
+		ps->flush_queries();
+	}
+
+	Transform xform = ps->body_get_state(box, PhysicsServer3D::BODY_STATE_TRANSFORM);
+	CHECK_MESSAGE(xform.origin.y > 0.4, "The box should be pushed out of the floor.");
+	CHECK_MESSAGE(Math::abs(xform.origin.x - 6.0) < 1e-3, "The box should not drift sideways.");
+	CHECK_MESSAGE(Math::abs(xform.origin.z - 3.0) < 1e-3, "The box should not drift sideways.");
+	CHECK_MESSAGE(xform.basis.is_equal_approx(Basis()), "The box should not tilt.");
+
+	ps->free(box);
+	ps->free(floor);
+	ps->free(box_shape);
+	ps->free(floor_shape);
+	ps->free(space);
+	ps->finish();
+	memdelete(ps);
+}
+
+TEST_CASE("[Physics][ContactSolver3D] Batched and scalar solvers apply the same impulses") {
+	const int frames = 20;
+	Vector<BodyResult> scalar = simulate(false, frames);
+	Vector<BodyResult> batched = simulate(true, frames);
+
+	REQUIRE(scalar.size() == batched.size());
+	for (int i = 0; i < scalar.size(); i++) {
+		CHECK_MESSAGE(is_close(scalar[i].linear_velocity, batched[i].linear_velocity), vformat("Linear velocity of box %d should match.", i));
+		CHECK_MESSAGE(is_close(scalar[i].angular_velocity, batched[i].angular_velocity), vformat("Angular velocity of box %d should match.", i));
+		CHECK_MESSAGE(is_close(scalar[i].transform.origin, batched[i].transform.origin), vformat("Position of box %d should match.", i));
+		CHECK_MESSAGE(scalar[i].transform.basis.is_equal_approx(batched[i].transform.basis), vformat("Rotation of box %d should match.", i));
+	}
+}
+
+TEST_CASE("[Physics][ContactSolver3D] Resting box is held by the floor") {
+	Vector<BodyResult> scalar = simulate(false, 60);
+	Vector<BodyResult> batched = simulate(true, 60);
+
+	for (int i = 0; i < scalar.size(); i++) {
+		CHECK_MESSAGE(scalar[i].transform.origin.y > 0.4, "The scalar solver should keep the box above the floor.");
+		CHECK_MESSAGE(batched[i].transform.origin.y > 0.4, "The batched solver should keep the box above the floor.");
+	}
+}
+
+} // namespace TestContactSolver3D
+
+#endif // TEST_CONTACT_SOLVER_3D_H
@@ -34,21 +34,33 @@
 
 #include "test_astar.h"
 #include "test_basis.h"
+#include "test_canvas_item_bounds.h"
 #include "test_class_db.h"
 #include "test_color.h"
+#include "test_concave_polygon_shape_3d.h"
+#include "test_contact_solver_3d.h"
 #include "test_gdscript.h"
 #include "test_gradient.h"
 #include "test_gui.h"
 #include "test_math.h"
+#include "test_mesh_optimizer.h"
+#include "test_node_3d.h"
 #include "test_oa_hash_map.h"
+#include "test_occlusion_buffer.h"
 #include "test_ordered_hash_map.h"
 #include "test_physics_2d.h"
 #include "test_physics_3d.h"
+#include "test_physics_benchmark.h"
+#include "test_physics_query_filter.h"
+#include "test_physics_server_3d_wrap_mt.h"
 #include "test_render.h"
+#include "test_scene_pool.h"
 #include "test_shader_lang.h"
 #include "test_string.h"
+#include "test_texture_streaming.h"
 #include "test_validate_testing.h"
 #include "test_variant.h"
+#include "test_visibility_range.h"
 
 #include "modules/modules_tests.gen.h"
 
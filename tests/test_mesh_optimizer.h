@@ -0,0 +1,306 @@
+/*************************************************************************/
+/*  test_mesh_optimizer.h                                                */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_MESH_OPTIMIZER_H
+#define TEST_MESH_OPTIMIZER_H
+
+#include "core/math/face3.h"
+#include "core/math/mesh_optimizer.h"
+
+#include "tests/test_macros.h"
+
+namespace TestMeshOptimizer {
+
+// Flat grid of p_size x p_size quads in the XZ plane, all wound the same way.
+static void make_grid(int p_size, Vector<Vector3> &r_vertices, Vector<int> &r_indices) {
+	for (int y = 0; y <= p_size; y++) {
+		for (int x = 0; x <= p_size; x++) {
+			r_vertices.push_back(Vector3(x, 0, y));
+		}
+	}
+	for (int y = 0; y < p_size; y++) {
+		for (int x = 0; x < p_size; x++) {
+			int i = y * (p_size + 1) + x;
+			r_indices.push_back(i);
+			r_indices.push_back(i + p_size + 1);
+			r_indices.push_back(i + 1);
+			r_indices.push_back(i + 1);
+			r_indices.push_back(i + p_size + 1);
+			r_indices.push_back(i + p_size + 2);
+		}
+	}
+}
+
+// Closed UV sphere with the poles welded, so every vertex is interior.
+static void make_sphere(int p_rings, int p_segments, Vector<Vector3> &r_vertices, Vector<int> &r_indices) {
+	r_vertices.push_back(Vector3(0, 1, 0));
+	for (int r = 1; r < p_rings; r++) {
+		float phi = Math_PI * r / p_rings;
+		for (int s = 0; s < p_segments; s++) {
+			float theta = Math_TAU * s / p_segments;
+			r_vertices.push_back(Vector3(Math::sin(phi) * Math::cos(theta), Math::cos(phi), Math::sin(phi) * Math::sin(theta)));
+		}
+	}
+	r_vertices.push_back(Vector3(0, -1, 0));
+	int bottom = r_vertices.size() - 1;
+
+	for (int s = 0; s < p_segments; s++) {
+		int n = (s + 1) % p_segments;
+		r_indices.push_back(0);
+		r_indices.push_back(1 + n);
+		r_indices.push_back(1 + s);
+		for (int r = 0; r < p_rings - 2; r++) {
+			int a = 1 + r * p_segments;
+			int b = a + p_segments;
+			r_indices.push_back(a + s);
+			r_indices.push_back(a + n);
+			r_indices.push_back(b + s);
+			r_indices.push_back(a + n);
+			r_indices.push_back(b + n);
+			r_indices.push_back(b + s);
+		}
+		int last = 1 + (p_rings - 2) * p_segments;
+		r_indices.push_back(bottom);
+		r_indices.push_back(last + s);
+		r_indices.push_back(last + n);
+	}
+}
+
+// Average number of vertex transforms per triangle with a FIFO cache.
+static float acmr(const Vector<int> &p_indices, int p_vertex_count, int p_cache_size) {
+	Vector<int> timestamps;
+	timestamps.resize(p_vertex_count);
+	for (int i = 0; i < p_vertex_count; i++) {
+		timestamps.write[i] = -p_cache_size - 1;
+	}
+	int time = 0;
+	int misses = 0;
+	for (int i = 0; i < p_indices.size(); i++) {
+		if (time - timestamps[p_indices[i]] > p_cache_size) {
+			timestamps.write[p_indices[i]] = time++;
+			misses++;
+		}
+	}
+	return float(misses) / (p_indices.size() / 3);
+}
+
+// Triangles as sorted keys, to compare index lists regardless of the triangle order.
+static Vector<int64_t> triangle_keys(const Vector<int> &p_indices) {
+	Vector<int64_t> keys;
+	for (int i = 0; i < p_indices.size(); i += 3) {
+		int a = p_indices[i];
+		int b = p_indices[i + 1];
+		int c = p_indices[i + 2];
+		// Rotate so the smallest index is first, which keeps the winding.
+		while (a > b || a > c) {
+			int t = a;
+			a = b;
+			b = c;
+			c = t;
+		}
+		keys.push_back((int64_t(a) << 40) | (int64_t(b) << 20) | int64_t(c));
+	}
+	keys.sort();
+	return keys;
+}
+
+// Largest distance from the surface of p_from to the surface of p_to, sampled on a barycentric
+// grid over every triangle of p_from.
+static float surface_distance(const Vector<Vector3> &p_vertices, const Vector<int> &p_from, const Vector<int> &p_to) {
+	const int steps = 4;
+	float max_distance = 0.0;
+	for (int i = 0; i < p_from.size(); i += 3) {
+		const Vector3 &a = p_vertices[p_from[i]];
+		const Vector3 &b = p_vertices[p_from[i + 1]];
+		const Vector3 &c = p_vertices[p_from[i + 2]];
+		for (int u = 0; u <= steps; u++) {
+			for (int v = 0; u + v <= steps; v++) {
+				Vector3 point = a + (b - a) * (float(u) / steps) + (c - a) * (float(v) / steps);
+				float distance = 1e20;
+				for (int j = 0; j < p_to.size() && distance > max_distance; j += 3) {
+					Face3 face(p_vertices[p_to[j]], p_vertices[p_to[j + 1]], p_vertices[p_to[j + 2]]);
+					distance = MIN(distance, face.get_closest_point_to(point).distance_to(point));
+				}
+				max_distance = MAX(max_distance, distance);
+			}
+		}
+	}
+	return max_distance;
+}
+
+static bool same_triangles(const Vector<int> &p_a, const Vector<int> &p_b) {
+	Vector<int64_t> a = triangle_keys(p_a);
+	Vector<int64_t> b = triangle_keys(p_b);
+	if (a.size() != b.size()) {
+		return false;
+	}
+	for (int i = 0; i < a.size(); i++) {
+		if (a[i] != b[i]) {
+			return false;
+		}
+	}
+	return true;
+}
+
+TEST_CASE("[MeshOptimizer] Vertex cache and overdraw ordering keep the triangles") {
+	Vector<Vector3> vertices;
+	Vector<int> indices;
+	make_grid(32, vertices, indices);
+
+	// Scramble the triangle order so there is something to optimize.
+	Vector<int> scrambled;
+	int triangle_count = indices.size() / 3;
+	for (int i = 0; i < triangle_count; i++) {
+		int t = (i * 617) % triangle_count;
+		for (int j = 0; j < 3; j++) {
+			scrambled.push_back(indices[t * 3 + j]);
+		}
+	}
+	REQUIRE(same_triangles(scrambled, indices));
+
+	Vector<int> optimized = scrambled;
+	MeshOptimizer::optimize_vertex_cache(optimized.ptrw(), optimized.size(), vertices.size());
+	CHECK(same_triangles(optimized, indices));
+	CHECK_MESSAGE(acmr(optimized, vertices.size(), 16) < acmr(scrambled, vertices.size(), 16) * 0.5,
+			"Cache optimized order should transform far fewer vertices.");
+	CHECK(acmr(optimized, vertices.size(), 16) < 1.0);
+
+	Vector<int> overdraw = optimized;
+	MeshOptimizer::optimize_overdraw(overdraw.ptrw(), overdraw.size(), vertices.ptr(), vertices.size());
+	CHECK(same_triangles(overdraw, indices));
+}
+
+TEST_CASE("[MeshOptimizer] Simplifying a flat grid is lossless and keeps its border") {
+	Vector<Vector3> vertices;
+	Vector<int> indices;
+	make_grid(16, vertices, indices);
+
+	float error = -1.0;
+	Vector<int> simplified = MeshOptimizer::simplify(indices.ptr(), indices.size(), vertices.ptr(), vertices.size(), 0, 0.001, &error);
+
+	CHECK(simplified.size() < indices.size() / 4);
+	CHECK(error == doctest::Approx(0.0));
+
+	bool facing_up = true;
+	Vector<bool> used;
+	used.resize(vertices.size());
+	for (int i = 0; i < used.size(); i++) {
+		used.write[i] = false;
+	}
+	for (int i = 0; i < simplified.size(); i += 3) {
+		const Vector3 &a = vertices[simplified[i]];
+		const Vector3 &b = vertices[simplified[i + 1]];
+		const Vector3 &c = vertices[simplified[i + 2]];
+		facing_up = facing_up && (b - a).cross(c - a).y > 0.0;
+		used.write[simplified[i]] = used.write[simplified[i + 1]] = used.write[simplified[i + 2]] = true;
+	}
+	CHECK_MESSAGE(facing_up, "No triangle should flip.");
+
+	bool border_kept = true;
+	for (int i = 0; i <= 16; i++) {
+		border_kept = border_kept && used[i] && used[16 * 17 + i] && used[i * 17] && used[i * 17 + 16];
+	}
+	CHECK_MESSAGE(border_kept, "Open border vertices should not move.");
+}
+
+TEST_CASE("[MeshOptimizer] Simplification respects the error bound and seams") {
+	Vector<Vector3> vertices;
+	Vector<int> indices;
+	make_sphere(24, 48, vertices, indices);
+
+	float error = 0.0;
+	Vector<int> simplified = MeshOptimizer::simplify(indices.ptr(), indices.size(), vertices.ptr(), vertices.size(), indices.size() / 4, 0.05, &error);
+	CHECK(simplified.size() <= indices.size() / 4 + 6);
+	CHECK(error > 0.0);
+	CHECK(error <= 0.05);
+
+	// A tiny error budget stops well before the target.
+	Vector<int> strict = MeshOptimizer::simplify(indices.ptr(), indices.size(), vertices.ptr(), vertices.size(), 0, 0.0001, &error);
+	CHECK(strict.size() > indices.size() / 2);
+
+	// Duplicate a vertex (as a UV seam would), it must survive simplification.
+	int seam_vertex = 1 + 12 * 48;
+	vertices.push_back(vertices[seam_vertex]);
+	int twin = vertices.size() - 1;
+	for (int i = 0; i < indices.size(); i += 3) {
+		if (indices[i] == seam_vertex || indices[i + 1] == seam_vertex || indices[i + 2] == seam_vertex) {
+			for (int j = 0; j < 3; j++) {
+				if (indices[i + j] == seam_vertex) {
+					indices.write[i + j] = twin;
+				}
+			}
+			break;
+		}
+	}
+	simplified = MeshOptimizer::simplify(indices.ptr(), indices.size(), vertices.ptr(), vertices.size(), 0, 1.0, &error);
+	CHECK(simplified.find(seam_vertex) != -1);
+	CHECK(simplified.find(twin) != -1);
+}
+
+TEST_CASE("[MeshOptimizer] The reported error bounds the distance to the original surface") {
+	Vector<Vector3> vertices;
+	Vector<int> indices;
+	make_sphere(16, 32, vertices, indices);
+
+	float error = 0.0;
+	Vector<int> simplified = MeshOptimizer::simplify(indices.ptr(), indices.size(), vertices.ptr(), vertices.size(), indices.size() / 4, 0.05, &error);
+	REQUIRE(simplified.size() < indices.size());
+	CHECK(surface_distance(vertices, indices, simplified) <= error + 1e-4);
+
+	Vector<MeshOptimizer::LOD> lods = MeshOptimizer::generate_lods(indices.ptr(), indices.size(), vertices.ptr(), vertices.size());
+	REQUIRE(lods.size() > 0);
+	for (int i = 0; i < lods.size(); i++) {
+		CHECK(surface_distance(vertices, indices, lods[i].indices) <= lods[i].error + 1e-4);
+	}
+}
+
+TEST_CASE("[MeshOptimizer] LOD chain") {
+	Vector<Vector3> vertices;
+	Vector<int> indices;
+	make_sphere(32, 64, vertices, indices);
+
+	Vector<MeshOptimizer::LOD> lods = MeshOptimizer::generate_lods(indices.ptr(), indices.size(), vertices.ptr(), vertices.size());
+	REQUIRE(lods.size() >= 3);
+
+	int previous_count = indices.size();
+	float previous_error = 0.0;
+	for (int i = 0; i < lods.size(); i++) {
+		CHECK(lods[i].indices.size() < previous_count);
+		CHECK(lods[i].indices.size() % 3 == 0);
+		CHECK(lods[i].error > previous_error);
+		CHECK(lods[i].error <= 0.2); // 10% of the sphere's size.
+		previous_count = lods[i].indices.size();
+		previous_error = lods[i].error;
+	}
+}
+
+} // namespace TestMeshOptimizer
+
+#endif // TEST_MESH_OPTIMIZER_H
@@ -0,0 +1,263 @@
+/*************************************************************************/
+/*  test_node_3d.h                                                       */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_NODE_3D_H
+#define TEST_NODE_3D_H
+
+#include "core/os/os.h"
+#include "scene/3d/node_3d.h"
+#include "scene/main/scene_tree.h"
+#include "scene/main/window.h"
+#include "servers/rendering_server.h"
+
+#include "tests/test_macros.h"
+
+// Transform change notifications through a live SceneTree. The root viewport of
+// the tree needs the rendering server, which the test runner doesn't start, so
+// these are skipped by default. Where the servers are up, run them with:
+//
+//     godot --test --test-case="[Node3D]*" --no-skip
+
+namespace TestNode3D {
+
+// Reads its global transform when notified, like VisualInstance3D does.
+class TransformWatcher : public Node3D {
+	GDCLASS(TransformWatcher, Node3D);
+
+protected:
+	void _notification(int p_what) {
+		if (p_what == NOTIFICATION_TRANSFORM_CHANGED) {
+			notified++;
+			notified_transform = get_global_transform();
+		}
+	}
+
+public:
+	int notified = 0;
+	Transform notified_transform;
+
+	void ignore_transform_notification(bool p_ignore) {
+		set_ignore_transform_notification(p_ignore);
+	}
+};
+
+static SceneTree *create_tree() {
+	if (!RenderingServer::get_singleton()) {
+		return nullptr;
+	}
+	SceneTree *tree = memnew(SceneTree);
+	tree->init();
+	return tree;
+}
+
+static void free_tree(SceneTree *p_tree) {
+	p_tree->finish();
+	memdelete(p_tree);
+}
+
+TEST_CASE("[Node3D] Dirty nodes don't hide notifying descendants" * doctest::skip()) {
+	SceneTree *tree = create_tree();
+	if (!tree) {
+		MESSAGE("No rendering server to build a SceneTree with, skipping.");
+		return;
+	}
+
+	Node3D *parent = memnew(Node3D);
+	tree->get_root()->add_child(parent);
+	Node3D *middle = memnew(Node3D);
+	parent->add_child(middle);
+	TransformWatcher *watcher = memnew(TransformWatcher);
+	middle->add_child(watcher);
+	tree->flush_transform_notifications();
+	watcher->get_global_transform();
+
+	SUBCASE("Reparenting") {
+		watcher->set_notify_transform(true);
+		Node3D *other = memnew(Node3D);
+		tree->get_root()->add_child(other);
+		tree->flush_transform_notifications();
+		watcher->notified = 0;
+
+		// Leave both the old and the new parent dirty across the move.
+		parent->set_translation(Vector3(1, 0, 0));
+		other->set_translation(Vector3(0, 2, 0));
+		middle->remove_child(watcher);
+		other->add_child(watcher);
+		other->set_translation(Vector3(0, 3, 0));
+
+		tree->flush_transform_notifications();
+		CHECK_MESSAGE(watcher->notified == 1, "Entering the tree queues the notification.");
+		CHECK(watcher->notified_transform.origin.is_equal_approx(Vector3(0, 3, 0)));
+
+		other->set_translation(Vector3(0, 4, 0));
+		tree->flush_transform_notifications();
+		CHECK_MESSAGE(watcher->notified == 2, "A moved parent reaches the reparented node.");
+		CHECK(watcher->notified_transform.origin.is_equal_approx(Vector3(0, 4, 0)));
+	}
+
+	SUBCASE("Enabling notifications") {
+		// The whole chain goes dirty while nobody below wants to hear about it.
+		parent->set_translation(Vector3(1, 0, 0));
+		middle->set_translation(Vector3(0, 1, 0));
+		watcher->set_notify_transform(true);
+		tree->flush_transform_notifications();
+		CHECK(watcher->notified == 0);
+
+		parent->set_translation(Vector3(2, 0, 0));
+		tree->flush_transform_notifications();
+		CHECK_MESSAGE(watcher->notified == 1, "Enabling notifications on a dirty node resolves it.");
+		CHECK(watcher->notified_transform.origin.is_equal_approx(Vector3(2, 1, 0)));
+	}
+
+	SUBCASE("Ignoring notifications") {
+		watcher->set_notify_transform(true);
+		watcher->ignore_transform_notification(true);
+		parent->set_translation(Vector3(1, 0, 0));
+		tree->flush_transform_notifications();
+		CHECK(watcher->notified == 0);
+
+		watcher->ignore_transform_notification(false);
+		parent->set_translation(Vector3(2, 0, 0));
+		tree->flush_transform_notifications();
+		CHECK_MESSAGE(watcher->notified == 1, "Listening again on a dirty node resolves it.");
+		CHECK(watcher->notified_transform.origin.is_equal_approx(Vector3(2, 0, 0)));
+	}
+
+	free_tree(tree);
+}
+
+TEST_CASE("[Node3D] Notifications match the transforms through an animated hierarchy" * doctest::skip()) {
+	SceneTree *tree = create_tree();
+	if (!tree) {
+		MESSAGE("No rendering server to build a SceneTree with, skipping.");
+		return;
+	}
+
+	// A chain where only every third node listens, animated from the top down
+	// and bottom up, one property at a time.
+	const int length = 12;
+	Vector<TransformWatcher *> chain;
+	Node *parent = tree->get_root();
+	for (int i = 0; i < length; i++) {
+		TransformWatcher *node = memnew(TransformWatcher);
+		node->set_notify_transform(i % 3 == 2);
+		parent->add_child(node);
+		chain.push_back(node);
+		parent = node;
+	}
+	tree->flush_transform_notifications();
+
+	for (int frame = 0; frame < 8; frame++) {
+		for (int i = 0; i < length; i++) {
+			chain[i]->notified = 0;
+		}
+		for (int i = 0; i < length; i++) {
+			int index = frame % 2 ? length - 1 - i : i;
+			chain[index]->set_translation(Vector3(0, 0.1 * (frame + 1), 0));
+			chain[index]->set_rotation(Vector3(0, 0.05 * frame, 0));
+		}
+		tree->flush_transform_notifications();
+
+		Transform expected;
+		for (int i = 0; i < length; i++) {
+			expected = expected * chain[i]->get_transform();
+			if (i % 3 == 2) {
+				CHECK_MESSAGE(chain[i]->notified == 1, vformat("Node %d was notified once on frame %d.", i, frame));
+				CHECK(chain[i]->notified_transform.is_equal_approx(expected));
+			}
+			CHECK(chain[i]->get_global_transform().is_equal_approx(expected));
+		}
+	}
+
+	free_tree(tree);
+}
+
+// A crowd of characters, each with a skeleton-like hierarchy of bones that
+// all listen for transform changes, animated the way an AnimationPlayer sets
+// tracks: every bone gets its translation, rotation and scale set separately,
+// parents first. Flushing includes resolving the global transforms, as the
+// listeners read them.
+TEST_CASE("[Node3D][Benchmark] Animated hierarchy" * doctest::skip()) {
+	SceneTree *tree = create_tree();
+	if (!tree) {
+		MESSAGE("No rendering server to build a SceneTree with, skipping.");
+		return;
+	}
+
+	const int characters = 50;
+	const int limbs = 5;
+	const int limb_length = 6;
+	const int frames = 200;
+
+	Vector<Node3D *> bones;
+	for (int c = 0; c < characters; c++) {
+		Node3D *root = memnew(TransformWatcher);
+		root->set_notify_transform(true);
+		tree->get_root()->add_child(root);
+		bones.push_back(root);
+		for (int l = 0; l < limbs; l++) {
+			Node3D *parent = root;
+			for (int i = 0; i < limb_length; i++) {
+				Node3D *bone = memnew(TransformWatcher);
+				bone->set_notify_transform(true);
+				parent->add_child(bone);
+				bones.push_back(bone);
+				parent = bone;
+			}
+		}
+	}
+	tree->flush_transform_notifications();
+
+	uint64_t set_usec = 0;
+	uint64_t flush_usec = 0;
+	for (int frame = 0; frame < frames; frame++) {
+		real_t t = frame / 60.0;
+		uint64_t begin = OS::get_singleton()->get_ticks_usec();
+		for (int i = 0; i < bones.size(); i++) {
+			bones[i]->set_translation(Vector3(0, 0.1, Math::sin(t + i) * 0.01));
+			bones[i]->set_rotation(Vector3(Math::sin(t * 2.0 + i) * 0.2, 0, 0));
+			bones[i]->set_scale(Vector3(1, 1, 1) * (1.0 + Math::sin(t) * 0.01));
+		}
+		uint64_t set_end = OS::get_singleton()->get_ticks_usec();
+		tree->flush_transform_notifications();
+		uint64_t flush_end = OS::get_singleton()->get_ticks_usec();
+		set_usec += set_end - begin;
+		flush_usec += flush_end - set_end;
+	}
+
+	print_line(vformat("Animated hierarchy: %d bones, %d frames, %.3f ms/frame setting tracks, %.3f ms/frame flushing notifications",
+			bones.size(), frames, double(set_usec) / frames / 1000.0, double(flush_usec) / frames / 1000.0));
+
+	free_tree(tree);
+}
+
+} // namespace TestNode3D
+
+#endif // TEST_NODE_3D_H
@@ -0,0 +1,132 @@
+/*************************************************************************/
+/*  test_occlusion_buffer.h                                              */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_OCCLUSION_BUFFER_H
+#define TEST_OCCLUSION_BUFFER_H
+
+#include "servers/rendering/occlusion_buffer_sw.h"
+
+#include "tests/test_macros.h"
+
+namespace TestOcclusionBuffer {
+
+static const uint32_t quad_indices[6] = { 0, 1, 2, 0, 2, 3 };
+
+static void begin_default(OcclusionBufferSW &r_buffer) {
+	CameraMatrix projection;
+	projection.set_perspective(70, 16.0 / 9.0, 0.05, 100);
+	r_buffer.set_size(128, 72);
+	r_buffer.begin(Transform(), projection);
+}
+
+// View space x that projects to a horizontal pixel coordinate of begin_default's buffer at a given distance.
+static float pixel_to_x(float p_pixel, float p_distance) {
+	return (p_pixel / 128.0 * 2.0 - 1.0) * Math::tan(Math::deg2rad(35.0)) * 16.0 / 9.0 * p_distance;
+}
+
+TEST_CASE("[OcclusionBuffer] Empty buffer occludes nothing") {
+	OcclusionBufferSW buffer;
+	begin_default(buffer);
+
+	CHECK(buffer.is_empty());
+	CHECK(!buffer.is_occluded(AABB(Vector3(-1, -1, -30), Vector3(2, 2, 2))));
+}
+
+TEST_CASE("[OcclusionBuffer] Wall hides what is behind it") {
+	OcclusionBufferSW buffer;
+	begin_default(buffer);
+
+	// 20x20 wall, 10 units in front of the camera.
+	Vector3 wall[4] = { Vector3(-10, -10, -10), Vector3(10, -10, -10), Vector3(10, 10, -10), Vector3(-10, 10, -10) };
+	buffer.draw_triangles(Transform(), wall, quad_indices, 6);
+
+	CHECK(!buffer.is_empty());
+	CHECK(buffer.get_depth(64, 36) == doctest::Approx(10.0));
+
+	CHECK_MESSAGE(buffer.is_occluded(AABB(Vector3(-1, -1, -30), Vector3(2, 2, 2))),
+			"A box straight behind the wall should be occluded.");
+	CHECK_MESSAGE(buffer.is_occluded(AABB(Vector3(30, -1, -40), Vector3(2, 2, 2))),
+			"A box behind the wall, off axis, should be occluded.");
+	CHECK_MESSAGE(!buffer.is_occluded(AABB(Vector3(-1, -1, -6), Vector3(2, 2, 2))),
+			"A box in front of the wall should not be occluded.");
+	CHECK_MESSAGE(!buffer.is_occluded(AABB(Vector3(45, -1, -40), Vector3(1, 1, 1))),
+			"A box seen past the edge of the wall should not be occluded.");
+	CHECK_MESSAGE(!buffer.is_occluded(AABB(Vector3(-1, -1, -12), Vector3(2, 2, 12))),
+			"A box crossing the near plane should never be occluded.");
+}
+
+TEST_CASE("[OcclusionBuffer] Depth is perspective correct and near clipped") {
+	OcclusionBufferSW buffer;
+	begin_default(buffer);
+
+	// Floor crossing the near plane, extending far in front of the camera.
+	Vector3 floor[4] = { Vector3(-50, -2, 1), Vector3(50, -2, 1), Vector3(50, -2, -100), Vector3(-50, -2, -100) };
+	buffer.draw_triangles(Transform(), floor, quad_indices, 6);
+
+	// A pixel is hidden behind its farthest corner, for the floor its top edge. Compare against
+	// the exact ray/floor intersection there.
+	float tan_half_fov = Math::tan(Math::deg2rad(35.0));
+	for (int y = 40; y < 72; y += 8) {
+		float ray_y = (y - 36.0) / 36.0 * tan_half_fov;
+		CHECK(buffer.get_depth(64, y) == doctest::Approx(2.0 / ray_y).epsilon(0.01));
+	}
+
+	// Moving the occluder with its transform moves it in the buffer.
+	begin_default(buffer);
+	Transform xform;
+	xform.origin = Vector3(0, 0, -5);
+	Vector3 wall[4] = { Vector3(-10, -10, -5), Vector3(10, -10, -5), Vector3(10, 10, -5), Vector3(-10, 10, -5) };
+	buffer.draw_triangles(xform, wall, quad_indices, 6);
+	CHECK(buffer.get_depth(64, 36) == doctest::Approx(10.0));
+}
+
+TEST_CASE("[OcclusionBuffer] Partly covered pixels on occluder edges hide nothing") {
+	OcclusionBufferSW buffer;
+	begin_default(buffer);
+
+	// The right edge of the wall crosses pixel 115 past its center, so the center is covered.
+	float edge_x = pixel_to_x(115.7, 10);
+	Vector3 wall[4] = { Vector3(-10, -10, -10), Vector3(edge_x, -10, -10), Vector3(edge_x, 10, -10), Vector3(-10, 10, -10) };
+	buffer.draw_triangles(Transform(), wall, quad_indices, 6);
+
+	float from_x = pixel_to_x(115.8, 40);
+	float to_x = pixel_to_x(115.95, 40);
+	CHECK_MESSAGE(!buffer.is_occluded(AABB(Vector3(from_x, -0.5, -40), Vector3(to_x - from_x, 1, 0.01))),
+			"A box seen just past the edge of the wall, within an edge pixel, should not be occluded.");
+
+	from_x = pixel_to_x(114.2, 40);
+	to_x = pixel_to_x(114.6, 40);
+	CHECK_MESSAGE(buffer.is_occluded(AABB(Vector3(from_x, -0.5, -40), Vector3(to_x - from_x, 1, 0.01))),
+			"A box just inside the edge of the wall should still be occluded.");
+}
+
+} // namespace TestOcclusionBuffer
+
+#endif // TEST_OCCLUSION_BUFFER_H
@@ -0,0 +1,669 @@
+/*************************************************************************/
+/*  test_physics_benchmark.h                                             */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_PHYSICS_BENCHMARK_H
+#define TEST_PHYSICS_BENCHMARK_H
+
+#include "core/math/random_pcg.h"
+#include "core/os/os.h"
+#include "servers/physics_2d/physics_server_2d_sw.h"
+#include "servers/physics_3d/physics_server_3d_sw.h"
+
+#include "tests/test_macros.h"
+
+// Canonical scenes built directly through the built-in physics servers, without
+// scene nodes or a renderer. Each scene is stepped for a fixed number of frames and
+// reports the per-stage solver timings, then checks the simulation stayed sane.
+//
+// They are slow, so they are skipped by default. To run them:
+//
+//     godot --test --test-case="[Physics][Benchmark]*" --no-skip
+//
+// The PHYSICS_BENCHMARK_FRAMES environment variable overrides the frame count.
+
+namespace TestPhysicsBenchmark {
+
+static const real_t STEP = 1.0 / 60.0;
+
+static int get_frame_count() {
+	if (OS::get_singleton()->has_environment("PHYSICS_BENCHMARK_FRAMES")) {
+		int frames = OS::get_singleton()->get_environment("PHYSICS_BENCHMARK_FRAMES").to_int();
+		if (frames > 0) {
+			return frames;
+		}
+	}
+	return 300;
+}
+
+static const char *stage_names[] = {
+	"integrate_forces",
+	"generate_islands",
+	"setup_constraints",
+	"solve_constraints",
+	"integrate_velocities",
+};
+
+struct BenchmarkStats {
+	uint64_t stage_usec[Space3DSW::ELAPSED_TIME_MAX] = {};
+	uint64_t step_usec = 0;
+	uint64_t query_usec = 0;
+	int frames = 0;
+	int max_pairs = 0;
+	int max_contacts = 0;
+	int64_t total_pairs = 0;
+	int64_t total_contacts = 0;
+
+	template <class S>
+	void add_frame(const S *p_space, uint64_t p_step_usec) {
+		for (int i = 0; i < S::ELAPSED_TIME_MAX; i++) {
+			stage_usec[i] += p_space->get_elapsed_time(typename S::ElapsedTime(i));
+		}
+		step_usec += p_step_usec;
+
+		int pairs = p_space->get_collision_pairs();
+		int contacts = p_space->get_contact_count();
+		max_pairs = MAX(max_pairs, pairs);
+		max_contacts = MAX(max_contacts, contacts);
+		total_pairs += pairs;
+		total_contacts += contacts;
+		frames++;
+	}
+
+	void report(const String &p_scene) const {
+		ERR_FAIL_COND(frames == 0);
+		double frame_msec = double(step_usec) / frames / 1000.0;
+		print_line(vformat("%s: %d frames, %.3f ms/frame step, %.3f ms/frame queries", p_scene, frames, frame_msec, double(query_usec) / frames / 1000.0));
+		for (int i = 0; i < Space3DSW::ELAPSED_TIME_MAX; i++) {
+			print_line(vformat("    %-22s %.3f ms/frame", stage_names[i], double(stage_usec[i]) / frames / 1000.0));
+		}
+		print_line(vformat("    pairs: %d avg, %d max; contacts: %d avg, %d max", int(total_pairs / frames), max_pairs, int(total_contacts / frames), max_contacts));
+	}
+};
+
+/* 3D */
+
+class Benchmark3D {
+	List<RID> rids;
+
+public:
+	PhysicsServer3DSW *ps;
+	RID space;
+	BenchmarkStats stats;
+
+	RID make_shape(PhysicsServer3D::ShapeType p_type, const Variant &p_data) {
+		RID shape = ps->shape_create(p_type);
+		ps->shape_set_data(shape, p_data);
+		rids.push_back(shape);
+		return shape;
+	}
+
+	RID make_body(PhysicsServer3D::BodyMode p_mode, RID p_shape, const Transform &p_xform) {
+		RID body = ps->body_create(p_mode);
+		ps->body_set_space(body, space);
+		ps->body_add_shape(body, p_shape);
+		ps->body_set_state(body, PhysicsServer3D::BODY_STATE_TRANSFORM, p_xform);
+		rids.push_back(body);
+		return body;
+	}
+
+	Transform get_transform(RID p_body) const {
+		return ps->body_get_state(p_body, PhysicsServer3D::BODY_STATE_TRANSFORM);
+	}
+
+	void make_floor() {
+		RID floor_shape = make_shape(PhysicsServer3D::SHAPE_BOX, Vector3(200, 1, 200));
+		make_body(PhysicsServer3D::BODY_MODE_STATIC, floor_shape, Transform(Basis(), Vector3(0, -1, 0)));
+	}
+
+	void step() {
+		uint64_t begin = OS::get_singleton()->get_ticks_usec();
+		ps->step(STEP);
+		ps->flush_queries();
+		stats.add_frame(ps->get_space(space), OS::get_singleton()->get_ticks_usec() - begin);
+	}
+
+	Benchmark3D() {
+		ps = memnew(PhysicsServer3DSW);
+		ps->init();
+		space = ps->space_create();
+		ps->space_set_active(space, true);
+	}
+
+	~Benchmark3D() {
+		for (List<RID>::Element *E = rids.back(); E; E = E->prev()) {
+			ps->free(E->get());
+		}
+		ps->free(space);
+		ps->finish();
+		memdelete(ps);
+	}
+};
+
+TEST_CASE("[Physics][Benchmark] 3D box pyramid" * doctest::skip()) {
+	Benchmark3D bench;
+	bench.make_floor();
+
+	const int base = 20;
+	RID box = bench.make_shape(PhysicsServer3D::SHAPE_BOX, Vector3(0.5, 0.5, 0.5));
+	RID top;
+	for (int row = 0; row < base; row++) {
+		for (int i = 0; i < base - row; i++) {
+			Vector3 pos((i - (base - row) * 0.5) * 1.05, 0.5 + row, 0);
+			top = bench.make_body(PhysicsServer3D::BODY_MODE_RIGID, box, Transform(Basis(), pos));
+		}
+	}
+
+	real_t top_height = bench.get_transform(top).origin.y;
+	int frames = get_frame_count();
+	for (int i = 0; i < frames; i++) {
+		bench.step();
+	}
+	bench.stats.report("3D box pyramid");
+
+	CHECK_MESSAGE(bench.get_transform(top).origin.y > top_height * 0.5, "The pyramid should not collapse.");
+}
+
+TEST_CASE("[Physics][Benchmark] 3D convex pile" * doctest::skip()) {
+	Benchmark3D bench;
+	bench.make_floor();
+
+	Dictionary capsule;
+	capsule["radius"] = 0.4;
+	capsule["height"] = 0.8;
+	Dictionary cylinder;
+	cylinder["radius"] = 0.5;
+	cylinder["height"] = 1.0;
+	Vector<Vector3> hull;
+	hull.push_back(Vector3(0.6, 0, 0));
+	hull.push_back(Vector3(-0.6, 0, 0));
+	hull.push_back(Vector3(0, 0.6, 0));
+	hull.push_back(Vector3(0, -0.6, 0));
+	hull.push_back(Vector3(0, 0, 0.6));
+	hull.push_back(Vector3(0, 0, -0.6));
+
+	RID shapes[5] = {
+		bench.make_shape(PhysicsServer3D::SHAPE_BOX, Vector3(0.5, 0.5, 0.5)),
+		bench.make_shape(PhysicsServer3D::SHAPE_SPHERE, 0.5),
+		bench.make_shape(PhysicsServer3D::SHAPE_CAPSULE, capsule),
+		bench.make_shape(PhysicsServer3D::SHAPE_CYLINDER, cylinder),
+		bench.make_shape(PhysicsServer3D::SHAPE_CONVEX_POLYGON, hull),
+	};
+
+	const int side = 10;
+	Vector<RID> bodies;
+	for (int i = 0; i < side * side * side; i++) {
+		Vector3 pos((i % side - side * 0.5) * 1.6, 2 + (i / (side * side)) * 1.6, ((i / side) % side - side * 0.5) * 1.6);
+		Basis rot(Vector3(0, 1, 0), i * 0.37);
+		bodies.push_back(bench.make_body(PhysicsServer3D::BODY_MODE_RIGID, shapes[i % 5], Transform(rot, pos)));
+	}
+
+	int frames = get_frame_count();
+	for (int i = 0; i < frames; i++) {
+		bench.step();
+	}
+	bench.stats.report("3D convex pile");
+
+	int below = 0;
+	for (int i = 0; i < bodies.size(); i++) {
+		if (bench.get_transform(bodies[i]).origin.y < -0.1) {
+			below++;
+		}
+	}
+	CHECK_MESSAGE(below == 0, "No body should fall through the floor.");
+}
+
+static void run_kinematic_characters_3d(bool p_batched) {
+	Benchmark3D bench;
+	bench.make_floor();
+
+	RID pillar = bench.make_shape(PhysicsServer3D::SHAPE_BOX, Vector3(0.5, 2, 0.5));
+	for (int i = 0; i < 16; i++) {
+		for (int j = 0; j < 16; j++) {
+			bench.make_body(PhysicsServer3D::BODY_MODE_STATIC, pillar, Transform(Basis(), Vector3((i - 8) * 6 + 3, 2, (j - 8) * 6 + 3)));
+		}
+	}
+
+	Dictionary capsule;
+	capsule["radius"] = 0.4;
+	capsule["height"] = 1.0;
+	RID character_shape = bench.make_shape(PhysicsServer3D::SHAPE_CAPSULE, capsule);
+	Basis upright(Vector3(1, 0, 0), Math_PI * 0.5);
+
+	const int count = 256;
+	Vector<RID> characters;
+	for (int i = 0; i < count; i++) {
+		Vector3 pos((i % 16 - 8) * 6, 1.0, (i / 16 - 8) * 6);
+		characters.push_back(bench.make_body(PhysicsServer3D::BODY_MODE_KINEMATIC, character_shape, Transform(upright, pos)));
+	}
+
+	Vector<Transform> from;
+	Vector<Vector3> motions;
+	Vector<PhysicsServer3D::MotionResult> results;
+	from.resize(count);
+	motions.resize(count);
+	results.resize(count);
+
+	int frames = get_frame_count();
+	for (int f = 0; f < frames; f++) {
+		uint64_t begin = OS::get_singleton()->get_ticks_usec();
+		for (int i = 0; i < count; i++) {
+			real_t angle = (f + i * 7) * 0.02;
+			from.write[i] = bench.get_transform(characters[i]);
+			motions.write[i] = (Vector3(Math::cos(angle), 0, Math::sin(angle)) * 4.0 + Vector3(0, -9.8, 0)) * STEP;
+		}
+
+		if (p_batched) {
+			bench.ps->body_test_motion_batch(characters.ptr(), from.ptr(), motions.ptr(), count, true, results.ptrw());
+		} else {
+			for (int i = 0; i < count; i++) {
+				bench.ps->body_test_motion(characters[i], from[i], motions[i], true, &results.write[i]);
+			}
+		}
+
+		for (int i = 0; i < count; i++) {
+			Transform xform = from[i];
+			xform.origin += results[i].motion;
+			bench.ps->body_set_state(characters[i], PhysicsServer3D::BODY_STATE_TRANSFORM, xform);
+		}
+		bench.stats.query_usec += OS::get_singleton()->get_ticks_usec() - begin;
+		bench.step();
+	}
+	bench.stats.report(p_batched ? "3D kinematic characters, batched" : "3D kinematic characters");
+
+	int below = 0;
+	for (int i = 0; i < count; i++) {
+		if (bench.get_transform(characters[i]).origin.y < 0.5) {
+			below++;
+		}
+	}
+	CHECK_MESSAGE(below == 0, "Characters should stay on the floor.");
+}
+
+TEST_CASE("[Physics][Benchmark] 3D kinematic characters" * doctest::skip()) {
+	run_kinematic_characters_3d(false);
+}
+
+TEST_CASE("[Physics][Benchmark] 3D kinematic characters, batched" * doctest::skip()) {
+	run_kinematic_characters_3d(true);
+}
+
+TEST_CASE("[Physics][Benchmark] 3D ray flood" * doctest::skip()) {
+	Benchmark3D bench;
+	bench.make_floor();
+
+	RID box = bench.make_shape(PhysicsServer3D::SHAPE_BOX, Vector3(0.5, 0.5, 0.5));
+	RID sphere = bench.make_shape(PhysicsServer3D::SHAPE_SPHERE, 0.5);
+	for (int i = 0; i < 32; i++) {
+		for (int j = 0; j < 32; j++) {
+			Vector3 pos((i - 16) * 3, 0.5, (j - 16) * 3);
+			bench.make_body(PhysicsServer3D::BODY_MODE_STATIC, (i + j) % 2 ? box : sphere, Transform(Basis(), pos));
+		}
+	}
+
+	RandomPCG rng;
+	const int rays = 4096;
+	int64_t missed = 0;
+
+	int frames = get_frame_count();
+	for (int f = 0; f < frames; f++) {
+		bench.step();
+
+		PhysicsDirectSpaceState3D *state = bench.ps->space_get_direct_state(bench.space);
+		uint64_t begin = OS::get_singleton()->get_ticks_usec();
+		for (int i = 0; i < rays; i++) {
+			Vector3 from(rng.random(-48.0f, 48.0f), 10, rng.random(-48.0f, 48.0f));
+			Vector3 to = from + Vector3(rng.random(-4.0f, 4.0f), -20, rng.random(-4.0f, 4.0f));
+			PhysicsDirectSpaceState3D::RayResult result;
+			if (!state->intersect_ray(from, to, result)) {
+				missed++;
+			}
+		}
+		bench.stats.query_usec += OS::get_singleton()->get_ticks_usec() - begin;
+	}
+	bench.stats.report("3D ray flood");
+
+	CHECK_MESSAGE(missed == 0, "Every ray should hit the obstacles or the floor.");
+}
+
+TEST_CASE("[Physics][Benchmark] 3D trimesh terrain" * doctest::skip()) {
+	Benchmark3D bench;
+
+	const int size = 64;
+	const real_t cell = 2.0;
+	Vector<Vector3> faces;
+	real_t min_height = 0;
+	for (int i = 0; i < size; i++) {
+		for (int j = 0; j < size; j++) {
+			Vector3 v[4];
+			for (int k = 0; k < 4; k++) {
+				real_t x = (i + (k & 1) - size / 2) * cell;
+				real_t z = (j + (k >> 1) - size / 2) * cell;
+				v[k] = Vector3(x, Math::sin(x * 0.2) * Math::cos(z * 0.15) * 3.0, z);
+				min_height = MIN(min_height, v[k].y);
+			}
+			faces.push_back(v[0]);
+			faces.push_back(v[1]);
+			faces.push_back(v[2]);
+			faces.push_back(v[2]);
+			faces.push_back(v[1]);
+			faces.push_back(v[3]);
+		}
+	}
+
+	uint64_t build_begin = OS::get_singleton()->get_ticks_usec();
+	RID terrain = bench.make_shape(PhysicsServer3D::SHAPE_CONCAVE_POLYGON, faces);
+	print_line(vformat("3D trimesh terrain: %d faces built in %.3f ms", faces.size() / 3, (OS::get_singleton()->get_ticks_usec() - build_begin) / 1000.0));
+	bench.make_body(PhysicsServer3D::BODY_MODE_STATIC, terrain, Transform());
+
+	RID shapes[2] = {
+		bench.make_shape(PhysicsServer3D::SHAPE_SPHERE, 0.5),
+		bench.make_shape(PhysicsServer3D::SHAPE_BOX, Vector3(0.5, 0.5, 0.5)),
+	};
+
+	Vector<RID> bodies;
+	for (int i = 0; i < 512; i++) {
+		Vector3 pos((i % 32 - 16) * 3.5, 6 + (i / 256) * 2, (i / 32 % 8 - 4) * 7);
+		bodies.push_back(bench.make_body(PhysicsServer3D::BODY_MODE_RIGID, shapes[i % 2], Transform(Basis(), pos)));
+	}
+
+	int frames = get_frame_count();
+	for (int i = 0; i < frames; i++) {
+		bench.step();
+	}
+	bench.stats.report("3D trimesh terrain");
+
+	int below = 0;
+	for (int i = 0; i < bodies.size(); i++) {
+		// bodies that rolled off the edge are expected to fall
+		Vector3 pos = bench.get_transform(bodies[i]).origin;
+		if (Math::abs(pos.x) < size * cell * 0.5 && Math::abs(pos.z) < size * cell * 0.5 && pos.y < min_height - 1.0) {
+			below++;
+		}
+	}
+	CHECK_MESSAGE(below == 0, "No body should fall through the terrain.");
+}
+
+/* 2D */
+
+class Benchmark2D {
+	List<RID> rids;
+
+public:
+	PhysicsServer2DSW *ps;
+	RID space;
+	BenchmarkStats stats;
+
+	RID make_shape(RID p_shape, const Variant &p_data) {
+		ps->shape_set_data(p_shape, p_data);
+		rids.push_back(p_shape);
+		return p_shape;
+	}
+
+	RID make_body(PhysicsServer2D::BodyMode p_mode, RID p_shape, const Transform2D &p_xform) {
+		RID body = ps->body_create();
+		ps->body_set_mode(body, p_mode);
+		ps->body_set_space(body, space);
+		ps->body_add_shape(body, p_shape);
+		ps->body_set_state(body, PhysicsServer2D::BODY_STATE_TRANSFORM, p_xform);
+		rids.push_back(body);
+		return body;
+	}
+
+	Transform2D get_transform(RID p_body) const {
+		return ps->body_get_state(p_body, PhysicsServer2D::BODY_STATE_TRANSFORM);
+	}
+
+	void make_floor() {
+		RID floor_shape = make_shape(ps->rectangle_shape_create(), Vector2(10000, 16));
+		make_body(PhysicsServer2D::BODY_MODE_STATIC, floor_shape, Transform2D(0, Vector2(0, 16)));
+	}
+
+	void step() {
+		uint64_t begin = OS::get_singleton()->get_ticks_usec();
+		ps->step(STEP);
+		ps->flush_queries();
+		stats.add_frame(ps->get_space(space), OS::get_singleton()->get_ticks_usec() - begin);
+	}
+
+	Benchmark2D() {
+		ps = memnew(PhysicsServer2DSW);
+		ps->init();
+		space = ps->space_create();
+		ps->space_set_active(space, true);
+	}
+
+	~Benchmark2D() {
+		for (List<RID>::Element *E = rids.back(); E; E = E->prev()) {
+			ps->free(E->get());
+		}
+		ps->free(space);
+		ps->finish();
+		memdelete(ps);
+	}
+};
+
+TEST_CASE("[Physics][Benchmark] 2D box pyramid" * doctest::skip()) {
+	Benchmark2D bench;
+	bench.make_floor();
+
+	const int base = 30;
+	RID box = bench.make_shape(bench.ps->rectangle_shape_create(), Vector2(8, 8));
+	RID top;
+	for (int row = 0; row < base; row++) {
+		for (int i = 0; i < base - row; i++) {
+			Vector2 pos((i - (base - row) * 0.5) * 17, -8 - row * 16);
+			top = bench.make_body(PhysicsServer2D::BODY_MODE_RIGID, box, Transform2D(0, pos));
+		}
+	}
+
+	real_t top_height = bench.get_transform(top).get_origin().y;
+	int frames = get_frame_count();
+	for (int i = 0; i < frames; i++) {
+		bench.step();
+	}
+	bench.stats.report("2D box pyramid");
+
+	// y grows downwards in 2D
+	CHECK_MESSAGE(bench.get_transform(top).get_origin().y < top_height * 0.5, "The pyramid should not collapse.");
+}
+
+TEST_CASE("[Physics][Benchmark] 2D convex pile" * doctest::skip()) {
+	Benchmark2D bench;
+	bench.make_floor();
+
+	Vector<Vector2> hull;
+	hull.push_back(Vector2(0, -9));
+	hull.push_back(Vector2(8, -3));
+	hull.push_back(Vector2(5, 8));
+	hull.push_back(Vector2(-5, 8));
+	hull.push_back(Vector2(-8, -3));
+
+	RID shapes[4] = {
+		bench.make_shape(bench.ps->rectangle_shape_create(), Vector2(8, 8)),
+		bench.make_shape(bench.ps->circle_shape_create(), 8),
+		bench.make_shape(bench.ps->capsule_shape_create(), Vector2(6, 8)),
+		bench.make_shape(bench.ps->convex_polygon_shape_create(), hull),
+	};
+
+	const int columns = 40;
+	Vector<RID> bodies;
+	for (int i = 0; i < columns * 50; i++) {
+		Vector2 pos((i % columns - columns * 0.5) * 24, -32 - (i / columns) * 24);
+		bodies.push_back(bench.make_body(PhysicsServer2D::BODY_MODE_RIGID, shapes[i % 4], Transform2D(i * 0.37, pos)));
+	}
+
+	int frames = get_frame_count();
+	for (int i = 0; i < frames; i++) {
+		bench.step();
+	}
+	bench.stats.report("2D convex pile");
+
+	int below = 0;
+	for (int i = 0; i < bodies.size(); i++) {
+		if (bench.get_transform(bodies[i]).get_origin().y > 1) {
+			below++;
+		}
+	}
+	CHECK_MESSAGE(below == 0, "No body should fall through the floor.");
+}
+
+TEST_CASE("[Physics][Benchmark] 2D kinematic characters" * doctest::skip()) {
+	Benchmark2D bench;
+	bench.make_floor();
+
+	RID pillar = bench.make_shape(bench.ps->rectangle_shape_create(), Vector2(8, 32));
+	for (int i = 0; i < 64; i++) {
+		bench.make_body(PhysicsServer2D::BODY_MODE_STATIC, pillar, Transform2D(0, Vector2((i - 32) * 96 + 48, -32)));
+	}
+
+	RID character_shape = bench.make_shape(bench.ps->capsule_shape_create(), Vector2(8, 16));
+
+	const int count = 256;
+	Vector<RID> characters;
+	for (int i = 0; i < count; i++) {
+		// dropped from above the pillars, some land on top of them
+		Vector2 pos((i - count / 2) * 24, -100);
+		characters.push_back(bench.make_body(PhysicsServer2D::BODY_MODE_KINEMATIC, character_shape, Transform2D(0, pos)));
+	}
+
+	int frames = get_frame_count();
+	for (int f = 0; f < frames; f++) {
+		uint64_t begin = OS::get_singleton()->get_ticks_usec();
+		for (int i = 0; i < count; i++) {
+			Transform2D xform = bench.get_transform(characters[i]);
+			real_t direction = Math::sin((f + i * 7) * 0.02) > 0 ? 1 : -1;
+			Vector2 motion = Vector2(direction * 120, 500) * STEP;
+
+			PhysicsServer2D::MotionResult result;
+			bench.ps->body_test_motion(characters[i], xform, motion, true, 0.08, &result);
+			xform.elements[2] += result.motion;
+			bench.ps->body_set_state(characters[i], PhysicsServer2D::BODY_STATE_TRANSFORM, xform);
+		}
+		bench.stats.query_usec += OS::get_singleton()->get_ticks_usec() - begin;
+		bench.step();
+	}
+	bench.stats.report("2D kinematic characters");
+
+	int below = 0;
+	for (int i = 0; i < count; i++) {
+		if (bench.get_transform(characters[i]).get_origin().y > -8) {
+			below++;
+		}
+	}
+	CHECK_MESSAGE(below == 0, "Characters should stay on the floor.");
+}
+
+TEST_CASE("[Physics][Benchmark] 2D ray flood" * doctest::skip()) {
+	Benchmark2D bench;
+	bench.make_floor();
+
+	RID box = bench.make_shape(bench.ps->rectangle_shape_create(), Vector2(8, 8));
+	RID circle = bench.make_shape(bench.ps->circle_shape_create(), 8);
+	for (int i = 0; i < 32; i++) {
+		for (int j = 0; j < 32; j++) {
+			Vector2 pos((i - 16) * 48, -8 - j * 48);
+			bench.make_body(PhysicsServer2D::BODY_MODE_STATIC, (i + j) % 2 ? box : circle, Transform2D(0, pos));
+		}
+	}
+
+	RandomPCG rng;
+	const int rays = 4096;
+	int64_t missed = 0;
+
+	int frames = get_frame_count();
+	for (int f = 0; f < frames; f++) {
+		bench.step();
+
+		PhysicsDirectSpaceState2D *state = bench.ps->space_get_direct_state(bench.space);
+		uint64_t begin = OS::get_singleton()->get_ticks_usec();
+		for (int i = 0; i < rays; i++) {
+			Vector2 from(rng.random(-768.0f, 768.0f), -1600);
+			Vector2 to = from + Vector2(rng.random(-64.0f, 64.0f), 1700);
+			PhysicsDirectSpaceState2D::RayResult result;
+			if (!state->intersect_ray(from, to, result)) {
+				missed++;
+			}
+		}
+		bench.stats.query_usec += OS::get_singleton()->get_ticks_usec() - begin;
+	}
+	bench.stats.report("2D ray flood");
+
+	CHECK_MESSAGE(missed == 0, "Every ray should hit the obstacles or the floor.");
+}
+
+TEST_CASE("[Physics][Benchmark] 2D concave terrain" * doctest::skip()) {
+	Benchmark2D bench;
+
+	const int segments = 1024;
+	const real_t cell = 8;
+	Vector<Vector2> terrain_segments;
+	real_t max_depth = 0;
+	for (int i = 0; i < segments; i++) {
+		for (int k = 0; k < 2; k++) {
+			real_t x = (i + k - segments / 2) * cell;
+			Vector2 point(x, Math::sin(x * 0.01) * 48 + Math::sin(x * 0.037) * 12);
+			max_depth = MAX(max_depth, point.y);
+			terrain_segments.push_back(point);
+		}
+	}
+
+	RID terrain = bench.make_shape(bench.ps->concave_polygon_shape_create(), terrain_segments);
+	bench.make_body(PhysicsServer2D::BODY_MODE_STATIC, terrain, Transform2D());
+
+	RID shapes[2] = {
+		bench.make_shape(bench.ps->circle_shape_create(), 6),
+		bench.make_shape(bench.ps->rectangle_shape_create(), Vector2(6, 6)),
+	};
+
+	Vector<RID> bodies;
+	for (int i = 0; i < 1024; i++) {
+		Vector2 pos((i % 256 - 128) * 28, -120 - (i / 256) * 24);
+		bodies.push_back(bench.make_body(PhysicsServer2D::BODY_MODE_RIGID, shapes[i % 2], Transform2D(0, pos)));
+	}
+
+	int frames = get_frame_count();
+	for (int i = 0; i < frames; i++) {
+		bench.step();
+	}
+	bench.stats.report("2D concave terrain");
+
+	int below = 0;
+	for (int i = 0; i < bodies.size(); i++) {
+		Vector2 pos = bench.get_transform(bodies[i]).get_origin();
+		if (Math::abs(pos.x) < segments * cell * 0.5 && pos.y > max_depth + 16) {
+			below++;
+		}
+	}
+	CHECK_MESSAGE(below == 0, "No body should fall through the terrain.");
+}
+
+} // namespace TestPhysicsBenchmark
+
+#endif // TEST_PHYSICS_BENCHMARK_H
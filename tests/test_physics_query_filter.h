@@ -0,0 +1,148 @@
+/*************************************************************************/
+/*  test_physics_query_filter.h                                          */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_PHYSICS_QUERY_FILTER_H
+#define TEST_PHYSICS_QUERY_FILTER_H
+
+#include "core/rid_owner.h"
+#include "servers/physics_query_filter.h"
+
+#include "tests/test_macros.h"
+
+namespace TestPhysicsQueryFilter {
+
+static int dummy_values[32];
+
+static bool exclude_odd_instances(void *p_userdata, const RID &p_rid, ObjectID p_instance_id) {
+	return (uint64_t(p_instance_id) & 1) != 0;
+}
+
+TEST_CASE("[PhysicsQueryFilter] Inline insert, erase and lookup") {
+	RID_PtrOwner<int> owner;
+	RID rids[4];
+	for (int i = 0; i < 4; i++) {
+		rids[i] = owner.make_rid(&dummy_values[i]);
+	}
+
+	PhysicsQueryFilter filter;
+	CHECK(!filter.has_rids());
+	CHECK(!filter.has_callback());
+
+	filter.insert(rids[2]);
+	filter.insert(rids[0]);
+	filter.insert(rids[2]);
+	CHECK(filter.size() == 2);
+	CHECK(filter.has(rids[0]));
+	CHECK(filter.has(rids[2]));
+	CHECK(!filter.has(rids[1]));
+	CHECK(filter[0] < filter[1]);
+
+	CHECK(filter.erase(rids[0]));
+	CHECK(!filter.erase(rids[3]));
+	CHECK(filter.size() == 1);
+	CHECK(!filter.has(rids[0]));
+
+	for (int i = 0; i < 4; i++) {
+		owner.free(rids[i]);
+	}
+}
+
+TEST_CASE("[PhysicsQueryFilter] Spill past the inline storage") {
+	RID_PtrOwner<int> owner;
+	RID rids[32];
+	PhysicsQueryFilter filter;
+	for (int i = 31; i >= 0; i--) {
+		rids[i] = owner.make_rid(&dummy_values[i]);
+		filter.insert(rids[i]);
+	}
+	CHECK(filter.size() == 32);
+
+	bool sorted = true;
+	for (uint32_t i = 1; i < filter.size(); i++) {
+		sorted = sorted && filter[i - 1] < filter[i];
+	}
+	CHECK(sorted);
+
+	bool all_found = true;
+	for (int i = 0; i < 32; i++) {
+		all_found = all_found && filter.has(rids[i]);
+	}
+	CHECK(all_found);
+
+	// Shrink back into the inline array and keep lookups consistent.
+	for (int i = 0; i < 28; i++) {
+		filter.erase(rids[i]);
+	}
+	CHECK(filter.size() == 4);
+	CHECK(!filter.has(rids[0]));
+	CHECK(filter.has(rids[31]));
+
+	PhysicsQueryFilter copy = filter;
+	CHECK(copy.size() == 4);
+	CHECK(copy.has(rids[30]));
+
+	for (int i = 0; i < 32; i++) {
+		owner.free(rids[i]);
+	}
+}
+
+TEST_CASE("[PhysicsQueryFilter] Set conversion and callback") {
+	RID_PtrOwner<int> owner;
+	RID a = owner.make_rid(&dummy_values[0]);
+	RID b = owner.make_rid(&dummy_values[1]);
+
+	Set<RID> set;
+	set.insert(b);
+	set.insert(a);
+	PhysicsQueryFilter filter = set;
+	CHECK(filter.size() == 2);
+	CHECK(filter.is_excluded(a, ObjectID()));
+
+	RID c = owner.make_rid(&dummy_values[2]);
+	CHECK(!filter.is_excluded(c, ObjectID(uint64_t(2))));
+	filter.set_callback(exclude_odd_instances);
+	CHECK(filter.has_callback());
+	CHECK(filter.is_excluded(c, ObjectID(uint64_t(3))));
+	CHECK(!filter.is_excluded(c, ObjectID(uint64_t(4))));
+
+	PhysicsQueryFilter callback_only;
+	callback_only.set_callback(exclude_odd_instances);
+	CHECK(callback_only.has_callback());
+	CHECK(!callback_only.has_rids());
+	CHECK(callback_only.size() == 0);
+
+	owner.free(a);
+	owner.free(b);
+	owner.free(c);
+}
+
+} // namespace TestPhysicsQueryFilter
+
+#endif // TEST_PHYSICS_QUERY_FILTER_H
@@ -0,0 +1,167 @@
+/*************************************************************************/
+/*  test_physics_server_3d_wrap_mt.h                                     */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_PHYSICS_SERVER_3D_WRAP_MT_H
+#define TEST_PHYSICS_SERVER_3D_WRAP_MT_H
+
+#include "core/os/os.h"
+#include "core/os/thread.h"
+#include "core/project_settings.h"
+#include "scene/3d/area_3d.h"
+#include "scene/3d/collision_shape_3d.h"
+#include "scene/3d/physics_body_3d.h"
+#include "scene/resources/box_shape_3d.h"
+#include "scene/resources/packed_scene.h"
+#include "servers/physics_3d/physics_server_3d_sw.h"
+#include "servers/physics_3d/physics_server_3d_wrap_mt.h"
+
+#include "tests/test_macros.h"
+
+#include <atomic>
+
+namespace TestPhysicsServer3DWrapMT {
+
+struct InstanceJob {
+	Ref<PackedScene> scene;
+	int count = 0;
+	Vector<Node *> instances;
+	Vector<Area3D *> areas;
+	std::atomic<bool> done = { false };
+};
+
+static void _instance_scenes(void *p_userdata) {
+	InstanceJob *job = static_cast<InstanceJob *>(p_userdata);
+	for (int i = 0; i < job->count; i++) {
+		job->instances.push_back(job->scene->instance());
+		// Areas come from a pool of the generic kind. Packing one needs the
+		// audio server, so they're made here instead.
+		job->areas.push_back(memnew(Area3D));
+	}
+	job->done = true;
+}
+
+TEST_CASE("[PhysicsServer3DWrapMT] Instancing physics bodies on a worker doesn't wait for the main thread") {
+	// Small pools run out a few times over, and the main thread never flushes
+	// the queue while it waits for the worker.
+	ProjectSettings *settings = ProjectSettings::get_singleton();
+	Variant pool_size = GLOBAL_DEF("memory/limits/multithreaded_server/rid_pool_prealloc", 60);
+	Variant thread_model = GLOBAL_DEF("physics/3d/thread_model", 1);
+	settings->set("memory/limits/multithreaded_server/rid_pool_prealloc", 4);
+	settings->set("physics/3d/thread_model", 1); // Single-Safe.
+	PhysicsServer3D *server = PhysicsServer3DWrapMT::init_server<PhysicsServer3DSW>();
+	server->init();
+
+	Node3D *root = memnew(Node3D);
+	RigidBody3D *body = memnew(RigidBody3D);
+	body->set_mass(3);
+	root->add_child(body);
+	body->set_owner(root);
+	CollisionShape3D *collision = memnew(CollisionShape3D);
+	Ref<BoxShape3D> box;
+	box.instance();
+	box->set_extents(Vector3(1, 2, 3));
+	box->set_local_to_scene(true);
+	collision->set_shape(box);
+	body->add_child(collision);
+	collision->set_owner(root);
+	StaticBody3D *floor = memnew(StaticBody3D);
+	root->add_child(floor);
+	floor->set_owner(root);
+
+	InstanceJob job;
+	job.scene.instance();
+	REQUIRE(job.scene->pack(root) == OK);
+	job.count = 10;
+
+	Thread *thread = Thread::create(_instance_scenes, &job);
+	uint64_t timeout = OS::get_singleton()->get_ticks_msec() + 10000;
+	while (!job.done && OS::get_singleton()->get_ticks_msec() < timeout) {
+		OS::get_singleton()->delay_usec(1000);
+	}
+	CHECK_MESSAGE(job.done, "The worker finished without the main thread flushing the queue.");
+	while (!job.done) {
+		// Let a blocked worker go, so that the test fails rather than hangs.
+		server->step(0);
+		OS::get_singleton()->delay_usec(1000);
+	}
+	Thread::wait_to_finish(thread);
+	memdelete(thread);
+
+	REQUIRE(job.instances.size() == job.count);
+	Set<RID> rids;
+	for (int i = 0; i < job.instances.size(); i++) {
+		RigidBody3D *instanced_body = Object::cast_to<RigidBody3D>(job.instances[i]->get_child(0));
+		StaticBody3D *instanced_floor = Object::cast_to<StaticBody3D>(job.instances[i]->get_child(1));
+		REQUIRE(instanced_body);
+		REQUIRE(instanced_floor);
+		Ref<BoxShape3D> instanced_box = Object::cast_to<CollisionShape3D>(instanced_body->get_child(0))->get_shape();
+		REQUIRE(instanced_box.is_valid());
+		CHECK(instanced_box != box);
+
+		RID body_rid = instanced_body->get_rid();
+		RID floor_rid = instanced_floor->get_rid();
+		RID shape_rid = instanced_box->get_rid();
+		RID area_rid = job.areas[i]->get_rid();
+		CHECK(body_rid.is_valid());
+		CHECK(floor_rid.is_valid());
+		CHECK(shape_rid.is_valid());
+		CHECK(area_rid.is_valid());
+		CHECK(!rids.has(body_rid));
+		CHECK(!rids.has(floor_rid));
+		CHECK(!rids.has(shape_rid));
+		CHECK(!rids.has(area_rid));
+		rids.insert(body_rid);
+		rids.insert(floor_rid);
+		rids.insert(shape_rid);
+		rids.insert(area_rid);
+
+		// Calls queued by the worker are applied before the main thread reads back.
+		CHECK(server->body_get_mode(floor_rid) == PhysicsServer3D::BODY_MODE_STATIC);
+		CHECK(server->body_get_param(body_rid, PhysicsServer3D::BODY_PARAM_MASS) == doctest::Approx(3));
+		CHECK(server->body_get_shape_count(body_rid) == 1);
+		CHECK(server->body_get_shape(body_rid, 0) == shape_rid);
+		CHECK(Vector3(server->shape_get_data(shape_rid)).is_equal_approx(Vector3(1, 2, 3)));
+
+		memdelete(job.instances[i]);
+		memdelete(job.areas[i]);
+	}
+
+	job.scene.unref();
+	box.unref();
+	memdelete(root);
+	server->finish();
+	memdelete(server);
+	settings->set("memory/limits/multithreaded_server/rid_pool_prealloc", pool_size);
+	settings->set("physics/3d/thread_model", thread_model);
+}
+
+} // namespace TestPhysicsServer3DWrapMT
+
+#endif // TEST_PHYSICS_SERVER_3D_WRAP_MT_H
@@ -0,0 +1,335 @@
+/*************************************************************************/
+/*  test_scene_pool.h                                                    */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_SCENE_POOL_H
+#define TEST_SCENE_POOL_H
+
+#include "core/message_queue.h"
+#include "core/script_language.h"
+#include "scene/3d/node_3d.h"
+#include "scene/main/scene_pool.h"
+#include "scene/resources/packed_scene.h"
+
+#include "tests/test_macros.h"
+
+// None of the nodes enter a SceneTree, so these run without any servers.
+
+namespace TestScenePool {
+
+// Stands in for a script with a single member, so that script state can be
+// checked without a scripting language.
+class MemberScriptInstance : public ScriptInstance {
+	Object *owner;
+	int health = 10;
+
+public:
+	virtual bool set(const StringName &p_name, const Variant &p_value) {
+		if (p_name == "health") {
+			health = p_value;
+			return true;
+		}
+		return false;
+	}
+	virtual bool get(const StringName &p_name, Variant &r_ret) const {
+		if (p_name == "health") {
+			r_ret = health;
+			return true;
+		}
+		return false;
+	}
+	virtual void get_property_list(List<PropertyInfo> *p_properties) const {
+		p_properties->push_back(PropertyInfo(Variant::INT, "health"));
+	}
+	virtual Variant::Type get_property_type(const StringName &p_name, bool *r_is_valid = nullptr) const {
+		if (r_is_valid) {
+			*r_is_valid = p_name == "health";
+		}
+		return p_name == "health" ? Variant::INT : Variant::NIL;
+	}
+
+	virtual Object *get_owner() { return owner; }
+	virtual void get_method_list(List<MethodInfo> *p_list) const {}
+	virtual bool has_method(const StringName &p_method) const { return false; }
+	virtual Variant call(const StringName &p_method, const Variant **p_args, int p_argcount, Callable::CallError &r_error) {
+		r_error.error = Callable::CallError::CALL_ERROR_INVALID_METHOD;
+		return Variant();
+	}
+	virtual void notification(int p_notification) {}
+	virtual Ref<Script> get_script() const { return Ref<Script>(); }
+	virtual ScriptLanguage *get_language() { return nullptr; }
+
+	virtual Vector<ScriptNetData> get_rpc_methods() const { return Vector<ScriptNetData>(); }
+	virtual uint16_t get_rpc_method_id(const StringName &p_method) const { return UINT16_MAX; }
+	virtual StringName get_rpc_method(uint16_t p_id) const { return StringName(); }
+	virtual MultiplayerAPI::RPCMode get_rpc_mode_by_id(uint16_t p_id) const { return MultiplayerAPI::RPC_MODE_DISABLED; }
+	virtual MultiplayerAPI::RPCMode get_rpc_mode(const StringName &p_method) const { return MultiplayerAPI::RPC_MODE_DISABLED; }
+	virtual Vector<ScriptNetData> get_rset_properties() const { return Vector<ScriptNetData>(); }
+	virtual uint16_t get_rset_property_id(const StringName &p_variable) const { return UINT16_MAX; }
+	virtual StringName get_rset_property(uint16_t p_id) const { return StringName(); }
+	virtual MultiplayerAPI::RPCMode get_rset_mode_by_id(uint16_t p_id) const { return MultiplayerAPI::RPC_MODE_DISABLED; }
+	virtual MultiplayerAPI::RPCMode get_rset_mode(const StringName &p_variable) const { return MultiplayerAPI::RPC_MODE_DISABLED; }
+
+	MemberScriptInstance(Object *p_owner) {
+		owner = p_owner;
+	}
+};
+
+class ScriptedNode : public Node3D {
+	GDCLASS(ScriptedNode, Node3D);
+
+public:
+	ScriptedNode() {
+		set_script_instance(memnew(MemberScriptInstance(this)));
+	}
+};
+
+// Root (Node3D)
+//     Child (ScriptedNode), in the "enemies" group, its "renamed" signal
+//     connected to the root.
+static Ref<PackedScene> create_scene() {
+	if (!ClassDB::class_exists("ScriptedNode")) {
+		ClassDB::register_class<ScriptedNode>();
+	}
+
+	Node3D *root = memnew(Node3D);
+	root->set_name("Root");
+	root->set_translation(Vector3(1, 2, 3));
+	ScriptedNode *child = memnew(ScriptedNode);
+	child->set_name("Child");
+	child->add_to_group("enemies", true);
+	root->add_child(child);
+	child->set_owner(root);
+	child->connect("renamed", Callable(root, "update_gizmo"), Vector<Variant>(), Object::CONNECT_PERSIST);
+
+	Ref<PackedScene> scene;
+	scene.instance();
+	scene->pack(root);
+	memdelete(root);
+	return scene;
+}
+
+// Released nodes that have a parent, and dropped ones, are handled through the
+// message queue, which the test runner doesn't create.
+struct MessageQueueScope {
+	MessageQueue *queue = nullptr;
+
+	void flush() {
+		MessageQueue::get_singleton()->flush();
+	}
+
+	MessageQueueScope() {
+		if (!MessageQueue::get_singleton()) {
+			queue = memnew(MessageQueue);
+		}
+	}
+	~MessageQueueScope() {
+		flush();
+		if (queue) {
+			memdelete(queue);
+		}
+	}
+};
+
+TEST_CASE("[ScenePool] Released instances are reset to their instanced state") {
+	MessageQueueScope queue;
+	Ref<ScenePool> pool;
+	pool.instance();
+	pool->set_scene(create_scene());
+
+	Node3D *root = Object::cast_to<Node3D>(pool->acquire());
+	REQUIRE(root);
+	Node *child = root->get_node(NodePath("Child"));
+	REQUIRE(child);
+	CHECK(int(child->get("health")) == 10);
+
+	Node3D *outsider = memnew(Node3D);
+	Callable scene_callable(root, "update_gizmo");
+	Callable runtime_callable(outsider, "update_gizmo");
+
+	root->set_translation(Vector3(5, 5, 5));
+	child->set("health", 3);
+	child->disconnect("renamed", scene_callable);
+	child->connect("tree_entered", runtime_callable);
+	child->remove_from_group("enemies");
+	child->add_to_group("targets");
+
+	pool->release(root);
+	CHECK(pool->get_available_count() == 1);
+	CHECK(pool->acquire() == root);
+
+	CHECK_MESSAGE(root->get_translation().is_equal_approx(Vector3(1, 2, 3)), "Properties saved with the scene are restored.");
+	CHECK_MESSAGE(int(child->get("health")) == 10, "Script members are restored.");
+	CHECK_MESSAGE(child->is_connected("renamed", scene_callable), "Connections from the scene are made again.");
+	CHECK_MESSAGE(!child->is_connected("tree_entered", runtime_callable), "Connections made at runtime are removed.");
+	CHECK_MESSAGE(child->is_in_group("enemies"), "Groups from the scene are added again.");
+	CHECK_MESSAGE(!child->is_in_group("targets"), "Groups added at runtime are removed.");
+
+	memdelete(outsider);
+	memdelete(root);
+}
+
+TEST_CASE("[ScenePool] Instances with added or removed nodes are dropped") {
+	MessageQueueScope queue;
+	Ref<ScenePool> pool;
+	pool.instance();
+	pool->set_scene(create_scene());
+
+	SUBCASE("Added node") {
+		Node *root = pool->acquire();
+		root->add_child(memnew(Node));
+		ObjectID id = root->get_instance_id();
+
+		pool->release(root);
+		CHECK(pool->get_available_count() == 0);
+		queue.flush();
+		CHECK_MESSAGE(!ObjectDB::get_instance(id), "The dropped instance is freed.");
+	}
+
+	SUBCASE("Removed node") {
+		Node *root = pool->acquire();
+		Node *child = root->get_node(NodePath("Child"));
+		root->remove_child(child);
+		memdelete(child);
+		ObjectID id = root->get_instance_id();
+
+		pool->release(root);
+		CHECK(pool->get_available_count() == 0);
+		queue.flush();
+		CHECK_MESSAGE(!ObjectDB::get_instance(id), "The dropped instance is freed.");
+	}
+
+	SUBCASE("Replaced node") {
+		// Same node count, but not the same nodes.
+		Node *root = pool->acquire();
+		Node *child = root->get_node(NodePath("Child"));
+		root->remove_child(child);
+		memdelete(child);
+		root->add_child(memnew(ScriptedNode));
+
+		pool->release(root);
+		CHECK(pool->get_available_count() == 0);
+	}
+
+	// The pool still works after dropping.
+	Node *root = pool->acquire();
+	pool->release(root);
+	CHECK(pool->get_available_count() == 1);
+}
+
+TEST_CASE("[ScenePool] The pool keeps at most max_size instances") {
+	MessageQueueScope queue;
+	Ref<ScenePool> pool;
+	pool.instance();
+	pool->set_scene(create_scene());
+	pool->set_max_size(2);
+
+	Vector<ObjectID> ids;
+	for (int i = 0; i < 3; i++) {
+		ids.push_back(pool->acquire()->get_instance_id());
+	}
+	for (int i = 0; i < ids.size(); i++) {
+		pool->release(Object::cast_to<Node>(ObjectDB::get_instance(ids[i])));
+	}
+	CHECK(pool->get_available_count() == 2);
+	queue.flush();
+	CHECK_MESSAGE(!ObjectDB::get_instance(ids[2]), "Releasing into a full pool frees the instance.");
+
+	pool->set_max_size(1);
+	CHECK(pool->get_available_count() == 1);
+	CHECK_MESSAGE(!ObjectDB::get_instance(ids[1]), "Shrinking the pool frees the extra instances.");
+
+	pool->prefill(5);
+	CHECK_MESSAGE(pool->get_available_count() == 1, "Prefilling stops at max_size.");
+
+	pool->set_max_size(0);
+	Node *root = pool->acquire();
+	ObjectID id = root->get_instance_id();
+	pool->release(root);
+	CHECK(pool->get_available_count() == 0);
+	queue.flush();
+	CHECK(!ObjectDB::get_instance(id));
+}
+
+TEST_CASE("[ScenePool] Hits and misses are counted") {
+	MessageQueueScope queue;
+	Ref<ScenePool> pool;
+	pool.instance();
+	pool->set_scene(create_scene());
+
+	uint32_t hits = ScenePool::get_hit_count();
+	uint32_t misses = ScenePool::get_miss_count();
+
+	Node *first = pool->acquire();
+	Node *second = pool->acquire();
+	CHECK(ScenePool::get_hit_count() == hits);
+	CHECK(ScenePool::get_miss_count() == misses + 2);
+
+	pool->release(first);
+	CHECK(pool->acquire() == first);
+	CHECK(ScenePool::get_hit_count() == hits + 1);
+	CHECK(ScenePool::get_miss_count() == misses + 2);
+
+	pool->prefill(2);
+	Node *third = pool->acquire();
+	Node *fourth = pool->acquire();
+	CHECK_MESSAGE(ScenePool::get_hit_count() == hits + 3, "Prefilled instances count as hits when acquired.");
+	CHECK_MESSAGE(ScenePool::get_miss_count() == misses + 2, "Prefilling doesn't count as a miss.");
+
+	pool->release(first);
+	pool->release(second);
+	pool->release(third);
+	pool->release(fourth);
+}
+
+TEST_CASE("[ScenePool] Releasing a node with a parent outlives the pool") {
+	MessageQueueScope queue;
+	Ref<ScenePool> pool;
+	pool.instance();
+	pool->set_scene(create_scene());
+
+	Node *parent = memnew(Node);
+	Node *root = pool->acquire();
+	parent->add_child(root);
+	ObjectID id = root->get_instance_id();
+
+	pool->release(root);
+	CHECK_MESSAGE(root->get_parent() == parent, "Nodes with a parent are released at the end of the frame.");
+	pool.unref();
+	queue.flush();
+
+	CHECK_MESSAGE(parent->get_child_count() == 0, "The node leaves its parent even though the pool was freed first.");
+	CHECK_MESSAGE(!ObjectDB::get_instance(id), "The pool frees the node when it goes away.");
+
+	memdelete(parent);
+}
+
+} // namespace TestScenePool
+
+#endif // TEST_SCENE_POOL_H
@@ -0,0 +1,233 @@
+/*************************************************************************/
+/*  test_texture_streaming.h                                             */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+
+#ifndef TEST_TEXTURE_STREAMING_H
+#define TEST_TEXTURE_STREAMING_H
+
+#include "scene/resources/texture_streaming.h"
+
+#include "tests/test_macros.h"
+
+namespace TestTextureStreaming {
+
+// Sizes of the mip chain of a square RGBA8 texture.
+static Vector<uint64_t> make_mip_sizes(int p_size) {
+	Vector<uint64_t> sizes;
+	while (true) {
+		sizes.push_back(uint64_t(p_size) * p_size * 4);
+		if (p_size == 1) {
+			break;
+		}
+		p_size >>= 1;
+	}
+	return sizes;
+}
+
+// 256x256 texture: full chain, from mip 1, from mip 2 and from mip 3 (32x32).
+static const uint64_t BYTES_FROM_MIP_0 = 349524;
+static const uint64_t BYTES_FROM_MIP_1 = 87380;
+static const uint64_t BYTES_FROM_MIP_2 = 21844;
+static const uint64_t BYTES_FROM_MIP_3 = 5460;
+
+TEST_CASE("[TextureStreaming] Requested mips are loaded and accounted for") {
+	TextureStreamingResidency residency;
+	residency.texture_add(1, make_mip_sizes(256), 3);
+
+	CHECK(residency.get_texture_count() == 1);
+	CHECK(residency.texture_get_resident_mip(1) == 3);
+	CHECK(residency.get_resident_bytes() == BYTES_FROM_MIP_3);
+
+	Vector<TextureStreamingResidency::Operation> loads;
+	Vector<TextureStreamingResidency::Operation> evictions;
+
+	residency.update(1, loads, evictions);
+	CHECK_MESSAGE(loads.empty(), "Nothing should load without renderer feedback.");
+
+	residency.texture_request(1, 2, 2);
+	residency.texture_request(1, 0, 2);
+	residency.texture_request(1, 1, 2);
+	residency.update(2, loads, evictions);
+	REQUIRE(loads.size() == 1);
+	CHECK_MESSAGE(loads[0].mip == 0, "The finest mip requested in a frame should win.");
+	CHECK(evictions.empty());
+	CHECK(residency.texture_get_pending_mip(1) == 0);
+	CHECK(residency.get_pending_bytes() == BYTES_FROM_MIP_0 - BYTES_FROM_MIP_3);
+
+	loads.clear();
+	residency.texture_request(1, 0, 3);
+	residency.update(3, loads, evictions);
+	CHECK_MESSAGE(loads.empty(), "A texture with a load in flight should not be loaded again.");
+
+	residency.texture_loaded(1, 0);
+	CHECK(residency.texture_get_resident_mip(1) == 0);
+	CHECK(residency.texture_get_pending_mip(1) == -1);
+	CHECK(residency.get_pending_bytes() == 0);
+	CHECK(residency.get_resident_bytes() == BYTES_FROM_MIP_0);
+
+	residency.texture_remove(1);
+	CHECK(residency.get_texture_count() == 0);
+	CHECK(residency.get_resident_bytes() == 0);
+}
+
+TEST_CASE("[TextureStreaming] Requests are clamped to the streamable range") {
+	TextureStreamingResidency residency;
+	residency.texture_add(1, make_mip_sizes(256), 3);
+
+	Vector<TextureStreamingResidency::Operation> loads;
+	Vector<TextureStreamingResidency::Operation> evictions;
+
+	residency.texture_request(1, 6, 1);
+	residency.update(1, loads, evictions);
+	CHECK_MESSAGE(loads.empty(), "Asking for less than the base mip should not load anything.");
+
+	residency.texture_request(1, -4, 2);
+	residency.update(2, loads, evictions);
+	REQUIRE(loads.size() == 1);
+	CHECK(loads[0].mip == 0);
+
+	residency.texture_load_failed(1);
+	CHECK(residency.get_pending_bytes() == 0);
+	CHECK(residency.texture_get_resident_mip(1) == 3);
+
+	loads.clear();
+	residency.texture_request(1, 0, 3);
+	residency.update(3, loads, evictions);
+	CHECK_MESSAGE(loads.empty(), "A texture that failed to load should stay at its resident mip.");
+}
+
+TEST_CASE("[TextureStreaming] Least recently used textures are evicted to fit the budget") {
+	TextureStreamingResidency residency;
+	residency.texture_add(1, make_mip_sizes(256), 3);
+	residency.texture_add(2, make_mip_sizes(256), 3);
+	residency.texture_add(3, make_mip_sizes(256), 3);
+	residency.set_budget(BYTES_FROM_MIP_0 + BYTES_FROM_MIP_1 + BYTES_FROM_MIP_3);
+
+	Vector<TextureStreamingResidency::Operation> loads;
+	Vector<TextureStreamingResidency::Operation> evictions;
+
+	// Texture 1 at full size, used at frame 1; texture 2 at mip 1, used at frame 2.
+	residency.texture_request(1, 0, 1);
+	residency.update(1, loads, evictions);
+	REQUIRE(loads.size() == 1);
+	residency.texture_loaded(1, 0);
+	loads.clear();
+
+	residency.texture_request(2, 1, 2);
+	residency.update(2, loads, evictions);
+	REQUIRE(loads.size() == 1);
+	residency.texture_loaded(2, 1);
+	loads.clear();
+	CHECK(evictions.empty());
+	CHECK(residency.get_resident_bytes() == BYTES_FROM_MIP_0 + BYTES_FROM_MIP_1 + BYTES_FROM_MIP_3);
+
+	// Texture 3 needs mip 1 now; texture 1 is the least recently used one.
+	residency.texture_request(3, 1, 3);
+	residency.update(3, loads, evictions);
+	REQUIRE(evictions.size() == 1);
+	CHECK(evictions[0].texture == 1);
+	CHECK(evictions[0].mip == 3);
+	REQUIRE(loads.size() == 1);
+	CHECK(loads[0].texture == 3);
+	CHECK(loads[0].mip == 1);
+	CHECK(residency.texture_get_resident_mip(1) == 3);
+	CHECK(residency.texture_get_resident_mip(2) == 1);
+	CHECK(residency.get_resident_bytes() + residency.get_pending_bytes() <= residency.get_budget());
+
+	// Lowering the budget evicts unused textures right away.
+	residency.texture_loaded(3, 1);
+	loads.clear();
+	evictions.clear();
+	residency.set_budget(BYTES_FROM_MIP_1 + BYTES_FROM_MIP_3 * 2);
+	residency.texture_request(3, 1, 4);
+	residency.update(4, loads, evictions);
+	REQUIRE(evictions.size() == 1);
+	CHECK(evictions[0].texture == 2);
+	CHECK(loads.empty());
+	CHECK(residency.get_resident_bytes() == BYTES_FROM_MIP_1 + BYTES_FROM_MIP_3 * 2);
+}
+
+TEST_CASE("[TextureStreaming] Visible textures are never evicted") {
+	TextureStreamingResidency residency;
+	residency.texture_add(1, make_mip_sizes(256), 3);
+	residency.texture_add(2, make_mip_sizes(256), 3);
+	residency.set_budget(BYTES_FROM_MIP_1 + BYTES_FROM_MIP_2);
+
+	Vector<TextureStreamingResidency::Operation> loads;
+	Vector<TextureStreamingResidency::Operation> evictions;
+
+	residency.texture_request(1, 1, 1);
+	residency.update(1, loads, evictions);
+	REQUIRE(loads.size() == 1);
+	residency.texture_loaded(1, 1);
+	loads.clear();
+
+	// Both are on screen: texture 1 stays, texture 2 gets the finest level that fits.
+	residency.texture_request(1, 1, 2);
+	residency.texture_request(2, 0, 2);
+	residency.update(2, loads, evictions);
+	CHECK(evictions.empty());
+	REQUIRE(loads.size() == 1);
+	CHECK(loads[0].texture == 2);
+	CHECK(loads[0].mip == 2);
+	CHECK(residency.get_resident_bytes() + residency.get_pending_bytes() <= residency.get_budget());
+}
+
+TEST_CASE("[TextureStreaming] Loads are issued by need and capped per update") {
+	TextureStreamingResidency residency;
+	for (int i = 1; i <= 4; i++) {
+		residency.texture_add(i, make_mip_sizes(256), 3);
+	}
+	residency.set_max_loads_per_update(2);
+
+	Vector<TextureStreamingResidency::Operation> loads;
+	Vector<TextureStreamingResidency::Operation> evictions;
+
+	residency.texture_request(1, 2, 1);
+	residency.texture_request(2, 0, 1);
+	residency.texture_request(3, 1, 1);
+	residency.texture_request(4, 2, 1);
+	residency.update(1, loads, evictions);
+	REQUIRE(loads.size() == 2);
+	CHECK_MESSAGE(loads[0].texture == 2, "The texture missing the most detail should load first.");
+	CHECK(loads[1].texture == 3);
+
+	loads.clear();
+	residency.texture_request(1, 2, 2);
+	residency.texture_request(4, 2, 2);
+	residency.update(2, loads, evictions);
+	REQUIRE(loads.size() == 2);
+	CHECK(loads[0].texture == 1);
+	CHECK(loads[1].texture == 4);
+}
+
+} // namespace TestTextureStreaming
+
+#endif // TEST_TEXTURE_STREAMING_H
@@ -0,0 +1,153 @@
+/*************************************************************************/
+/*  test_visibility_range.h                                              */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_VISIBILITY_RANGE_H
+#define TEST_VISIBILITY_RANGE_H
+
+#include "servers/rendering/rendering_server_scene.h"
+
+#include "tests/test_macros.h"
+
+namespace TestVisibilityRange {
+
+typedef RenderingServerScene::Instance Instance;
+
+// Instances are centered on the origin, the camera sits on the Z axis.
+static void add_instance(RenderingServerScene::Scenario &r_scenario, Instance &r_instance, float p_begin, float p_end, float p_begin_margin = 0, float p_end_margin = 0) {
+	r_instance.scenario = &r_scenario;
+	r_instance.transformed_aabb = AABB(Vector3(-1, -1, -1), Vector3(2, 2, 2));
+	r_instance.lod_begin = p_begin;
+	r_instance.lod_end = p_end;
+	r_instance.lod_begin_hysteresis = p_begin_margin;
+	r_instance.lod_end_hysteresis = p_end_margin;
+	RenderingServerScene::_instance_update_visibility_range_list(&r_instance);
+}
+
+static void update(RenderingServerScene::Scenario &r_scenario, float p_distance) {
+	RenderingServerScene::_scene_update_visibility_ranges(&r_scenario, Vector3(0, 0, p_distance));
+}
+
+TEST_CASE("[VisibilityRange] Margins only apply once an instance is shown") {
+	RenderingServerScene::Scenario scenario;
+	Instance instance;
+	add_instance(scenario, instance, 10, 100, 2, 5);
+
+	update(scenario, 50);
+	CHECK(!instance.visibility_range_culled);
+
+	// Leaving through the far end.
+	update(scenario, 104);
+	CHECK(!instance.visibility_range_culled);
+	update(scenario, 106);
+	CHECK(instance.visibility_range_culled);
+	update(scenario, 104);
+	CHECK_MESSAGE(instance.visibility_range_culled, "Hidden instances come back at the range itself, not the margin.");
+	update(scenario, 99);
+	CHECK(!instance.visibility_range_culled);
+
+	// Leaving through the near end.
+	update(scenario, 9);
+	CHECK(!instance.visibility_range_culled);
+	update(scenario, 7);
+	CHECK(instance.visibility_range_culled);
+	CHECK(instance.visibility_range_state == RenderingServerScene::VISIBILITY_RANGE_TOO_CLOSE);
+	update(scenario, 9);
+	CHECK(instance.visibility_range_culled);
+	update(scenario, 11);
+	CHECK(!instance.visibility_range_culled);
+}
+
+TEST_CASE("[VisibilityRange] Children swap in exactly when the parent swaps out") {
+	RenderingServerScene::Scenario scenario;
+	Instance parent;
+	Instance children[2];
+	Instance grandchild;
+
+	add_instance(scenario, parent, 50, 0, 5);
+	add_instance(scenario, children[0], 20, 0);
+	add_instance(scenario, children[1], 0, 0);
+	add_instance(scenario, grandchild, 0, 0);
+	RenderingServerScene::_instance_link_visibility_parent(&children[0], &parent);
+	RenderingServerScene::_instance_link_visibility_parent(&children[1], &parent);
+	RenderingServerScene::_instance_link_visibility_parent(&grandchild, &children[0]);
+
+	// The parent's margin delays the swap both ways, and the children follow it in the same update.
+	const float distances[] = { 100, 48, 44, 48, 52, 30 };
+	const bool parent_drawn[] = { true, true, false, false, true, false };
+	for (int i = 0; i < 6; i++) {
+		update(scenario, distances[i]);
+		CHECK(parent.visibility_range_culled == !parent_drawn[i]);
+		CHECK(children[0].visibility_range_culled == parent_drawn[i]);
+		CHECK(children[1].visibility_range_culled == parent_drawn[i]);
+		CHECK(grandchild.visibility_range_culled);
+	}
+
+	// Deeper levels swap in the same way.
+	update(scenario, 10);
+	CHECK(parent.visibility_range_culled);
+	CHECK(children[0].visibility_range_culled);
+	CHECK(!children[1].visibility_range_culled);
+	CHECK(!grandchild.visibility_range_culled);
+	CHECK(!grandchild.visibility_parent_culled);
+
+	// A visible parent hides its whole subtree without looking at its descendants' ranges.
+	update(scenario, 100);
+	CHECK(grandchild.visibility_range_culled);
+	CHECK(grandchild.visibility_parent_culled);
+	grandchild.lod_end = 1;
+	grandchild.visibility_range_state = RenderingServerScene::VISIBILITY_RANGE_VISIBLE;
+	update(scenario, 100);
+	CHECK_MESSAGE(grandchild.visibility_range_state == RenderingServerScene::VISIBILITY_RANGE_VISIBLE, "Hidden subtrees should be skipped.");
+	grandchild.lod_end = 0;
+
+	// Instances attached below a hidden subtree are hidden with it.
+	Instance late_child;
+	add_instance(scenario, late_child, 0, 0);
+	RenderingServerScene::_instance_link_visibility_parent(&late_child, &grandchild);
+	update(scenario, 100);
+	CHECK(late_child.visibility_range_culled);
+	update(scenario, 10);
+	CHECK(!grandchild.visibility_range_culled);
+	CHECK(late_child.visibility_range_culled);
+
+	// Detached children are evaluated on their own again.
+	RenderingServerScene::_instance_link_visibility_parent(&children[1], nullptr);
+	update(scenario, 100);
+	CHECK(!children[1].visibility_range_culled);
+	CHECK(children[0].visibility_range_culled);
+
+	RenderingServerScene::_instance_link_visibility_parent(&late_child, nullptr);
+	RenderingServerScene::_instance_link_visibility_parent(&grandchild, nullptr);
+	RenderingServerScene::_instance_link_visibility_parent(&children[0], nullptr);
+}
+
+} // namespace TestVisibilityRange
+
+#endif // TEST_VISIBILITY_RANGE_H